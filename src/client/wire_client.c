@@ -0,0 +1,456 @@
+/*******************************************************************************
+ * @file wire_client.c
+ * @brief Client library for socket server's binary protocol.
+ *
+ * Library does not depend on anything but the protocol's codec, so tools
+ * and remote players link just these two files.
+ *
+ ******************************************************************************/
+#define _GNU_SOURCE // SOCK_CLOEXEC
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// App's internal libs
+#include "client/wire_client.h"
+#include "input/input_common.h"
+#include "input/wire_protocol.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+struct WireClientPrivateOps {
+  int (*open_socket)(const char *address, bool is_nonblocking, int *fd);
+  int (*finish_frame)(struct WireClient *client);
+  int (*write_output)(struct WireClient *client);
+  int (*process_input)(struct WireClient *client);
+  int (*process_record)(struct WireClient *client,
+                        struct InputWireRecord *record);
+};
+
+static struct InputWireOps *input_wire_ops;
+static struct WireClientPrivateOps *wire_client_priv_ops;
+struct WireClientPrivateOps *get_wire_client_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int wire_client_connect(struct WireClient *client, const char *address,
+                               bool is_nonblocking) {
+  struct WireClientHandlers handlers;
+  void *data;
+  int err;
+
+  if (!client || !address) {
+    return EINVAL;
+  }
+
+  input_wire_ops = get_input_wire_ops();
+  wire_client_priv_ops = get_wire_client_priv_ops();
+
+  handlers = client->handlers;
+  data = client->data;
+  memset(client, 0, sizeof(*client));
+  client->fd = -1;
+  client->handlers = handlers;
+  client->data = data;
+
+  err = wire_client_priv_ops->open_socket(address, is_nonblocking,
+                                          &client->fd);
+  if (err) {
+    return err;
+  }
+
+  // Hello goes out with the first frames, so it costs no write of its own.
+  client->output[client->output_length++] = INPUT_WIRE_MAGIC;
+  client->output[client->output_length++] = INPUT_WIRE_VERSION;
+
+  return 0;
+}
+
+static int wire_client_queue_move(struct WireClient *client,
+                                  game_user_id_t user,
+                                  const enum InputEvents *events,
+                                  size_t events_length) {
+  int err;
+
+  if (!client || client->fd == -1 || user < 1) {
+    return EINVAL;
+  }
+
+  err = input_wire_ops->compose_events(client->payload,
+                                       &client->payload_length, user, events,
+                                       events_length);
+  if (err == ENOBUFS) {
+    err = wire_client_priv_ops->finish_frame(client);
+    if (err) {
+      return err;
+    }
+
+    err = input_wire_ops->compose_events(client->payload,
+                                         &client->payload_length, user,
+                                         events, events_length);
+    if (err == ENOBUFS) {
+      return EMSGSIZE;
+    }
+  }
+  if (err) {
+    return err;
+  }
+
+  client->payload_moves++;
+
+  return 0;
+}
+
+static int wire_client_join(struct WireClient *client, size_t users_amount,
+                            size_t board_size) {
+  int err;
+
+  if (!client || client->fd == -1 || users_amount > UINT32_MAX ||
+      board_size > UINT32_MAX) {
+    return EINVAL;
+  }
+
+  err = input_wire_ops->compose_join(client->payload, &client->payload_length,
+                                     users_amount, board_size);
+  if (err == ENOBUFS) {
+    err = wire_client_priv_ops->finish_frame(client);
+    if (err) {
+      return err;
+    }
+
+    err = input_wire_ops->compose_join(
+        client->payload, &client->payload_length, users_amount, board_size);
+  }
+  if (err) {
+    return err;
+  }
+
+  client->seat = 0;
+
+  return 0;
+}
+
+static int wire_client_flush(struct WireClient *client) {
+  int err;
+
+  if (!client || client->fd == -1) {
+    return EINVAL;
+  }
+
+  // Output full of frames is written first to make room for the last one.
+  if (wire_client_priv_ops->finish_frame(client) == ENOBUFS) {
+    err = wire_client_priv_ops->write_output(client);
+    if (err) {
+      return err;
+    }
+
+    err = wire_client_priv_ops->finish_frame(client);
+    if (err) {
+      return err;
+    }
+  }
+
+  return wire_client_priv_ops->write_output(client);
+}
+
+static int wire_client_receive(struct WireClient *client) {
+  ssize_t bytes_read;
+
+  if (!client || client->fd == -1) {
+    return EINVAL;
+  }
+
+  bytes_read = read(client->fd, client->input + client->input_length,
+                    sizeof(client->input) - client->input_length);
+  if (bytes_read == -1) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return EAGAIN;
+    }
+    return errno;
+  }
+
+  if (bytes_read == 0) {
+    return ECONNRESET;
+  }
+
+  client->input_length += bytes_read;
+
+  return wire_client_priv_ops->process_input(client);
+}
+
+static void wire_client_close(struct WireClient *client) {
+  if (!client || client->fd == -1) {
+    return;
+  }
+
+  close(client->fd);
+  client->fd = -1;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int wire_client_open_socket(const char *address, bool is_nonblocking,
+                                   int *fd) {
+  const char unix_prefix[] = "unix:";
+  const char tcp_prefix[] = "tcp:";
+  struct sockaddr_un unix_address = {.sun_family = AF_UNIX};
+  struct sockaddr_in tcp_address = {.sin_family = AF_INET};
+  struct sockaddr *socket_address;
+  char host[INET_ADDRSTRLEN];
+  socklen_t address_length;
+  const char *value;
+  const char *colon;
+  char *end;
+  long port;
+  int domain;
+  int err;
+
+  if (strncmp(address, unix_prefix, sizeof(unix_prefix) - 1) == 0) {
+    value = address + sizeof(unix_prefix) - 1;
+    if (*value == 0 || strlen(value) >= sizeof(unix_address.sun_path)) {
+      return EINVAL;
+    }
+
+    strcpy(unix_address.sun_path, value);
+    domain = AF_UNIX;
+    socket_address = (struct sockaddr *)&unix_address;
+    address_length = sizeof(unix_address);
+  } else if (strncmp(address, tcp_prefix, sizeof(tcp_prefix) - 1) == 0) {
+    value = address + sizeof(tcp_prefix) - 1;
+    tcp_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    // Host is optional, port follows the last colon.
+    colon = strrchr(value, ':');
+    if (colon) {
+      if ((size_t)(colon - value) >= sizeof(host)) {
+        return EINVAL;
+      }
+
+      memcpy(host, value, colon - value);
+      host[colon - value] = 0;
+      if (inet_pton(AF_INET, host, &tcp_address.sin_addr) != 1) {
+        return EINVAL;
+      }
+      value = colon + 1;
+    }
+
+    port = strtol(value, &end, 10);
+    if (end == value || *end || port <= 0 || port > UINT16_MAX) {
+      return EINVAL;
+    }
+
+    tcp_address.sin_port = htons(port);
+    domain = AF_INET;
+    socket_address = (struct sockaddr *)&tcp_address;
+    address_length = sizeof(tcp_address);
+  } else {
+    return EINVAL;
+  }
+
+  *fd = socket(domain,
+               SOCK_STREAM | SOCK_CLOEXEC |
+                   (is_nonblocking ? SOCK_NONBLOCK : 0),
+               0);
+  if (*fd == -1) {
+    return errno;
+  }
+
+  if (connect(*fd, socket_address, address_length) == -1 &&
+      !(is_nonblocking && errno == EINPROGRESS)) {
+    err = errno;
+    close(*fd);
+    *fd = -1;
+    return err;
+  }
+
+  return 0;
+}
+
+static int wire_client_finish_frame(struct WireClient *client) {
+  if (client->payload_length == 0) {
+    return 0;
+  }
+
+  if (sizeof(client->output) - client->output_length < INPUT_WIRE_FRAME_MAX) {
+    return ENOBUFS;
+  }
+
+  client->output_length += input_wire_ops->compose_frame(
+      client->payload, client->payload_length,
+      client->output + client->output_length);
+  client->moves_sent += client->payload_moves;
+  client->payload_length = 0;
+  client->payload_moves = 0;
+
+  return 0;
+}
+
+static int wire_client_write_output(struct WireClient *client) {
+  size_t written = 0;
+  ssize_t bytes_written;
+  int err = 0;
+
+  while (written < client->output_length) {
+    bytes_written = send(client->fd, client->output + written,
+                         client->output_length - written, MSG_NOSIGNAL);
+    if (bytes_written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      err = errno == EWOULDBLOCK ? EAGAIN : errno;
+      break;
+    }
+
+    written += bytes_written;
+  }
+
+  memmove(client->output, client->output + written,
+          client->output_length - written);
+  client->output_length -= written;
+
+  return err;
+}
+
+static int wire_client_process_input(struct WireClient *client) {
+  struct InputWireRecord record;
+  struct InputWireFrame frame;
+  size_t offset = 0;
+  int err;
+
+  if (client->version == 0) {
+    if (client->input_length < INPUT_WIRE_HELLO_LENGTH) {
+      return 0;
+    }
+
+    if (client->input[0] != INPUT_WIRE_MAGIC || client->input[1] == 0 ||
+        client->input[1] > INPUT_WIRE_VERSION) {
+      return EPROTO;
+    }
+
+    client->version = client->input[1];
+    offset = INPUT_WIRE_HELLO_LENGTH;
+  }
+
+  for (;;) {
+    err = input_wire_ops->parse_frame(client->input + offset,
+                                      client->input_length - offset, &frame);
+    if (err == EAGAIN) {
+      break;
+    }
+    if (err) {
+      return EPROTO;
+    }
+
+    while ((err = input_wire_ops->parse_record(&frame, &record)) == 0) {
+      err = wire_client_priv_ops->process_record(client, &record);
+      if (err) {
+        return err;
+      }
+    }
+    if (err != ENOENT) {
+      return EPROTO;
+    }
+
+    offset += frame.frame_length;
+  }
+
+  memmove(client->input, client->input + offset,
+          client->input_length - offset);
+  client->input_length -= offset;
+
+  return 0;
+}
+
+static int wire_client_process_record(struct WireClient *client,
+                                     struct InputWireRecord *record) {
+  struct UserMove move;
+
+  switch (record->kind) {
+  case INPUT_WIRE_ACK:
+    // Server acknowledges only moves it got.
+    if (record->moves > client->moves_sent - client->moves_acked) {
+      return EPROTO;
+    }
+
+    client->moves_acked += record->moves;
+    return 0;
+
+  case INPUT_WIRE_MOVE:
+    move = (struct UserMove){
+        .type = record->move_type,
+        .user_id = record->user,
+        .coordinates = {.x = record->x, .y = record->y},
+    };
+    if (client->handlers.move) {
+      client->handlers.move(client, &move);
+    }
+    return 0;
+
+  case INPUT_WIRE_GAME:
+    if (record->game == INPUT_WIRE_GAME_START) {
+      client->seat = record->user;
+      if (client->handlers.start) {
+        client->handlers.start(client, record->user, record->users,
+                               record->board_size);
+      }
+      return 0;
+    }
+
+    // Only clients ask for a game.
+    if (record->game != INPUT_WIRE_GAME_RESULT) {
+      return EPROTO;
+    }
+
+    if (client->handlers.result) {
+      client->handlers.result(client, record->user, record->moves);
+    }
+    return 0;
+
+  default:
+    // Server never sends events.
+    return EPROTO;
+  }
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct WireClientPrivateOps wire_client_priv_ops_ = {
+    .open_socket = wire_client_open_socket,
+    .finish_frame = wire_client_finish_frame,
+    .write_output = wire_client_write_output,
+    .process_input = wire_client_process_input,
+    .process_record = wire_client_process_record,
+};
+
+struct WireClientPrivateOps *get_wire_client_priv_ops(void) {
+  return &wire_client_priv_ops_;
+}
+
+static struct WireClientOps wire_client_ops = {
+    .connect = wire_client_connect,
+    .queue_move = wire_client_queue_move,
+    .join = wire_client_join,
+    .flush = wire_client_flush,
+    .receive = wire_client_receive,
+    .close = wire_client_close,
+};
+
+struct WireClientOps *get_wire_client_ops(void) { return &wire_client_ops; }
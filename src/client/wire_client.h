@@ -0,0 +1,108 @@
+#ifndef CLIENT_WIRE_CLIENT_H
+#define CLIENT_WIRE_CLIENT_H
+/*******************************************************************************
+ * @file wire_client.h
+ * @brief Client library for socket server's binary protocol.
+ *
+ * Client queues moves, each being a batch of one user's events, into a
+ * frame and sends frames once it is flushed, so many moves cost a single
+ * write. Server acknowledges moves it processed, client counts them, so
+ * caller knows how many of its moves are still in flight.
+ *
+ * Servers hosting sessions also report every select and quit and end of
+ * every game, client passes them to handlers set by caller. Client may ask
+ * such server to seat it with other players, it then plays only for the
+ * seat server gave it. Users are counted from 1 everywhere, like on the
+ * wire.
+ *
+ * Client works over blocking socket as well as over non blocking one,
+ * which caller polls itself. Nothing is allocated, one client is one
+ * struct WireClient.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "game/user_move.h"
+#include "input/input_common.h"
+#include "input/wire_protocol.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define WIRE_CLIENT_OUTPUT_MAX (32 * INPUT_WIRE_FRAME_MAX)
+// Session servers answer with moves too, take many frames per read.
+#define WIRE_CLIENT_INPUT_MAX (16 * INPUT_WIRE_FRAME_MAX)
+
+struct WireClient;
+
+struct WireClientHandlers {
+  void (*move)(struct WireClient *client, const struct UserMove *move);
+  // Winner is 0 if game ended with a draw or quit.
+  void (*result)(struct WireClient *client, game_user_id_t winner,
+                 size_t valid_moves);
+  // Client was seated with other players.
+  void (*start)(struct WireClient *client, game_user_id_t seat,
+                size_t users_amount, size_t board_size);
+};
+
+struct WireClient {
+  int fd;
+  // Version server agreed to, zero until its hello arrives.
+  uint8_t version;
+  // Frame being built.
+  uint8_t payload[INPUT_WIRE_PAYLOAD_MAX];
+  size_t payload_length;
+  size_t payload_moves;
+  // Finished frames not written yet.
+  uint8_t output[WIRE_CLIENT_OUTPUT_MAX];
+  size_t output_length;
+  uint8_t input[WIRE_CLIENT_INPUT_MAX];
+  size_t input_length;
+  // Moves in finished frames.
+  size_t moves_sent;
+  size_t moves_acked;
+  // User client plays for since server seated it, 0 until then.
+  game_user_id_t seat;
+  // Kept by connect, so caller may set them before it.
+  struct WireClientHandlers handlers;
+  void *data;
+};
+
+struct WireClientOps {
+  // Connects to address server listens on, `unix:<path>`, `tcp:<port>`
+  //  on localhost or `tcp:<ipv4>:<port>`, and queues hello. Non blocking
+  //  connect may still be in progress.
+  int (*connect)(struct WireClient *client, const char *address,
+                 bool is_nonblocking);
+  // Adds user's events to the frame being built as a single move, frame
+  //  is finished first if it has no room left. Returns ENOBUFS if output
+  //  is full, caller has to flush it then.
+  int (*queue_move)(struct WireClient *client, game_user_id_t user,
+                    const enum InputEvents *events, size_t events_length);
+  // Asks server to seat client with players waiting for the same game.
+  //  Join has to be the last thing client sends, nothing else may be
+  //  queued until start handler is called.
+  int (*join)(struct WireClient *client, size_t users_amount,
+              size_t board_size);
+  // Finishes the frame being built and writes whole output. Returns EAGAIN
+  //  if non blocking socket can't take all of it now.
+  int (*flush)(struct WireClient *client);
+  // Reads once and processes everything server sent. Returns EAGAIN if
+  //  there was nothing to read, ECONNRESET once server closed connection
+  //  and EPROTO if it broke the protocol.
+  int (*receive)(struct WireClient *client);
+  void (*close)(struct WireClient *client);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct WireClientOps *get_wire_client_ops(void);
+
+#endif // CLIENT_WIRE_CLIENT_H
@@ -46,6 +46,7 @@ struct ConfigPrivateOps {
   int (*add_var)(struct ConfigAddVarInput *, struct ConfigAddVarOutput *);
 };
 
+static char module_id[] = "config";
 static struct LoggingUtilsOps *logging_ops;
 static struct ConfigSubsystem config_subsystem;
 
@@ -112,6 +113,51 @@ static int config_var_init(struct ConfigVariable *var, char *var_name,
   return 0;
 };
 
+static int config_read_var(char *var_name, char *default_value, char *value,
+                           size_t size) {
+  struct ConfigVariable config_var;
+  struct ConfigAddVarOutput add_var;
+  struct ConfigGetVarOutput get_var;
+  int err;
+
+  if (!value || size == 0) {
+    return EINVAL;
+  }
+
+  err = config_var_init(&config_var, var_name, default_value);
+  if (err) {
+    return err;
+  }
+
+  err = config_add_variable_intrfc(
+      (struct ConfigAddVarInput){.var = &config_var}, &add_var);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to add %s config variable: %s",
+                         config_var.var_name, strerror(err));
+    return err;
+  }
+
+  err = config_get_variable_intrfc(
+      (struct ConfigGetVarInput){.var_id = add_var.var_id,
+                                 .mode = CONFIG_GET_VAR_BY_ID},
+      &get_var);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to get %s config variable: %s",
+                         config_var.var_name, strerror(err));
+    return err;
+  }
+
+  if (strlen(get_var.value) >= size) {
+    logging_ops->log_err(module_id, "Value of %s is too long: %s",
+                         config_var.var_name, get_var.value);
+    return ENAMETOOLONG;
+  }
+
+  strcpy(value, get_var.value);
+
+  return 0;
+}
+
 /*******************************************************************************
  *    PRIVATE API
  ******************************************************************************/
@@ -225,6 +271,7 @@ static struct ConfigOps config_pub_ops = {
     .init_var = config_var_init,
     .get_var = config_get_variable_intrfc,
     .add_var = config_add_variable_intrfc,
+    .read_var = config_read_var,
 };
 
 struct ConfigOps *get_config_ops(void) {
@@ -9,6 +9,11 @@
  * and retrieving configuration variables.
  *
  ******************************************************************************/
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+
 /*******************************************************************************
  *    PUBLIC API
  ******************************************************************************/
@@ -57,6 +62,11 @@ struct ConfigOps {
   int (*init_var)(struct ConfigVariable *, char *, char *);
   int (*add_var)(struct ConfigAddVarInput, struct ConfigAddVarOutput *);
   int (*get_var)(struct ConfigGetVarInput, struct ConfigGetVarOutput *);
+  // Registers variable and copies its value to the buffer, so modules
+  //  reading their settings once on init do not have to go through
+  //  variable ids. Fails with ENAMETOOLONG if value does not fit.
+  int (*read_var)(char *var_name, char *default_value, char *value,
+                  size_t size);
 };
 
 /*******************************************************************************
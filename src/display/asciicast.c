@@ -0,0 +1,440 @@
+/*******************************************************************************
+ * @file asciicast.c
+ * @brief Display recording game session into asciicast v2 file.
+ *
+ * Cli display hands every composed frame to the recorder's tap, which only
+ * timestamps it and copies it into bounded ring buffer. Formatting and
+ * writing happens on recorder's own thread. If writer falls so much behind
+ * that a frame does not fit into the buffer, the frame is dropped and cli
+ * display is asked for a full redraw, so the recording never contains diff
+ * applied on top of a missing frame.
+ *
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// App's internal libs
+#include "config/config.h"
+#include "display/asciicast.h"
+#include "display/cli.h"
+#include "display/display.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define ASCIICAST_BUFFER_SIZE (1024 * 1024)
+#define ASCIICAST_PATH_MAX 256
+// Used in header if terminal dimensions are unknown.
+#define ASCIICAST_DEFAULT_ROWS 24
+#define ASCIICAST_DEFAULT_COLS 80
+
+// Stored in the ring right before frame's bytes.
+struct AsciicastEvent {
+  uint64_t time_ns;
+  size_t rows;
+  size_t cols;
+  size_t length;
+};
+
+struct AsciicastRecorder {
+  char path[ASCIICAST_PATH_MAX];
+  FILE *file;
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t wakeup;
+  struct timespec started_at;
+  bool is_recording;
+  bool is_stopping;
+  bool is_resync_needed;
+  // Ring buffer shared by tap and writer.
+  char *buffer;
+  size_t head;
+  size_t length;
+  // Owned by writer thread.
+  char *event_buffer;
+  bool is_header_written;
+  size_t rows;
+  size_t cols;
+  struct DisplayAsciicastStats stats;
+};
+
+struct DisplayAsciicastPrivateOps {
+  display_display_func_t display;
+  int (*open)(void);
+  void (*close)(void);
+  int (*get_path)(char *path, size_t size);
+  int (*tap)(const char *buffer, size_t length, size_t rows, size_t cols,
+             bool is_full);
+  void (*ring_write)(const void *src, size_t n);
+  void (*ring_read)(void *dst, size_t n);
+  void *(*writer_thread)(void *arg);
+  void (*write_event)(struct AsciicastEvent *event, const char *buffer);
+  void (*write_escaped)(const char *buffer, size_t length);
+};
+
+static char module_id[] = "display_asciicast";
+static struct AsciicastRecorder recorder = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .wakeup = PTHREAD_COND_INITIALIZER,
+};
+static struct ConfigOps *config_ops;
+static struct LoggingUtilsOps *logging_ops;
+static struct DisplayAsciicastPrivateOps *display_asciicast_priv_ops;
+struct DisplayAsciicastPrivateOps *get_display_asciicast_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int display_asciicast_init(void) {
+  struct DisplayCliOps *cli_ops;
+  struct DisplayOps *display_ops;
+  int err;
+
+  display_asciicast_priv_ops = get_display_asciicast_priv_ops();
+  display_ops = get_display_ops();
+  cli_ops = get_display_cli_ops();
+  config_ops = get_config_ops();
+  logging_ops = get_logging_utils_ops();
+
+  err = display_asciicast_priv_ops->get_path(recorder.path,
+                                             sizeof(recorder.path));
+  if (err) {
+    return err;
+  }
+
+  err = display_ops->add_display(&(struct DisplayDisplay){
+      .display_name = DISPLAY_ASCIICAST_NAME,
+      .display = display_asciicast_priv_ops->display,
+      .open = display_asciicast_priv_ops->open,
+      .close = display_asciicast_priv_ops->close});
+  if (err) {
+    return err;
+  }
+
+  err = cli_ops->add_frame_tap(display_asciicast_priv_ops->tap);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to add cli frame tap: %s",
+                         strerror(err));
+    return err;
+  }
+
+  return 0;
+}
+
+static void display_asciicast_destroy(void) {
+  display_asciicast_priv_ops->close();
+}
+
+static void display_asciicast_get_stats(struct DisplayAsciicastStats *stats) {
+  if (!stats) {
+    return;
+  }
+
+  pthread_mutex_lock(&recorder.mutex);
+  *stats = recorder.stats;
+  pthread_mutex_unlock(&recorder.mutex);
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+// Frames arrive through cli display's tap, there is nothing to do here.
+static int display_asciicast_display(struct DisplayData *data) {
+  (void)data;
+
+  return 0;
+}
+
+static int display_asciicast_open(void) {
+  int err;
+
+  recorder.file = fopen(recorder.path, "w");
+  if (!recorder.file) {
+    err = errno;
+    logging_ops->log_err(module_id, "Unable to open %s: %s", recorder.path,
+                         strerror(err));
+    return err;
+  }
+
+  recorder.buffer = malloc(ASCIICAST_BUFFER_SIZE);
+  recorder.event_buffer = malloc(ASCIICAST_BUFFER_SIZE);
+  if (!recorder.buffer || !recorder.event_buffer) {
+    err = ENOMEM;
+    goto error;
+  }
+
+  recorder.head = 0;
+  recorder.length = 0;
+  recorder.is_header_written = false;
+  recorder.stats = (struct DisplayAsciicastStats){0};
+  clock_gettime(CLOCK_MONOTONIC, &recorder.started_at);
+
+  // Recording has to start with a full frame.
+  recorder.is_resync_needed = true;
+  recorder.is_stopping = false;
+
+  err = pthread_create(&recorder.thread, NULL,
+                       display_asciicast_priv_ops->writer_thread, NULL);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to start writer thread: %s",
+                         strerror(err));
+    goto error;
+  }
+
+  pthread_mutex_lock(&recorder.mutex);
+  recorder.is_recording = true;
+  pthread_mutex_unlock(&recorder.mutex);
+
+  logging_ops->log_info(module_id, "Recording session to %s", recorder.path);
+
+  return 0;
+
+error:
+  free(recorder.buffer);
+  free(recorder.event_buffer);
+  recorder.buffer = NULL;
+  recorder.event_buffer = NULL;
+  fclose(recorder.file);
+  recorder.file = NULL;
+
+  return err;
+}
+
+// Everything already in the buffer is written before the file is closed.
+static void display_asciicast_close(void) {
+  pthread_mutex_lock(&recorder.mutex);
+  if (!recorder.is_recording) {
+    pthread_mutex_unlock(&recorder.mutex);
+    return;
+  }
+  recorder.is_recording = false;
+  recorder.is_stopping = true;
+  pthread_cond_signal(&recorder.wakeup);
+  pthread_mutex_unlock(&recorder.mutex);
+
+  pthread_join(recorder.thread, NULL);
+
+  fclose(recorder.file);
+  recorder.file = NULL;
+  free(recorder.buffer);
+  free(recorder.event_buffer);
+  recorder.buffer = NULL;
+  recorder.event_buffer = NULL;
+
+  logging_ops->log_info(module_id, "Recorded %zu frames, %zu dropped",
+                        recorder.stats.frames, recorder.stats.dropped_frames);
+}
+
+static int display_asciicast_get_path(char *path, size_t size) {
+  return config_ops->read_var(DISPLAY_ASCIICAST_PATH_VAR_NAME,
+                              DISPLAY_ASCIICAST_PATH_DEFAULT, path, size);
+}
+
+// Called from cli display's render thread, only copies the frame.
+static int display_asciicast_tap(const char *buffer, size_t length,
+                                 size_t rows, size_t cols, bool is_full) {
+  struct AsciicastEvent event;
+  struct timespec now;
+  int result = 0;
+
+  pthread_mutex_lock(&recorder.mutex);
+  if (!recorder.is_recording || length == 0) {
+    goto out;
+  }
+
+  if (recorder.is_resync_needed && !is_full) {
+    result = DISPLAY_CLI_TAP_RESYNC;
+    goto out;
+  }
+
+  if (ASCIICAST_BUFFER_SIZE - recorder.length < sizeof(event) + length) {
+    recorder.stats.dropped_frames++;
+    recorder.is_resync_needed = true;
+    result = DISPLAY_CLI_TAP_RESYNC;
+    goto out;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  event = (struct AsciicastEvent){
+      .time_ns = (uint64_t)(now.tv_sec - recorder.started_at.tv_sec) *
+                     1000000000ULL +
+                 now.tv_nsec - recorder.started_at.tv_nsec,
+      .rows = rows,
+      .cols = cols,
+      .length = length,
+  };
+
+  display_asciicast_priv_ops->ring_write(&event, sizeof(event));
+  display_asciicast_priv_ops->ring_write(buffer, length);
+  recorder.stats.frames++;
+  recorder.is_resync_needed = false;
+
+  pthread_cond_signal(&recorder.wakeup);
+
+out:
+  pthread_mutex_unlock(&recorder.mutex);
+
+  return result;
+}
+
+static void display_asciicast_ring_write(const void *src, size_t n) {
+  size_t tail = (recorder.head + recorder.length) % ASCIICAST_BUFFER_SIZE;
+  size_t chunk = ASCIICAST_BUFFER_SIZE - tail;
+
+  if (chunk > n) {
+    chunk = n;
+  }
+
+  memcpy(recorder.buffer + tail, src, chunk);
+  memcpy(recorder.buffer, (const char *)src + chunk, n - chunk);
+  recorder.length += n;
+}
+
+static void display_asciicast_ring_read(void *dst, size_t n) {
+  size_t chunk = ASCIICAST_BUFFER_SIZE - recorder.head;
+
+  if (chunk > n) {
+    chunk = n;
+  }
+
+  memcpy(dst, recorder.buffer + recorder.head, chunk);
+  memcpy((char *)dst + chunk, recorder.buffer, n - chunk);
+  recorder.head = (recorder.head + n) % ASCIICAST_BUFFER_SIZE;
+  recorder.length -= n;
+}
+
+static void *display_asciicast_writer_thread(void *arg) {
+  struct AsciicastEvent event;
+  (void)arg;
+
+  for (;;) {
+    pthread_mutex_lock(&recorder.mutex);
+    while (recorder.length == 0 && !recorder.is_stopping) {
+      pthread_cond_wait(&recorder.wakeup, &recorder.mutex);
+    }
+
+    if (recorder.length == 0) {
+      pthread_mutex_unlock(&recorder.mutex);
+      break;
+    }
+
+    display_asciicast_priv_ops->ring_read(&event, sizeof(event));
+    display_asciicast_priv_ops->ring_read(recorder.event_buffer, event.length);
+    pthread_mutex_unlock(&recorder.mutex);
+
+    display_asciicast_priv_ops->write_event(&event, recorder.event_buffer);
+  }
+
+  fflush(recorder.file);
+
+  return NULL;
+}
+
+static void display_asciicast_write_event(struct AsciicastEvent *event,
+                                          const char *buffer) {
+  unsigned long long seconds = event->time_ns / 1000000000ULL;
+  unsigned long micros = (event->time_ns % 1000000000ULL) / 1000;
+
+  if (event->rows == 0 || event->cols == 0) {
+    event->rows = recorder.rows ? recorder.rows : ASCIICAST_DEFAULT_ROWS;
+    event->cols = recorder.cols ? recorder.cols : ASCIICAST_DEFAULT_COLS;
+  }
+
+  if (!recorder.is_header_written) {
+    fprintf(recorder.file,
+            "{\"version\": 2, \"width\": %zu, \"height\": %zu, "
+            "\"timestamp\": %lld}\n",
+            event->cols, event->rows, (long long)time(NULL));
+    recorder.is_header_written = true;
+  } else if (event->rows != recorder.rows || event->cols != recorder.cols) {
+    fprintf(recorder.file, "[%llu.%06lu, \"r\", \"%zux%zu\"]\n", seconds,
+            micros, event->cols, event->rows);
+  }
+
+  recorder.rows = event->rows;
+  recorder.cols = event->cols;
+
+  fprintf(recorder.file, "[%llu.%06lu, \"o\", \"", seconds, micros);
+  display_asciicast_priv_ops->write_escaped(buffer, event->length);
+  fputs("\"]\n", recorder.file);
+}
+
+// Output is JSON string, control characters have to be escaped.
+static void display_asciicast_write_escaped(const char *buffer,
+                                            size_t length) {
+  size_t start = 0;
+  unsigned char c;
+
+  for (size_t i = 0; i < length; i++) {
+    c = (unsigned char)buffer[i];
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    fwrite(buffer + start, 1, i - start, recorder.file);
+    start = i + 1;
+
+    switch (c) {
+    case '"':
+      fputs("\\\"", recorder.file);
+      break;
+    case '\\':
+      fputs("\\\\", recorder.file);
+      break;
+    case '\n':
+      fputs("\\n", recorder.file);
+      break;
+    case '\r':
+      fputs("\\r", recorder.file);
+      break;
+    default:
+      fprintf(recorder.file, "\\u%04x", c);
+    }
+  }
+
+  fwrite(buffer + start, 1, length - start, recorder.file);
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct DisplayAsciicastPrivateOps display_asciicast_priv_ops_ = {
+    .display = display_asciicast_display,
+    .open = display_asciicast_open,
+    .close = display_asciicast_close,
+    .get_path = display_asciicast_get_path,
+    .tap = display_asciicast_tap,
+    .ring_write = display_asciicast_ring_write,
+    .ring_read = display_asciicast_ring_read,
+    .writer_thread = display_asciicast_writer_thread,
+    .write_event = display_asciicast_write_event,
+    .write_escaped = display_asciicast_write_escaped,
+};
+
+struct DisplayAsciicastPrivateOps *get_display_asciicast_priv_ops(void) {
+  return &display_asciicast_priv_ops_;
+}
+
+static struct DisplayAsciicastOps display_asciicast_ops = {
+    .init = display_asciicast_init,
+    .destroy = display_asciicast_destroy,
+    .get_stats = display_asciicast_get_stats,
+};
+
+struct DisplayAsciicastOps *get_display_asciicast_ops(void) {
+  return &display_asciicast_ops;
+}
@@ -0,0 +1,42 @@
+#ifndef DISPLAY_ASCIICAST_H
+#define DISPLAY_ASCIICAST_H
+/*******************************************************************************
+ * @file asciicast.h
+ * @brief Display recording game session into asciicast v2 file.
+ *
+ * Recorder does not render anything on its own, it taps frames composed by
+ * cli display's `frame` renderer, so it is meant to be used together with
+ * it, e.g. `display=cli,asciicast`. Frames are written to the file by
+ * background thread, so recording never slows the game down.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define DISPLAY_ASCIICAST_NAME "asciicast"
+#define DISPLAY_ASCIICAST_PATH_VAR_NAME "asciicast_path"
+#define DISPLAY_ASCIICAST_PATH_DEFAULT "session.cast"
+
+struct DisplayAsciicastStats {
+  size_t frames;
+  size_t dropped_frames;
+};
+
+struct DisplayAsciicastOps {
+  int (*init)(void);
+  void (*destroy)(void);
+  void (*get_stats)(struct DisplayAsciicastStats *stats);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct DisplayAsciicastOps *get_display_asciicast_ops(void);
+
+#endif // DISPLAY_ASCIICAST_H
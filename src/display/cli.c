@@ -5,16 +5,14 @@
  * TO-DO
  *
  ******************************************************************************/
-// TO-DO pass to display matrix 3x3 and some metadata.
-//        matrix is easier to translate to image than list
-//        because you can iterate over rows and columns.
-
 /*******************************************************************************
  *    IMPORTS
  ******************************************************************************/
 // C standard library
 #include <errno.h>
 #include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -24,6 +22,7 @@
 #include <unistd.h>
 
 // App's internal libs
+#include "config/config.h"
 #include "display/cli.h"
 #include "display/display.h"
 #include "game/game.h"
@@ -41,23 +40,129 @@
 #define ANSI_RESET_COLOR "\033[0m"
 #define ANSI_BG_GRAY "\033[48;5;240m"
 #define ANSI_BG_YELLOW "\033[43m"
+#define ANSI_CURSOR_HOME "\033[H"
+#define ANSI_CLEAR_SCREEN "\033[2J"
+#define ANSI_CLEAR_LINE "\033[K"
+
+// Frame is allocated once on init, big enough for common terminal sizes.
+//  It only grows if terminal is so big that frame does not fit anymore.
+#define CLI_FRAME_INITIAL_CAPACITY (64 * 1024)
+
+enum CliRenderer {
+  CLI_RENDERER_PRINTF,
+  CLI_RENDERER_FRAME,
+};
+
+#define CLI_CELLS_MAX (GAME_BOARD_XY_MAX * GAME_BOARD_XY_MAX)
+#define CLI_FRAME_TAPS_MAX 4
+
+struct CliFrame {
+  char *buffer;
+  size_t length;
+  size_t capacity;
+};
+
+enum CliCellStyle {
+  CLI_CELL_STYLE_NONE,
+  CLI_CELL_STYLE_CURSOR,
+  CLI_CELL_STYLE_CURSOR_TAKEN,
+  CLI_CELL_STYLE_INVALID,
+};
+
+struct CliCell {
+  char glyph;
+  enum CliCellStyle style;
+};
+
+// Where board is placed on the terminal, rows and columns are 1-based
+//  as in ANSI cursor positioning. If board does not fit into the terminal
+//  only window of height x width cells is drawn.
+struct CliLayout {
+  unsigned int generation;
+  int rows;
+  int cols;
+  size_t top;
+  size_t left;
+  size_t height;
+  size_t width;
+};
+
+// Board coordinates of the window's top left cell.
+struct CliViewport {
+  size_t y;
+  size_t x;
+};
+
+// What is currently visible on the terminal. Frame renderer compares new
+//  frame against it and sends only cells which changed. Cells are stored
+//  row by row for the visible window only.
+struct CliScreen {
+  bool is_valid;
+  enum GameStates game_state;
+  int user_id;
+  size_t board_xy;
+  struct CliLayout layout;
+  struct CliViewport viewport;
+  struct CliCell cells[CLI_CELLS_MAX];
+};
 
 struct CliDisplay {
   size_t width;
   size_t height;
+  enum CliRenderer renderer;
+  struct CliFrame frame;
+  struct CliScreen screen;
+  struct CliCell cells[CLI_CELLS_MAX];
+  display_cli_frame_tap_t taps[CLI_FRAME_TAPS_MAX];
+  size_t taps_length;
 };
 
 struct DisplayCliPrivateOps {
   display_display_func_t display;
+  display_display_func_t display_frame;
+  int (*open)(void);
   int (*configure_terminal)(void);
   void (*restore_terminal)(void);
-  int (*find_move)(size_t y, size_t x, struct DisplayData *data,
-                   struct UserMove **user_move);
   void (*display_player_info)(struct DisplayData *data);
   void (*display_empty_lines)(struct DisplayData *data);
   void (*display_empty_prefix)(struct DisplayData *data);
+  int (*get_renderer)(enum CliRenderer *renderer);
+  int (*frame_init)(struct CliFrame *frame, size_t capacity);
+  void (*frame_destroy)(struct CliFrame *frame);
+  int (*frame_append)(struct CliFrame *frame, const char *str, size_t n);
+  int (*frame_append_format)(struct CliFrame *frame, const char *fmt, ...);
+  int (*frame_append_repeat)(struct CliFrame *frame, char c, size_t n);
+  int (*frame_flush)(struct CliFrame *frame);
+  bool (*frame_tap)(struct CliFrame *frame, struct CliLayout *layout,
+                    bool is_full);
+  int (*frame_move_cursor)(struct CliFrame *frame, size_t row, size_t col);
+  int (*frame_cell)(struct CliFrame *frame, struct CliCell *cell);
+  int (*frame_player_info)(struct CliFrame *frame, struct DisplayData *data,
+                           struct CliLayout *layout);
+  int (*frame_full)(struct CliFrame *frame, struct DisplayData *data,
+                    struct CliLayout *layout, struct CliCell *cells);
+  int (*frame_diff)(struct CliFrame *frame, struct DisplayData *data,
+                    struct CliLayout *layout, struct CliCell *cells,
+                    struct CliScreen *screen);
+  int (*frame_scroll)(struct CliFrame *frame, struct CliScreen *screen,
+                      struct CliViewport *viewport);
+  int (*frame_scroll_rows)(struct CliFrame *frame, struct CliScreen *screen,
+                           long shift);
+  int (*frame_scroll_columns)(struct CliFrame *frame, struct CliScreen *screen,
+                              long shift);
+  int (*frame_blank_row)(struct CliFrame *frame, struct CliLayout *layout,
+                         size_t row);
+  int (*compose_cells)(struct DisplayData *data, struct CliLayout *layout,
+                       struct CliViewport *viewport, struct CliCell *cells);
+  void (*compute_layout)(struct DisplayData *data, struct CliLayout *layout);
+  void (*follow_cursor)(struct DisplayData *data, struct CliLayout *layout,
+                        struct CliViewport *viewport);
 };
 
+static char module_id[] = "display_cli";
+static struct CliDisplay cli_display;
+static struct ConfigOps *config_ops;
+static struct LoggingUtilsOps *logging_ops;
 static struct SignalUtilsOps *signals_ops;
 static struct TerminalUtilsOps *terminal_ops;
 static struct DisplayCliPrivateOps *display_cli_priv_ops;
@@ -67,6 +172,7 @@ struct DisplayCliPrivateOps *get_display_cli_priv_ops(void);
  *    API
  ******************************************************************************/
 static int display_cli_init(void) {
+  display_display_func_t display_func;
   struct DisplayOps *display_ops;
   int err;
 
@@ -74,21 +180,84 @@ static int display_cli_init(void) {
   display_ops = get_display_ops();
   terminal_ops = get_terminal_ops();
   signals_ops = get_signal_utils_ops();
+  config_ops = get_config_ops();
+  logging_ops = get_logging_utils_ops();
+
+  cli_display.taps_length = 0;
+  // Nothing is known about terminal's content until the first frame.
+  cli_display.screen.is_valid = false;
 
-  err = display_ops->add_display(
-      &(struct DisplayDisplay){.display_name = DISPLAY_CLI_NAME,
-                               .display = display_cli_priv_ops->display});
+  err = display_cli_priv_ops->get_renderer(&cli_display.renderer);
   if (err) {
     return err;
   }
 
-  signals_ops->add_handler(display_cli_priv_ops->restore_terminal);
+  display_func = display_cli_priv_ops->display;
 
-  display_cli_priv_ops->configure_terminal();
+  if (cli_display.renderer == CLI_RENDERER_FRAME) {
+    err = display_cli_priv_ops->frame_init(&cli_display.frame,
+                                           CLI_FRAME_INITIAL_CAPACITY);
+    if (err) {
+      logging_ops->log_err(module_id, "Unable to allocate frame: %s",
+                           strerror(err));
+      return err;
+    }
+
+    // Whole frame goes out with a single write, anything printed to stdout
+    //  in meantime should not be flushed in the middle of the frame.
+    setvbuf(stdout, NULL, _IOFBF, BUFSIZ);
+
+    display_func = display_cli_priv_ops->display_frame;
+  }
+
+  err = display_ops->add_display(&(struct DisplayDisplay){
+      .display_name = DISPLAY_CLI_NAME,
+      .display = display_func,
+      .open = display_cli_priv_ops->open,
+      .close = display_cli_priv_ops->restore_terminal});
+  if (err) {
+    return err;
+  }
+
+  err = signals_ops->add_winch_handler(
+      terminal_ops->invalidate_terminal_dimensions);
+  if (err) {
+    return err;
+  }
 
   return 0;
 };
 
+static void display_cli_destroy(void) {
+  display_cli_priv_ops->frame_destroy(&cli_display.frame);
+}
+
+static int display_cli_add_frame_tap(display_cli_frame_tap_t tap) {
+  if (!tap) {
+    return EINVAL;
+  }
+
+  if (cli_display.taps_length >= CLI_FRAME_TAPS_MAX) {
+    return ENOBUFS;
+  }
+
+  cli_display.taps[cli_display.taps_length++] = tap;
+
+  return 0;
+}
+
+// Terminal is taken over only if cli display is really used.
+static int display_cli_open(void) {
+  int err;
+
+  err = signals_ops->add_handler(display_cli_priv_ops->restore_terminal);
+  if (err) {
+    return err;
+  }
+
+  return display_cli_priv_ops->configure_terminal();
+}
+
 static int display_cli_configure_terminal(void) {
   terminal_ops->disable_echo(STDIN_FILENO);
 
@@ -100,6 +269,30 @@ static void display_cli_restore_terminal(void) {
   terminal_ops->enable_echo(STDIN_FILENO);
 }
 
+static int display_cli_get_renderer(enum CliRenderer *renderer) {
+  char value[CONFIG_VARIABLE_MAX];
+  int err;
+
+  err = config_ops->read_var(DISPLAY_CLI_RENDERER_VAR_NAME,
+                             DISPLAY_CLI_RENDERER_FRAME, value, sizeof(value));
+  if (err) {
+    return err;
+  }
+
+  if (strcmp(value, DISPLAY_CLI_RENDERER_FRAME) == 0) {
+    *renderer = CLI_RENDERER_FRAME;
+  } else if (strcmp(value, DISPLAY_CLI_RENDERER_PRINTF) == 0) {
+    *renderer = CLI_RENDERER_PRINTF;
+  } else {
+    logging_ops->log_err(module_id, "Unknown cli renderer: %s", value);
+    return EINVAL;
+  }
+
+  logging_ops->log_info(module_id, "Cli renderer: %s", value);
+
+  return 0;
+}
+
 static char *get_user_char(int user_id) {
   switch (user_id) {
   case 0:
@@ -127,51 +320,35 @@ static char *get_user_char(int user_id) {
   }
 }
 
-static char *display_get_move_string(struct UserMove *move) {
-  // Print the move details
-  /* printf("Move: Type=%d, User=%d, Coordinates=[%d, %d]\n", move->type, */
-  /*        move->user_id, move->coordinates.x, move->coordinates.y); */
+static char *display_cli_get_cell_string(const struct GameBoardCell *cell,
+                                         size_t n, char buffer[n]) {
+  const char *user_char = " ";
+  char *color = "";
 
-  switch (move->type) {
-  case USER_MOVE_TYPE_SELECT_INVALID:
-    return ANSI_BG_RED " " ANSI_RESET_COLOR;
-  case USER_MOVE_TYPE_HIGHLIGHT:
-    return ANSI_BG_GRAY " " ANSI_RESET_COLOR;
-  case USER_MOVE_TYPE_SELECT_VALID:
-    return get_user_char(move->user_id);
-  case USER_MOVE_TYPE_QUIT:
-    return "";
+  if (cell->flags & GAME_BOARD_CELL_TAKEN) {
+    user_char = get_user_char(cell->owner);
   }
 
-  return NULL;
-}
+  if (cell->flags & GAME_BOARD_CELL_INVALID) {
+    color = ANSI_BG_RED;
+  } else if (cell->flags & GAME_BOARD_CELL_HIGHLIGHT) {
+    color = (cell->flags & GAME_BOARD_CELL_TAKEN) ? ANSI_BG_YELLOW
+                                                  : ANSI_BG_GRAY;
+  }
 
-static char *
-display_cli_get_move_string_with_invalid_move(struct DisplayData *data,
-                                              struct UserMove *user_move,
-                                              size_t n, char buffer[n]) {
-  const struct UserMove *current_move = &data->moves[data->moves_length - 1];
-  char *str_to_disp = display_get_move_string(user_move);
-  char *color = "";
-  if (current_move->coordinates.y == user_move->coordinates.y &&
-      current_move->coordinates.x == user_move->coordinates.x) {
-    if (current_move->type == USER_MOVE_TYPE_SELECT_INVALID)
-      color = ANSI_BG_RED;
-    else if (current_move->type == USER_MOVE_TYPE_HIGHLIGHT)
-      color = ANSI_BG_YELLOW;
+  if (!*color) {
+    return (char *)user_char;
   }
 
-  snprintf(buffer, n - 1, "%s%s%s", color, str_to_disp, ANSI_RESET_COLOR);
+  snprintf(buffer, n, "%s%s%s", color, user_char, ANSI_RESET_COLOR);
 
   return buffer;
 }
 
 static int display_cli_display(struct DisplayData *data) {
-  struct UserMove *tmp_user_move;
   char *str_to_display;
   const size_t buffer_size = 255;
   char buffer[buffer_size];
-  int err;
 
   if (data->game_state == GameStateQuitting) {
     printf("User %i quitting. To quit press q.\n", data->user_id + 1);
@@ -185,15 +362,8 @@ static int display_cli_display(struct DisplayData *data) {
   for (size_t index_y = 0; index_y < data->board_xy; index_y++) {
     display_cli_priv_ops->display_empty_prefix(data);
     for (size_t index_x = 0; index_x < data->board_xy; index_x++) {
-      str_to_display = " ";
-      err = display_cli_priv_ops->find_move(index_y, index_x, data,
-                                            &tmp_user_move);
-      if (err != ENOENT) {
-        str_to_display = display_cli_get_move_string_with_invalid_move(
-            data, tmp_user_move, buffer_size, buffer);
-        if (!str_to_display)
-          return ENODATA;
-      }
+      str_to_display = display_cli_get_cell_string(
+          &data->cells[index_y][index_x], buffer_size, buffer);
 
       if (index_x != data->board_xy - 1) {
         printf("%s|", str_to_display);
@@ -212,22 +382,510 @@ static int display_cli_display(struct DisplayData *data) {
   return 0;
 };
 
-static int display_cli_get_move_matching_y_x(size_t y, size_t x,
-                                             struct DisplayData *data,
-                                             struct UserMove **user_move) {
-  const struct UserMove *tmp_user_move;
-  for (size_t i = 0; i < data->moves_length; i++) {
-    tmp_user_move = &data->moves[i];
-
-    if (tmp_user_move->coordinates.y == y &&
-        tmp_user_move->coordinates.x == x) {
-      *user_move = (struct UserMove *)tmp_user_move;
-      return 0;
+static int display_cli_display_frame(struct DisplayData *data) {
+  struct CliScreen *screen = &cli_display.screen;
+  struct CliFrame *frame = &cli_display.frame;
+  struct CliCell *cells = cli_display.cells;
+  struct CliViewport viewport = {0};
+  struct CliLayout layout;
+  bool is_resync_requested;
+  bool is_full_redraw;
+  int err;
+
+  if (data->board_xy * data->board_xy > CLI_CELLS_MAX) {
+    return EINVAL;
+  }
+
+  frame->length = 0;
+
+  display_cli_priv_ops->compute_layout(data, &layout);
+
+  // Anything what changes the screen's structure requires drawing it again
+  //  from scratch, otherwise only differences are sent to the terminal.
+  //  Terminal may reflow its content on resize even if it ends up with the
+  //  same geometry, so every resize forces full redraw.
+  is_full_redraw = !screen->is_valid ||
+                   screen->layout.generation != layout.generation ||
+                   screen->game_state != data->game_state ||
+                   screen->board_xy != data->board_xy ||
+                   screen->layout.rows != layout.rows ||
+                   screen->layout.cols != layout.cols;
+
+  if (screen->is_valid && screen->board_xy == data->board_xy) {
+    viewport = screen->viewport;
+  }
+
+  display_cli_priv_ops->follow_cursor(data, &layout, &viewport);
+
+  err = display_cli_priv_ops->compose_cells(data, &layout, &viewport, cells);
+  if (err) {
+    return err;
+  }
+
+  if (!is_full_redraw) {
+    // Scrolling moves what is already on the terminal, only cells exposed
+    //  by the scroll are left for diff to draw.
+    err = display_cli_priv_ops->frame_scroll(frame, screen, &viewport);
+    if (err == ERANGE) {
+      frame->length = 0;
+      is_full_redraw = true;
+    } else if (err) {
+      return err;
     }
   }
 
-  return ENOENT;
-};
+  if (is_full_redraw) {
+    err = display_cli_priv_ops->frame_full(frame, data, &layout, cells);
+  } else {
+    err = display_cli_priv_ops->frame_diff(frame, data, &layout, cells, screen);
+  }
+  if (err) {
+    return err;
+  }
+
+  is_resync_requested =
+      display_cli_priv_ops->frame_tap(frame, &layout, is_full_redraw);
+
+  err = display_cli_priv_ops->frame_flush(frame);
+  if (err) {
+    screen->is_valid = false;
+    return err;
+  }
+
+  screen->is_valid = !is_resync_requested;
+  screen->game_state = data->game_state;
+  screen->user_id = data->user_id;
+  screen->board_xy = data->board_xy;
+  screen->layout = layout;
+  screen->viewport = viewport;
+  memcpy(screen->cells, cells,
+         sizeof(struct CliCell) * layout.height * layout.width);
+
+  return 0;
+}
+
+static int display_cli_frame_full(struct CliFrame *frame,
+                                  struct DisplayData *data,
+                                  struct CliLayout *layout,
+                                  struct CliCell *cells) {
+  size_t index_y, index_x;
+  int err;
+
+  err = display_cli_priv_ops->frame_append(frame, ANSI_CURSOR_HOME
+                                           ANSI_CLEAR_SCREEN,
+                                           strlen(ANSI_CURSOR_HOME
+                                                  ANSI_CLEAR_SCREEN));
+  if (err) {
+    return err;
+  }
+
+  if (data->game_state == GameStateQuitting) {
+    return display_cli_priv_ops->frame_append_format(
+        frame, "User %i quitting. To quit press q.\n", data->user_id + 1);
+  }
+
+  err = display_cli_priv_ops->frame_player_info(frame, data, layout);
+  if (err) {
+    return err;
+  }
+
+  for (index_y = 0; index_y < layout->height; index_y++) {
+    err = display_cli_priv_ops->frame_move_cursor(
+        frame, layout->top + index_y, layout->left);
+    if (err) {
+      return err;
+    }
+
+    for (index_x = 0; index_x < layout->width; index_x++) {
+      err = display_cli_priv_ops->frame_cell(
+          frame, &cells[index_y * layout->width + index_x]);
+      if (err) {
+        return err;
+      }
+
+      if (index_x != layout->width - 1) {
+        err = display_cli_priv_ops->frame_append(frame, "|", 1);
+        if (err) {
+          return err;
+        }
+      }
+    }
+  }
+
+  err = display_cli_priv_ops->frame_move_cursor(
+      frame, layout->top + layout->height + 1, 1);
+  if (err) {
+    return err;
+  }
+
+  if (data->game_state == GameStateWinning) {
+    err = display_cli_priv_ops->frame_append_format(
+        frame, "User %i won. To quit press q.", data->user_id + 1);
+    if (err) {
+      return err;
+    }
+  }
+
+  return 0;
+}
+
+static int display_cli_frame_diff(struct CliFrame *frame,
+                                  struct DisplayData *data,
+                                  struct CliLayout *layout,
+                                  struct CliCell *cells,
+                                  struct CliScreen *screen) {
+  size_t index_y, index_x, i;
+  bool is_changed = false;
+  int err;
+
+  if (data->game_state == GameStateQuitting) {
+    return 0;
+  }
+
+  if (screen->user_id != data->user_id) {
+    err = display_cli_priv_ops->frame_player_info(frame, data, layout);
+    if (err) {
+      return err;
+    }
+    is_changed = true;
+  }
+
+  for (index_y = 0; index_y < layout->height; index_y++) {
+    for (index_x = 0; index_x < layout->width; index_x++) {
+      i = index_y * layout->width + index_x;
+
+      if (cells[i].glyph == screen->cells[i].glyph &&
+          cells[i].style == screen->cells[i].style) {
+        continue;
+      }
+
+      // Every cell takes two columns, one for itself and one for separator.
+      err = display_cli_priv_ops->frame_move_cursor(
+          frame, layout->top + index_y, layout->left + index_x * 2);
+      if (err) {
+        return err;
+      }
+
+      err = display_cli_priv_ops->frame_cell(frame, &cells[i]);
+      if (err) {
+        return err;
+      }
+      is_changed = true;
+    }
+  }
+
+  // Keep terminal's cursor parked below the board, as after full redraw.
+  if (is_changed || frame->length > 0) {
+    return display_cli_priv_ops->frame_move_cursor(
+        frame, layout->top + layout->height + 1, 1);
+  }
+
+  return 0;
+}
+
+// Returns ERANGE if window moved so far that nothing on the screen can be
+//  reused.
+static int display_cli_frame_scroll(struct CliFrame *frame,
+                                    struct CliScreen *screen,
+                                    struct CliViewport *viewport) {
+  long shift_y = (long)viewport->y - (long)screen->viewport.y;
+  long shift_x = (long)viewport->x - (long)screen->viewport.x;
+  int err;
+
+  if (labs(shift_y) >= (long)screen->layout.height ||
+      labs(shift_x) >= (long)screen->layout.width) {
+    return ERANGE;
+  }
+
+  if (shift_y) {
+    err = display_cli_priv_ops->frame_scroll_rows(frame, screen, shift_y);
+    if (err) {
+      return err;
+    }
+  }
+
+  if (shift_x) {
+    err = display_cli_priv_ops->frame_scroll_columns(frame, screen, shift_x);
+    if (err) {
+      return err;
+    }
+  }
+
+  return 0;
+}
+
+// Moves window's rows using terminal's scroll region, so only exposed rows
+//  have to be sent. Screen's cells are shifted the same way.
+static int display_cli_frame_scroll_rows(struct CliFrame *frame,
+                                         struct CliScreen *screen,
+                                         long shift) {
+  struct CliLayout *layout = &screen->layout;
+  size_t amount = (size_t)labs(shift);
+  size_t row_size = sizeof(struct CliCell) * layout->width;
+  size_t kept = layout->height - amount;
+  size_t exposed;
+  int err;
+
+  err = display_cli_priv_ops->frame_append_format(
+      frame, "\033[%zu;%zur\033[%zu%c\033[r", layout->top,
+      layout->top + layout->height - 1, amount, shift > 0 ? 'S' : 'T');
+  if (err) {
+    return err;
+  }
+
+  if (shift > 0) {
+    memmove(screen->cells, screen->cells + amount * layout->width,
+            row_size * kept);
+    exposed = kept;
+  } else {
+    memmove(screen->cells + amount * layout->width, screen->cells,
+            row_size * kept);
+    exposed = 0;
+  }
+
+  for (size_t i = exposed; i < exposed + amount; i++) {
+    err = display_cli_priv_ops->frame_blank_row(frame, layout, i);
+    if (err) {
+      return err;
+    }
+
+    for (size_t j = 0; j < layout->width; j++) {
+      screen->cells[i * layout->width + j] =
+          (struct CliCell){.glyph = ' ', .style = CLI_CELL_STYLE_NONE};
+    }
+  }
+
+  return 0;
+}
+
+// Moves window's columns by deleting or inserting characters at the
+//  window's left edge, then draws separators for exposed columns.
+static int display_cli_frame_scroll_columns(struct CliFrame *frame,
+                                            struct CliScreen *screen,
+                                            long shift) {
+  struct CliLayout *layout = &screen->layout;
+  size_t amount = (size_t)labs(shift);
+  size_t kept = layout->width - amount;
+  struct CliCell *row;
+  size_t exposed;
+  int err;
+
+  for (size_t i = 0; i < layout->height; i++) {
+    row = &screen->cells[i * layout->width];
+
+    err = display_cli_priv_ops->frame_move_cursor(frame, layout->top + i,
+                                                  layout->left);
+    if (err) {
+      return err;
+    }
+
+    if (shift > 0) {
+      // Delete leading cells, the separator before first exposed cell is
+      //  the only one which is missing.
+      err = display_cli_priv_ops->frame_append_format(
+          frame, "\033[%zuP", amount * 2);
+      if (err) {
+        return err;
+      }
+
+      err = display_cli_priv_ops->frame_move_cursor(
+          frame, layout->top + i, layout->left + kept * 2 - 1);
+      if (err) {
+        return err;
+      }
+
+      err = display_cli_priv_ops->frame_append(frame, "|", 1);
+      for (size_t j = 0; !err && j < amount; j++) {
+        err = display_cli_priv_ops->frame_append(
+            frame, j == amount - 1 ? " " : " |", j == amount - 1 ? 1 : 2);
+      }
+      if (err) {
+        return err;
+      }
+
+      memmove(row, row + amount, sizeof(struct CliCell) * kept);
+      exposed = kept;
+    } else {
+      // Insert blank cells with their separators, cells pushed out of the
+      //  window are erased.
+      err = display_cli_priv_ops->frame_append_format(
+          frame, "\033[%zu@", amount * 2);
+      for (size_t j = 0; !err && j < amount; j++) {
+        err = display_cli_priv_ops->frame_append(frame, " |", 2);
+      }
+      if (err) {
+        return err;
+      }
+
+      err = display_cli_priv_ops->frame_move_cursor(
+          frame, layout->top + i, layout->left + layout->width * 2 - 1);
+      if (err) {
+        return err;
+      }
+
+      err = display_cli_priv_ops->frame_append(frame, ANSI_CLEAR_LINE,
+                                               strlen(ANSI_CLEAR_LINE));
+      if (err) {
+        return err;
+      }
+
+      memmove(row + amount, row, sizeof(struct CliCell) * kept);
+      exposed = 0;
+    }
+
+    for (size_t j = exposed; j < exposed + amount; j++) {
+      row[j] = (struct CliCell){.glyph = ' ', .style = CLI_CELL_STYLE_NONE};
+    }
+  }
+
+  return 0;
+}
+
+static int display_cli_frame_blank_row(struct CliFrame *frame,
+                                       struct CliLayout *layout, size_t row) {
+  int err;
+
+  err = display_cli_priv_ops->frame_move_cursor(frame, layout->top + row,
+                                                layout->left);
+  if (err) {
+    return err;
+  }
+
+  for (size_t i = 0; i < layout->width - 1; i++) {
+    err = display_cli_priv_ops->frame_append(frame, " |", 2);
+    if (err) {
+      return err;
+    }
+  }
+
+  return display_cli_priv_ops->frame_append(frame, " ", 1);
+}
+
+static int display_cli_compose_cells(struct DisplayData *data,
+                                     struct CliLayout *layout,
+                                     struct CliViewport *viewport,
+                                     struct CliCell *cells) {
+  const struct GameBoardCell *board_cell;
+  struct CliCell *cell = cells;
+
+  for (size_t index_y = 0; index_y < layout->height; index_y++) {
+    board_cell = &data->cells[viewport->y + index_y][viewport->x];
+
+    for (size_t index_x = 0; index_x < layout->width;
+         index_x++, cell++, board_cell++) {
+      cell->glyph = ' ';
+      cell->style = CLI_CELL_STYLE_NONE;
+
+      if (board_cell->flags & GAME_BOARD_CELL_TAKEN) {
+        cell->glyph = get_user_char(board_cell->owner)[0];
+      }
+
+      if (board_cell->flags & GAME_BOARD_CELL_INVALID) {
+        cell->style = CLI_CELL_STYLE_INVALID;
+      } else if (board_cell->flags & GAME_BOARD_CELL_HIGHLIGHT) {
+        cell->style = (board_cell->flags & GAME_BOARD_CELL_TAKEN)
+                          ? CLI_CELL_STYLE_CURSOR_TAKEN
+                          : CLI_CELL_STYLE_CURSOR;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static void display_cli_compute_layout(struct DisplayData *data,
+                                       struct CliLayout *layout) {
+  // Board rows are preceded by player info line and one empty line,
+  //  followed by one empty line and line for the win message.
+  const long header_height = 2;
+  const long footer_height = 2;
+  long max_width, max_height, top, left;
+  int err;
+
+  layout->generation = terminal_ops->get_terminal_generation();
+  layout->rows = 0;
+  layout->cols = 0;
+  layout->top = 1 + header_height;
+  layout->left = 1;
+  layout->height = data->board_xy;
+  layout->width = data->board_xy;
+
+  err = terminal_ops->get_cached_terminal_dimensions(
+      STDIN_FILENO, &layout->rows, &layout->cols);
+  if (err) {
+    layout->rows = 0;
+    layout->cols = 0;
+    return;
+  }
+
+  // Every cell takes two columns except the last one, which has no
+  //  separator.
+  max_height = layout->rows - header_height - footer_height;
+  max_width = (layout->cols + 1) / 2;
+
+  if (max_height < (long)layout->height) {
+    layout->height = max_height > 1 ? (size_t)max_height : 1;
+  }
+
+  if (max_width < (long)layout->width) {
+    layout->width = max_width > 1 ? (size_t)max_width : 1;
+  }
+
+  top = 1 + header_height;
+  if ((long)layout->rows + 1 > (long)layout->height) {
+    top += (layout->rows - (long)layout->height + 1) / 2;
+  }
+  if (top + (long)layout->height - 1 + footer_height > layout->rows) {
+    top = layout->rows - footer_height - (long)layout->height + 1;
+  }
+  layout->top = top > 1 + header_height ? (size_t)top : 1 + header_height;
+
+  left = 1;
+  if ((long)layout->cols + 2 > (long)layout->width) {
+    left += (layout->cols - (long)layout->width + 2) / 2;
+  }
+  if (left + (long)layout->width * 2 - 2 > layout->cols) {
+    left = layout->cols - (long)layout->width * 2 + 2;
+  }
+  layout->left = left > 1 ? (size_t)left : 1;
+}
+
+// Moves window as little as possible to keep user's cursor visible.
+static void display_cli_follow_cursor(struct DisplayData *data,
+                                      struct CliLayout *layout,
+                                      struct CliViewport *viewport) {
+  size_t max_y = data->board_xy - layout->height;
+  size_t max_x = data->board_xy - layout->width;
+  size_t y = 0, x = 0;
+
+  if (data->cursor.y > 0) {
+    y = (size_t)data->cursor.y < data->board_xy ? (size_t)data->cursor.y
+                                                 : data->board_xy - 1;
+  }
+  if (data->cursor.x > 0) {
+    x = (size_t)data->cursor.x < data->board_xy ? (size_t)data->cursor.x
+                                                 : data->board_xy - 1;
+  }
+
+  if (y < viewport->y) {
+    viewport->y = y;
+  } else if (y >= viewport->y + layout->height) {
+    viewport->y = y - layout->height + 1;
+  }
+
+  if (x < viewport->x) {
+    viewport->x = x;
+  } else if (x >= viewport->x + layout->width) {
+    viewport->x = x - layout->width + 1;
+  }
+
+  if (viewport->y > max_y) {
+    viewport->y = max_y;
+  }
+  if (viewport->x > max_x) {
+    viewport->x = max_x;
+  }
+}
 
 static void display_cli_display_player_info(struct DisplayData *data) {
   printf("Current user: %d=%s\n\n", data->user_id + 1,
@@ -238,7 +896,7 @@ static void display_cli_display_empty_lines(struct DisplayData *data) {
   int err;
   int rows, _;
 
-  err = terminal_ops->get_terminal_dimensions(STDIN_FILENO, &rows, &_);
+  err = terminal_ops->get_cached_terminal_dimensions(STDIN_FILENO, &rows, &_);
   if (err) {
     return;
   }
@@ -253,7 +911,7 @@ static void display_cli_display_empty_prefix(struct DisplayData *data) {
   int err;
   int _, cols;
 
-  err = terminal_ops->get_terminal_dimensions(STDIN_FILENO, &_, &cols);
+  err = terminal_ops->get_cached_terminal_dimensions(STDIN_FILENO, &_, &cols);
   if (err) {
     return;
   }
@@ -264,17 +922,234 @@ static void display_cli_display_empty_prefix(struct DisplayData *data) {
   }
 }
 
+static int display_cli_frame_player_info(struct CliFrame *frame,
+                                         struct DisplayData *data,
+                                         struct CliLayout *layout) {
+  int err;
+
+  err = display_cli_priv_ops->frame_move_cursor(frame, layout->top - 2, 1);
+  if (err) {
+    return err;
+  }
+
+  return display_cli_priv_ops->frame_append_format(
+      frame, "Current user: %d=%s" ANSI_CLEAR_LINE, data->user_id + 1,
+      get_user_char(data->user_id));
+}
+
+static int display_cli_frame_cell(struct CliFrame *frame,
+                                  struct CliCell *cell) {
+  const char *style = "";
+
+  switch (cell->style) {
+  case CLI_CELL_STYLE_NONE:
+    return display_cli_priv_ops->frame_append(frame, &cell->glyph, 1);
+  case CLI_CELL_STYLE_CURSOR:
+    style = ANSI_BG_GRAY;
+    break;
+  case CLI_CELL_STYLE_CURSOR_TAKEN:
+    style = ANSI_BG_YELLOW;
+    break;
+  case CLI_CELL_STYLE_INVALID:
+    style = ANSI_BG_RED;
+    break;
+  }
+
+  return display_cli_priv_ops->frame_append_format(
+      frame, "%s%c" ANSI_RESET_COLOR, style, cell->glyph);
+}
+
+static int display_cli_frame_move_cursor(struct CliFrame *frame, size_t row,
+                                         size_t col) {
+  return display_cli_priv_ops->frame_append_format(frame, "\033[%zu;%zuH",
+                                                   row, col);
+}
+
+/*******************************************************************************
+ *    FRAME BUFFER
+ ******************************************************************************/
+static int display_cli_frame_init(struct CliFrame *frame, size_t capacity) {
+  if (!frame || !capacity) {
+    return EINVAL;
+  }
+
+  frame->buffer = malloc(capacity);
+  if (!frame->buffer) {
+    return ENOMEM;
+  }
+
+  frame->capacity = capacity;
+  frame->length = 0;
+
+  return 0;
+}
+
+static void display_cli_frame_destroy(struct CliFrame *frame) {
+  if (!frame) {
+    return;
+  }
+
+  free(frame->buffer);
+  frame->buffer = NULL;
+  frame->capacity = 0;
+  frame->length = 0;
+}
+
+static int display_cli_frame_reserve(struct CliFrame *frame, size_t n) {
+  size_t new_capacity;
+  char *new_buffer;
+
+  if (frame->length + n <= frame->capacity) {
+    return 0;
+  }
+
+  new_capacity = frame->capacity ? frame->capacity : CLI_FRAME_INITIAL_CAPACITY;
+  while (new_capacity < frame->length + n) {
+    new_capacity *= 2;
+  }
+
+  new_buffer = realloc(frame->buffer, new_capacity);
+  if (!new_buffer) {
+    return ENOMEM;
+  }
+
+  frame->buffer = new_buffer;
+  frame->capacity = new_capacity;
+
+  return 0;
+}
+
+static int display_cli_frame_append(struct CliFrame *frame, const char *str,
+                                    size_t n) {
+  int err;
+
+  err = display_cli_frame_reserve(frame, n);
+  if (err) {
+    return err;
+  }
+
+  memcpy(frame->buffer + frame->length, str, n);
+  frame->length += n;
+
+  return 0;
+}
+
+static int display_cli_frame_append_repeat(struct CliFrame *frame, char c,
+                                           size_t n) {
+  int err;
+
+  err = display_cli_frame_reserve(frame, n);
+  if (err) {
+    return err;
+  }
+
+  memset(frame->buffer + frame->length, c, n);
+  frame->length += n;
+
+  return 0;
+}
+
+static int display_cli_frame_append_format(struct CliFrame *frame,
+                                           const char *fmt, ...) {
+  va_list args;
+  int length;
+  int err;
+
+  va_start(args, fmt);
+  length = vsnprintf(NULL, 0, fmt, args);
+  va_end(args);
+  if (length < 0) {
+    return EINVAL;
+  }
+
+  // vsnprintf always writes null terminator, it is not part of the frame.
+  err = display_cli_frame_reserve(frame, length + 1);
+  if (err) {
+    return err;
+  }
+
+  va_start(args, fmt);
+  vsnprintf(frame->buffer + frame->length, length + 1, fmt, args);
+  va_end(args);
+
+  frame->length += length;
+
+  return 0;
+}
+
+static int display_cli_frame_flush(struct CliFrame *frame) {
+  size_t written = 0;
+  ssize_t result;
+
+  // Anything which was buffered in stdout needs to land before the frame.
+  fflush(stdout);
+
+  while (written < frame->length) {
+    result = write(STDOUT_FILENO, frame->buffer + written,
+                   frame->length - written);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno;
+    }
+
+    written += result;
+  }
+
+  frame->length = 0;
+
+  return 0;
+}
+
+// Taps see exactly the bytes which go to the terminal, so recorders do not
+//  need to render anything on their own.
+static bool display_cli_frame_tap(struct CliFrame *frame,
+                                  struct CliLayout *layout, bool is_full) {
+  bool is_resync_requested = false;
+
+  for (size_t i = 0; i < cli_display.taps_length; i++) {
+    if (cli_display.taps[i](frame->buffer, frame->length, layout->rows,
+                            layout->cols, is_full) == DISPLAY_CLI_TAP_RESYNC) {
+      is_resync_requested = true;
+    }
+  }
+
+  return is_resync_requested;
+}
+
 /*******************************************************************************
  *    MODULARIZATION BOILERCODE
  ******************************************************************************/
 struct DisplayCliPrivateOps priv_ops = {
     .display = display_cli_display,
+    .open = display_cli_open,
     .configure_terminal = display_cli_configure_terminal,
     .restore_terminal = display_cli_restore_terminal,
-    .find_move = display_cli_get_move_matching_y_x,
     .display_player_info = display_cli_display_player_info,
     .display_empty_lines = display_cli_display_empty_lines,
     .display_empty_prefix = display_cli_display_empty_prefix,
+    .display_frame = display_cli_display_frame,
+    .get_renderer = display_cli_get_renderer,
+    .frame_init = display_cli_frame_init,
+    .frame_destroy = display_cli_frame_destroy,
+    .frame_append = display_cli_frame_append,
+    .frame_append_format = display_cli_frame_append_format,
+    .frame_append_repeat = display_cli_frame_append_repeat,
+    .frame_flush = display_cli_frame_flush,
+    .frame_tap = display_cli_frame_tap,
+    .frame_move_cursor = display_cli_frame_move_cursor,
+    .frame_cell = display_cli_frame_cell,
+    .frame_player_info = display_cli_frame_player_info,
+    .frame_full = display_cli_frame_full,
+    .frame_diff = display_cli_frame_diff,
+    .frame_scroll = display_cli_frame_scroll,
+    .frame_scroll_rows = display_cli_frame_scroll_rows,
+    .frame_scroll_columns = display_cli_frame_scroll_columns,
+    .frame_blank_row = display_cli_frame_blank_row,
+    .compose_cells = display_cli_compose_cells,
+    .compute_layout = display_cli_compute_layout,
+    .follow_cursor = display_cli_follow_cursor,
 };
 
 struct DisplayCliPrivateOps *get_display_cli_priv_ops(void) {
@@ -283,6 +1158,8 @@ struct DisplayCliPrivateOps *get_display_cli_priv_ops(void) {
 
 static struct DisplayCliOps cli_display_ops = {
     .init = display_cli_init,
+    .destroy = display_cli_destroy,
+    .add_frame_tap = display_cli_add_frame_tap,
 };
 
 struct DisplayCliOps *get_display_cli_ops(void) {
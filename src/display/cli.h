@@ -1,10 +1,36 @@
 #ifndef DISPLAY_CLI_H
 #define DISPLAY_CLI_H
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+
 /*******************************************************************************
  *    PUBLIC API
  ******************************************************************************/
+// Renderer used by cli display is chosen with `cli_renderer` config variable.
+//  `frame` composes whole frame in memory and writes it at once, `printf`
+//  prints every cell separately.
+#define DISPLAY_CLI_RENDERER_VAR_NAME "cli_renderer"
+#define DISPLAY_CLI_RENDERER_FRAME "frame"
+#define DISPLAY_CLI_RENDERER_PRINTF "printf"
+
+// Frame tap receives every frame composed by `frame` renderer right before
+//  it is written to the terminal, together with terminal dimensions and
+//  information whether the frame redraws whole screen. Tap is called from
+//  display's render thread and must not block. Returning
+//  DISPLAY_CLI_TAP_RESYNC makes next frame a full redraw.
+#define DISPLAY_CLI_TAP_RESYNC 1
+
+typedef int (*display_cli_frame_tap_t)(const char *buffer, size_t length,
+                                       size_t rows, size_t cols,
+                                       bool is_full);
+
 struct DisplayCliOps {
   int (*init)(void);
+  void (*destroy)(void);
+  int (*add_frame_tap)(display_cli_frame_tap_t tap);
 };
 
 /*******************************************************************************
@@ -12,6 +12,12 @@
 // C standard library
 #include <asm-generic/errno-base.h>
 #include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
@@ -23,27 +29,100 @@
 #include "display/display.h"
 #include "init/init.h"
 #include "utils/logging_utils.h"
+#include "utils/signals_utils.h"
 #include "utils/std_lib_utils.h"
 
 /*******************************************************************************
  *    PRIVATE DECLARATIONS & DEFINITIONS
  ******************************************************************************/
 #define MAX_DISPLAY_REGISTRATIONS 10
+#define MAX_ACTIVE_DISPLAYS 4
+#define DISPLAY_QUEUE_MAX 64
+
+_Static_assert(ATOMIC_INT_LOCK_FREE == 2,
+               "Resize handler needs lock-free atomics");
 
 typedef struct DisplaySubsystem DisplaySubsystem;
 
 struct DisplaySubsystem {
   SARRS_FIELD(displays, struct DisplayDisplay, MAX_DISPLAY_REGISTRATIONS);
+  SARRS_FIELD(active_displays, int, MAX_ACTIVE_DISPLAYS);
+  bool is_opened[MAX_DISPLAY_REGISTRATIONS];
 };
 
 SARRS_DECL(DisplaySubsystem, displays, struct DisplayDisplay,
            MAX_DISPLAY_REGISTRATIONS);
+SARRS_DECL(DisplaySubsystem, active_displays, int, MAX_ACTIVE_DISPLAYS);
+
+// Snapshot owns copy of the board, so game state machine can go on with
+//  next step while displays are still drawing. One snapshot is shared
+//  read-only by all active displays and freed by the last one releasing it.
+struct DisplaySnapshot {
+  atomic_size_t refs;
+  struct DisplayData data;
+  struct GameBoardCell cells[GAME_BOARD_XY_MAX][GAME_BOARD_XY_MAX];
+};
+
+// Every active display consumes snapshots on its own thread from its own
+//  bounded queue, so slow display does not hold back the others. When
+//  queue is full the oldest snapshot is dropped, so display with queue of
+//  one always draws only the newest frame. Thread is woken up by semaphore
+//  because it is the only primitive which can be used from SIGWINCH
+//  handler.
+struct DisplaySink {
+  int display_id;
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  sem_t wakeup;
+  bool is_stopping;
+  volatile sig_atomic_t is_redraw_requested;
+  size_t dropped_frames;
+  size_t queue_capacity;
+  size_t queue_head;
+  size_t queue_length;
+  struct DisplaySnapshot *queue[DISPLAY_QUEUE_MAX];
+  // Last rendered snapshot, kept for redraws.
+  struct DisplaySnapshot *current;
+};
+
+// Resize handler may run on any thread, in the middle of start or stop. It
+//  touches sinks only while marked as in flight and only if renderer runs,
+//  stop clears running first and then waits for handlers in flight, so
+//  sinks are never destroyed under the handler. Lock-free atomics are the
+//  only shared state which is safe to use from the handler.
+struct DisplayRenderer {
+  atomic_int is_running;
+  atomic_int redraws_in_flight;
+  size_t sinks_length;
+  struct DisplaySink sinks[MAX_ACTIVE_DISPLAYS];
+};
+
+struct DisplayPrivateOps {
+  struct DisplaySubsystem *(*get_subsystem)(void);
+  int (*validate_data)(struct DisplayData *data);
+  int (*render)(int display_id, struct DisplayData *data);
+  int (*render_sync)(struct DisplayData *data);
+  int (*open_display)(int display_id);
+  struct DisplaySnapshot *(*create_snapshot)(struct DisplayData *data,
+                                             size_t refs);
+  void (*release_snapshot)(struct DisplaySnapshot *snapshot);
+  int (*start_sink)(struct DisplaySink *sink, int display_id);
+  void (*stop_sink)(struct DisplaySink *sink);
+  void (*push_snapshot)(struct DisplaySink *sink,
+                        struct DisplaySnapshot *snapshot);
+  void *(*sink_thread)(void *arg);
+  void (*request_redraw)(void);
+};
 
 static char module_id[] = "display_subsystem";
 static struct DisplaySubsystem display_subsystem;
+static struct DisplayRenderer display_renderer;
 static struct LoggingUtilsOps *logging_ops;
 static struct ConfigOps *config_ops;
 static struct StdLibUtilsOps *std_lib_ops;
+static struct SignalUtilsOps *signals_ops;
+static struct DisplayPrivateOps *display_priv_ops;
+struct DisplayPrivateOps *get_display_priv_ops(void);
 
 /*******************************************************************************
  *    API
@@ -52,40 +131,136 @@ static int display_init(void) {
   logging_ops = get_logging_utils_ops();
   config_ops = get_config_ops();
   std_lib_ops = get_std_lib_utils_ops();
+  signals_ops = get_signal_utils_ops();
+  display_priv_ops = get_display_priv_ops();
+
+  DisplaySubsystem_displays_init(&display_subsystem);
+  DisplaySubsystem_active_displays_init(&display_subsystem);
+  memset(display_subsystem.is_opened, 0, sizeof(display_subsystem.is_opened));
+
   return 0;
 };
 
 static int display_display(struct DisplayData *data) {
-  struct DisplayDisplay *display;
+  struct DisplayRenderer *renderer = &display_renderer;
+  struct DisplaySnapshot *snapshot;
   int err;
 
-  if (!data || data->user_id < 0 || !data->moves) {
-    return EINVAL;
-  }
-
-  err = DisplaySubsystem_displays_get(&display_subsystem, data->display_id,
-                                      &display);
+  err = display_priv_ops->validate_data(data);
   if (err) {
-    logging_ops->log_err(module_id,
-                         "Failed to get display for display_id %d: %s",
-                         data->display_id, strerror(err));
     return err;
   }
 
-  err = display->display(data);
-  if (err) {
-    logging_ops->log_err(module_id, "Display rendering failed for %s: %s",
-                         display->display_name, strerror(err));
-    return err;
+  // Without render threads frame is rendered right away.
+  if (!renderer->is_running) {
+    return display_priv_ops->render_sync(data);
   }
 
-  logging_ops->log_info(module_id,
-                        "Display rendering completed successfully for %s",
-                        display->display_name);
+  // Board is copied once, no matter how many displays are active.
+  snapshot = display_priv_ops->create_snapshot(data, renderer->sinks_length);
+  if (!snapshot) {
+    return ENOMEM;
+  }
+
+  for (size_t i = 0; i < renderer->sinks_length; i++) {
+    display_priv_ops->push_snapshot(&renderer->sinks[i], snapshot);
+  }
 
   return 0;
 }
 
+static int display_start(void) {
+  struct DisplayRenderer *renderer = &display_renderer;
+  int *display_id;
+  size_t i;
+  int err;
+
+  if (renderer->is_running) {
+    return 0;
+  }
+
+  renderer->sinks_length = 0;
+
+  for (i = 0;
+       i < DisplaySubsystem_active_displays_length(&display_subsystem); i++) {
+    DisplaySubsystem_active_displays_get(&display_subsystem, i, &display_id);
+
+    err = display_priv_ops->start_sink(&renderer->sinks[i], *display_id);
+    if (err) {
+      goto error;
+    }
+
+    renderer->sinks_length++;
+  }
+
+  if (renderer->sinks_length == 0) {
+    return 0;
+  }
+
+  renderer->is_running = 1;
+
+  // Display's terminal callbacks are already registered by now, so resize
+  //  is redrawn with already refreshed terminal dimensions. Handler is
+  //  registered only by the first start, later ones find it registered.
+  err = signals_ops->add_winch_handler(display_priv_ops->request_redraw);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to register resize handler: %s",
+                         strerror(err));
+  }
+
+  return 0;
+
+error:
+  for (i = 0; i < renderer->sinks_length; i++) {
+    display_priv_ops->stop_sink(&renderer->sinks[i]);
+  }
+  renderer->sinks_length = 0;
+
+  return err;
+}
+
+static void display_stop(void) {
+  struct DisplayRenderer *renderer = &display_renderer;
+
+  if (!renderer->is_running) {
+    return;
+  }
+
+  renderer->is_running = 0;
+
+  while (atomic_load(&renderer->redraws_in_flight) > 0) {
+    sched_yield();
+  }
+
+  // Frames which are still queued are drawn before threads exit.
+  for (size_t i = 0; i < renderer->sinks_length; i++) {
+    display_priv_ops->stop_sink(&renderer->sinks[i]);
+  }
+
+  renderer->sinks_length = 0;
+}
+
+static void display_destroy(void) {
+  struct DisplayDisplay *display;
+
+  display_stop();
+
+  for (size_t i = 0; i < DisplaySubsystem_displays_length(&display_subsystem);
+       i++) {
+    if (!display_subsystem.is_opened[i]) {
+      continue;
+    }
+
+    DisplaySubsystem_displays_get(&display_subsystem, i, &display);
+
+    if (display->close) {
+      display->close();
+    }
+
+    display_subsystem.is_opened[i] = false;
+  }
+}
+
 static int display_add_display(struct DisplayDisplay *new_display) {
   int err;
 
@@ -128,24 +303,353 @@ static int display_get_display_id(const char *display_name,
   return ENOENT;
 }
 
+static int display_activate_display(int display_id) {
+  struct DisplayDisplay *display;
+  int *active_id;
+  int err;
+
+  err = DisplaySubsystem_displays_get(&display_subsystem, display_id,
+                                      &display);
+  if (err) {
+    return err;
+  }
+
+  for (size_t i = 0;
+       i < DisplaySubsystem_active_displays_length(&display_subsystem); i++) {
+    DisplaySubsystem_active_displays_get(&display_subsystem, i, &active_id);
+    if (*active_id == display_id) {
+      return 0;
+    }
+  }
+
+  err = DisplaySubsystem_active_displays_append(&display_subsystem,
+                                                display_id);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to activate display %s: %s",
+                         display->display_name, strerror(err));
+    return err;
+  }
+
+  return 0;
+}
+
 struct DisplaySubsystem *display_get_subsystem(void) {
   return &display_subsystem;
 };
 
 /*******************************************************************************
- *    MODULARITY BOILERCODE
+ *    PRIVATE API
  ******************************************************************************/
-struct DisplayPrivateOps {
-  struct DisplaySubsystem *(*get_subsystem)(void);
-};
+static int display_validate_data(struct DisplayData *data) {
+  if (!data || data->user_id < 0 || !data->cells ||
+      data->board_xy > GAME_BOARD_XY_MAX) {
+    return EINVAL;
+  }
+
+  return 0;
+}
+
+static int display_render(int display_id, struct DisplayData *data) {
+  struct DisplayDisplay *display;
+  int err;
+
+  err = DisplaySubsystem_displays_get(&display_subsystem, display_id,
+                                      &display);
+  if (err) {
+    logging_ops->log_err(module_id,
+                         "Failed to get display for display_id %d: %s",
+                         display_id, strerror(err));
+    return err;
+  }
+
+  err = display_priv_ops->open_display(display_id);
+  if (err) {
+    return err;
+  }
+
+  err = display->display(data);
+  if (err) {
+    logging_ops->log_err(module_id, "Display rendering failed for %s: %s",
+                         display->display_name, strerror(err));
+    return err;
+  }
+
+  logging_ops->log_info(module_id,
+                        "Display rendering completed successfully for %s",
+                        display->display_name);
+
+  return 0;
+}
+
+static int display_open_display(int display_id) {
+  struct DisplayDisplay *display;
+  int err;
+
+  err = DisplaySubsystem_displays_get(&display_subsystem, display_id,
+                                      &display);
+  if (err) {
+    return err;
+  }
+
+  if (display_subsystem.is_opened[display_id]) {
+    return 0;
+  }
+
+  if (display->open) {
+    err = display->open();
+    if (err) {
+      logging_ops->log_err(module_id, "Unable to open display %s: %s",
+                           display->display_name, strerror(err));
+      return err;
+    }
+  }
+
+  display_subsystem.is_opened[display_id] = true;
+
+  return 0;
+}
+
+// If no display was activated, frame goes to the one from display data.
+static int display_render_sync(struct DisplayData *data) {
+  size_t length = DisplaySubsystem_active_displays_length(&display_subsystem);
+  int *display_id;
+  int err;
 
+  if (length == 0) {
+    return display_priv_ops->render(data->display_id, data);
+  }
+
+  for (size_t i = 0; i < length; i++) {
+    DisplaySubsystem_active_displays_get(&display_subsystem, i, &display_id);
+
+    err = display_priv_ops->render(*display_id, data);
+    if (err) {
+      return err;
+    }
+  }
+
+  return 0;
+}
+
+static struct DisplaySnapshot *
+display_create_snapshot(struct DisplayData *data, size_t refs) {
+  struct DisplaySnapshot *snapshot;
+
+  snapshot = malloc(sizeof(struct DisplaySnapshot));
+  if (!snapshot) {
+    return NULL;
+  }
+
+  atomic_init(&snapshot->refs, refs);
+  snapshot->data = *data;
+
+  for (size_t i = 0; i < data->board_xy; i++) {
+    memcpy(snapshot->cells[i], data->cells[i],
+           sizeof(struct GameBoardCell) * data->board_xy);
+  }
+
+  snapshot->data.cells =
+      (const struct GameBoardCell(*)[GAME_BOARD_XY_MAX])snapshot->cells;
+
+  return snapshot;
+}
+
+static void display_release_snapshot(struct DisplaySnapshot *snapshot) {
+  if (!snapshot) {
+    return;
+  }
+
+  if (atomic_fetch_sub(&snapshot->refs, 1) == 1) {
+    free(snapshot);
+  }
+}
+
+static int display_start_sink(struct DisplaySink *sink, int display_id) {
+  struct DisplayDisplay *display;
+  int err;
+
+  err = DisplaySubsystem_displays_get(&display_subsystem, display_id,
+                                      &display);
+  if (err) {
+    return err;
+  }
+
+  *sink = (struct DisplaySink){
+      .display_id = display_id,
+      .queue_capacity = display->queue_length,
+  };
+
+  if (sink->queue_capacity == 0) {
+    sink->queue_capacity = 1;
+  } else if (sink->queue_capacity > DISPLAY_QUEUE_MAX) {
+    sink->queue_capacity = DISPLAY_QUEUE_MAX;
+  }
+
+  // Displays are opened before any of render threads runs, so none of them
+  //  misses frames rendered by the others.
+  err = display_priv_ops->open_display(display_id);
+  if (err) {
+    return err;
+  }
+
+  if (display->start) {
+    err = display->start();
+    if (err) {
+      logging_ops->log_err(module_id, "Unable to start display %s: %s",
+                           display->display_name, strerror(err));
+      return err;
+    }
+  }
+
+  err = pthread_mutex_init(&sink->mutex, NULL);
+  if (err) {
+    return err;
+  }
+
+  if (sem_init(&sink->wakeup, 0, 0) == -1) {
+    err = errno;
+    pthread_mutex_destroy(&sink->mutex);
+    return err;
+  }
+
+  err = pthread_create(&sink->thread, NULL, display_priv_ops->sink_thread,
+                       sink);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to start %s render thread: %s",
+                         display->display_name, strerror(err));
+    sem_destroy(&sink->wakeup);
+    pthread_mutex_destroy(&sink->mutex);
+    return err;
+  }
+
+  return 0;
+}
+
+static void display_stop_sink(struct DisplaySink *sink) {
+  pthread_mutex_lock(&sink->mutex);
+  sink->is_stopping = true;
+  pthread_mutex_unlock(&sink->mutex);
+
+  sem_post(&sink->wakeup);
+  pthread_join(sink->thread, NULL);
+
+  display_priv_ops->release_snapshot(sink->current);
+  sink->current = NULL;
+
+  sem_destroy(&sink->wakeup);
+  pthread_mutex_destroy(&sink->mutex);
+
+  logging_ops->log_info(module_id,
+                        "Render thread of display %d stopped, %zu frames "
+                        "dropped",
+                        sink->display_id, sink->dropped_frames);
+}
+
+static void display_push_snapshot(struct DisplaySink *sink,
+                                  struct DisplaySnapshot *snapshot) {
+  struct DisplaySnapshot *dropped = NULL;
+
+  pthread_mutex_lock(&sink->mutex);
+  if (sink->queue_length == sink->queue_capacity) {
+    dropped = sink->queue[sink->queue_head];
+    sink->queue_head = (sink->queue_head + 1) % sink->queue_capacity;
+    sink->queue_length--;
+    sink->dropped_frames++;
+  }
+
+  sink->queue[(sink->queue_head + sink->queue_length) % sink->queue_capacity] =
+      snapshot;
+  sink->queue_length++;
+  pthread_mutex_unlock(&sink->mutex);
+
+  display_priv_ops->release_snapshot(dropped);
+
+  sem_post(&sink->wakeup);
+}
+
+static void *display_sink_thread(void *arg) {
+  struct DisplaySink *sink = arg;
+  struct DisplaySnapshot *snapshot;
+  bool is_done;
+
+  for (;;) {
+    while (sem_wait(&sink->wakeup) == -1 && errno == EINTR)
+      ;
+
+    // Rendering happens without lock, so publishing next frame never waits
+    //  for the display.
+    pthread_mutex_lock(&sink->mutex);
+    snapshot = NULL;
+    if (sink->queue_length > 0) {
+      snapshot = sink->queue[sink->queue_head];
+      sink->queue_head = (sink->queue_head + 1) % sink->queue_capacity;
+      sink->queue_length--;
+    }
+    pthread_mutex_unlock(&sink->mutex);
+
+    if (snapshot) {
+      display_priv_ops->release_snapshot(sink->current);
+      sink->current = snapshot;
+      sink->is_redraw_requested = 0;
+      display_priv_ops->render(sink->display_id, &snapshot->data);
+    } else if (sink->current && sink->is_redraw_requested) {
+      sink->is_redraw_requested = 0;
+      display_priv_ops->render(sink->display_id, &sink->current->data);
+    }
+
+    pthread_mutex_lock(&sink->mutex);
+    is_done = sink->is_stopping && sink->queue_length == 0;
+    pthread_mutex_unlock(&sink->mutex);
+
+    if (is_done) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+static void display_request_redraw(void) {
+  struct DisplayRenderer *renderer = &display_renderer;
+
+  atomic_fetch_add(&renderer->redraws_in_flight, 1);
+
+  if (renderer->is_running) {
+    for (size_t i = 0; i < renderer->sinks_length; i++) {
+      renderer->sinks[i].is_redraw_requested = 1;
+      sem_post(&renderer->sinks[i].wakeup);
+    }
+  }
+
+  atomic_fetch_sub(&renderer->redraws_in_flight, 1);
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
 static struct DisplayPrivateOps display_private_ops = {
-    .get_subsystem = display_get_subsystem};
+    .get_subsystem = display_get_subsystem,
+    .validate_data = display_validate_data,
+    .render = display_render,
+    .render_sync = display_render_sync,
+    .open_display = display_open_display,
+    .create_snapshot = display_create_snapshot,
+    .release_snapshot = display_release_snapshot,
+    .start_sink = display_start_sink,
+    .stop_sink = display_stop_sink,
+    .push_snapshot = display_push_snapshot,
+    .sink_thread = display_sink_thread,
+    .request_redraw = display_request_redraw,
+};
 
 static struct DisplayOps display_ops = {
     .init = display_init,
+    .destroy = display_destroy,
+    .start = display_start,
+    .stop = display_stop,
     .display = display_display,
     .add_display = display_add_display,
+    .activate_display = display_activate_display,
     .get_display_id = display_get_display_id,
 };
 
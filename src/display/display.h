@@ -32,12 +32,15 @@ struct DisplayData {
   enum GameStates game_state;
   int display_id;
   int user_id;
-  // User moves are passed as reference from game state machine,
+  // Board is passed as reference from game state machine,
   //  we are not copying from performence reasons but we still
-  //  want to prevent display from changing users moves.
-  const struct UserMove *moves;
-  size_t moves_length;
+  //  want to prevent display from changing it. Only first board_xy
+  //  rows and columns are in use.
+  const struct GameBoardCell (*cells)[GAME_BOARD_XY_MAX];
   size_t board_xy;
+  // Coordinates of the current user's last move, displays which cannot
+  //  show whole board keep it in sight.
+  struct UserMoveCoordinates cursor;
 };
 
 typedef int (*display_display_func_t)(struct DisplayData *data);
@@ -45,14 +48,34 @@ typedef int (*display_display_func_t)(struct DisplayData *data);
 struct DisplayDisplay {
   display_display_func_t display;
   const char *display_name;
+  // Optional, open is called before the first frame display renders and
+  //  close on destroy if display was opened. Displays which need to take
+  //  over resources like terminal should do it here rather than on init,
+  //  because any registered display may end up unused.
+  int (*open)(void);
+  void (*close)(void);
+  // Optional, start is called on every start before display's render
+  //  thread runs. Displays opened for one game stay opened for the next
+  //  ones, state which belongs to single game should be reset here.
+  int (*start)(void);
+  // How many frames may wait for display, when display is slower than the
+  //  game the oldest ones are dropped. 0 means only the newest frame.
+  size_t queue_length;
 };
 
 struct DisplayOps {
   int (*init)(void); // We will add display config var in game_config.c
+  void (*destroy)(void);
   //  Each display registers itself to display on init and game_config
-  //  just chooses which one will be used during game session.
+  //  just chooses which ones will be used during game session.
+  // Every active display renders on its own thread between start and stop,
+  //  before start every frame is rendered synchronously.
+  int (*start)(void);
+  void (*stop)(void);
   display_display_func_t display;
   int (*add_display)(struct DisplayDisplay *new_display);
+  // Every frame is sent to all activated displays.
+  int (*activate_display)(int display_id);
   int (*get_display_id)(const char *display_name, int *id_placeholder);
 };
 
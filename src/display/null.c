@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * @file null.c
+ * @brief Displays which do not touch the terminal.
+ *
+ * Counting display does not format anything, bytes are computed from the
+ * layout plain text rendering would have: player info line followed by
+ * board rows, where cells are separated by `|`.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// App's internal libs
+#include "display/display.h"
+#include "display/null.h"
+#include "game/game_state_machine/game_states.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+// Written by counting display's render thread, read by anyone asking for
+//  stats.
+struct DisplayCountingCounters {
+  atomic_size_t frames;
+  atomic_size_t bytes;
+};
+
+struct DisplayNullPrivateOps {
+  display_display_func_t display_null;
+  display_display_func_t display_counting;
+  int (*reset_counting)(void);
+  size_t (*count_frame_bytes)(struct DisplayData *data);
+};
+
+static char module_id[] = "display_null";
+static struct DisplayCountingCounters counting_counters;
+static struct LoggingUtilsOps *logging_ops;
+static struct DisplayNullPrivateOps *display_null_priv_ops;
+struct DisplayNullPrivateOps *get_display_null_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int display_null_init(void) {
+  struct DisplayOps *display_ops;
+  int err;
+
+  display_null_priv_ops = get_display_null_priv_ops();
+  display_ops = get_display_ops();
+  logging_ops = get_logging_utils_ops();
+
+  display_null_priv_ops->reset_counting();
+
+  err = display_ops->add_display(
+      &(struct DisplayDisplay){.display_name = DISPLAY_NULL_NAME,
+                               .display = display_null_priv_ops->display_null});
+  if (err) {
+    return err;
+  }
+
+  err = display_ops->add_display(&(struct DisplayDisplay){
+      .display_name = DISPLAY_COUNTING_NAME,
+      .display = display_null_priv_ops->display_counting,
+      .open = display_null_priv_ops->reset_counting,
+      .start = display_null_priv_ops->reset_counting});
+  if (err) {
+    return err;
+  }
+
+  return 0;
+}
+
+static void
+display_null_get_counting_stats(struct DisplayCountingStats *stats) {
+  if (!stats) {
+    return;
+  }
+
+  // Counters are read one by one, while frames are counted they may be
+  //  a frame apart.
+  stats->frames =
+      atomic_load_explicit(&counting_counters.frames, memory_order_relaxed);
+  stats->bytes =
+      atomic_load_explicit(&counting_counters.bytes, memory_order_relaxed);
+}
+
+static void display_null_destroy(void) {
+  struct DisplayCountingStats stats;
+
+  display_null_get_counting_stats(&stats);
+  if (stats.frames == 0) {
+    return;
+  }
+
+  logging_ops->log_info(module_id, "Counted %zu frames, %zu bytes",
+                        stats.frames, stats.bytes);
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int display_null_display(struct DisplayData *data) {
+  (void)data;
+
+  return 0;
+}
+
+static int display_null_display_counting(struct DisplayData *data) {
+  atomic_fetch_add_explicit(&counting_counters.frames, 1,
+                            memory_order_relaxed);
+  atomic_fetch_add_explicit(&counting_counters.bytes,
+                            display_null_priv_ops->count_frame_bytes(data),
+                            memory_order_relaxed);
+
+  return 0;
+}
+
+// Every game counts from zero, no matter how many ran before it. Display
+//  is opened only once, so counters are reset on every start as well.
+static int display_null_reset_counting(void) {
+  atomic_store(&counting_counters.frames, 0);
+  atomic_store(&counting_counters.bytes, 0);
+
+  return 0;
+}
+
+static size_t display_null_count_frame_bytes(struct DisplayData *data) {
+  int length;
+
+  if (data->game_state == GameStateQuitting) {
+    length = snprintf(NULL, 0, "User %i quitting. To quit press q.\n",
+                      data->user_id + 1);
+    return length < 0 ? 0 : (size_t)length;
+  }
+
+  // Users chars are single characters, user ids are not.
+  length = snprintf(NULL, 0, "Current user: %d=x\n\n", data->user_id + 1);
+  if (length < 0) {
+    return 0;
+  }
+
+  // Every cell is followed by separator, last one in a row by new line.
+  return (size_t)length + data->board_xy * data->board_xy * 2;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct DisplayNullPrivateOps display_null_priv_ops_ = {
+    .display_null = display_null_display,
+    .display_counting = display_null_display_counting,
+    .reset_counting = display_null_reset_counting,
+    .count_frame_bytes = display_null_count_frame_bytes,
+};
+
+struct DisplayNullPrivateOps *get_display_null_priv_ops(void) {
+  return &display_null_priv_ops_;
+}
+
+static struct DisplayNullOps display_null_ops = {
+    .init = display_null_init,
+    .destroy = display_null_destroy,
+    .get_counting_stats = display_null_get_counting_stats,
+};
+
+struct DisplayNullOps *get_display_null_ops(void) {
+  return &display_null_ops;
+}
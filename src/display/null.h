@@ -0,0 +1,40 @@
+#ifndef DISPLAY_NULL_H
+#define DISPLAY_NULL_H
+/*******************************************************************************
+ * @file null.h
+ * @brief Displays which do not touch the terminal.
+ *
+ * `null` display drops every frame, `counting` display only tallies frames
+ * and bytes a plain text rendering of them would take. Both are meant for
+ * benchmarks and sessions running without TTY.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define DISPLAY_NULL_NAME "null"
+#define DISPLAY_COUNTING_NAME "counting"
+
+struct DisplayCountingStats {
+  size_t frames;
+  size_t bytes;
+};
+
+struct DisplayNullOps {
+  int (*init)(void);
+  void (*destroy)(void);
+  void (*get_counting_stats)(struct DisplayCountingStats *stats);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct DisplayNullOps *get_display_null_ops(void);
+
+#endif // DISPLAY_NULL_H
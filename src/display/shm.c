@@ -0,0 +1,232 @@
+/*******************************************************************************
+ * @file shm.c
+ * @brief Display publishing the board into POSIX shared memory.
+ *
+ * Segment is created when display is opened and removed when it is closed,
+ * readers which still have it mapped keep the last published board.
+ *
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L // shm_open, ftruncate
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// App's internal libs
+#include "config/config.h"
+#include "display/display.h"
+#include "display/shm.h"
+#include "game/game_state_machine/game_state_machine.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define SHM_SEGMENT_NAME_MAX 64
+
+_Static_assert(GAME_BOARD_XY_MAX <= DISPLAY_SHM_BOARD_XY_MAX,
+               "Board does not fit into shared memory segment");
+
+struct ShmPublisher {
+  char name[SHM_SEGMENT_NAME_MAX];
+  struct DisplayShmBoard *board;
+};
+
+struct DisplayShmPrivateOps {
+  display_display_func_t display;
+  int (*open)(void);
+  void (*close)(void);
+  int (*get_name)(char *name, size_t size);
+};
+
+static char module_id[] = "display_shm";
+static struct ShmPublisher publisher;
+static struct ConfigOps *config_ops;
+static struct LoggingUtilsOps *logging_ops;
+static struct DisplayShmPrivateOps *display_shm_priv_ops;
+struct DisplayShmPrivateOps *get_display_shm_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int display_shm_init(void) {
+  struct DisplayOps *display_ops;
+  int err;
+
+  display_shm_priv_ops = get_display_shm_priv_ops();
+  display_ops = get_display_ops();
+  config_ops = get_config_ops();
+  logging_ops = get_logging_utils_ops();
+
+  err = display_shm_priv_ops->get_name(publisher.name, sizeof(publisher.name));
+  if (err) {
+    return err;
+  }
+
+  err = display_ops->add_display(
+      &(struct DisplayDisplay){.display_name = DISPLAY_SHM_NAME,
+                               .display = display_shm_priv_ops->display,
+                               .open = display_shm_priv_ops->open,
+                               .close = display_shm_priv_ops->close});
+  if (err) {
+    return err;
+  }
+
+  return 0;
+}
+
+static void display_shm_destroy(void) { display_shm_priv_ops->close(); }
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int display_shm_display(struct DisplayData *data) {
+  struct DisplayShmBoard *board = publisher.board;
+  uint_least64_t sequence;
+  uint32_t moves_count = 0;
+
+  if (!board) {
+    return ENODEV;
+  }
+
+  // Odd sequence tells readers that board is being written.
+  sequence = atomic_load_explicit(&board->sequence, memory_order_relaxed);
+  atomic_store_explicit(&board->sequence, sequence + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  board->game_state = data->game_state;
+  board->user_id = data->user_id;
+  board->board_xy = data->board_xy;
+  board->cursor_x = data->cursor.x;
+  board->cursor_y = data->cursor.y;
+
+  for (size_t y = 0; y < data->board_xy; y++) {
+    for (size_t x = 0; x < data->board_xy; x++) {
+      board->cells[y][x].owner = data->cells[y][x].owner;
+      board->cells[y][x].flags = data->cells[y][x].flags;
+      if (data->cells[y][x].flags & GAME_BOARD_CELL_TAKEN) {
+        moves_count++;
+      }
+    }
+  }
+
+  board->moves_count = moves_count;
+
+  atomic_store_explicit(&board->sequence, sequence + 2, memory_order_release);
+
+  return 0;
+}
+
+static int display_shm_open(void) {
+  struct DisplayShmBoard *board;
+  int err;
+  int fd;
+
+  fd = shm_open(publisher.name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+  if (fd == -1) {
+    err = errno;
+    logging_ops->log_err(module_id, "Unable to create %s: %s", publisher.name,
+                         strerror(err));
+    return err;
+  }
+
+  if (ftruncate(fd, sizeof(struct DisplayShmBoard)) == -1) {
+    err = errno;
+    goto error;
+  }
+
+  board = mmap(NULL, sizeof(struct DisplayShmBoard), PROT_READ | PROT_WRITE,
+               MAP_SHARED, fd, 0);
+  if (board == MAP_FAILED) {
+    err = errno;
+    goto error;
+  }
+
+  close(fd);
+
+  // Fresh segment is zeroed, so readers see even sequence with empty board
+  //  until the first frame is published.
+  board->version = DISPLAY_SHM_VERSION;
+  board->pid = getpid();
+  atomic_store_explicit(&board->sequence, 0, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  board->magic = DISPLAY_SHM_MAGIC;
+
+  publisher.board = board;
+
+  logging_ops->log_info(module_id, "Publishing board to %s", publisher.name);
+
+  return 0;
+
+error:
+  logging_ops->log_err(module_id, "Unable to set up %s: %s", publisher.name,
+                       strerror(err));
+  close(fd);
+  shm_unlink(publisher.name);
+
+  return err;
+}
+
+static void display_shm_close(void) {
+  if (!publisher.board) {
+    return;
+  }
+
+  munmap(publisher.board, sizeof(struct DisplayShmBoard));
+  publisher.board = NULL;
+
+  shm_unlink(publisher.name);
+}
+
+// Every game process gets its own segment, so many games can be watched
+//  at once.
+static int display_shm_get_name(char *name, size_t size) {
+  char value[SHM_SEGMENT_NAME_MAX];
+  int length;
+  int err;
+
+  err = config_ops->read_var(DISPLAY_SHM_NAME_VAR_NAME,
+                             DISPLAY_SHM_NAME_DEFAULT, value, sizeof(value));
+  if (err) {
+    return err;
+  }
+
+  length = snprintf(name, size, "%s.%d", value, (int)getpid());
+  if (length < 0 || (size_t)length >= size) {
+    logging_ops->log_err(module_id, "Shared memory name too long: %s", value);
+    return ENAMETOOLONG;
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct DisplayShmPrivateOps display_shm_priv_ops_ = {
+    .display = display_shm_display,
+    .open = display_shm_open,
+    .close = display_shm_close,
+    .get_name = display_shm_get_name,
+};
+
+struct DisplayShmPrivateOps *get_display_shm_priv_ops(void) {
+  return &display_shm_priv_ops_;
+}
+
+static struct DisplayShmOps display_shm_ops = {
+    .init = display_shm_init,
+    .destroy = display_shm_destroy,
+};
+
+struct DisplayShmOps *get_display_shm_ops(void) { return &display_shm_ops; }
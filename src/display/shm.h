@@ -0,0 +1,67 @@
+#ifndef DISPLAY_SHM_H
+#define DISPLAY_SHM_H
+/*******************************************************************************
+ * @file shm.h
+ * @brief Display publishing the board into POSIX shared memory.
+ *
+ * Every frame is copied into shared memory segment named
+ * `<shm_name>.<pid>`, where external viewers (see ttt-view) can read it
+ * without any syscall and without involving the game process.
+ *
+ * Segment is protected by seqlock. Writer makes the sequence odd, updates
+ * the board and makes the sequence even again. Reader loads the sequence,
+ * copies the board and loads the sequence again. Copy is consistent only
+ * if both loads returned the same even number, otherwise reader retries.
+ *
+ * Layout below is shared with other processes, so it uses fixed size types
+ * and has to be versioned on every change.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stdatomic.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define DISPLAY_SHM_NAME "shm"
+#define DISPLAY_SHM_NAME_VAR_NAME "shm_name"
+#define DISPLAY_SHM_NAME_DEFAULT "/ttt"
+#define DISPLAY_SHM_MAGIC 0x54545453 // "TTTS"
+#define DISPLAY_SHM_VERSION 1
+#define DISPLAY_SHM_BOARD_XY_MAX 11
+
+struct DisplayShmCell {
+  int32_t owner;
+  uint32_t flags; // enum GameBoardCellFlags
+};
+
+struct DisplayShmBoard {
+  uint32_t magic;
+  uint32_t version;
+  atomic_uint_least64_t sequence;
+  int32_t pid;
+  uint32_t game_state; // enum GameStates
+  int32_t user_id;
+  uint32_t board_xy;
+  uint32_t moves_count;
+  int32_t cursor_x;
+  int32_t cursor_y;
+  struct DisplayShmCell cells[DISPLAY_SHM_BOARD_XY_MAX]
+                             [DISPLAY_SHM_BOARD_XY_MAX];
+};
+
+struct DisplayShmOps {
+  int (*init)(void);
+  void (*destroy)(void);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct DisplayShmOps *get_display_shm_ops(void);
+
+#endif // DISPLAY_SHM_H
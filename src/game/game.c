@@ -5,6 +5,11 @@
  * This file manages the game's lifecycle, including start, stop, and quit
  * operations. It integrates input management and ensures proper shutdown
  * sequences.
+ *
+ * Input devices only push events into game queue, whole game state machine
+ * runs on the game loop thread, which drains the queue in batches. So game
+ * state has single writer no matter how many devices there are, and input
+ * keeps flowing while frame is being rendered.
  ******************************************************************************/
 
 /*******************************************************************************
@@ -12,13 +17,18 @@
  ******************************************************************************/
 // C standard library
 #include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
 // App's internal libs
 #include "config/config.h"
+#include "display/display.h"
 #include "game/game.h"
+#include "game/game_queue.h"
 #include "game/game_state_machine/game_sm_subsystem.h"
 #include "game/game_state_machine/game_state_machine.h"
 #include "init/init.h"
@@ -29,17 +39,44 @@
 /*******************************************************************************
  *    GLOBALS
  ******************************************************************************/
+#define GAME_LOOP_BATCH_MAX 64
+
+struct GameLoop {
+  pthread_t thread;
+  bool is_running;
+  atomic_bool is_stopping;
+  // Set once game is over, events which are still queued are dropped.
+  atomic_bool is_quitting;
+};
+
+struct GamePrivateOps {
+  int (*start_loop)(void);
+  void (*stop_loop)(void);
+  void *(*loop)(void *);
+  void (*process_events)(const struct GameQueueEvent *events, size_t length);
+};
+
+static struct GameLoop game_loop;
 static struct InputOps *input_ops;
+static struct DisplayOps *display_ops;
 static struct LoggingUtilsOps *logging_ops;
+static struct GameQueueOps *game_queue_ops;
 static struct GameSmSubsystemOps *gsm_sub_ops;
+static struct GameStateMachineOps *gsm_ops;
+static struct GamePrivateOps *game_priv_ops;
+struct GamePrivateOps *get_game_priv_ops(void);
 
 /*******************************************************************************
  *    API
  ******************************************************************************/
 int game_init(void) {
   input_ops = get_input_ops();
+  display_ops = get_display_ops();
   logging_ops = get_logging_utils_ops();
   gsm_sub_ops = get_game_sm_subsystem_ops();
+  gsm_ops = get_game_state_machine_ops();
+  game_queue_ops = get_game_queue_ops();
+  game_priv_ops = get_game_priv_ops();
 
   return 0;
 }
@@ -52,33 +89,63 @@ int game_init(void) {
 int game_start(void) {
   int err;
 
-  // Start the input subsystem
-  logging_ops->log_info(GAME_FILE_NAME, "Starting input subsystem...");
-  err = input_ops->start();
+  // Rendering runs on its own thread, so slow terminal does not hold input.
+  err = display_ops->start();
   if (err) {
-    logging_ops->log_err(GAME_FILE_NAME, "Failed to start input subsystem: %s",
+    logging_ops->log_err(GAME_FILE_NAME, "Failed to start display: %s",
                          strerror(err));
     return err;
   }
 
-  logging_ops->log_info(GAME_FILE_NAME,
-                        "Input subsystem started successfully.");
-
   logging_ops->disable_console_logger();
 
+  // Game loop is not running yet, so this is the only writer.
   err = gsm_sub_ops->display_starting_screen();
   if (err) {
     logging_ops->log_err(
         GAME_FILE_NAME, "Unable to display starting screen: %s", strerror(err));
+    display_ops->stop();
+    return err;
+  }
+
+  err = game_priv_ops->start_loop();
+  if (err) {
+    logging_ops->log_err(GAME_FILE_NAME, "Failed to start game loop: %s",
+                         strerror(err));
+    display_ops->stop();
     return err;
   }
 
+  // Start the input subsystem
+  logging_ops->log_info(GAME_FILE_NAME, "Starting input subsystem...");
+  err = input_ops->start();
+  if (err) {
+    logging_ops->log_err(GAME_FILE_NAME, "Failed to start input subsystem: %s",
+                         strerror(err));
+    game_priv_ops->stop_loop();
+    display_ops->stop();
+    return err;
+  }
+
+  logging_ops->log_info(GAME_FILE_NAME,
+                        "Input subsystem started successfully.");
+
   // Wait for input events
   logging_ops->log_info(GAME_FILE_NAME, "Waiting for input events...");
   err = input_ops->wait();
   if (err) {
     logging_ops->log_err(GAME_FILE_NAME, "Error while waiting for input: %s",
                          strerror(err));
+  }
+
+  input_ops->stop();
+
+  // Input is done, events which are still queued are processed before loop
+  //  exits, then only frames which are still pending have to be drawn.
+  game_priv_ops->stop_loop();
+  display_ops->stop();
+
+  if (err) {
     return err;
   }
 
@@ -89,20 +156,123 @@ int game_start(void) {
 
 /**
  * @brief Quits the game, performing necessary cleanup and shutdown.
+ *
+ * Safe to call from any thread, it only requests the stop. Game loop and
+ * input are joined by game_start's thread.
  */
 void game_stop(void) {
   logging_ops = get_logging_utils_ops();
 
   logging_ops->log_info(GAME_FILE_NAME, "Stopping game...");
 
-  input_ops->stop();
+  atomic_store(&game_loop.is_quitting, true);
+
+  input_ops->request_stop();
 
-  logging_ops->log_info(GAME_FILE_NAME, "Game stopped successfully.");
+  logging_ops->log_info(GAME_FILE_NAME, "Game stop requested successfully.");
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int game_start_loop(void) {
+  int err;
+
+  atomic_store(&game_loop.is_stopping, false);
+  atomic_store(&game_loop.is_quitting, false);
+
+  err = pthread_create(&game_loop.thread, NULL, game_priv_ops->loop, NULL);
+  if (err) {
+    return err;
+  }
+
+  game_loop.is_running = true;
+
+  return 0;
+}
+
+static void game_stop_loop(void) {
+  if (!game_loop.is_running) {
+    return;
+  }
+
+  atomic_store(&game_loop.is_stopping, true);
+  game_queue_ops->wake_up();
+
+  pthread_join(game_loop.thread, NULL);
+  game_loop.is_running = false;
+
+  if (game_queue_ops->get_dropped_events() > 0) {
+    logging_ops->log_err(GAME_FILE_NAME, "Dropped %zu input events",
+                         game_queue_ops->get_dropped_events());
+  }
+}
+
+// Stop is checked before draining, so everything which was pushed before
+//  the stop is still processed.
+static void *game_loop_thread(void *data) {
+  struct GameQueueEvent events[GAME_LOOP_BATCH_MAX];
+  bool is_stopping;
+  size_t length;
+  (void)data;
+
+  do {
+    game_queue_ops->wait();
+
+    is_stopping = atomic_load(&game_loop.is_stopping);
+
+    while ((length = game_queue_ops->pop(events, GAME_LOOP_BATCH_MAX)) > 0) {
+      if (atomic_load(&game_loop.is_quitting)) {
+        continue;
+      }
+
+      game_priv_ops->process_events(events, length);
+    }
+  } while (!is_stopping);
+
+  return NULL;
+}
+
+// Consecutive events of the same device make one step of the game.
+static void game_process_events(const struct GameQueueEvent *events,
+                                size_t length) {
+  enum InputEvents input_events[GAME_LOOP_BATCH_MAX];
+  uint64_t now_ns = game_queue_ops->get_timestamp();
+  size_t start = 0;
+  size_t i;
+
+  logging_ops->log_info(GAME_FILE_NAME,
+                        "Processing %zu events, oldest queued for %llu us",
+                        length,
+                        (unsigned long long)(now_ns - events[0].timestamp_ns) /
+                            1000);
+
+  for (i = 0; i < length; i++) {
+    input_events[i] = events[i].input_event;
+
+    if (i + 1 < length && events[i + 1].device_id == events[start].device_id) {
+      continue;
+    }
+
+    // Errors are logged and handled by game state machine itself.
+    gsm_ops->step_batch(&input_events[start], i + 1 - start,
+                        events[start].device_id);
+    start = i + 1;
+  }
 }
 
 /*******************************************************************************
  *    MODULARITY BOILERCODE
  ******************************************************************************/
+static struct GamePrivateOps game_priv_ops_ = {
+    .start_loop = game_start_loop,
+    .stop_loop = game_stop_loop,
+    .loop = game_loop_thread,
+    .process_events = game_process_events,
+};
+
+struct GamePrivateOps *get_game_priv_ops(void) { return &game_priv_ops_; }
+
 struct GameOps game_ops = {
     .init = game_init,
     .start = game_start,
@@ -1,5 +1,6 @@
 #include <asm-generic/errno-base.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -10,6 +11,7 @@
 
 #include "config/config.h"
 #include "game/game_config.h"
+#include "game/game_queue.h"
 #include "game/game_state_machine/game_state_machine.h"
 #include "game/game_user.h"
 #include "game/user_move.h"
@@ -34,13 +36,17 @@ static GameConfig game_config;
 static int game_config_init(void) {
   struct ConfigVariable config_var = {.var_name = "users_amount",
                                       .default_value = "2"};
-  struct GameStateMachineOps *gsm_ops = get_game_state_machine_ops();
+  struct GameQueueOps *game_queue_ops = get_game_queue_ops();
   struct DisplayOps *display_ops = get_display_ops();
   struct InputGetDeviceExtendedOutput get_device;
   struct ConfigAddVarOutput add_var;
   struct ConfigGetVarOutput get_var;
   struct GameUser user;
+  char display_name[CONFIG_VARIABLE_MAX];
   int users_amount;
+  const char *names;
+  size_t length;
+  bool is_first;
   int display_id;
   size_t i;
   int err;
@@ -121,8 +127,10 @@ static int game_config_init(void) {
     }
 
     err = input_ops->set_callback(
-        (struct InputSetCallbackInput){.callback = gsm_ops->step,
-                                       .device_id = get_device.device_id},
+        (struct InputSetCallbackInput){
+            .callback = game_queue_ops->push,
+            .batch_callback = game_queue_ops->push_batch,
+            .device_id = get_device.device_id},
         &(struct InputSetCallbackOutput){});
     if (err) {
       log_ops->log_err(GAME_CONFIG_FILE_NAME,
@@ -171,14 +179,51 @@ static int game_config_init(void) {
     return err;
   }
 
-  err = display_ops->get_display_id(get_var.value, &display_id);
-  if (err) {
-    log_ops->log_err(GAME_CONFIG_FILE_NAME, "Unable to get %s display: %s",
-                     get_var.value, strerror(err));
-    return err;
+  // Display variable holds comma separated list of displays, every frame
+  //  is sent to all of them. First one is the primary display.
+  names = get_var.value;
+  is_first = true;
+  while (*names) {
+    length = strcspn(names, ",");
+    if (length == 0 || length >= sizeof(display_name)) {
+      log_ops->log_err(GAME_CONFIG_FILE_NAME, "Invalid display list: %s",
+                       get_var.value);
+      return EINVAL;
+    }
+
+    memcpy(display_name, names, length);
+    display_name[length] = 0;
+
+    err = display_ops->get_display_id(display_name, &display_id);
+    if (err) {
+      log_ops->log_err(GAME_CONFIG_FILE_NAME, "Unable to get %s display: %s",
+                       display_name, strerror(err));
+      return err;
+    }
+
+    err = display_ops->activate_display(display_id);
+    if (err) {
+      log_ops->log_err(GAME_CONFIG_FILE_NAME,
+                       "Unable to activate %s display: %s", display_name,
+                       strerror(err));
+      return err;
+    }
+
+    if (is_first) {
+      game_config.display_id = display_id;
+      is_first = false;
+    }
+
+    names += length;
+    if (*names == ',') {
+      names++;
+    }
   }
 
-  game_config.display_id = display_id;
+  if (is_first) {
+    log_ops->log_err(GAME_CONFIG_FILE_NAME, "No display configured");
+    return EINVAL;
+  }
 
   return 0;
 }
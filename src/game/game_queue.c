@@ -0,0 +1,219 @@
+/*******************************************************************************
+ * @file game_queue.c
+ * @brief Queue of input events waiting for the game loop.
+ *
+ * Events travel through bounded multi producer, single consumer ring, queue
+ * adds timestamps, waking up the consumer and waiting for it when the ring
+ * is full.
+ *
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// App's internal libs
+#include "game/game_queue.h"
+#include "input/input_common.h"
+#include "utils/logging_utils.h"
+#include "utils/ring_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+// Consumer is woken up after every chunk, so it drains the queue while long
+//  batch is still being pushed.
+#define GAME_QUEUE_WAKE_UP_CHUNK 256
+// How many times producer yields to consumer waiting for free slot, before
+//  it drops the rest of its events.
+#define GAME_QUEUE_PUSH_RETRIES_MAX 1000
+
+_Static_assert((GAME_QUEUE_LENGTH_MAX & (GAME_QUEUE_LENGTH_MAX - 1)) == 0,
+               "Game queue length has to be power of two");
+_Static_assert(GAME_QUEUE_LENGTH_MAX >= INPUT_BATCH_LENGTH_MAX,
+               "Game queue has to hold the biggest batch");
+
+struct GameQueue {
+  struct Ring ring;
+  atomic_size_t dropped_events;
+  sem_t wakeup;
+  bool is_initialized;
+};
+
+struct GameQueuePrivateOps {
+  uint64_t (*get_timestamp)(void);
+};
+
+static struct GameQueue game_queue;
+static struct LoggingUtilsOps *logging_ops;
+static struct RingUtilsOps *ring_utils_ops;
+static struct GameQueuePrivateOps *game_queue_priv_ops;
+struct GameQueuePrivateOps *get_game_queue_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int game_queue_init(void) {
+  int err;
+
+  logging_ops = get_logging_utils_ops();
+  ring_utils_ops = get_ring_utils_ops();
+  game_queue_priv_ops = get_game_queue_priv_ops();
+
+  if (game_queue.is_initialized) {
+    ring_utils_ops->destroy(&game_queue.ring);
+    sem_destroy(&game_queue.wakeup);
+    game_queue.is_initialized = false;
+  }
+
+  atomic_store(&game_queue.dropped_events, 0);
+
+  err = ring_utils_ops->init(&game_queue.ring, GAME_QUEUE_LENGTH_MAX,
+                             sizeof(struct GameQueueEvent));
+  if (err) {
+    logging_ops->log_err(GAME_QUEUE_FILE_NAME, "Unable to create ring: %s",
+                         strerror(err));
+    return err;
+  }
+
+  if (sem_init(&game_queue.wakeup, 0, 0) == -1) {
+    err = errno;
+    logging_ops->log_err(GAME_QUEUE_FILE_NAME, "Unable to create semaphore: %s",
+                         strerror(err));
+    ring_utils_ops->destroy(&game_queue.ring);
+    return err;
+  }
+
+  game_queue.is_initialized = true;
+
+  return 0;
+}
+
+static void game_queue_destroy(void) {
+  if (!game_queue.is_initialized) {
+    return;
+  }
+
+  ring_utils_ops->destroy(&game_queue.ring);
+  sem_destroy(&game_queue.wakeup);
+  game_queue.is_initialized = false;
+}
+
+static int game_queue_push_batch(const enum InputEvents *input_events,
+                                 size_t input_events_length,
+                                 input_device_id_t device_id) {
+  struct GameQueueEvent event = {.device_id = device_id,
+                                 .timestamp_ns =
+                                     game_queue_priv_ops->get_timestamp()};
+  size_t retries = 0;
+  size_t i = 0;
+
+  while (i < input_events_length) {
+    event.input_event = input_events[i];
+    if (ring_utils_ops->push(&game_queue.ring, &event) == 0) {
+      retries = 0;
+      if (++i % GAME_QUEUE_WAKE_UP_CHUNK == 0) {
+        sem_post(&game_queue.wakeup);
+      }
+      continue;
+    }
+
+    // Queue is full, consumer has to be running to make some room.
+    if (retries == GAME_QUEUE_PUSH_RETRIES_MAX) {
+      atomic_fetch_add_explicit(&game_queue.dropped_events,
+                                input_events_length - i,
+                                memory_order_relaxed);
+      sem_post(&game_queue.wakeup);
+      return ENOBUFS;
+    }
+
+    if (retries++ == 0) {
+      sem_post(&game_queue.wakeup);
+    }
+    sched_yield();
+  }
+
+  sem_post(&game_queue.wakeup);
+
+  return 0;
+}
+
+static int game_queue_push(enum InputEvents input_event,
+                           input_device_id_t device_id) {
+  return game_queue_push_batch(&input_event, 1, device_id);
+}
+
+static size_t game_queue_pop(struct GameQueueEvent *events,
+                             size_t events_max) {
+  size_t i;
+
+  for (i = 0; i < events_max; i++) {
+    if (ring_utils_ops->pop(&game_queue.ring, &events[i])) {
+      break;
+    }
+  }
+
+  return i;
+}
+
+static void game_queue_wait(void) {
+  while (sem_wait(&game_queue.wakeup) == -1 && errno == EINTR)
+    ;
+}
+
+static void game_queue_wake_up(void) {
+  if (game_queue.is_initialized) {
+    sem_post(&game_queue.wakeup);
+  }
+}
+
+static size_t game_queue_get_dropped_events(void) {
+  return atomic_load(&game_queue.dropped_events);
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static uint64_t game_queue_get_timestamp(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct GameQueuePrivateOps game_queue_priv_ops_ = {
+    .get_timestamp = game_queue_get_timestamp,
+};
+
+struct GameQueuePrivateOps *get_game_queue_priv_ops(void) {
+  return &game_queue_priv_ops_;
+}
+
+static struct GameQueueOps game_queue_ops = {
+    .init = game_queue_init,
+    .destroy = game_queue_destroy,
+    .push = game_queue_push,
+    .push_batch = game_queue_push_batch,
+    .pop = game_queue_pop,
+    .wait = game_queue_wait,
+    .wake_up = game_queue_wake_up,
+    .get_dropped_events = game_queue_get_dropped_events,
+    .get_timestamp = game_queue_get_timestamp,
+};
+
+struct GameQueueOps *get_game_queue_ops(void) { return &game_queue_ops; }
@@ -0,0 +1,59 @@
+#ifndef GAME_QUEUE_H
+#define GAME_QUEUE_H
+/*******************************************************************************
+ * @file game_queue.h
+ * @brief Queue of input events waiting for the game loop.
+ *
+ * Input devices push events from their own threads, game loop is the only
+ * consumer. Queue is bounded ring where every slot carries its own sequence
+ * number, so producers claim slots with single compare and swap and never
+ * take a lock. Producer which finds the queue full wakes the consumer up and
+ * waits for it to make room, events are dropped only when it never does.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+#include "input/input_common.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define GAME_QUEUE_FILE_NAME "game_queue"
+// Has to be power of two, big enough to hold the biggest batch.
+#define GAME_QUEUE_LENGTH_MAX 8192
+
+struct GameQueueEvent {
+  enum InputEvents input_event;
+  input_device_id_t device_id;
+  // CLOCK_MONOTONIC time in which device received the event.
+  uint64_t timestamp_ns;
+};
+
+struct GameQueueOps {
+  int (*init)(void);
+  void (*destroy)(void);
+  // Same signatures as device's callbacks, so they can be used directly.
+  input_callback_func_t push;
+  input_batch_callback_func_t push_batch;
+  // Moves up to `events_max` events into `events`, never blocks.
+  size_t (*pop)(struct GameQueueEvent *events, size_t events_max);
+  // Blocks until something is pushed or queue is woken up.
+  void (*wait)(void);
+  void (*wake_up)(void);
+  // Every event which did not make it into the queue is counted.
+  size_t (*get_dropped_events)(void);
+  // CLOCK_MONOTONIC time used for events' timestamps.
+  uint64_t (*get_timestamp)(void);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct GameQueueOps *get_game_queue_ops(void);
+
+#endif // GAME_QUEUE_H
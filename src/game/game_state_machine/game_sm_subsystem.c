@@ -123,7 +123,7 @@ int game_sm_subsystem_get_next_state(struct GameStateMachineInput input,
   return 0;
 }
 
-static int gsm_display_starting_screen(void) {
+static int gsm_display_state(void) {
   struct MiniGameStateMachine *mini_machine;
   for (size_t i = 0;
        i < GameSmSubsystem_mini_machines_length(&game_sm_subsystem); i++) {
@@ -140,6 +140,8 @@ static int gsm_display_starting_screen(void) {
   return ENOENT;
 }
 
+static int gsm_display_starting_screen(void) { return gsm_display_state(); }
+
 /*******************************************************************************
  *    PRIVATE API
  ******************************************************************************/
@@ -246,6 +248,7 @@ static struct GameSmSubsystemOps game_sm_subsystem_ops = {
     .next_state = game_sm_subsystem_get_next_state,
     .add_mini_state_machine = game_sm_subsystem_add_mini_state_machine,
     .display_starting_screen = gsm_display_starting_screen,
+    .display_state = gsm_display_state,
 };
 
 struct GameSmSubsystemOps *get_game_sm_subsystem_ops(void) {
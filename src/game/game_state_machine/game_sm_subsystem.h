@@ -16,6 +16,8 @@ struct GameSmSubsystemOps {
                     struct GameStateMachineState *state);
   int (*add_mini_state_machine)(struct MiniGameStateMachine mini_state_machine);
   int (*display_starting_screen)(void);
+  // Displays current state without processing any event.
+  int (*display_state)(void);
 };
 
 struct GameSmSubsystemOps *get_game_sm_subsystem_ops(void);
@@ -22,6 +22,7 @@
 #include "game/game_state_machine/game_sm_subsystem.h"
 #include "game/game_state_machine/game_state_machine.h"
 #include "game/game_state_machine/game_states.h"
+#include "game/game_state_machine/mini_state_machines/common.h"
 #include "game/game_user.h"
 #include "game/user_move.h"
 #include "init/init.h"
@@ -39,6 +40,8 @@ SARRS_DECL(GameStateMachineState, users_moves, struct UserMove,
            MAX_USERS_MOVES);
 
 struct GameStateMachinePrivOps {
+  int (*validate_input)(struct GameStateMachineInput input);
+  int (*advance)(struct GameStateMachineInput input);
   int (*validate_device_id)(input_device_id_t device_id);
   int (*validate_input_event)(enum InputEvents input_event);
 };
@@ -48,6 +51,7 @@ static struct InputOps *input_ops;
 static struct LoggingUtilsOps *logging_ops;
 static struct GameConfigOps *game_config_ops;
 static struct GameSmSubsystemOps *gsm_sub_ops;
+static struct GameStateMachineCommonOps *gsm_common_ops;
 static struct GameStateMachineState game_sm;
 static char gsm_module_id[] = "game_state_machine";
 
@@ -68,9 +72,11 @@ int game_sm_init(void) {
   game_ops = get_game_ops();
   gsm_priv_ops = get_game_state_machine_priv_ops();
   gsm_sub_ops = get_game_sm_subsystem_ops();
+  gsm_common_ops = get_sm_mini_machines_common_ops();
 
   GameStateMachineState_users_moves_init(&game_sm);
-  GameStateMachineState_users_moves_append(&game_sm, default_user_move);
+  memset(game_sm.board, 0, sizeof(game_sm.board));
+  gsm_common_ops->add_move(&game_sm, default_user_move);
   game_sm.current_state = GameStatePlay;
   game_sm.current_user = 0;
 
@@ -78,30 +84,82 @@ int game_sm_init(void) {
 }
 
 int game_sm_step(enum InputEvents input_event, input_device_id_t device_id) {
+  struct GameStateMachineInput input = {.input_event = input_event,
+                                        .device_id = device_id};
   int err;
 
-  logging_ops->log_info(gsm_module_id, "Event %d User %d", input_event,
+  err = gsm_priv_ops->validate_input(input);
+  if (err) {
+    return err;
+  }
+
+  return gsm_priv_ops->advance(input);
+}
+
+// Events are applied one after another, but board is displayed only once,
+//  after the last of them. Events which are not valid in the moment they are
+//  processed (f.e. another user's keys) are skipped, like in single step.
+int game_sm_step_batch(const enum InputEvents *input_events,
+                       size_t input_events_length,
+                       input_device_id_t device_id) {
+  struct GameStateMachineInput input;
+  int err;
+
+  if (!input_events) {
+    return EINVAL;
+  }
+
+  for (size_t i = 0; i < input_events_length; i++) {
+    if (game_sm.current_state == GameStateQuit) {
+      logging_ops->log_info(gsm_module_id, "Dropping %zu events after quit",
+                            input_events_length - i);
+      return 0;
+    }
+
+    input = (struct GameStateMachineInput){.input_event = input_events[i],
+                                           .device_id = device_id,
+                                           .is_display_deferred = true};
+
+    if (gsm_priv_ops->validate_input(input)) {
+      continue;
+    }
+
+    err = gsm_priv_ops->advance(input);
+    if (err) {
+      return err;
+    }
+  }
+
+  return gsm_sub_ops->display_state();
+}
+
+static int validate_input(struct GameStateMachineInput input) {
+  int err;
+
+  logging_ops->log_info(gsm_module_id, "Event %d User %d", input.input_event,
                         game_sm.current_user);
 
-  err = gsm_priv_ops->validate_input_event(input_event);
+  err = gsm_priv_ops->validate_input_event(input.input_event);
   if (err) {
     logging_ops->log_err(gsm_module_id, "Invalid input event: %s",
                          strerror(err));
     return err;
   }
 
-  err = gsm_priv_ops->validate_device_id(device_id);
+  err = gsm_priv_ops->validate_device_id(input.device_id);
   if (err) {
     logging_ops->log_err(gsm_module_id, "Invalid device id %d for user %d: %s",
-                         device_id, game_sm.current_user, strerror(err));
+                         input.device_id, game_sm.current_user, strerror(err));
     return err;
   }
 
-  // Make compiler happy
-  err = gsm_sub_ops->next_state(
-      (struct GameStateMachineInput){.input_event = input_event,
-                                     .device_id = device_id},
-      &game_sm);
+  return 0;
+}
+
+static int advance(struct GameStateMachineInput input) {
+  int err;
+
+  err = gsm_sub_ops->next_state(input, &game_sm);
   if (err) {
     logging_ops->log_err(gsm_module_id, "Unable to get next gsm state: %s",
                          strerror(err));
@@ -146,6 +204,8 @@ static struct GameStateMachineState *get_state(void) { return &game_sm; };
  *    MODULARITY BOILERCODE
  ******************************************************************************/
 static struct GameStateMachinePrivOps game_sm_priv_ops = {
+    .validate_input = validate_input,
+    .advance = advance,
     .validate_input_event = validate_input_event,
     .validate_device_id = validate_device_id,
 };
@@ -153,6 +213,7 @@ static struct GameStateMachinePrivOps game_sm_priv_ops = {
 struct GameStateMachineOps game_sm_ops = {
     .init = game_sm_init,
     .step = game_sm_step,
+    .step_batch = game_sm_step_batch,
     .get_state = get_state,
 };
 
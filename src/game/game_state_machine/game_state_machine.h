@@ -11,6 +11,8 @@
 /*******************************************************************************
  *    IMPORTS
  ******************************************************************************/
+#include <stdbool.h>
+
 #include "input/input_common.h"
 #include "static_array_lib.h"
 
@@ -28,14 +30,33 @@
  ******************************************************************************/
 #define MAX_USERS_MOVES 1000
 #define MAX_USERS 10
+#define GAME_BOARD_XY_MAX (MAX_USERS + 1)
+
+enum GameBoardCellFlags {
+  GAME_BOARD_CELL_TAKEN = 1 << 0,
+  GAME_BOARD_CELL_HIGHLIGHT = 1 << 1,
+  GAME_BOARD_CELL_INVALID = 1 << 2,
+};
+
+// Owner is meaningful only for taken cells, zeroed cell is an empty one.
+struct GameBoardCell {
+  game_user_id_t owner;
+  unsigned int flags;
+};
 
 struct GameStateMachineInput {
   enum InputEvents input_event;
   input_device_id_t device_id;
+  // Set for all but the last event of a batch, board is drawn once per batch.
+  bool is_display_deferred;
 };
 
 struct GameStateMachineState {
   SARRS_FIELD(users_moves, struct UserMove, MAX_USERS_MOVES);
+  // Dense, row-major view of users moves. It is kept in sync with users
+  //  moves by common add_move and delete_last_move, so moves should not be
+  //  added or deleted in any other way.
+  struct GameBoardCell board[GAME_BOARD_XY_MAX][GAME_BOARD_XY_MAX];
   game_user_id_t current_user;
   enum GameStates current_state;
 };
@@ -43,6 +64,7 @@ struct GameStateMachineState {
 struct GameStateMachineOps {
   int (*init)(void);
   input_callback_func_t step;
+  input_batch_callback_func_t step_batch;
   struct GameStateMachineState *(*get_state)(void);
 };
 
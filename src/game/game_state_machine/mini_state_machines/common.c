@@ -35,17 +35,52 @@ static struct UserMove *get_last_move(struct GameStateMachineState *state) {
   return &(state->users_moves[state->users_moves_offset - 1]);
 }
 
+static struct GameBoardCell *get_move_cell(struct GameStateMachineState *state,
+                                           struct UserMove *user_move) {
+  int x = user_move->coordinates.x;
+  int y = user_move->coordinates.y;
+
+  if (x < 0 || x >= GAME_BOARD_XY_MAX || y < 0 || y >= GAME_BOARD_XY_MAX) {
+    return NULL;
+  }
+
+  return &state->board[y][x];
+}
+
 static int add_move(struct GameStateMachineState *state,
                     struct UserMove user_move) {
+  struct GameBoardCell *cell;
+
   if (!state || state->users_moves_offset + 1 > MAX_USERS_MOVES)
     return EINVAL;
 
+  cell = get_move_cell(state, &user_move);
+  if (!cell)
+    return EINVAL;
+
+  switch (user_move.type) {
+  case USER_MOVE_TYPE_SELECT_VALID:
+    cell->owner = user_move.user_id;
+    cell->flags |= GAME_BOARD_CELL_TAKEN;
+    break;
+  case USER_MOVE_TYPE_HIGHLIGHT:
+    cell->flags |= GAME_BOARD_CELL_HIGHLIGHT;
+    break;
+  case USER_MOVE_TYPE_SELECT_INVALID:
+    cell->flags |= GAME_BOARD_CELL_INVALID;
+    break;
+  case USER_MOVE_TYPE_QUIT:
+    break;
+  }
+
   state->users_moves[state->users_moves_offset++] = user_move;
 
   return 0;
 };
 
 static int delete_last_move(struct GameStateMachineState *state) {
+  struct GameBoardCell *cell;
+  struct UserMove *last_move;
 
   if (!state)
     return EINVAL;
@@ -53,6 +88,27 @@ static int delete_last_move(struct GameStateMachineState *state) {
   if (state->users_moves_offset == 0)
     return 0;
 
+  // Only one highlight or invalid move lives on the list at a time, so
+  //  clearing the flag is enough to undo it.
+  last_move = &state->users_moves[state->users_moves_offset - 1];
+  cell = get_move_cell(state, last_move);
+  if (cell) {
+    switch (last_move->type) {
+    case USER_MOVE_TYPE_SELECT_VALID:
+      cell->owner = 0;
+      cell->flags &= ~GAME_BOARD_CELL_TAKEN;
+      break;
+    case USER_MOVE_TYPE_HIGHLIGHT:
+      cell->flags &= ~GAME_BOARD_CELL_HIGHLIGHT;
+      break;
+    case USER_MOVE_TYPE_SELECT_INVALID:
+      cell->flags &= ~GAME_BOARD_CELL_INVALID;
+      break;
+    case USER_MOVE_TYPE_QUIT:
+      break;
+    }
+  }
+
   state->users_moves_offset--;
 
   return 0;
@@ -64,10 +64,21 @@ int display_state_machine_init(void) {
 
 int display_state_machine_next_state(struct GameStateMachineInput input,
                                      struct GameStateMachineState *state) {
+  struct UserMove *last_move = gsm_common_ops->get_last_move(state);
   int display_id;
   int users_amount;
   int err;
 
+  // Game was stopped during this step, last frame stays on the screen.
+  if (state->current_state == GameStateQuit) {
+    return 0;
+  }
+
+  // Rest of the batch is still waiting, it will be displayed at once.
+  if (input.is_display_deferred) {
+    return 0;
+  }
+
   err = game_config_ops->get_display_id(&display_id);
   if (err) {
     return err;
@@ -80,11 +91,12 @@ int display_state_machine_next_state(struct GameStateMachineInput input,
 
   struct DisplayData display_data = {
       .game_state = state->current_state,
-      .moves = state->users_moves,
-      .moves_length = state->users_moves_offset,
+      .cells = (const struct GameBoardCell(*)[GAME_BOARD_XY_MAX])state->board,
       .user_id = state->current_user,
       .display_id = display_id,
       .board_xy = users_amount + 1,
+      .cursor = last_move ? last_move->coordinates
+                          : (struct UserMoveCoordinates){0},
   };
 
   err = display_ops->display(&display_data);
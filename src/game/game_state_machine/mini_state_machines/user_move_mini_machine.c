@@ -19,6 +19,7 @@
 #include "game/game_state_machine/game_sm_subsystem.h"
 #include "game/game_state_machine/game_state_machine.h"
 #include "game/game_state_machine/game_states.h"
+#include "game/game_state_machine/mini_state_machines/common.h"
 #include "game/game_state_machine/mini_state_machines/user_move_mini_machine.h"
 #include "game/user_move.h"
 #include "init/init.h"
@@ -56,6 +57,7 @@ struct GameSmUserMoveModulePrivateOps {
 static struct LoggingUtilsOps *logging_ops;
 static struct GameConfigOps *game_config_ops;
 static struct GameSmSubsystemOps *gsm_sub_ops;
+static struct GameStateMachineCommonOps *gsm_common_ops;
 static char module_id[] = "user_move_sm_module";
 static struct UserMoveStateMachineState user_move_state_machine;
 static struct GameSmUserMoveModulePrivateOps *user_move_priv_ops;
@@ -70,6 +72,7 @@ int user_move_state_machine_init(void) {
   game_config_ops = get_game_config_ops();
   logging_ops = get_logging_utils_ops();
   gsm_sub_ops = get_game_sm_subsystem_ops();
+  gsm_common_ops = get_sm_mini_machines_common_ops();
   user_move_priv_ops = get_user_move_priv_ops();
 
   user_move_priv_ops->set_default_state();
@@ -145,7 +148,11 @@ int user_move_state_machine_next_state(struct GameStateMachineInput input,
   new_user_move.coordinates.x = coordinates->x;
   new_user_move.coordinates.y = coordinates->y;
 
-  state->users_moves[state->users_moves_offset++] = new_user_move;
+  err = gsm_common_ops->add_move(state, new_user_move);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to add move: %s", strerror(err));
+    return err;
+  }
 
   return 0;
 }
@@ -23,6 +23,7 @@
 #include "game/game_state_machine/game_states.h"
 #include "game/game_state_machine/mini_state_machines/common.h"
 #include "game/game_state_machine/mini_state_machines/win_mini_machine.h"
+#include "game/game_win.h"
 #include "game/user_move.h"
 #include "init/init.h"
 #include "input/input.h"
@@ -34,26 +35,21 @@
 struct GameSmWinModulePrivateOps {
   int (*next_state)(struct GameStateMachineInput input,
                     struct GameStateMachineState *state);
-  bool (*process_vertical_win)(struct UserMove *current_user_move, size_t n,
-                               struct UserMove users_moves[n],
-                               size_t users_amount);
-  bool (*process_horizontal_win)(struct UserMove *current_user_move, size_t n,
-                                 struct UserMove users_moves[n],
-                                 size_t users_amount);
-  bool (*process_diagonal_win)(struct UserMove *current_user_move, size_t n,
-                               struct UserMove users_moves[n],
-                               size_t users_amount);
-  bool (*process_diagonal_win_a)(struct UserMove *current_user_move, size_t n,
-                                 struct UserMove users_moves[n],
-                                 size_t users_amount);
-  bool (*process_diagonal_win_b)(struct UserMove *current_user_move, size_t n,
-                                 struct UserMove users_moves[n],
-                                 size_t users_amount);
+  bool (*is_win)(struct GameStateMachineState *state,
+                 struct UserMove *current_user_move, size_t users_amount);
 };
+
+// Board as seen by the win rule, cells owned by the user who moved last.
+struct GameSmWinBoard {
+  struct GameStateMachineState *state;
+  game_user_id_t user_id;
+};
+
 static char gsm_win_module_id[] = "win_sm_module";
 static struct GameStateMachineCommonOps *gsm_common_ops;
 static struct GameConfigOps *game_config_ops;
 static struct GameOps *game_ops;
+static struct GameWinOps *game_win_ops;
 static struct GameSmWinModulePrivateOps *win_priv_ops;
 struct GameSmWinModulePrivateOps *get_game_sm_win_module_priv_ops(void);
 
@@ -104,19 +100,7 @@ static int win_state_machine_next_state(struct GameStateMachineInput input,
     return err;
   }
 
-  is_win = win_priv_ops->process_vertical_win(current_user_move,
-                                              state->users_moves_offset - 1,
-                                              state->users_moves, users_amount);
-  if (!is_win) {
-    is_win = win_priv_ops->process_horizontal_win(
-        current_user_move, state->users_moves_offset - 1, state->users_moves,
-        users_amount);
-  }
-  if (!is_win) {
-    is_win = win_priv_ops->process_diagonal_win(
-        current_user_move, state->users_moves_offset - 1, state->users_moves,
-        users_amount);
-  }
+  is_win = win_priv_ops->is_win(state, current_user_move, users_amount);
 
   if (is_win) {
     state->current_state = GameStateWinning;
@@ -126,114 +110,25 @@ static int win_state_machine_next_state(struct GameStateMachineInput input,
   return 0;
 };
 
-static bool
-win_state_machine_process_vertical_win(struct UserMove *current_user_move,
-                                       size_t n, struct UserMove users_moves[n],
-                                       size_t users_amount) {
-  struct UserMove *tmp_user_move;
-  size_t win_moves_counter = 0;
-
-  for (size_t i = 0; i < n; i++) {
-    tmp_user_move = &users_moves[i];
-
-    if (tmp_user_move->user_id == current_user_move->user_id &&
-        tmp_user_move->coordinates.x == current_user_move->coordinates.x) {
-      win_moves_counter++;
-    }
-  }
-
-  return win_moves_counter >= users_amount;
-}
-
-static bool
-win_state_machine_process_horizontal_win(struct UserMove *current_user_move,
-                                         size_t n, struct UserMove *users_moves,
-                                         size_t users_amount) {
-  struct UserMove *tmp_user_move;
-  size_t win_moves_counter = 0;
-
-  for (size_t i = 0; i < n; i++) {
-    tmp_user_move = &users_moves[i];
-
-    if (tmp_user_move->user_id == current_user_move->user_id &&
-        tmp_user_move->coordinates.y == current_user_move->coordinates.y) {
-      win_moves_counter++;
-    }
-  }
-
-  return win_moves_counter >= users_amount;
-}
-
-static bool
-win_state_machine_process_diagonal_win(struct UserMove *current_user_move,
-                                       size_t n, struct UserMove *users_moves,
-                                       size_t users_amount) {
-  bool is_win;
-
-  is_win = win_priv_ops->process_diagonal_win_a(current_user_move, n,
-                                                users_moves, users_amount);
-  if (!is_win) {
-    is_win = win_priv_ops->process_diagonal_win_b(current_user_move, n,
-                                                  users_moves, users_amount);
-  }
+static bool win_state_machine_is_cell_owned(const void *board, int x, int y) {
+  const struct GameSmWinBoard *win_board = board;
+  struct GameBoardCell *cell = &win_board->state->board[y][x];
 
-  return is_win;
+  return (cell->flags & GAME_BOARD_CELL_TAKEN) &&
+         cell->owner == win_board->user_id;
 }
 
-static bool
-win_state_machine_process_diagonal_win_a(struct UserMove *current_user_move,
-                                         size_t n, struct UserMove *users_moves,
-                                         size_t users_amount) {
-  struct UserMove *tmp_user_move;
-  size_t win_moves_counter = 0;
+static bool win_state_machine_is_win(struct GameStateMachineState *state,
+                                     struct UserMove *current_user_move,
+                                     size_t users_amount) {
+  struct GameSmWinBoard board = {.state = state,
+                                 .user_id = current_user_move->user_id};
 
-  for (size_t xy_i = 0; xy_i <= users_amount; xy_i++) {
-    for (size_t i = 0; i < n; i++) {
-      tmp_user_move = &users_moves[i];
-      if (tmp_user_move->user_id == current_user_move->user_id) {
-        if ((tmp_user_move->coordinates.y ==
-                 current_user_move->coordinates.y - xy_i &&
-             tmp_user_move->coordinates.x ==
-                 current_user_move->coordinates.x + xy_i) ||
-            (tmp_user_move->coordinates.y ==
-                 current_user_move->coordinates.y + xy_i &&
-             tmp_user_move->coordinates.x ==
-                 current_user_move->coordinates.x - xy_i)) {
-          win_moves_counter++;
-        }
-      }
-    }
-  }
-
-  return win_moves_counter >= users_amount;
-}
-
-static bool
-win_state_machine_process_diagonal_win_b(struct UserMove *current_user_move,
-                                         size_t n, struct UserMove *users_moves,
-                                         size_t users_amount) {
-  struct UserMove *tmp_user_move;
-  size_t win_moves_counter = 0;
-
-  for (size_t xy_i = 0; xy_i <= users_amount; xy_i++) {
-    for (size_t i = 0; i < n; i++) {
-      tmp_user_move = &users_moves[i];
-      if (tmp_user_move->user_id == current_user_move->user_id) {
-        if ((tmp_user_move->coordinates.y ==
-                 current_user_move->coordinates.y - xy_i &&
-             tmp_user_move->coordinates.x ==
-                 current_user_move->coordinates.x - xy_i) ||
-            (tmp_user_move->coordinates.y ==
-                 current_user_move->coordinates.y + xy_i &&
-             tmp_user_move->coordinates.x ==
-                 current_user_move->coordinates.x + xy_i)) {
-          win_moves_counter++;
-        }
-      }
-    }
-  }
+  game_win_ops = get_game_win_ops();
 
-  return win_moves_counter >= users_amount;
+  return game_win_ops->is_win(&board, users_amount + 1, users_amount,
+                              current_user_move->coordinates,
+                              win_state_machine_is_cell_owned);
 }
 
 /*******************************************************************************
@@ -242,11 +137,7 @@ win_state_machine_process_diagonal_win_b(struct UserMove *current_user_move,
 
 static struct GameSmWinModulePrivateOps private_ops = {
     .next_state = win_state_machine_next_state,
-    .process_horizontal_win = win_state_machine_process_horizontal_win,
-    .process_vertical_win = win_state_machine_process_vertical_win,
-    .process_diagonal_win = win_state_machine_process_diagonal_win,
-    .process_diagonal_win_a = win_state_machine_process_diagonal_win_a,
-    .process_diagonal_win_b = win_state_machine_process_diagonal_win_b,
+    .is_win = win_state_machine_is_win,
 };
 
 static struct GameSmWinModuleOps game_sm_win_ops = {.init =
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * @file game_win.c
+ * @brief Rule deciding whether the last move won the game.
+ *
+ * Only lines crossing the last move can be new, so for each of four
+ * directions owned cells are counted from the last move both ways until
+ * the first foreign cell or the board's edge.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <stdbool.h>
+#include <stddef.h>
+
+// App's internal libs
+#include "game/game_win.h"
+#include "game/user_move.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+struct GameWinPrivateOps {
+  size_t (*count_owned)(const void *board, size_t board_size,
+                        struct UserMoveCoordinates from, int x_step,
+                        int y_step, game_win_is_owned_func_t is_owned);
+};
+
+// Session server checks wins on many threads at once, so ops are bound when
+//  the program loads instead of by init.
+static struct GameWinPrivateOps game_win_priv_ops_;
+static struct GameWinPrivateOps *game_win_priv_ops = &game_win_priv_ops_;
+
+static const int game_win_directions[][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static bool game_win_is_win(const void *board, size_t board_size,
+                            size_t users_amount,
+                            struct UserMoveCoordinates last_move,
+                            game_win_is_owned_func_t is_owned) {
+  size_t directions_length =
+      sizeof(game_win_directions) / sizeof(game_win_directions[0]);
+  size_t length;
+  int x_step;
+  int y_step;
+
+  for (size_t i = 0; i < directions_length; i++) {
+    x_step = game_win_directions[i][0];
+    y_step = game_win_directions[i][1];
+
+    // Last move itself is counted once, both walks start next to it.
+    length = 1 +
+             game_win_priv_ops->count_owned(board, board_size, last_move,
+                                            x_step, y_step, is_owned) +
+             game_win_priv_ops->count_owned(board, board_size, last_move,
+                                            -x_step, -y_step, is_owned);
+    if (length >= users_amount + 1) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static size_t game_win_count_owned(const void *board, size_t board_size,
+                                   struct UserMoveCoordinates from, int x_step,
+                                   int y_step,
+                                   game_win_is_owned_func_t is_owned) {
+  int size = board_size;
+  int x = from.x + x_step;
+  int y = from.y + y_step;
+  size_t count = 0;
+
+  while (x >= 0 && x < size && y >= 0 && y < size && is_owned(board, x, y)) {
+    count++;
+    x += x_step;
+    y += y_step;
+  }
+
+  return count;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct GameWinPrivateOps game_win_priv_ops_ = {
+    .count_owned = game_win_count_owned,
+};
+
+static struct GameWinOps game_win_ops = {
+    .is_win = game_win_is_win,
+};
+
+struct GameWinOps *get_game_win_ops(void) { return &game_win_ops; }
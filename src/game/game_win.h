@@ -0,0 +1,40 @@
+#ifndef GAME_WIN_H
+#define GAME_WIN_H
+/*******************************************************************************
+ * @file game_win.h
+ * @brief Rule deciding whether the last move won the game.
+ *
+ * User wins by owning users amount + 1 cells in a row, column or diagonal
+ * crossing the cell selected last, which on the local game's board is the
+ * whole line. Local game and session server keep their boards in different
+ * shapes, so the rule asks the caller which cells belong to the user.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "game/user_move.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+// Tells whether cell belongs to the user who made the last move, `board` is
+//  passed through untouched. Cells outside of the board are never asked for.
+typedef bool (*game_win_is_owned_func_t)(const void *board, int x, int y);
+
+struct GameWinOps {
+  bool (*is_win)(const void *board, size_t board_size, size_t users_amount,
+                 struct UserMoveCoordinates last_move,
+                 game_win_is_owned_func_t is_owned);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct GameWinOps *get_game_win_ops(void);
+
+#endif // GAME_WIN_H
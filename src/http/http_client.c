@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * @file http_client.c
+ * @brief HTML+JS client served by the HTTP server.
+ *
+ * Client subscribes to state updates over WebSocket and sends every key
+ * or button press as a move of the user chosen on the page. Arrows move
+ * the cursor, enter selects the cell and escape quits, the same as on the
+ * keyboard. Broken WebSocket is reopened, browsers without it poll the
+ * state instead.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <stddef.h>
+
+// App's internal libs
+#include "http/http_client.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define HTTP_CLIENT_POLL_MS "250"
+
+static const char http_client_page[] =
+    "<!DOCTYPE html>\n"
+    "<html>\n"
+    "<head>\n"
+    "<meta charset=\"utf-8\">\n"
+    "<title>Tic Tac Toe</title>\n"
+    "<style>\n"
+    "body{font-family:monospace;margin:2em}\n"
+    "td{width:2em;height:2em;text-align:center;border:1px solid #888}\n"
+    "td.h{background:#ffd}td.i{background:#fcc}\n"
+    "button{width:5em;margin:2px}\n"
+    "</style>\n"
+    "</head>\n"
+    "<body>\n"
+    "<p>Play as user <select id=\"user\"></select> <span id=\"status\">"
+    "</span></p>\n"
+    "<table id=\"board\"></table>\n"
+    "<p>\n"
+    "<button data-e=\"up\">up</button>"
+    "<button data-e=\"down\">down</button>"
+    "<button data-e=\"left\">left</button>"
+    "<button data-e=\"right\">right</button>"
+    "<button data-e=\"select\">select</button>"
+    "<button data-e=\"exit\">exit</button>\n"
+    "</p>\n"
+    "<script>\n"
+    "const marks=' XOABCDEFGHI';\n"
+    "const user=document.getElementById('user');\n"
+    "const board=document.getElementById('board');\n"
+    "const status=document.getElementById('status');\n"
+    "function draw(s){\n"
+    " while(user.options.length<s.board_xy-1)"
+    "user.add(new Option(user.options.length+1));\n"
+    " status.textContent=s.state+', user '+s.user+' moves';\n"
+    " board.innerHTML='';\n"
+    " s.cells.forEach((row,y)=>{const tr=board.insertRow();\n"
+    "  row.forEach((c,x)=>{const td=tr.insertCell();"
+    "td.textContent=marks[c]||c;\n"
+    "   if(s.flags[y][x]&2)td.className='h';"
+    "if(s.flags[y][x]&4)td.className='i';});});\n"
+    "}\n"
+    "let state=null,ws=null;\n"
+    "function update(s){\n"
+    " if(s.cells)state=s;\n"
+    " else if(state){state.state=s.state;state.user=s.user;"
+    "state.cursor=s.cursor;\n"
+    "  s.changes.forEach(([x,y,c,f])=>{state.cells[y][x]=c;"
+    "state.flags[y][x]=f;});}\n"
+    " if(state)draw(state);\n"
+    "}\n"
+    "function poll(){fetch('/api/state').then(r=>r.ok?r.json():null)"
+    ".then(s=>{if(s)update(s);}).catch(()=>{})"
+    ".finally(()=>setTimeout(poll," HTTP_CLIENT_POLL_MS "));}\n"
+    "function subscribe(){\n"
+    " if(!window.WebSocket)return poll();\n"
+    " ws=new WebSocket('ws://'+location.host+'/api/updates');\n"
+    " ws.onmessage=m=>{const s=JSON.parse(m.data);if(!s.error)update(s);};\n"
+    " ws.onclose=()=>{ws=null;setTimeout(subscribe,1000);};\n"
+    "}\n"
+    "function send(e){const m=JSON.stringify({user:+user.value||1,event:e});\n"
+    " if(ws&&ws.readyState===1)ws.send(m);\n"
+    " else fetch('/api/move',{method:'POST',body:m});}\n"
+    "document.querySelectorAll('button').forEach(b=>"
+    "b.onclick=()=>send(b.dataset.e));\n"
+    "const keys={ArrowUp:'up',ArrowDown:'down',ArrowLeft:'left',"
+    "ArrowRight:'right',Enter:'select',Escape:'exit'};\n"
+    "document.onkeydown=k=>{if(keys[k.key]){k.preventDefault();"
+    "send(keys[k.key]);}};\n"
+    "subscribe();\n"
+    "</script>\n"
+    "</body>\n"
+    "</html>\n";
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static const char *http_client_get_page(size_t *length) {
+  if (length) {
+    *length = sizeof(http_client_page) - 1;
+  }
+
+  return http_client_page;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct HttpClientOps http_client_ops = {
+    .get_page = http_client_get_page,
+};
+
+struct HttpClientOps *get_http_client_ops(void) { return &http_client_ops; }
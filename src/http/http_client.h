@@ -0,0 +1,29 @@
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+/*******************************************************************************
+ * @file http_client.h
+ * @brief HTML+JS client served by the HTTP server.
+ *
+ * Page is compiled into the game, so server does not depend on files
+ * installed next to it.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+struct HttpClientOps {
+  const char *(*get_page)(size_t *length);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct HttpClientOps *get_http_client_ops(void);
+
+#endif // HTTP_CLIENT_H
@@ -0,0 +1,465 @@
+/*******************************************************************************
+ * @file http_parser.c
+ * @brief Parser of HTTP/1.1 requests and of moves sent as JSON.
+ *
+ * Only what the game's API needs is understood. Headers other than
+ * Content-Length, Connection and the ones asking for WebSocket are skipped,
+ * chunked bodies are refused.
+ * JSON parser knows only flat object with the move's keys, strings with
+ * escapes are refused, no event name needs them.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <ctype.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <strings.h>
+
+// App's internal libs
+#include "http/http_parser.h"
+#include "input/input_common.h"
+#include "input/input_device.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+// Longest event name with terminating null.
+#define HTTP_EVENT_NAME_MAX 8
+#define HTTP_CONTENT_LENGTH_MAX 1000000
+#define HTTP_MOVE_USER_MAX 1000
+
+struct HttpSlice {
+  const char *data;
+  size_t length;
+};
+
+struct HttpParserPrivateOps {
+  int (*parse_request_line)(struct HttpSlice line,
+                            struct HttpRequest *request);
+  int (*parse_header)(struct HttpSlice line, struct HttpRequest *request);
+  bool (*next_line)(struct HttpSlice *buffer, struct HttpSlice *line);
+  void (*advance)(struct HttpSlice *slice, size_t length);
+  bool (*is_token_eq)(struct HttpSlice token, const char *value);
+  void (*skip_spaces)(struct HttpSlice *json);
+  int (*parse_string)(struct HttpSlice *json, struct HttpSlice *string);
+  int (*parse_event)(struct HttpSlice *json, struct HttpMove *move);
+  int (*parse_user)(struct HttpSlice *json, struct HttpMove *move);
+};
+
+static struct InputDeviceOps *input_device_ops;
+static struct HttpParserPrivateOps *http_parser_priv_ops;
+struct HttpParserPrivateOps *get_http_parser_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int http_parse_request(const char *buffer, size_t length,
+                              struct HttpRequest *request) {
+  struct HttpSlice rest = {.data = buffer, .length = length};
+  struct HttpSlice line;
+  int err;
+
+  if (!buffer || !request) {
+    return EINVAL;
+  }
+
+  http_parser_priv_ops = get_http_parser_priv_ops();
+
+  *request = (struct HttpRequest){0};
+
+  // Empty lines before request line are allowed by RFC 9112.
+  do {
+    if (!http_parser_priv_ops->next_line(&rest, &line)) {
+      return EAGAIN;
+    }
+  } while (line.length == 0);
+
+  err = http_parser_priv_ops->parse_request_line(line, request);
+  if (err) {
+    return err;
+  }
+
+  for (;;) {
+    if (!http_parser_priv_ops->next_line(&rest, &line)) {
+      return EAGAIN;
+    }
+
+    if (line.length == 0) {
+      break;
+    }
+
+    err = http_parser_priv_ops->parse_header(line, request);
+    if (err) {
+      return err;
+    }
+  }
+
+  request->head_length = rest.data - buffer;
+
+  return 0;
+}
+
+static int http_parse_move(const char *body, size_t length,
+                           struct HttpMove *move) {
+  struct HttpSlice json = {.data = body, .length = length};
+  struct HttpSlice key;
+  bool has_user = false;
+  int err;
+
+  if (!body || !move) {
+    return EINVAL;
+  }
+
+  http_parser_priv_ops = get_http_parser_priv_ops();
+  input_device_ops = get_input_device_ops();
+
+  *move = (struct HttpMove){.user = 0};
+
+  http_parser_priv_ops->skip_spaces(&json);
+  if (json.length == 0 || *json.data != '{') {
+    return EINVAL;
+  }
+  http_parser_priv_ops->advance(&json, 1);
+
+  for (;;) {
+    http_parser_priv_ops->skip_spaces(&json);
+    err = http_parser_priv_ops->parse_string(&json, &key);
+    if (err) {
+      return err;
+    }
+
+    http_parser_priv_ops->skip_spaces(&json);
+    if (json.length == 0 || *json.data != ':') {
+      return EINVAL;
+    }
+    http_parser_priv_ops->advance(&json, 1);
+    http_parser_priv_ops->skip_spaces(&json);
+
+    if (http_parser_priv_ops->is_token_eq(key, "user")) {
+      err = http_parser_priv_ops->parse_user(&json, move);
+      has_user = true;
+    } else if (http_parser_priv_ops->is_token_eq(key, "event") ||
+               http_parser_priv_ops->is_token_eq(key, "events")) {
+      err = http_parser_priv_ops->parse_event(&json, move);
+    } else {
+      err = EINVAL;
+    }
+
+    if (err) {
+      return err;
+    }
+
+    http_parser_priv_ops->skip_spaces(&json);
+    if (json.length == 0) {
+      return EINVAL;
+    }
+
+    if (*json.data == ',') {
+      http_parser_priv_ops->advance(&json, 1);
+      continue;
+    }
+
+    if (*json.data != '}') {
+      return EINVAL;
+    }
+    http_parser_priv_ops->advance(&json, 1);
+    break;
+  }
+
+  http_parser_priv_ops->skip_spaces(&json);
+  if (json.length > 0 || !has_user || move->events_length == 0) {
+    return EINVAL;
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int http_parse_request_line(struct HttpSlice line,
+                                   struct HttpRequest *request) {
+  const char *method_end;
+  const char *path_end;
+  const char *version;
+  size_t method_length;
+
+  method_end = memchr(line.data, ' ', line.length);
+  if (!method_end) {
+    return EPROTO;
+  }
+
+  method_length = method_end - line.data;
+
+  if (method_length == 3 && memcmp(line.data, "GET", 3) == 0) {
+    request->method = HTTP_METHOD_GET;
+  } else if (method_length == 4 && memcmp(line.data, "POST", 4) == 0) {
+    request->method = HTTP_METHOD_POST;
+  } else {
+    request->method = HTTP_METHOD_UNKNOWN;
+  }
+
+  request->path = line.data + method_length + 1;
+  path_end =
+      memchr(request->path, ' ', line.data + line.length - request->path);
+  if (!path_end || path_end == request->path) {
+    return EPROTO;
+  }
+
+  request->path_length = path_end - request->path;
+
+  // Query is not used by any endpoint.
+  for (size_t i = 0; i < request->path_length; i++) {
+    if (request->path[i] == '?') {
+      request->path_length = i;
+      break;
+    }
+  }
+
+  version = path_end + 1;
+  if (line.data + line.length - version != 8 ||
+      memcmp(version, "HTTP/1.", 7) != 0) {
+    return EPROTO;
+  }
+
+  // HTTP/1.1 keeps connection open unless asked not to, HTTP/1.0 closes
+  //  it unless asked not to.
+  if (version[7] == '1') {
+    request->is_keep_alive = true;
+  } else if (version[7] == '0') {
+    request->is_keep_alive = false;
+  } else {
+    return EPROTO;
+  }
+
+  return 0;
+}
+
+static int http_parse_header(struct HttpSlice line,
+                             struct HttpRequest *request) {
+  struct HttpSlice name;
+  struct HttpSlice value;
+  const char *colon;
+  size_t content_length;
+
+  colon = memchr(line.data, ':', line.length);
+  if (!colon || colon == line.data) {
+    return EPROTO;
+  }
+
+  name = (struct HttpSlice){.data = line.data, .length = colon - line.data};
+  value = (struct HttpSlice){.data = colon + 1,
+                             .length = line.data + line.length - colon - 1};
+
+  while (value.length > 0 && (*value.data == ' ' || *value.data == '\t')) {
+    http_parser_priv_ops->advance(&value, 1);
+  }
+  while (value.length > 0 && (value.data[value.length - 1] == ' ' ||
+                              value.data[value.length - 1] == '\t')) {
+    value.length--;
+  }
+
+  if (http_parser_priv_ops->is_token_eq(name, "Content-Length")) {
+    if (value.length == 0) {
+      return EPROTO;
+    }
+
+    content_length = 0;
+    for (size_t i = 0; i < value.length; i++) {
+      if (!isdigit((unsigned char)value.data[i])) {
+        return EPROTO;
+      }
+
+      content_length = content_length * 10 + (value.data[i] - '0');
+      if (content_length > HTTP_CONTENT_LENGTH_MAX) {
+        return EPROTO;
+      }
+    }
+
+    request->content_length = content_length;
+  } else if (http_parser_priv_ops->is_token_eq(name, "Connection")) {
+    if (http_parser_priv_ops->is_token_eq(value, "close")) {
+      request->is_keep_alive = false;
+    } else if (http_parser_priv_ops->is_token_eq(value, "keep-alive")) {
+      request->is_keep_alive = true;
+    }
+  } else if (http_parser_priv_ops->is_token_eq(name, "Upgrade")) {
+    request->is_websocket =
+        http_parser_priv_ops->is_token_eq(value, "websocket");
+  } else if (http_parser_priv_ops->is_token_eq(name, "Sec-WebSocket-Key")) {
+    request->websocket_key = value.data;
+    request->websocket_key_length = value.length;
+  } else if (http_parser_priv_ops->is_token_eq(name, "Transfer-Encoding")) {
+    return EPROTO;
+  }
+
+  return 0;
+}
+
+// Line ends with LF, optionally preceded by CR, which is not part of line.
+static bool http_next_line(struct HttpSlice *buffer, struct HttpSlice *line) {
+  const char *end;
+
+  end = memchr(buffer->data, '\n', buffer->length);
+  if (!end) {
+    return false;
+  }
+
+  line->data = buffer->data;
+  line->length = end - buffer->data;
+  if (line->length > 0 && line->data[line->length - 1] == '\r') {
+    line->length--;
+  }
+
+  http_parser_priv_ops->advance(buffer, end + 1 - buffer->data);
+
+  return true;
+}
+
+static void http_advance(struct HttpSlice *slice, size_t length) {
+  slice->data += length;
+  slice->length -= length;
+}
+
+static bool http_is_token_eq(struct HttpSlice token, const char *value) {
+  return strlen(value) == token.length &&
+         strncasecmp(token.data, value, token.length) == 0;
+}
+
+static void http_skip_spaces(struct HttpSlice *json) {
+  while (json->length > 0 && isspace((unsigned char)*json->data)) {
+    http_parser_priv_ops->advance(json, 1);
+  }
+}
+
+static int http_parse_string(struct HttpSlice *json, struct HttpSlice *string) {
+  const char *end;
+
+  if (json->length == 0 || *json->data != '"') {
+    return EINVAL;
+  }
+
+  end = memchr(json->data + 1, '"', json->length - 1);
+  if (!end) {
+    return EINVAL;
+  }
+
+  string->data = json->data + 1;
+  string->length = end - string->data;
+  if (memchr(string->data, '\\', string->length)) {
+    return EINVAL;
+  }
+
+  http_parser_priv_ops->advance(json, end + 1 - json->data);
+
+  return 0;
+}
+
+// Value is either single event or array of them.
+static int http_parse_json_event(struct HttpSlice *json,
+                                 struct HttpMove *move) {
+  char name[HTTP_EVENT_NAME_MAX];
+  struct HttpSlice string;
+  bool is_array = false;
+  int err;
+
+  if (json->length > 0 && *json->data == '[') {
+    http_parser_priv_ops->advance(json, 1);
+    is_array = true;
+  }
+
+  for (;;) {
+    http_parser_priv_ops->skip_spaces(json);
+    err = http_parser_priv_ops->parse_string(json, &string);
+    if (err) {
+      return err;
+    }
+
+    if (string.length >= sizeof(name) ||
+        move->events_length >= HTTP_MOVE_EVENTS_MAX) {
+      return EINVAL;
+    }
+
+    memcpy(name, string.data, string.length);
+    name[string.length] = 0;
+
+    err = input_device_ops->parse_event(
+        name, &move->events[move->events_length]);
+    if (err) {
+      return err;
+    }
+    move->events_length++;
+
+    if (!is_array) {
+      return 0;
+    }
+
+    http_parser_priv_ops->skip_spaces(json);
+    if (json->length == 0) {
+      return EINVAL;
+    }
+
+    if (*json->data == ']') {
+      http_parser_priv_ops->advance(json, 1);
+      return 0;
+    }
+
+    if (*json->data != ',') {
+      return EINVAL;
+    }
+    http_parser_priv_ops->advance(json, 1);
+  }
+}
+
+static int http_parse_user(struct HttpSlice *json, struct HttpMove *move) {
+  int user = 0;
+
+  if (json->length == 0 || !isdigit((unsigned char)*json->data)) {
+    return EINVAL;
+  }
+
+  while (json->length > 0 && isdigit((unsigned char)*json->data)) {
+    user = user * 10 + (*json->data - '0');
+    // No user has so big number, it only could overflow.
+    if (user > HTTP_MOVE_USER_MAX) {
+      return EINVAL;
+    }
+    http_parser_priv_ops->advance(json, 1);
+  }
+
+  move->user = user;
+
+  return 0;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct HttpParserPrivateOps http_parser_priv_ops_ = {
+    .parse_request_line = http_parse_request_line,
+    .parse_header = http_parse_header,
+    .next_line = http_next_line,
+    .advance = http_advance,
+    .is_token_eq = http_is_token_eq,
+    .skip_spaces = http_skip_spaces,
+    .parse_string = http_parse_string,
+    .parse_event = http_parse_json_event,
+    .parse_user = http_parse_user,
+};
+
+struct HttpParserPrivateOps *get_http_parser_priv_ops(void) {
+  return &http_parser_priv_ops_;
+}
+
+static struct HttpParserOps http_parser_ops = {
+    .parse_request = http_parse_request,
+    .parse_move = http_parse_move,
+};
+
+struct HttpParserOps *get_http_parser_ops(void) { return &http_parser_ops; }
@@ -0,0 +1,68 @@
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+/*******************************************************************************
+ * @file http_parser.h
+ * @brief Parser of HTTP/1.1 requests and of moves sent as JSON.
+ *
+ * Parser never allocates and never copies, request only points into the
+ * buffer it was parsed from, so it is valid as long as the buffer is.
+ * Buffer may hold less than whole request, parser then asks for more data,
+ * or more than one request, parser then tells where the first one ends.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "input/input_common.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define HTTP_MOVE_EVENTS_MAX 32
+
+enum HttpMethod {
+  HTTP_METHOD_UNKNOWN = 0,
+  HTTP_METHOD_GET,
+  HTTP_METHOD_POST,
+};
+
+struct HttpRequest {
+  enum HttpMethod method;
+  const char *path;
+  size_t path_length;
+  // Request line and headers, body starts right after them.
+  size_t head_length;
+  size_t content_length;
+  bool is_keep_alive;
+  // Client asks to switch to WebSocket with given key.
+  bool is_websocket;
+  const char *websocket_key;
+  size_t websocket_key_length;
+};
+
+struct HttpMove {
+  int user;
+  enum InputEvents events[HTTP_MOVE_EVENTS_MAX];
+  size_t events_length;
+};
+
+struct HttpParserOps {
+  // Returns 0 once whole head is in the buffer, EAGAIN if it is not yet
+  //  and EPROTO if it is not a valid request. Body may still be missing.
+  int (*parse_request)(const char *buffer, size_t length,
+                       struct HttpRequest *request);
+  // Accepts `{"user": <n>, "event": "<event>"}` or the same with
+  //  `"events": [...]`, events are named as for text input devices.
+  int (*parse_move)(const char *body, size_t length, struct HttpMove *move);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct HttpParserOps *get_http_parser_ops(void);
+
+#endif // HTTP_PARSER_H
@@ -0,0 +1,1436 @@
+/*******************************************************************************
+ * @file http_server.c
+ * @brief HTTP/1.1 server exposing the game to browsers.
+ *
+ * Server works the same way as socket input server, it has no thread of
+ * its own, listening socket and connections are watched from input
+ * subsystem's event loop. Every connection owns fixed request and response
+ * buffers in the connections pool, requests are parsed in place and
+ * responses are composed right into the response buffer, so nothing is
+ * allocated per connection or per request.
+ *
+ * Pipelined requests are answered in order, response buffer is written
+ * once per readiness no matter how many requests it holds. Connection
+ * which does not take its responses is not read until it does.
+ *
+ * Game state is rendered to JSON by display's thread once per frame, the
+ * loop only copies it into responses. Display also encodes WebSocket frame
+ * with what changed since the previous frame and wakes the loop up, which
+ * copies the same frame to every subscriber. Subscriber which does not
+ * keep up misses frames and gets whole state once it catches up.
+ *
+ ******************************************************************************/
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "static_array_lib.h"
+
+// App's internal libs
+#include "config/config.h"
+#include "display/display.h"
+#include "game/game_state_machine/game_state_machine.h"
+#include "game/game_state_machine/game_states.h"
+#include "http/http_client.h"
+#include "http/http_parser.h"
+#include "http/http_server.h"
+#include "http/http_websocket.h"
+#include "input/input.h"
+#include "input/input_common.h"
+#include "input/input_device.h"
+#include "input/input_server.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define HTTP_PORT_MAX 8
+#define HTTP_REQUEST_BUFFER_MAX 4096
+#define HTTP_RESPONSE_BUFFER_MAX 16384
+// Largest single response, request is handled only if there is that much
+//  room left in response buffer.
+#define HTTP_RESPONSE_MAX 8192
+#define HTTP_HEAD_MAX 256
+#define HTTP_STATE_MAX 2048
+#define HTTP_ERROR_MAX 64
+// Published frames which wait for the loop to fan them out.
+#define HTTP_FRAMES_MAX 16
+#define HTTP_FRAME_MAX (HTTP_WEBSOCKET_HEAD_MAX + HTTP_STATE_MAX)
+// Longest message client may send over WebSocket.
+#define HTTP_MESSAGE_MAX 1024
+// Largest reply to client's WebSocket frame.
+#define HTTP_REPLY_MAX (HTTP_WEBSOCKET_HEAD_MAX + HTTP_WEBSOCKET_CONTROL_MAX)
+#define HTTP_CLOSE_PROTOCOL_ERROR 1002
+#define HTTP_CLOSE_UNSUPPORTED 1003
+#define HTTP_CLOSE_TOO_LARGE 1009
+#define HTTP_STATUS_SWITCHING 101
+#define HTTP_STATUS_OK 200
+#define HTTP_STATUS_ACCEPTED 202
+#define HTTP_STATUS_BAD_REQUEST 400
+#define HTTP_STATUS_NOT_FOUND 404
+#define HTTP_STATUS_NOT_ALLOWED 405
+#define HTTP_STATUS_CONFLICT 409
+#define HTTP_STATUS_TOO_LARGE 413
+#define HTTP_STATUS_UNAVAILABLE 503
+#define HTTP_CONTENT_TYPE_JSON "application/json"
+#define HTTP_CONTENT_TYPE_HTML "text/html; charset=utf-8"
+
+_Static_assert(HTTP_STATE_MAX + HTTP_HEAD_MAX <= HTTP_RESPONSE_MAX,
+               "State does not fit into response");
+_Static_assert(HTTP_MESSAGE_MAX + 14 <= HTTP_REQUEST_BUFFER_MAX,
+               "Message does not fit into request");
+_Static_assert(HTTP_SERVER_CONNECTIONS_MAX <= INPUT_SERVER_CONNECTIONS_MAX &&
+                   HTTP_SERVER_USERS_MAX <= INPUT_SERVER_USERS_MAX,
+               "Server does not fit into shared scaffolding");
+
+struct HttpConnection {
+  struct InputWatch watch;
+  char request[HTTP_REQUEST_BUFFER_MAX];
+  size_t request_length;
+  char response[HTTP_RESPONSE_BUFFER_MAX];
+  size_t response_offset;
+  size_t response_length;
+  // Connection is closed once responses written so far are sent.
+  bool is_closing;
+  // Connection switched to WebSocket and receives game's frames.
+  bool is_websocket;
+  // Subscriber missed some frames, it gets whole state instead.
+  bool is_stale;
+};
+
+struct HttpFrame {
+  char data[HTTP_FRAME_MAX];
+  size_t length;
+};
+
+// Written by display's thread, read by loop's thread.
+struct HttpGameState {
+  pthread_mutex_t mutex;
+  char body[HTTP_STATE_MAX];
+  // Zero until the first frame is displayed.
+  size_t body_length;
+  // Encoded frames, n-th published frame is at n % HTTP_FRAMES_MAX.
+  struct HttpFrame frames[HTTP_FRAMES_MAX];
+  uint64_t frames_length;
+  // Display wakes the loop up through it, it is open from init to destroy.
+  int frames_fd;
+};
+
+// Frame deltas are computed against, only display's thread touches it.
+struct HttpPreviousFrame {
+  enum GameStates game_state;
+  int user_id;
+  struct UserMoveCoordinates cursor;
+  // Zero until the first frame is displayed.
+  size_t board_xy;
+  struct GameBoardCell cells[GAME_BOARD_XY_MAX][GAME_BOARD_XY_MAX];
+};
+
+typedef struct HttpServer {
+  char port[HTTP_PORT_MAX];
+  struct InputServer base;
+  struct InputWatch frames_watch;
+  // Published frames up to this one were fanned out to subscribers.
+  uint64_t frames_offset;
+  struct HttpConnection connections[HTTP_SERVER_CONNECTIONS_MAX];
+  // Connections switched to WebSocket.
+  SARRS_FIELD(subscribers, size_t, HTTP_SERVER_CONNECTIONS_MAX);
+  struct HttpServerStats stats;
+  bool is_started;
+} HttpServer;
+
+SARRS_DECL(HttpServer, subscribers, size_t, HTTP_SERVER_CONNECTIONS_MAX);
+
+struct HttpServerPrivateOps {
+  int (*start)(struct HttpServer *server);
+  void (*stop)(struct HttpServer *server);
+  int (*open_connection)(int fd, size_t index);
+  void (*process_connection)(struct InputWatch *watch, uint32_t events);
+  void (*process_frames)(struct InputWatch *watch, uint32_t events);
+  int (*process_requests)(struct HttpServer *server,
+                          struct HttpConnection *connection);
+  void (*process_messages)(struct HttpServer *server,
+                           struct HttpConnection *connection);
+  void (*handle_request)(struct HttpServer *server,
+                         struct HttpConnection *connection,
+                         struct HttpRequest *request, const char *body);
+  void (*handle_state)(struct HttpServer *server,
+                       struct HttpConnection *connection,
+                       struct HttpRequest *request);
+  void (*handle_move)(struct HttpServer *server,
+                      struct HttpConnection *connection,
+                      struct HttpRequest *request, const char *body);
+  void (*handle_upgrade)(struct HttpServer *server,
+                         struct HttpConnection *connection,
+                         struct HttpRequest *request);
+  void (*handle_message)(struct HttpServer *server,
+                         struct HttpConnection *connection,
+                         struct HttpWebsocketFrame *frame);
+  int (*deliver_move)(struct HttpServer *server, struct HttpMove *move,
+                      const char **error);
+  void (*respond)(struct HttpServer *server, struct HttpConnection *connection,
+                  int status, const char *content_type, const char *body,
+                  size_t body_length, bool is_keep_alive);
+  void (*respond_error)(struct HttpServer *server,
+                        struct HttpConnection *connection, int status,
+                        const char *error, bool is_keep_alive);
+  void (*send_frame)(struct HttpConnection *connection,
+                     enum HttpWebsocketOpcode opcode, const char *payload,
+                     size_t payload_length);
+  void (*send_close)(struct HttpConnection *connection, uint16_t code);
+  void (*send_state)(struct HttpServer *server,
+                     struct HttpConnection *connection);
+  void (*fan_out)(struct HttpServer *server);
+  void (*complete)(struct HttpServer *server,
+                   struct HttpConnection *connection);
+  size_t (*get_response_room)(struct HttpConnection *connection);
+  int (*flush)(struct HttpConnection *connection);
+  int (*update_watch)(struct HttpConnection *connection);
+  void (*close_connection)(struct HttpServer *server,
+                           struct HttpConnection *connection);
+  bool (*is_path)(struct HttpRequest *request, const char *path);
+  const char *(*get_status_text)(int status);
+  display_display_func_t display;
+  int (*open_display)(void);
+  void (*close_display)(void);
+  size_t (*render_state)(struct DisplayData *data, char *buffer, size_t size);
+  size_t (*render_delta)(struct DisplayData *data, char *buffer, size_t size);
+  const char *(*get_state_name)(enum GameStates game_state);
+  bool (*is_frame_changed)(struct DisplayData *data);
+  void (*save_frame)(struct DisplayData *data);
+};
+
+static char module_id[] = HTTP_SERVER_DISP_NAME;
+static struct HttpServer http_server;
+static struct HttpGameState http_game_state = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .frames_fd = -1,
+};
+static struct HttpPreviousFrame http_previous_frame;
+static struct InputOps *input_ops;
+static struct ConfigOps *config_ops;
+static struct DisplayOps *display_ops;
+static struct InputServerOps *input_server_ops;
+static struct HttpParserOps *http_parser_ops;
+static struct HttpClientOps *http_client_ops;
+static struct HttpWebsocketOps *http_websocket_ops;
+static struct LoggingUtilsOps *logging_ops;
+static struct HttpServerPrivateOps *http_priv_ops;
+struct HttpServerPrivateOps *get_http_server_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int http_server_start(void);
+static int http_server_stop(void);
+static int http_server_wait(void);
+
+static int http_server_init(void) {
+  char address[INPUT_SERVER_ADDRESS_MAX];
+  int err;
+
+  http_priv_ops = get_http_server_priv_ops();
+  logging_ops = get_logging_utils_ops();
+  config_ops = get_config_ops();
+  input_ops = get_input_ops();
+  display_ops = get_display_ops();
+  input_server_ops = get_input_server_ops();
+  http_parser_ops = get_http_parser_ops();
+  http_client_ops = get_http_client_ops();
+  http_websocket_ops = get_http_websocket_ops();
+
+  http_server.is_started = false;
+  http_game_state.body_length = 0;
+  http_game_state.frames_length = 0;
+  http_previous_frame.board_xy = 0;
+
+  err = config_ops->read_var(HTTP_SERVER_PORT_VAR_NAME,
+                             HTTP_SERVER_PORT_DEFAULT, http_server.port,
+                             sizeof(http_server.port));
+  if (err) {
+    return err;
+  }
+
+  snprintf(address, sizeof(address), "tcp:%s", http_server.port);
+
+  err = input_server_ops->parse_address(&http_server.base, address);
+  if (err) {
+    logging_ops->log_err(module_id, "Invalid %s value: %s",
+                         HTTP_SERVER_PORT_VAR_NAME, http_server.port);
+    return err;
+  }
+
+  err = input_server_ops->init(
+      &http_server.base, HTTP_SERVER_DISP_NAME, HTTP_SERVER_USERS_MAX,
+      HTTP_SERVER_CONNECTIONS_MAX,
+      (struct InputServerHandlers){
+          .start = http_server_start,
+          .stop = http_server_stop,
+          .wait = http_server_wait,
+          .open_connection = http_priv_ops->open_connection,
+      });
+  if (err) {
+    return err;
+  }
+
+  http_game_state.frames_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (http_game_state.frames_fd == -1) {
+    err = errno;
+    logging_ops->log_err(module_id, "Unable to create eventfd: %s",
+                         strerror(err));
+    return err;
+  }
+
+  // Browsers may only watch the game, so server is started by the display
+  //  as well.
+  err = display_ops->add_display(
+      &(struct DisplayDisplay){.display_name = HTTP_SERVER_DISP_NAME,
+                               .display = http_priv_ops->display,
+                               .open = http_priv_ops->open_display,
+                               .close = http_priv_ops->close_display});
+  if (err) {
+    return err;
+  }
+
+  return 0;
+}
+
+static void http_server_destroy(void) {
+  if (http_server.is_started) {
+    http_priv_ops->stop(&http_server);
+  }
+
+  if (http_game_state.frames_fd != -1) {
+    close(http_game_state.frames_fd);
+    http_game_state.frames_fd = -1;
+  }
+}
+
+static void http_server_get_stats(struct HttpServerStats *stats) {
+  if (!stats) {
+    return;
+  }
+
+  *stats = http_server.stats;
+  stats->accepted = http_server.base.accepted;
+  stats->rejected = http_server.base.rejected;
+}
+
+// All users' devices and the display share one server, it is started by
+//  the first of them.
+static int http_server_start(void) {
+  int err;
+
+  err = http_priv_ops->start(&http_server);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to start server on port %s: %s",
+                         http_server.port, strerror(err));
+    return err;
+  }
+
+  return 0;
+}
+
+static int http_server_stop(void) {
+  http_priv_ops->stop(&http_server);
+
+  return 0;
+}
+
+// Server runs on input's loop, input subsystem waits for the loop itself.
+static int http_server_wait(void) { return 0; }
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int http_server_start_server(struct HttpServer *server) {
+  int err;
+
+  if (server->is_started) {
+    return 0;
+  }
+
+  for (size_t i = 0; i < HTTP_SERVER_CONNECTIONS_MAX; i++) {
+    server->connections[i].watch.fd = -1;
+  }
+  HttpServer_subscribers_init(server);
+
+  server->stats = (struct HttpServerStats){0};
+
+  // Frames published so far have nobody to go to.
+  pthread_mutex_lock(&http_game_state.mutex);
+  server->frames_offset = http_game_state.frames_length;
+  pthread_mutex_unlock(&http_game_state.mutex);
+
+  server->frames_watch = (struct InputWatch){
+      .fd = http_game_state.frames_fd,
+      .events = EPOLLIN,
+      .callback = http_priv_ops->process_frames,
+  };
+
+  err = input_ops->add_watch(&server->frames_watch);
+  if (err) {
+    return err;
+  }
+
+  err = input_server_ops->start(&server->base);
+  if (err) {
+    input_ops->remove_watch(&server->frames_watch);
+    return err;
+  }
+
+  err = input_ops->add_watch(&server->base.listen_watch);
+  if (err) {
+    input_server_ops->stop(&server->base);
+    input_ops->remove_watch(&server->frames_watch);
+    return err;
+  }
+
+  server->is_started = true;
+
+  logging_ops->log_info(module_id, "Listening on port %s", server->port);
+
+  return 0;
+}
+
+static void http_server_stop_server(struct HttpServer *server) {
+  if (!server->is_started) {
+    return;
+  }
+
+  server->is_started = false;
+
+  for (size_t i = 0; i < HTTP_SERVER_CONNECTIONS_MAX; i++) {
+    if (server->connections[i].watch.fd != -1) {
+      http_priv_ops->close_connection(server, &server->connections[i]);
+    }
+  }
+
+  input_server_ops->stop(&server->base);
+
+  input_ops->remove_watch(&server->frames_watch);
+
+  logging_ops->log_info(module_id,
+                        "Accepted %zu clients, rejected %zu, served %zu "
+                        "requests, received %zu events, %zu errors, "
+                        "upgraded %zu clients, sent %zu frames",
+                        server->base.accepted, server->base.rejected,
+                        server->stats.requests, server->stats.events,
+                        server->stats.errors, server->stats.upgrades,
+                        server->stats.frames);
+}
+
+static int http_server_open_connection(int fd, size_t index) {
+  struct HttpConnection *connection = &http_server.connections[index];
+  int err;
+
+  connection->watch = (struct InputWatch){
+      .fd = fd,
+      .events = EPOLLIN | EPOLLRDHUP,
+      .callback = http_priv_ops->process_connection,
+  };
+  connection->request_length = 0;
+  connection->response_offset = 0;
+  connection->response_length = 0;
+  connection->is_closing = false;
+  connection->is_websocket = false;
+  connection->is_stale = false;
+
+  err = input_ops->add_watch(&connection->watch);
+  if (err) {
+    connection->watch.fd = -1;
+    return err;
+  }
+
+  return 0;
+}
+
+static void http_server_process_connection(struct InputWatch *watch,
+                                           uint32_t events) {
+  struct HttpConnection *connection =
+      INPUT_WATCH_CONTAINER(watch, struct HttpConnection, watch);
+  struct HttpServer *server = &http_server;
+  ssize_t bytes_read;
+  int err;
+
+  if (!server->is_started) {
+    return;
+  }
+
+  if (events & EPOLLOUT) {
+    err = http_priv_ops->flush(connection);
+    if (err) {
+      goto error;
+    }
+  }
+
+  // Connection is read only once all responses are taken, otherwise
+  //  client could make server buffer unlimited amount of responses.
+  if (connection->response_length == 0 && !connection->is_closing &&
+      (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+    bytes_read =
+        read(watch->fd, connection->request + connection->request_length,
+             sizeof(connection->request) - connection->request_length);
+    if (bytes_read == -1 &&
+        (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+      return;
+    }
+
+    // Peer closed connection or it broke, nobody would read the responses.
+    if (bytes_read <= 0) {
+      goto error;
+    }
+
+    connection->request_length += bytes_read;
+  }
+
+  err = http_priv_ops->process_requests(server, connection);
+  if (err) {
+    goto error;
+  }
+
+  http_priv_ops->complete(server, connection);
+
+  return;
+
+error:
+  http_priv_ops->close_connection(server, connection);
+}
+
+// Display published new frames.
+static void http_server_process_frames(struct InputWatch *watch,
+                                       uint32_t events) {
+  struct HttpServer *server =
+      INPUT_WATCH_CONTAINER(watch, struct HttpServer, frames_watch);
+  eventfd_t value;
+  (void)events;
+
+  eventfd_read(watch->fd, &value);
+
+  if (!server->is_started) {
+    return;
+  }
+
+  http_priv_ops->fan_out(server);
+}
+
+// Handles every complete request in the buffer, as long as there is room
+//  for its response.
+static int http_server_process_requests(struct HttpServer *server,
+                                        struct HttpConnection *connection) {
+  struct HttpRequest request;
+  size_t request_length;
+  size_t offset = 0;
+  int err;
+
+  if (connection->is_websocket) {
+    http_priv_ops->process_messages(server, connection);
+    return 0;
+  }
+
+  while (offset < connection->request_length && !connection->is_closing &&
+         !connection->is_websocket) {
+    if (http_priv_ops->get_response_room(connection) < HTTP_RESPONSE_MAX) {
+      break;
+    }
+
+    err = http_parser_ops->parse_request(connection->request + offset,
+                                         connection->request_length - offset,
+                                         &request);
+    if (err == EAGAIN) {
+      // Head which does not fit into the buffer would never be complete.
+      if (offset == 0 &&
+          connection->request_length == sizeof(connection->request)) {
+        http_priv_ops->respond_error(server, connection, HTTP_STATUS_TOO_LARGE,
+                                     "request too large", false);
+      }
+      break;
+    }
+
+    if (err) {
+      http_priv_ops->respond_error(server, connection, HTTP_STATUS_BAD_REQUEST,
+                                   "bad request", false);
+      break;
+    }
+
+    request_length = request.head_length + request.content_length;
+    if (request_length > sizeof(connection->request)) {
+      http_priv_ops->respond_error(server, connection, HTTP_STATUS_TOO_LARGE,
+                                   "request too large", false);
+      break;
+    }
+
+    // Body is still on its way.
+    if (connection->request_length - offset < request_length) {
+      break;
+    }
+
+    http_priv_ops->handle_request(server, connection, &request,
+                                  connection->request + offset +
+                                      request.head_length);
+    server->stats.requests++;
+
+    offset += request_length;
+  }
+
+  memmove(connection->request, connection->request + offset,
+          connection->request_length - offset);
+  connection->request_length -= offset;
+
+  // Client may send messages right after the handshake.
+  if (connection->is_websocket) {
+    http_priv_ops->process_messages(server, connection);
+  }
+
+  return 0;
+}
+
+// Handles every complete WebSocket message in the buffer, as long as there
+//  is room for a reply.
+static void http_server_process_messages(struct HttpServer *server,
+                                         struct HttpConnection *connection) {
+  struct HttpWebsocketFrame frame;
+  size_t offset = 0;
+  int err;
+
+  while (offset < connection->request_length && !connection->is_closing) {
+    if (http_priv_ops->get_response_room(connection) < HTTP_REPLY_MAX) {
+      break;
+    }
+
+    err = http_websocket_ops->parse_frame(connection->request + offset,
+                                          connection->request_length - offset,
+                                          HTTP_MESSAGE_MAX, &frame);
+    if (err == EAGAIN) {
+      break;
+    }
+
+    if (err) {
+      server->stats.errors++;
+      http_priv_ops->send_close(connection, err == EMSGSIZE
+                                                ? HTTP_CLOSE_TOO_LARGE
+                                                : HTTP_CLOSE_PROTOCOL_ERROR);
+      break;
+    }
+
+    http_priv_ops->handle_message(server, connection, &frame);
+    server->stats.requests++;
+
+    offset += frame.frame_length;
+  }
+
+  memmove(connection->request, connection->request + offset,
+          connection->request_length - offset);
+  connection->request_length -= offset;
+}
+
+static void http_server_handle_request(struct HttpServer *server,
+                                       struct HttpConnection *connection,
+                                       struct HttpRequest *request,
+                                       const char *body) {
+  const char *page;
+  size_t page_length;
+
+  if (http_priv_ops->is_path(request, "/") ||
+      http_priv_ops->is_path(request, "/index.html")) {
+    if (request->method != HTTP_METHOD_GET) {
+      goto not_allowed;
+    }
+
+    page = http_client_ops->get_page(&page_length);
+    http_priv_ops->respond(server, connection, HTTP_STATUS_OK,
+                           HTTP_CONTENT_TYPE_HTML, page, page_length,
+                           request->is_keep_alive);
+    return;
+  }
+
+  if (http_priv_ops->is_path(request, "/api/state")) {
+    if (request->method != HTTP_METHOD_GET) {
+      goto not_allowed;
+    }
+
+    http_priv_ops->handle_state(server, connection, request);
+    return;
+  }
+
+  if (http_priv_ops->is_path(request, "/api/move")) {
+    if (request->method != HTTP_METHOD_POST) {
+      goto not_allowed;
+    }
+
+    http_priv_ops->handle_move(server, connection, request, body);
+    return;
+  }
+
+  if (http_priv_ops->is_path(request, "/api/updates")) {
+    if (request->method != HTTP_METHOD_GET) {
+      goto not_allowed;
+    }
+
+    http_priv_ops->handle_upgrade(server, connection, request);
+    return;
+  }
+
+  http_priv_ops->respond_error(server, connection, HTTP_STATUS_NOT_FOUND,
+                               "not found", request->is_keep_alive);
+  return;
+
+not_allowed:
+  http_priv_ops->respond_error(server, connection, HTTP_STATUS_NOT_ALLOWED,
+                               "method not allowed", request->is_keep_alive);
+}
+
+static void http_server_handle_state(struct HttpServer *server,
+                                     struct HttpConnection *connection,
+                                     struct HttpRequest *request) {
+  struct HttpGameState *state = &http_game_state;
+
+  pthread_mutex_lock(&state->mutex);
+
+  if (state->body_length == 0) {
+    pthread_mutex_unlock(&state->mutex);
+    http_priv_ops->respond_error(server, connection, HTTP_STATUS_UNAVAILABLE,
+                                 "no state displayed yet",
+                                 request->is_keep_alive);
+    return;
+  }
+
+  http_priv_ops->respond(server, connection, HTTP_STATUS_OK,
+                         HTTP_CONTENT_TYPE_JSON, state->body,
+                         state->body_length, request->is_keep_alive);
+
+  pthread_mutex_unlock(&state->mutex);
+}
+
+static void http_server_handle_move(struct HttpServer *server,
+                                    struct HttpConnection *connection,
+                                    struct HttpRequest *request,
+                                    const char *body) {
+  struct HttpMove move;
+  const char *error;
+  char response[64];
+  int length;
+  int status;
+  int err;
+
+  err = http_parser_ops->parse_move(body, request->content_length, &move);
+  if (err) {
+    http_priv_ops->respond_error(server, connection, HTTP_STATUS_BAD_REQUEST,
+                                 "invalid move", request->is_keep_alive);
+    return;
+  }
+
+  status = http_priv_ops->deliver_move(server, &move, &error);
+  if (status) {
+    http_priv_ops->respond_error(server, connection, status, error,
+                                 request->is_keep_alive);
+    return;
+  }
+
+  length = snprintf(response, sizeof(response), "{\"events\":%zu}",
+                    move.events_length);
+
+  http_priv_ops->respond(server, connection, HTTP_STATUS_ACCEPTED,
+                         HTTP_CONTENT_TYPE_JSON, response, length,
+                         request->is_keep_alive);
+}
+
+static void http_server_handle_upgrade(struct HttpServer *server,
+                                      struct HttpConnection *connection,
+                                      struct HttpRequest *request) {
+  char accept[HTTP_WEBSOCKET_ACCEPT_MAX];
+  int length;
+
+  if (!request->is_websocket ||
+      http_websocket_ops->get_accept_key(request->websocket_key,
+                                         request->websocket_key_length,
+                                         accept)) {
+    http_priv_ops->respond_error(server, connection, HTTP_STATUS_BAD_REQUEST,
+                                 "websocket expected", request->is_keep_alive);
+    return;
+  }
+
+  length = snprintf(connection->response + connection->response_length,
+                    HTTP_HEAD_MAX,
+                    "HTTP/1.1 %d %s\r\n"
+                    "Upgrade: websocket\r\n"
+                    "Connection: Upgrade\r\n"
+                    "Sec-WebSocket-Accept: %s\r\n"
+                    "\r\n",
+                    HTTP_STATUS_SWITCHING,
+                    http_priv_ops->get_status_text(HTTP_STATUS_SWITCHING),
+                    accept);
+  if (length < 0 || length >= HTTP_HEAD_MAX) {
+    connection->is_closing = true;
+    return;
+  }
+
+  connection->response_length += length;
+
+  // There is subscriber slot for every connection.
+  HttpServer_subscribers_append(server, connection - server->connections);
+  connection->is_websocket = true;
+  // New subscriber starts with whole state.
+  connection->is_stale = true;
+
+  server->stats.upgrades++;
+}
+
+static void http_server_handle_message(struct HttpServer *server,
+                                       struct HttpConnection *connection,
+                                       struct HttpWebsocketFrame *frame) {
+  char response[HTTP_ERROR_MAX];
+  struct HttpMove move;
+  const char *error;
+  int length;
+  int status;
+
+  switch (frame->opcode) {
+  case HTTP_WEBSOCKET_TEXT:
+    // Messages are short, client has no reason to fragment them.
+    if (!frame->is_final) {
+      break;
+    }
+
+    if (http_parser_ops->parse_move(frame->payload, frame->payload_length,
+                                    &move)) {
+      status = HTTP_STATUS_BAD_REQUEST;
+      error = "invalid move";
+    } else {
+      status = http_priv_ops->deliver_move(server, &move, &error);
+    }
+
+    // Accepted move shows up in the next frame, only errors are replied.
+    if (status) {
+      server->stats.errors++;
+      length = snprintf(response, sizeof(response), "{\"error\":\"%s\"}",
+                        error);
+      if (length > 0 && (size_t)length < sizeof(response)) {
+        http_priv_ops->send_frame(connection, HTTP_WEBSOCKET_TEXT, response,
+                                  length);
+      }
+    }
+    return;
+
+  case HTTP_WEBSOCKET_PING:
+    http_priv_ops->send_frame(connection, HTTP_WEBSOCKET_PONG, frame->payload,
+                              frame->payload_length);
+    return;
+
+  case HTTP_WEBSOCKET_PONG:
+    return;
+
+  case HTTP_WEBSOCKET_CLOSE:
+    // Client's status code is echoed back, as RFC 6455 suggests.
+    http_priv_ops->send_frame(connection, HTTP_WEBSOCKET_CLOSE, frame->payload,
+                              frame->payload_length < 2 ? 0 : 2);
+    connection->is_closing = true;
+    return;
+
+  default:
+    break;
+  }
+
+  server->stats.errors++;
+  http_priv_ops->send_close(connection, HTTP_CLOSE_UNSUPPORTED);
+}
+
+// Returns 0 if users' device took the events, otherwise HTTP status and
+//  error explaining it.
+static int http_server_deliver_move(struct HttpServer *server,
+                                    struct HttpMove *move,
+                                    const char **error) {
+  struct InputServerUser *user;
+  int err = 0;
+
+  // User does not play over HTTP, nobody would take the events.
+  if (move->user < 1 || move->user > HTTP_SERVER_USERS_MAX ||
+      !server->base.users[move->user - 1].callback) {
+    *error = "user does not play over http";
+    return HTTP_STATUS_CONFLICT;
+  }
+
+  user = &server->base.users[move->user - 1];
+
+  if (user->batch_callback) {
+    err = user->batch_callback(move->events, move->events_length,
+                               user->device_id);
+  } else {
+    for (size_t i = 0; i < move->events_length && !err; i++) {
+      err = user->callback(move->events[i], user->device_id);
+    }
+  }
+
+  if (err) {
+    *error = "game is busy";
+    return HTTP_STATUS_UNAVAILABLE;
+  }
+
+  server->stats.events += move->events_length;
+
+  return 0;
+}
+
+// Caller makes sure there is HTTP_RESPONSE_MAX of room in the buffer.
+static void http_server_respond(struct HttpServer *server,
+                                struct HttpConnection *connection, int status,
+                                const char *content_type, const char *body,
+                                size_t body_length, bool is_keep_alive) {
+  char *response = connection->response + connection->response_length;
+  int length;
+
+  if (status >= HTTP_STATUS_BAD_REQUEST) {
+    server->stats.errors++;
+  }
+
+  length = snprintf(response, HTTP_HEAD_MAX,
+                    "HTTP/1.1 %d %s\r\n"
+                    "Content-Type: %s\r\n"
+                    "Content-Length: %zu\r\n"
+                    "Connection: %s\r\n"
+                    "\r\n",
+                    status, http_priv_ops->get_status_text(status),
+                    content_type, body_length,
+                    is_keep_alive ? "keep-alive" : "close");
+  if (length < 0 || length >= HTTP_HEAD_MAX ||
+      length + body_length > HTTP_RESPONSE_MAX) {
+    logging_ops->log_err(module_id, "Response %d does not fit", status);
+    connection->is_closing = true;
+    return;
+  }
+
+  memcpy(response + length, body, body_length);
+  connection->response_length += length + body_length;
+
+  if (!is_keep_alive) {
+    connection->is_closing = true;
+  }
+}
+
+static void http_server_respond_error(struct HttpServer *server,
+                                      struct HttpConnection *connection,
+                                      int status, const char *error,
+                                      bool is_keep_alive) {
+  char body[HTTP_ERROR_MAX];
+  int length;
+
+  length = snprintf(body, sizeof(body), "{\"error\":\"%s\"}", error);
+  if (length < 0 || (size_t)length >= sizeof(body)) {
+    length = 0;
+  }
+
+  http_priv_ops->respond(server, connection, status, HTTP_CONTENT_TYPE_JSON,
+                         body, length, is_keep_alive);
+}
+
+// Caller makes sure there is HTTP_REPLY_MAX of room in the buffer.
+static void http_server_send_frame(struct HttpConnection *connection,
+                                   enum HttpWebsocketOpcode opcode,
+                                   const char *payload,
+                                   size_t payload_length) {
+  char *response = connection->response + connection->response_length;
+  size_t head_length;
+
+  head_length =
+      http_websocket_ops->compose_head(opcode, payload_length, response);
+  memcpy(response + head_length, payload, payload_length);
+  connection->response_length += head_length + payload_length;
+}
+
+static void http_server_send_close(struct HttpConnection *connection,
+                                   uint16_t code) {
+  char payload[2] = {(char)(code >> 8), (char)(code & 0xFF)};
+
+  http_priv_ops->send_frame(connection, HTTP_WEBSOCKET_CLOSE, payload,
+                            sizeof(payload));
+  connection->is_closing = true;
+}
+
+// Stale subscriber gets whole state once there is room for it, which
+//  makes up for all frames it missed.
+static void http_server_send_state(struct HttpServer *server,
+                                   struct HttpConnection *connection) {
+  struct HttpGameState *state = &http_game_state;
+  char *response;
+  size_t head_length;
+
+  if (http_priv_ops->get_response_room(connection) < HTTP_FRAME_MAX) {
+    return;
+  }
+
+  response = connection->response + connection->response_length;
+
+  pthread_mutex_lock(&state->mutex);
+
+  // Nothing was displayed yet, the first frame will be whole state anyway.
+  if (state->body_length > 0) {
+    head_length = http_websocket_ops->compose_head(
+        HTTP_WEBSOCKET_TEXT, state->body_length, response);
+    memcpy(response + head_length, state->body, state->body_length);
+    connection->response_length += head_length + state->body_length;
+    server->stats.frames++;
+  }
+
+  pthread_mutex_unlock(&state->mutex);
+
+  connection->is_stale = false;
+}
+
+// Every published frame is copied as it is to every subscriber which has
+//  room for it.
+static void http_server_fan_out(struct HttpServer *server) {
+  struct HttpGameState *state = &http_game_state;
+  struct HttpConnection *connection;
+  struct HttpFrame *frame;
+  size_t i;
+
+  pthread_mutex_lock(&state->mutex);
+
+  // Display overwrote frames before the loop got to them.
+  if (state->frames_length - server->frames_offset > HTTP_FRAMES_MAX) {
+    server->frames_offset = state->frames_length;
+    for (i = 0; i < HttpServer_subscribers_length(server); i++) {
+      server->connections[server->subscribers[i]].is_stale = true;
+    }
+  }
+
+  for (; server->frames_offset < state->frames_length;
+       server->frames_offset++) {
+    frame = &state->frames[server->frames_offset % HTTP_FRAMES_MAX];
+
+    for (i = 0; i < HttpServer_subscribers_length(server); i++) {
+      connection = &server->connections[server->subscribers[i]];
+      if (connection->is_stale || connection->is_closing) {
+        continue;
+      }
+
+      if (http_priv_ops->get_response_room(connection) < frame->length) {
+        connection->is_stale = true;
+        continue;
+      }
+
+      memcpy(connection->response + connection->response_length,
+             frame->data, frame->length);
+      connection->response_length += frame->length;
+      server->stats.frames++;
+    }
+  }
+
+  pthread_mutex_unlock(&state->mutex);
+
+  // Closed subscriber is replaced by the last one, which is already done.
+  for (i = HttpServer_subscribers_length(server); i > 0; i--) {
+    http_priv_ops->complete(server,
+                            &server->connections[server->subscribers[i - 1]]);
+  }
+}
+
+// Sends what is in response buffer and decides what connection waits for
+//  next, connection which is done or broken is closed.
+static void http_server_complete(struct HttpServer *server,
+                                 struct HttpConnection *connection) {
+  int err;
+
+  if (connection->is_stale && !connection->is_closing) {
+    http_priv_ops->send_state(server, connection);
+  }
+
+  err = http_priv_ops->flush(connection);
+  if (err) {
+    goto error;
+  }
+
+  if (connection->response_length == 0 && connection->is_closing) {
+    goto error;
+  }
+
+  err = http_priv_ops->update_watch(connection);
+  if (err) {
+    goto error;
+  }
+
+  return;
+
+error:
+  http_priv_ops->close_connection(server, connection);
+}
+
+// Responses which are still not sent are moved to the beginning, so they
+//  do not waste the room.
+static size_t http_server_get_response_room(struct HttpConnection *connection) {
+  if (connection->response_offset > 0 &&
+      sizeof(connection->response) - connection->response_length <
+          HTTP_RESPONSE_MAX) {
+    memmove(connection->response,
+            connection->response + connection->response_offset,
+            connection->response_length - connection->response_offset);
+    connection->response_length -= connection->response_offset;
+    connection->response_offset = 0;
+  }
+
+  return sizeof(connection->response) - connection->response_length;
+}
+
+static int http_server_flush(struct HttpConnection *connection) {
+  ssize_t bytes_written;
+
+  while (connection->response_offset < connection->response_length) {
+    bytes_written =
+        send(connection->watch.fd,
+             connection->response + connection->response_offset,
+             connection->response_length - connection->response_offset,
+             MSG_NOSIGNAL);
+    if (bytes_written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return 0;
+      }
+
+      return errno;
+    }
+
+    connection->response_offset += bytes_written;
+  }
+
+  connection->response_offset = 0;
+  connection->response_length = 0;
+
+  return 0;
+}
+
+// Connection waits either for requests or for room to send responses,
+//  never for both.
+static int http_server_update_watch(struct HttpConnection *connection) {
+  uint32_t events = connection->response_length > 0 ? EPOLLOUT
+                                                    : EPOLLIN | EPOLLRDHUP;
+
+  if (connection->watch.events == events) {
+    return 0;
+  }
+
+  return input_ops->modify_watch(&connection->watch, events);
+}
+
+static void http_server_close_connection(struct HttpServer *server,
+                                         struct HttpConnection *connection) {
+  size_t index = connection - server->connections;
+  size_t length;
+
+  if (connection->is_websocket) {
+    length = HttpServer_subscribers_length(server);
+    for (size_t i = 0; i < length; i++) {
+      if (server->subscribers[i] == index) {
+        server->subscribers[i] = server->subscribers[length - 1];
+        server->subscribers_offset--;
+        break;
+      }
+    }
+    connection->is_websocket = false;
+  }
+
+  input_ops->remove_watch(&connection->watch);
+  close(connection->watch.fd);
+  connection->watch.fd = -1;
+
+  input_server_ops->release_connection(&server->base,
+                                       connection - server->connections);
+}
+
+static bool http_server_is_path(struct HttpRequest *request,
+                                const char *path) {
+  return request->path_length == strlen(path) &&
+         memcmp(request->path, path, request->path_length) == 0;
+}
+
+static const char *http_server_get_status_text(int status) {
+  switch (status) {
+  case HTTP_STATUS_SWITCHING:
+    return "Switching Protocols";
+  case HTTP_STATUS_OK:
+    return "OK";
+  case HTTP_STATUS_ACCEPTED:
+    return "Accepted";
+  case HTTP_STATUS_BAD_REQUEST:
+    return "Bad Request";
+  case HTTP_STATUS_NOT_FOUND:
+    return "Not Found";
+  case HTTP_STATUS_NOT_ALLOWED:
+    return "Method Not Allowed";
+  case HTTP_STATUS_CONFLICT:
+    return "Conflict";
+  case HTTP_STATUS_TOO_LARGE:
+    return "Content Too Large";
+  case HTTP_STATUS_UNAVAILABLE:
+    return "Service Unavailable";
+  default:
+    return "Unknown";
+  }
+}
+
+// Runs on display's thread, state and frame are rendered aside and only
+//  copied under the lock, so requests wait for memcpy at most.
+static int http_server_display(struct DisplayData *data) {
+  struct HttpGameState *state = &http_game_state;
+  char delta[HTTP_STATE_MAX];
+  char body[HTTP_STATE_MAX];
+  char head[HTTP_WEBSOCKET_HEAD_MAX];
+  struct HttpFrame *frame;
+  size_t delta_length;
+  size_t head_length;
+  size_t length;
+
+  // Nothing to tell subscribers about.
+  if (!http_priv_ops->is_frame_changed(data)) {
+    return 0;
+  }
+
+  length = http_priv_ops->render_state(data, body, sizeof(body));
+  if (length == 0) {
+    return ENOBUFS;
+  }
+
+  // Board was resized or too much changed, whole state is sent instead.
+  delta_length = http_priv_ops->render_delta(data, delta, sizeof(delta));
+  if (delta_length == 0 || delta_length >= length) {
+    memcpy(delta, body, length);
+    delta_length = length;
+  }
+
+  head_length = http_websocket_ops->compose_head(HTTP_WEBSOCKET_TEXT,
+                                                 delta_length, head);
+
+  pthread_mutex_lock(&state->mutex);
+  memcpy(state->body, body, length);
+  state->body_length = length;
+
+  frame = &state->frames[state->frames_length % HTTP_FRAMES_MAX];
+  memcpy(frame->data, head, head_length);
+  memcpy(frame->data + head_length, delta, delta_length);
+  frame->length = head_length + delta_length;
+  state->frames_length++;
+  pthread_mutex_unlock(&state->mutex);
+
+  http_priv_ops->save_frame(data);
+
+  if (eventfd_write(state->frames_fd, 1) == -1) {
+    return errno;
+  }
+
+  return 0;
+}
+
+static int http_server_open_display(void) { return http_server_start(); }
+
+static void http_server_close_display(void) {
+  http_priv_ops->stop(&http_server);
+}
+
+#define HTTP_RENDER(...)                                                       \
+  do {                                                                         \
+    written = snprintf(buffer + length, size - length, __VA_ARGS__);           \
+    if (written < 0 || (size_t)written >= size - length) {                     \
+      return 0;                                                                \
+    }                                                                          \
+    length += written;                                                         \
+  } while (0)
+
+// Returns length of rendered state, zero if it does not fit.
+static size_t http_server_render_state(struct DisplayData *data, char *buffer,
+                                       size_t size) {
+  const struct GameBoardCell *cell;
+  size_t length = 0;
+  int written;
+
+  HTTP_RENDER("{\"state\":\"%s\",\"user\":%d,\"board_xy\":%zu,"
+              "\"cursor\":[%d,%d],\"cells\":[",
+              http_priv_ops->get_state_name(data->game_state),
+              data->user_id + 1, data->board_xy, data->cursor.x,
+              data->cursor.y);
+
+  // Taken cell holds number of its owner, the same as `user`.
+  for (size_t y = 0; y < data->board_xy; y++) {
+    HTTP_RENDER("%s[", y ? "," : "");
+    for (size_t x = 0; x < data->board_xy; x++) {
+      cell = &data->cells[y][x];
+      HTTP_RENDER("%s%d", x ? "," : "",
+                  cell->flags & GAME_BOARD_CELL_TAKEN ? cell->owner + 1 : 0);
+    }
+    HTTP_RENDER("]");
+  }
+
+  HTTP_RENDER("],\"flags\":[");
+
+  for (size_t y = 0; y < data->board_xy; y++) {
+    HTTP_RENDER("%s[", y ? "," : "");
+    for (size_t x = 0; x < data->board_xy; x++) {
+      HTTP_RENDER("%s%u", x ? "," : "", data->cells[y][x].flags);
+    }
+    HTTP_RENDER("]");
+  }
+
+  HTTP_RENDER("]}");
+
+  return length;
+}
+
+// Renders what changed since the previous frame, every change is
+//  `[x, y, owner, flags]`. Returns zero if it does not fit or board was
+//  resized.
+static size_t http_server_render_delta(struct DisplayData *data, char *buffer,
+                                       size_t size) {
+  struct HttpPreviousFrame *previous = &http_previous_frame;
+  const struct GameBoardCell *cell;
+  bool is_first = true;
+  size_t length = 0;
+  int written;
+
+  if (previous->board_xy != data->board_xy) {
+    return 0;
+  }
+
+  HTTP_RENDER("{\"state\":\"%s\",\"user\":%d,\"cursor\":[%d,%d],"
+              "\"changes\":[",
+              http_priv_ops->get_state_name(data->game_state),
+              data->user_id + 1, data->cursor.x, data->cursor.y);
+
+  for (size_t y = 0; y < data->board_xy; y++) {
+    for (size_t x = 0; x < data->board_xy; x++) {
+      cell = &data->cells[y][x];
+      if (cell->flags == previous->cells[y][x].flags &&
+          cell->owner == previous->cells[y][x].owner) {
+        continue;
+      }
+
+      HTTP_RENDER("%s[%zu,%zu,%d,%u]", is_first ? "" : ",", x, y,
+                  cell->flags & GAME_BOARD_CELL_TAKEN ? cell->owner + 1 : 0,
+                  cell->flags);
+      is_first = false;
+    }
+  }
+
+  HTTP_RENDER("]}");
+
+  return length;
+}
+
+#undef HTTP_RENDER
+
+static const char *http_server_get_state_name(enum GameStates game_state) {
+  switch (game_state) {
+  case GameStatePlay:
+    return "play";
+  case GameStateQuitting:
+    return "quitting";
+  case GameStateQuit:
+    return "quit";
+  case GameStateWinning:
+    return "winning";
+  case GameStateWin:
+    return "win";
+  default:
+    return "unknown";
+  }
+}
+
+static bool http_server_is_frame_changed(struct DisplayData *data) {
+  struct HttpPreviousFrame *previous = &http_previous_frame;
+
+  if (previous->board_xy != data->board_xy ||
+      previous->game_state != data->game_state ||
+      previous->user_id != data->user_id ||
+      previous->cursor.x != data->cursor.x ||
+      previous->cursor.y != data->cursor.y) {
+    return true;
+  }
+
+  for (size_t y = 0; y < data->board_xy; y++) {
+    if (memcmp(previous->cells[y], data->cells[y],
+               data->board_xy * sizeof(struct GameBoardCell))) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void http_server_save_frame(struct DisplayData *data) {
+  struct HttpPreviousFrame *previous = &http_previous_frame;
+
+  previous->game_state = data->game_state;
+  previous->user_id = data->user_id;
+  previous->cursor = data->cursor;
+  previous->board_xy = data->board_xy;
+
+  for (size_t y = 0; y < data->board_xy; y++) {
+    memcpy(previous->cells[y], data->cells[y],
+           data->board_xy * sizeof(struct GameBoardCell));
+  }
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct HttpServerPrivateOps http_server_priv_ops_ = {
+    .start = http_server_start_server,
+    .stop = http_server_stop_server,
+    .open_connection = http_server_open_connection,
+    .process_connection = http_server_process_connection,
+    .process_frames = http_server_process_frames,
+    .process_requests = http_server_process_requests,
+    .process_messages = http_server_process_messages,
+    .handle_request = http_server_handle_request,
+    .handle_state = http_server_handle_state,
+    .handle_move = http_server_handle_move,
+    .handle_upgrade = http_server_handle_upgrade,
+    .handle_message = http_server_handle_message,
+    .deliver_move = http_server_deliver_move,
+    .respond = http_server_respond,
+    .respond_error = http_server_respond_error,
+    .send_frame = http_server_send_frame,
+    .send_close = http_server_send_close,
+    .send_state = http_server_send_state,
+    .fan_out = http_server_fan_out,
+    .complete = http_server_complete,
+    .get_response_room = http_server_get_response_room,
+    .flush = http_server_flush,
+    .update_watch = http_server_update_watch,
+    .close_connection = http_server_close_connection,
+    .is_path = http_server_is_path,
+    .get_status_text = http_server_get_status_text,
+    .display = http_server_display,
+    .open_display = http_server_open_display,
+    .close_display = http_server_close_display,
+    .render_state = http_server_render_state,
+    .render_delta = http_server_render_delta,
+    .get_state_name = http_server_get_state_name,
+    .is_frame_changed = http_server_is_frame_changed,
+    .save_frame = http_server_save_frame,
+};
+
+struct HttpServerPrivateOps *get_http_server_priv_ops(void) {
+  return &http_server_priv_ops_;
+}
+
+static struct HttpServerOps http_server_ops = {
+    .init = http_server_init,
+    .destroy = http_server_destroy,
+    .get_stats = http_server_get_stats,
+};
+
+struct HttpServerOps *get_http_server_ops(void) { return &http_server_ops; }
@@ -0,0 +1,61 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+/*******************************************************************************
+ * @file http_server.h
+ * @brief HTTP/1.1 server exposing the game to browsers.
+ *
+ * Server listens on localhost TCP port and serves:
+ *  - `GET /` HTML+JS client,
+ *  - `GET /api/state` game state as JSON, board, current user and state
+ *    of the game, as it was last displayed,
+ *  - `POST /api/move` events of a user, e.g.
+ *    `{"user": 1, "events": ["up", "select"]}`,
+ *  - `GET /api/updates` WebSocket, which first sends the same state as
+ *    `/api/state` and then only what changed with every frame, e.g.
+ *    `{"state":"play","user":2,"cursor":[1,0],"changes":[[1,0,1,3]]}`
+ *    where every change is `[x, y, owner, flags]`. Moves may be sent over
+ *    it as text messages in the same format as to `/api/move`.
+ *
+ * State is published by `http` display, moves are routed to `http<n>`
+ * device, so n-th user selects it with `user<n>_input=http<n>`. Connections
+ * are kept alive and requests may be pipelined.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define HTTP_SERVER_DISP_NAME "http"
+#define HTTP_SERVER_PORT_VAR_NAME "http_port"
+#define HTTP_SERVER_PORT_DEFAULT "8080"
+#define HTTP_SERVER_USERS_MAX 10
+#define HTTP_SERVER_CONNECTIONS_MAX 1024
+
+struct HttpServerStats {
+  size_t accepted;
+  size_t rejected;
+  size_t requests;
+  size_t events;
+  size_t errors;
+  // Connections switched to WebSocket and frames sent over them.
+  size_t upgrades;
+  size_t frames;
+};
+
+struct HttpServerOps {
+  int (*init)(void);
+  void (*destroy)(void);
+  void (*get_stats)(struct HttpServerStats *stats);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct HttpServerOps *get_http_server_ops(void);
+
+#endif // HTTP_SERVER_H
@@ -0,0 +1,329 @@
+/*******************************************************************************
+ * @file http_websocket.c
+ * @brief WebSocket (RFC 6455) framing used by the HTTP server.
+ *
+ * Handshake needs SHA-1 and base64 of client's key, both are implemented
+ * here rather than pulled from a crypto library, the key is the only thing
+ * they are ever used for.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// App's internal libs
+#include "http/http_websocket.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define HTTP_WEBSOCKET_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+// Clients send base64 of 16 random bytes, which is 24 characters.
+#define HTTP_WEBSOCKET_KEY_MAX 64
+#define HTTP_SHA1_DIGEST_LENGTH 20
+#define HTTP_SHA1_BLOCK_LENGTH 64
+#define HTTP_SHA1_ROTATE(value, bits)                                          \
+  (((value) << (bits)) | ((value) >> (32 - (bits))))
+
+struct HttpWebsocketPrivateOps {
+  void (*sha1)(const uint8_t *data, size_t length,
+               uint8_t digest[HTTP_SHA1_DIGEST_LENGTH]);
+  void (*sha1_block)(uint32_t state[5], const uint8_t *block);
+  void (*encode_base64)(const uint8_t *data, size_t length, char *output);
+  bool (*is_opcode_valid)(uint8_t opcode);
+};
+
+static struct HttpWebsocketPrivateOps *http_websocket_priv_ops;
+struct HttpWebsocketPrivateOps *get_http_websocket_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int
+http_websocket_get_accept_key(const char *key, size_t key_length,
+                              char accept[HTTP_WEBSOCKET_ACCEPT_MAX]) {
+  char message[HTTP_WEBSOCKET_KEY_MAX + sizeof(HTTP_WEBSOCKET_GUID) - 1];
+  uint8_t digest[HTTP_SHA1_DIGEST_LENGTH];
+
+  if (!key || !accept || key_length == 0 ||
+      key_length > HTTP_WEBSOCKET_KEY_MAX) {
+    return EINVAL;
+  }
+
+  http_websocket_priv_ops = get_http_websocket_priv_ops();
+
+  memcpy(message, key, key_length);
+  memcpy(message + key_length, HTTP_WEBSOCKET_GUID,
+         sizeof(HTTP_WEBSOCKET_GUID) - 1);
+
+  http_websocket_priv_ops->sha1(
+      (const uint8_t *)message, key_length + sizeof(HTTP_WEBSOCKET_GUID) - 1,
+      digest);
+  http_websocket_priv_ops->encode_base64(digest, sizeof(digest), accept);
+
+  return 0;
+}
+
+static int http_websocket_parse_frame(char *buffer, size_t length,
+                                      size_t payload_max,
+                                      struct HttpWebsocketFrame *frame) {
+  const uint8_t *head = (const uint8_t *)buffer;
+  size_t head_length = 2;
+  uint64_t payload_length;
+  uint8_t opcode;
+  const char *mask;
+
+  if (!buffer || !frame) {
+    return EINVAL;
+  }
+
+  http_websocket_priv_ops = get_http_websocket_priv_ops();
+
+  if (length < head_length) {
+    return EAGAIN;
+  }
+
+  opcode = head[0] & 0x0F;
+
+  // No extension is ever negotiated, so reserved bits stay clear, and
+  //  clients have to mask every frame.
+  if ((head[0] & 0x70) || !(head[1] & 0x80) ||
+      !http_websocket_priv_ops->is_opcode_valid(opcode)) {
+    return EPROTO;
+  }
+
+  payload_length = head[1] & 0x7F;
+  if (payload_length == 126) {
+    head_length += 2;
+    if (length < head_length) {
+      return EAGAIN;
+    }
+    payload_length = (uint64_t)head[2] << 8 | head[3];
+  } else if (payload_length == 127) {
+    head_length += 8;
+    if (length < head_length) {
+      return EAGAIN;
+    }
+    payload_length = 0;
+    for (size_t i = 2; i < 10; i++) {
+      payload_length = payload_length << 8 | head[i];
+    }
+  }
+
+  // Control frames are never fragmented and are short.
+  if ((opcode & 0x8) &&
+      (!(head[0] & 0x80) || payload_length > HTTP_WEBSOCKET_CONTROL_MAX)) {
+    return EPROTO;
+  }
+
+  if (payload_length > payload_max) {
+    return EMSGSIZE;
+  }
+
+  head_length += 4;
+  if (length < head_length || length - head_length < payload_length) {
+    return EAGAIN;
+  }
+
+  mask = buffer + head_length - 4;
+
+  *frame = (struct HttpWebsocketFrame){
+      .opcode = opcode,
+      .is_final = head[0] & 0x80,
+      .payload = buffer + head_length,
+      .payload_length = payload_length,
+      .frame_length = head_length + payload_length,
+  };
+
+  for (size_t i = 0; i < frame->payload_length; i++) {
+    frame->payload[i] ^= mask[i % 4];
+  }
+
+  return 0;
+}
+
+static size_t http_websocket_compose_head(enum HttpWebsocketOpcode opcode,
+                                          size_t payload_length,
+                                          char head[HTTP_WEBSOCKET_HEAD_MAX]) {
+  head[0] = (char)(0x80 | opcode);
+
+  if (payload_length < 126) {
+    head[1] = (char)payload_length;
+    return 2;
+  }
+
+  if (payload_length <= UINT16_MAX) {
+    head[1] = 126;
+    head[2] = (char)(payload_length >> 8);
+    head[3] = (char)(payload_length & 0xFF);
+    return 4;
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static void http_websocket_sha1(const uint8_t *data, size_t length,
+                                uint8_t digest[HTTP_SHA1_DIGEST_LENGTH]) {
+  uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+                       0xC3D2E1F0};
+  uint8_t tail[2 * HTTP_SHA1_BLOCK_LENGTH] = {0};
+  uint64_t bits_length = (uint64_t)length * 8;
+  size_t tail_length;
+  size_t offset = 0;
+
+  for (; length - offset >= HTTP_SHA1_BLOCK_LENGTH;
+       offset += HTTP_SHA1_BLOCK_LENGTH) {
+    http_websocket_priv_ops->sha1_block(state, data + offset);
+  }
+
+  // Message is padded with 1 bit and zeros, so its length fits into last
+  //  8 bytes of the last block.
+  tail_length = length - offset;
+  memcpy(tail, data + offset, tail_length);
+  tail[tail_length++] = 0x80;
+  tail_length = tail_length + 8 <= HTTP_SHA1_BLOCK_LENGTH
+                    ? HTTP_SHA1_BLOCK_LENGTH
+                    : 2 * HTTP_SHA1_BLOCK_LENGTH;
+
+  for (size_t i = 0; i < 8; i++) {
+    tail[tail_length - 1 - i] = (uint8_t)(bits_length >> (8 * i));
+  }
+
+  for (size_t i = 0; i < tail_length; i += HTTP_SHA1_BLOCK_LENGTH) {
+    http_websocket_priv_ops->sha1_block(state, tail + i);
+  }
+
+  for (size_t i = 0; i < 5; i++) {
+    digest[4 * i] = (uint8_t)(state[i] >> 24);
+    digest[4 * i + 1] = (uint8_t)(state[i] >> 16);
+    digest[4 * i + 2] = (uint8_t)(state[i] >> 8);
+    digest[4 * i + 3] = (uint8_t)state[i];
+  }
+}
+
+static void http_websocket_sha1_block(uint32_t state[5],
+                                      const uint8_t *block) {
+  uint32_t words[80];
+  uint32_t a = state[0], b = state[1], c = state[2], d = state[3],
+           e = state[4];
+  uint32_t f, k, temp;
+
+  for (size_t i = 0; i < 16; i++) {
+    words[i] = (uint32_t)block[4 * i] << 24 |
+               (uint32_t)block[4 * i + 1] << 16 |
+               (uint32_t)block[4 * i + 2] << 8 | block[4 * i + 3];
+  }
+
+  for (size_t i = 16; i < 80; i++) {
+    words[i] = HTTP_SHA1_ROTATE(
+        words[i - 3] ^ words[i - 8] ^ words[i - 14] ^ words[i - 16], 1);
+  }
+
+  for (size_t i = 0; i < 80; i++) {
+    if (i < 20) {
+      f = (b & c) | (~b & d);
+      k = 0x5A827999;
+    } else if (i < 40) {
+      f = b ^ c ^ d;
+      k = 0x6ED9EBA1;
+    } else if (i < 60) {
+      f = (b & c) | (b & d) | (c & d);
+      k = 0x8F1BBCDC;
+    } else {
+      f = b ^ c ^ d;
+      k = 0xCA62C1D6;
+    }
+
+    temp = HTTP_SHA1_ROTATE(a, 5) + f + e + k + words[i];
+    e = d;
+    d = c;
+    c = HTTP_SHA1_ROTATE(b, 30);
+    b = a;
+    a = temp;
+  }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+}
+
+// Output has to have room for 4 characters per 3 bytes and null.
+static void http_websocket_encode_base64(const uint8_t *data, size_t length,
+                                         char *output) {
+  static const char alphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  uint32_t group;
+  size_t i;
+
+  for (i = 0; i + 2 < length; i += 3) {
+    group = (uint32_t)data[i] << 16 | (uint32_t)data[i + 1] << 8 | data[i + 2];
+    *output++ = alphabet[group >> 18 & 0x3F];
+    *output++ = alphabet[group >> 12 & 0x3F];
+    *output++ = alphabet[group >> 6 & 0x3F];
+    *output++ = alphabet[group & 0x3F];
+  }
+
+  if (i < length) {
+    group = (uint32_t)data[i] << 16;
+    if (i + 1 < length) {
+      group |= (uint32_t)data[i + 1] << 8;
+    }
+
+    *output++ = alphabet[group >> 18 & 0x3F];
+    *output++ = alphabet[group >> 12 & 0x3F];
+    *output++ = i + 1 < length ? alphabet[group >> 6 & 0x3F] : '=';
+    *output++ = '=';
+  }
+
+  *output = 0;
+}
+
+static bool http_websocket_is_opcode_valid(uint8_t opcode) {
+  switch (opcode) {
+  case HTTP_WEBSOCKET_CONTINUATION:
+  case HTTP_WEBSOCKET_TEXT:
+  case HTTP_WEBSOCKET_BINARY:
+  case HTTP_WEBSOCKET_CLOSE:
+  case HTTP_WEBSOCKET_PING:
+  case HTTP_WEBSOCKET_PONG:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct HttpWebsocketPrivateOps http_websocket_priv_ops_ = {
+    .sha1 = http_websocket_sha1,
+    .sha1_block = http_websocket_sha1_block,
+    .encode_base64 = http_websocket_encode_base64,
+    .is_opcode_valid = http_websocket_is_opcode_valid,
+};
+
+struct HttpWebsocketPrivateOps *get_http_websocket_priv_ops(void) {
+  return &http_websocket_priv_ops_;
+}
+
+static struct HttpWebsocketOps http_websocket_ops = {
+    .get_accept_key = http_websocket_get_accept_key,
+    .parse_frame = http_websocket_parse_frame,
+    .compose_head = http_websocket_compose_head,
+};
+
+struct HttpWebsocketOps *get_http_websocket_ops(void) {
+  return &http_websocket_ops;
+}
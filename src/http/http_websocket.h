@@ -0,0 +1,72 @@
+#ifndef HTTP_WEBSOCKET_H
+#define HTTP_WEBSOCKET_H
+/*******************************************************************************
+ * @file http_websocket.h
+ * @brief WebSocket (RFC 6455) framing used by the HTTP server.
+ *
+ * Only what server side needs is implemented: computing handshake's accept
+ * key, parsing frames sent by clients and composing heads of frames sent
+ * to them. Server never fragments its messages, so every frame it sends is
+ * the final one.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+// Base64 of SHA-1 digest with terminating null.
+#define HTTP_WEBSOCKET_ACCEPT_MAX 29
+// Longest head of frame sent by server, server never sends frame longer
+//  than UINT16_MAX.
+#define HTTP_WEBSOCKET_HEAD_MAX 4
+// Control frames carry at most 125 bytes.
+#define HTTP_WEBSOCKET_CONTROL_MAX 125
+
+enum HttpWebsocketOpcode {
+  HTTP_WEBSOCKET_CONTINUATION = 0x0,
+  HTTP_WEBSOCKET_TEXT = 0x1,
+  HTTP_WEBSOCKET_BINARY = 0x2,
+  HTTP_WEBSOCKET_CLOSE = 0x8,
+  HTTP_WEBSOCKET_PING = 0x9,
+  HTTP_WEBSOCKET_PONG = 0xA,
+};
+
+struct HttpWebsocketFrame {
+  enum HttpWebsocketOpcode opcode;
+  bool is_final;
+  // Points into parsed buffer, payload is already unmasked.
+  char *payload;
+  size_t payload_length;
+  // Head and payload, next frame starts right after it.
+  size_t frame_length;
+};
+
+struct HttpWebsocketOps {
+  // Writes value of Sec-WebSocket-Accept header for client's key.
+  int (*get_accept_key)(const char *key, size_t key_length,
+                        char accept[HTTP_WEBSOCKET_ACCEPT_MAX]);
+  // Returns 0 once whole frame is in the buffer, EAGAIN if it is not yet,
+  //  EMSGSIZE if payload is longer than payload_max and EPROTO if client
+  //  broke the protocol. Payload is unmasked in place, so the buffer is
+  //  modified only if whole frame is there.
+  int (*parse_frame)(char *buffer, size_t length, size_t payload_max,
+                     struct HttpWebsocketFrame *frame);
+  // Writes head of final frame into head and returns its length, zero if
+  //  payload is too long.
+  size_t (*compose_head)(enum HttpWebsocketOpcode opcode,
+                         size_t payload_length,
+                         char head[HTTP_WEBSOCKET_HEAD_MAX]);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct HttpWebsocketOps *get_http_websocket_ops(void);
+
+#endif // HTTP_WEBSOCKET_H
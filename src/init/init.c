@@ -8,10 +8,14 @@
 #include <string.h>
 
 #include "config/config.h"
+#include "display/asciicast.h"
 #include "display/cli.h"
 #include "display/display.h"
+#include "display/null.h"
+#include "display/shm.h"
 #include "game/game.h"
 #include "game/game_config.h"
+#include "game/game_queue.h"
 #include "game/game_state_machine/game_sm_subsystem.h"
 #include "game/game_state_machine/game_state_machine.h"
 #include "game/game_state_machine/mini_state_machines/common.h"
@@ -21,9 +25,13 @@
 #include "game/game_state_machine/mini_state_machines/user_move_mini_machine.h"
 #include "game/game_state_machine/mini_state_machines/user_turn_mini_machine.h"
 #include "game/game_state_machine/mini_state_machines/win_mini_machine.h"
+#include "http/http_server.h"
+#include "input/generator.h"
 #include "input/input.h"
 #include "input/keyboard/keyboard.h"
 #include "input/keyboard/keyboard_keys_mapping_1.h"
+#include "input/replay.h"
+#include "input/socket_server.h"
 #include "static_array_lib.h"
 #include "utils/logging_utils.h"
 #include "utils/signals_utils.h"
@@ -127,9 +135,17 @@ static int init_register_multiple_modules(void) {
   struct KeyboardKeysMapping1Ops *km1_ops = get_keyboard_keys_mapping_1_ops();
   struct GameSmSubsystemOps *game_sm_sub_ops = get_game_sm_subsystem_ops();
   struct DisplayCliOps *display_cli_ops = get_display_cli_ops();
+  struct DisplayNullOps *display_null_ops = get_display_null_ops();
+  struct DisplayAsciicastOps *display_asciicast_ops =
+      get_display_asciicast_ops();
+  struct DisplayShmOps *display_shm_ops = get_display_shm_ops();
+  struct HttpServerOps *http_server_ops = get_http_server_ops();
   struct GameConfigOps *game_config_ops = get_game_config_ops();
   struct SignalUtilsOps *signals_ops = get_signal_utils_ops();
   struct KeyboardOps *keyboard_ops = get_keyboard_ops();
+  struct InputReplayOps *replay_ops = get_input_replay_ops();
+  struct InputGeneratorOps *generator_ops = get_input_generator_ops();
+  struct InputSocketOps *socket_ops = get_input_socket_ops();
   struct GameSmCleanLastMoveModuleOps *clean_last_move_ops =
       get_game_sm_clean_last_move_module_ops();
   struct GameStateMachineOps *game_state_machine_ops =
@@ -143,6 +159,7 @@ static int init_register_multiple_modules(void) {
   struct ConfigOps *config_ops = get_config_ops();
   struct InputOps *input_ops = get_input_ops();
   struct GameOps *game_ops = get_game_ops();
+  struct GameQueueOps *game_queue_ops = get_game_queue_ops();
   struct DisplayOps *display_ops = get_display_ops();
   struct GameSmUserTurnModuleOps *turn_ops = get_game_sm_user_turn_module_ops();
   struct InitRegistration modules[] = {
@@ -150,17 +167,46 @@ static int init_register_multiple_modules(void) {
        .destroy = NULL,
        .display_name = "signals_utils"},
       {.init = config_ops->init, .destroy = NULL, .display_name = "config"},
-      {.init = input_ops->init, .destroy = NULL, .display_name = "input"},
+      {.init = input_ops->init,
+       .destroy = input_ops->destroy,
+       .display_name = "input"},
       {.init = keyboard_ops->init,
        .destroy = keyboard_ops->destroy,
        .display_name = "keyboard"},
       {.init = km1_ops->init,
        .destroy = NULL,
        .display_name = KEYBOARD_KEYS_MAPPING_1_DISP_NAME},
-      {.init = display_ops->init, .destroy = NULL, .display_name = "display"},
+      {.init = replay_ops->init,
+       .destroy = replay_ops->destroy,
+       .display_name = INPUT_REPLAY_DISP_NAME},
+      {.init = generator_ops->init,
+       .destroy = generator_ops->destroy,
+       .display_name = INPUT_GENERATOR_DISP_NAME},
+      {.init = socket_ops->init,
+       .destroy = socket_ops->destroy,
+       .display_name = INPUT_SOCKET_DISP_NAME},
+      {.init = display_ops->init,
+       .destroy = display_ops->destroy,
+       .display_name = "display"},
       {.init = display_cli_ops->init,
-       .destroy = NULL,
+       .destroy = display_cli_ops->destroy,
        .display_name = "display_cli"},
+      {.init = display_null_ops->init,
+       .destroy = display_null_ops->destroy,
+       .display_name = "display_null"},
+      {.init = display_asciicast_ops->init,
+       .destroy = display_asciicast_ops->destroy,
+       .display_name = "display_asciicast"},
+      {.init = display_shm_ops->init,
+       .destroy = display_shm_ops->destroy,
+       .display_name = "display_shm"},
+      // Server adds both input devices and display.
+      {.init = http_server_ops->init,
+       .destroy = http_server_ops->destroy,
+       .display_name = HTTP_SERVER_DISP_NAME},
+      {.init = game_queue_ops->init,
+       .destroy = game_queue_ops->destroy,
+       .display_name = "game_queue"},
       {.init = game_ops->init, .destroy = NULL, .display_name = "game"},
       {.init = game_config_ops->init,
        .destroy = NULL,
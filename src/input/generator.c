@@ -0,0 +1,456 @@
+/*******************************************************************************
+ * @file generator.c
+ * @brief Input device generating synthetic event streams.
+ *
+ * Generator does not own any thread, it is driven by a timer watched from
+ * input subsystem's event loop. Timer is armed for the moment next event is
+ * due at configured rate, events which are late by then are caught up in
+ * chunks, so high rates do not need a timer expiration per event. Rate of
+ * zero means as fast as the game takes the events. Generator removes its
+ * watch once configured duration passes.
+ *
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L // strtok_r
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// App's internal libs
+#include "config/config.h"
+#include "input/generator.h"
+#include "input/input.h"
+#include "input/input_common.h"
+#include "input/input_device.h"
+#include "input/input_timer.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+// Events delivered on single loop's iteration.
+#define GENERATOR_CHUNK_MAX 256
+#define GENERATOR_EVENTS_LENGTH (INPUT_EVENT_EXIT - INPUT_EVENT_UP + 1)
+#define GENERATOR_NS_PER_S 1000000000ULL
+// Rate times nanoseconds in a second has to fit into 64 bits.
+#define GENERATOR_RATE_MAX GENERATOR_NS_PER_S
+#define GENERATOR_DURATION_MAX (UINT64_MAX / GENERATOR_NS_PER_S)
+
+struct InputGenerator {
+  input_device_id_t device_id;
+  input_callback_func_t callback;
+  // Events per second, zero means no limit.
+  uint64_t rate;
+  uint64_t seed;
+  uint64_t state;
+  uint64_t duration_ns;
+  // Running sums of weights, event is picked by bisecting them.
+  uint64_t weights[GENERATOR_EVENTS_LENGTH];
+  // Drawn but not delivered yet.
+  enum InputEvents input_event;
+  uint64_t start_ns;
+  struct InputGeneratorStats stats;
+  struct InputWatch watch;
+  bool is_started;
+};
+
+struct InputGeneratorPrivateOps {
+  int (*get_number)(char *var_name, char *default_value, uint64_t *number);
+  int (*parse_weights)(char *weights_str,
+                       uint64_t weights[GENERATOR_EVENTS_LENGTH]);
+  int (*start)(struct InputGenerator *generator);
+  void (*stop)(struct InputGenerator *generator);
+  enum InputEvents (*draw_event)(struct InputGenerator *generator);
+  void (*process_timer)(struct InputWatch *watch, uint32_t events);
+  uint64_t (*get_deadline)(uint64_t start_ns, uint64_t events, uint64_t rate);
+  uint64_t (*get_due_events)(uint64_t elapsed_ns, uint64_t rate);
+};
+
+static char module_id[] = INPUT_GENERATOR_DISP_NAME;
+static struct InputGenerator generator;
+static struct InputOps *input_ops;
+static struct ConfigOps *config_ops;
+static struct LoggingUtilsOps *logging_ops;
+static struct InputTimerOps *timer_ops;
+static struct InputGeneratorPrivateOps *generator_priv_ops;
+struct InputGeneratorPrivateOps *get_input_generator_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int input_generator_start(void);
+static int input_generator_stop(void);
+static int input_generator_wait(void);
+
+static int input_generator_init(void) {
+  struct InputAddDeviceOutput add_device_output;
+  struct InputDeviceOps *input_device_ops;
+  char weights[CONFIG_VARIABLE_MAX];
+  struct InputDevice input_device;
+  uint64_t duration;
+  int err;
+
+  generator_priv_ops = get_input_generator_priv_ops();
+  logging_ops = get_logging_utils_ops();
+  config_ops = get_config_ops();
+  input_ops = get_input_ops();
+  input_device_ops = get_input_device_ops();
+  timer_ops = get_input_timer_ops();
+
+  generator.watch.fd = -1;
+  generator.is_started = false;
+
+  err = generator_priv_ops->get_number(INPUT_GENERATOR_RATE_VAR_NAME,
+                                       INPUT_GENERATOR_RATE_DEFAULT,
+                                       &generator.rate);
+  if (err) {
+    return err;
+  }
+
+  if (generator.rate > GENERATOR_RATE_MAX) {
+    logging_ops->log_err(module_id, "%s can't be bigger than %llu",
+                         INPUT_GENERATOR_RATE_VAR_NAME,
+                         (unsigned long long)GENERATOR_RATE_MAX);
+    return EINVAL;
+  }
+
+  err = generator_priv_ops->get_number(INPUT_GENERATOR_SEED_VAR_NAME,
+                                       INPUT_GENERATOR_SEED_DEFAULT,
+                                       &generator.seed);
+  if (err) {
+    return err;
+  }
+
+  err = generator_priv_ops->get_number(INPUT_GENERATOR_DURATION_VAR_NAME,
+                                       INPUT_GENERATOR_DURATION_DEFAULT,
+                                       &duration);
+  if (err) {
+    return err;
+  }
+
+  if (duration > GENERATOR_DURATION_MAX) {
+    logging_ops->log_err(module_id, "%s can't be bigger than %llu",
+                         INPUT_GENERATOR_DURATION_VAR_NAME,
+                         (unsigned long long)GENERATOR_DURATION_MAX);
+    return EINVAL;
+  }
+
+  generator.duration_ns = duration * GENERATOR_NS_PER_S;
+
+  err = config_ops->read_var(INPUT_GENERATOR_WEIGHTS_VAR_NAME,
+                             INPUT_GENERATOR_WEIGHTS_DEFAULT, weights,
+                             sizeof(weights));
+  if (err) {
+    return err;
+  }
+
+  err = generator_priv_ops->parse_weights(weights, generator.weights);
+  if (err) {
+    logging_ops->log_err(module_id, "Invalid %s value: %s",
+                         INPUT_GENERATOR_WEIGHTS_VAR_NAME, weights);
+    return err;
+  }
+
+  err = input_device_ops->init_device(
+      &input_device, input_generator_wait, input_generator_stop,
+      input_generator_start, INPUT_GENERATOR_DISP_NAME);
+  if (err) {
+    logging_ops->log_err(module_id, "Input device initialization failed: %s",
+                         strerror(err));
+    return err;
+  }
+
+  err = input_ops->add_device(
+      (struct InputAddDeviceInput){.device = &input_device},
+      &add_device_output);
+  if (err) {
+    logging_ops->log_err(module_id, "Adding input device failed: %s",
+                         strerror(err));
+    return err;
+  }
+
+  generator.device_id = add_device_output.device_id;
+
+  return 0;
+}
+
+static void input_generator_destroy(void) {
+  if (generator.is_started) {
+    generator_priv_ops->stop(&generator);
+  }
+}
+
+static void input_generator_get_stats(struct InputGeneratorStats *stats) {
+  if (!stats) {
+    return;
+  }
+
+  *stats = generator.stats;
+}
+
+static int input_generator_start(void) {
+  int err;
+
+  err = generator_priv_ops->start(&generator);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to start generator: %s",
+                         strerror(err));
+    return err;
+  }
+
+  return 0;
+}
+
+static int input_generator_stop(void) {
+  generator_priv_ops->stop(&generator);
+
+  return 0;
+}
+
+// Generator runs on input's loop, input subsystem waits for the loop itself.
+static int input_generator_wait(void) { return 0; }
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int input_generator_get_number(char *var_name, char *default_value,
+                                      uint64_t *number) {
+  char value[CONFIG_VARIABLE_MAX];
+  char *end;
+  int err;
+
+  err = config_ops->read_var(var_name, default_value, value, sizeof(value));
+  if (err) {
+    return err;
+  }
+
+  errno = 0;
+  *number = strtoull(value, &end, 10);
+  if (errno || *end || value[0] == 0 || value[0] == '-') {
+    logging_ops->log_err(module_id, "Invalid %s value: %s", var_name, value);
+    return EINVAL;
+  }
+
+  return 0;
+}
+
+static int
+input_generator_parse_weights(char *weights_str,
+                              uint64_t weights[GENERATOR_EVENTS_LENGTH]) {
+  uint64_t weight;
+  uint64_t sum = 0;
+  char *saveptr;
+  char *token;
+  char *end;
+  size_t i;
+
+  token = strtok_r(weights_str, ",", &saveptr);
+  for (i = 0; i < GENERATOR_EVENTS_LENGTH && token; i++) {
+    errno = 0;
+    weight = strtoull(token, &end, 10);
+    if (errno || *end || token[0] == 0 || token[0] == '-') {
+      return EINVAL;
+    }
+
+    // Sums are what events are drawn from, so they have to fit as well.
+    if (weight > UINT64_MAX - sum) {
+      return EINVAL;
+    }
+
+    sum += weight;
+    weights[i] = sum;
+    token = strtok_r(NULL, ",", &saveptr);
+  }
+
+  // Every event needs its weight, even if it is zero.
+  if (i != GENERATOR_EVENTS_LENGTH || token || sum == 0) {
+    return EINVAL;
+  }
+
+  return 0;
+}
+
+static int input_generator_start_generator(struct InputGenerator *generator) {
+  struct InputGetDeviceOutput get_device;
+  int err;
+
+  if (generator->is_started) {
+    return 0;
+  }
+
+  // Device's callback is set by now, it does not change until the stop.
+  err = input_ops->get_device(
+      (struct InputGetDeviceInput){.device_id = generator->device_id},
+      &get_device);
+  if (err) {
+    return err;
+  }
+
+  generator->callback = get_device.device->callback;
+  generator->stats = (struct InputGeneratorStats){0};
+  // Xorshift never leaves zero state.
+  generator->state = generator->seed ? generator->seed : 1;
+  generator->input_event = generator_priv_ops->draw_event(generator);
+
+  generator->start_ns = timer_ops->get_timestamp();
+
+  err = timer_ops->start(&generator->watch, generator_priv_ops->process_timer,
+                         generator->start_ns);
+  if (err) {
+    return err;
+  }
+
+  generator->is_started = true;
+
+  logging_ops->log_info(module_id, "Generating %llu events per second",
+                        (unsigned long long)generator->rate);
+
+  return 0;
+}
+
+static void input_generator_stop_generator(struct InputGenerator *generator) {
+  if (!generator->is_started) {
+    return;
+  }
+
+  generator->is_started = false;
+
+  timer_ops->stop(&generator->watch);
+
+  logging_ops->log_info(module_id, "Generated %zu events, %zu retries",
+                        generator->stats.events, generator->stats.retries);
+}
+
+static enum InputEvents
+input_generator_draw_event(struct InputGenerator *generator) {
+  uint64_t total = generator->weights[GENERATOR_EVENTS_LENGTH - 1];
+  uint64_t value;
+  size_t low = 0;
+  size_t high = GENERATOR_EVENTS_LENGTH - 1;
+  size_t middle;
+
+  generator->state ^= generator->state >> 12;
+  generator->state ^= generator->state << 25;
+  generator->state ^= generator->state >> 27;
+  value = (generator->state * 0x2545F4914F6CDD1DULL) % total;
+
+  while (low < high) {
+    middle = (low + high) / 2;
+    if (value < generator->weights[middle]) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+
+  return INPUT_EVENT_UP + low;
+}
+
+static void input_generator_process_timer(struct InputWatch *watch,
+                                          uint32_t events) {
+  struct InputGenerator *generator =
+      INPUT_WATCH_CONTAINER(watch, struct InputGenerator, watch);
+  uint64_t elapsed_ns;
+  uint64_t due_events;
+  uint64_t now;
+  int err;
+  (void)events;
+
+  if (!generator->is_started || !timer_ops->consume(watch)) {
+    return;
+  }
+
+  now = timer_ops->get_timestamp();
+  elapsed_ns = now - generator->start_ns;
+
+  if (generator->duration_ns && elapsed_ns >= generator->duration_ns) {
+    generator_priv_ops->stop(generator);
+    return;
+  }
+
+  due_events = generator->stats.events + GENERATOR_CHUNK_MAX;
+  if (generator->rate) {
+    // Events which are late are caught up, a chunk at a time.
+    due_events =
+        generator_priv_ops->get_due_events(elapsed_ns, generator->rate) + 1;
+    if (due_events > generator->stats.events + GENERATOR_CHUNK_MAX) {
+      due_events = generator->stats.events + GENERATOR_CHUNK_MAX;
+    }
+  }
+
+  while (generator->stats.events < due_events) {
+    err = generator->callback(generator->input_event, generator->device_id);
+    if (err == ENOBUFS) {
+      generator->stats.retries++;
+      timer_ops->back_off(watch, now);
+      return;
+    }
+
+    if (err) {
+      logging_ops->log_err(module_id, "Unable to deliver event: %s",
+                           strerror(err));
+    }
+
+    generator->stats.events++;
+    generator->input_event = generator_priv_ops->draw_event(generator);
+  }
+
+  if (!generator->rate) {
+    timer_ops->set(watch, now);
+    return;
+  }
+
+  // Deadline in the past fires right away, so lagging generator keeps up.
+  timer_ops->set(watch, generator_priv_ops->get_deadline(
+                           generator->start_ns, generator->stats.events,
+                           generator->rate));
+}
+
+// Whole seconds and the rest are scaled apart, so neither product can
+//  overflow while rate stays within GENERATOR_RATE_MAX.
+static uint64_t input_generator_get_deadline(uint64_t start_ns,
+                                             uint64_t events, uint64_t rate) {
+  return start_ns + events / rate * GENERATOR_NS_PER_S +
+         events % rate * GENERATOR_NS_PER_S / rate;
+}
+
+static uint64_t input_generator_get_due_events(uint64_t elapsed_ns,
+                                               uint64_t rate) {
+  return elapsed_ns / GENERATOR_NS_PER_S * rate +
+         elapsed_ns % GENERATOR_NS_PER_S * rate / GENERATOR_NS_PER_S;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct InputGeneratorPrivateOps input_generator_priv_ops_ = {
+    .get_number = input_generator_get_number,
+    .parse_weights = input_generator_parse_weights,
+    .start = input_generator_start_generator,
+    .stop = input_generator_stop_generator,
+    .draw_event = input_generator_draw_event,
+    .process_timer = input_generator_process_timer,
+    .get_deadline = input_generator_get_deadline,
+    .get_due_events = input_generator_get_due_events,
+};
+
+struct InputGeneratorPrivateOps *get_input_generator_priv_ops(void) {
+  return &input_generator_priv_ops_;
+}
+
+static struct InputGeneratorOps input_generator_ops = {
+    .init = input_generator_init,
+    .destroy = input_generator_destroy,
+    .get_stats = input_generator_get_stats,
+};
+
+struct InputGeneratorOps *get_input_generator_ops(void) {
+  return &input_generator_ops;
+}
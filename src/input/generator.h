@@ -0,0 +1,48 @@
+#ifndef INPUT_GENERATOR_H
+#define INPUT_GENERATOR_H
+/*******************************************************************************
+ * @file generator.h
+ * @brief Input device generating synthetic event streams.
+ *
+ * Events are drawn from seeded pseudo random generator, so the same seed
+ * gives the same stream. Every event's chance is given by its weight in
+ * `up,down,left,right,select,exit` order. Meant for load and soak tests
+ * together with `null` or `counting` display.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define INPUT_GENERATOR_DISP_NAME "generator"
+#define INPUT_GENERATOR_RATE_VAR_NAME "generator_rate"
+#define INPUT_GENERATOR_RATE_DEFAULT "1000"
+#define INPUT_GENERATOR_SEED_VAR_NAME "generator_seed"
+#define INPUT_GENERATOR_SEED_DEFAULT "1"
+#define INPUT_GENERATOR_DURATION_VAR_NAME "generator_duration"
+#define INPUT_GENERATOR_DURATION_DEFAULT "0"
+#define INPUT_GENERATOR_WEIGHTS_VAR_NAME "generator_weights"
+#define INPUT_GENERATOR_WEIGHTS_DEFAULT "10,10,10,10,10,1"
+
+struct InputGeneratorStats {
+  size_t events;
+  size_t retries;
+};
+
+struct InputGeneratorOps {
+  int (*init)(void);
+  void (*destroy)(void);
+  void (*get_stats)(struct InputGeneratorStats *stats);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct InputGeneratorOps *get_input_generator_ops(void);
+
+#endif // INPUT_GENERATOR_H
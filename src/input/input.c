@@ -6,6 +6,11 @@
  * including initialization, destruction, registration, and callback management.
  * The subsystem relies on logging and registration utilities to ensure robust
  * and traceable operations.
+ *
+ * All devices share one epoll loop running on its own thread between start
+ * and stop. Devices add watches for their file descriptors when they are
+ * started, loop is woken up for shutdown through eventfd, so stop can be
+ * called from any thread, including loop's own thread from a callback.
  ******************************************************************************/
 
 /*******************************************************************************
@@ -13,9 +18,15 @@
  ******************************************************************************/
 // C standard library
 #include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #include "static_array_lib.h"
 
@@ -27,12 +38,28 @@
  *    PRIVATE DECLARATIONS & DEFINITIONS
  ******************************************************************************/
 #define INPUT_DEVICES_MAX 100
+#define INPUT_EVENTS_MAX 16
+#define INPUT_READY_WATCHES_MAX 16
 
 typedef struct InputSubsystem {
   SARRS_FIELD(devices, struct InputDevice, INPUT_DEVICES_MAX);
+  bool is_initialized;
+  int epoll_fd;
+  struct InputWatch stop_watch;
+  // Devices watches, loop exits once there is nothing to watch.
+  size_t watches_length;
+  // Regular files can't be polled, they are always ready, so their watches
+  //  are dispatched on every loop's iteration instead.
+  SARRS_FIELD(ready_watches, struct InputWatch *, INPUT_READY_WATCHES_MAX);
+  pthread_t thread;
+  // Loop's thread was started and was not joined yet.
+  bool is_running;
+  bool is_stopping;
 } InputSubsystem;
 
 SARRS_DECL(InputSubsystem, devices, struct InputDevice, INPUT_DEVICES_MAX);
+SARRS_DECL(InputSubsystem, ready_watches, struct InputWatch *,
+           INPUT_READY_WATCHES_MAX);
 
 static struct LoggingUtilsOps *log_ops;
 static struct InputSubsystem input_subsystem;
@@ -49,7 +76,16 @@ struct InputPrivateOps {
                              struct InputSetCallbackOutput *);
   int (*start)(struct InputSubsystem *);
   int (*stop)(struct InputSubsystem *);
+  int (*request_stop)(struct InputSubsystem *);
   int (*wait)(struct InputSubsystem *);
+  void (*destroy)(struct InputSubsystem *);
+  int (*add_watch)(struct InputSubsystem *, struct InputWatch *);
+  int (*remove_watch)(struct InputSubsystem *, struct InputWatch *);
+  int (*modify_watch)(struct InputSubsystem *, struct InputWatch *,
+                      uint32_t);
+  void *(*loop)(void *);
+  void (*join_loop)(struct InputSubsystem *);
+  void (*stop_watch_callback)(struct InputWatch *, uint32_t);
 };
 
 static struct InputPrivateOps *input_private_ops;
@@ -79,6 +115,10 @@ static int input_init_intrfc(void) {
   return 0;
 }
 
+static void input_destroy_intrfc(void) {
+  input_private_ops->destroy(&input_subsystem);
+}
+
 static int input_add_device_intrfc(struct InputAddDeviceInput input,
                                    struct InputAddDeviceOutput *output) {
   int err;
@@ -170,6 +210,55 @@ static int input_stop_intrfc(void) {
   return 0;
 }
 
+static int input_request_stop_intrfc(void) {
+  log_ops->log_info(INPUT_FILE_NAME, "Requesting input subsystem stop.");
+
+  return input_private_ops->request_stop(&input_subsystem);
+}
+
+static int input_add_watch_intrfc(struct InputWatch *watch) {
+  int err;
+
+  if (!watch || !watch->callback) {
+    return EINVAL;
+  }
+
+  err = input_private_ops->add_watch(&input_subsystem, watch);
+  if (err) {
+    log_ops->log_err(INPUT_FILE_NAME, "Unable to add watch for fd %d: %s",
+                     watch->fd, strerror(err));
+    return err;
+  }
+
+  return 0;
+}
+
+static int input_remove_watch_intrfc(struct InputWatch *watch) {
+  if (!watch) {
+    return EINVAL;
+  }
+
+  return input_private_ops->remove_watch(&input_subsystem, watch);
+}
+
+static int input_modify_watch_intrfc(struct InputWatch *watch,
+                                     uint32_t events) {
+  int err;
+
+  if (!watch) {
+    return EINVAL;
+  }
+
+  err = input_private_ops->modify_watch(&input_subsystem, watch, events);
+  if (err) {
+    log_ops->log_err(INPUT_FILE_NAME, "Unable to modify watch for fd %d: %s",
+                     watch->fd, strerror(err));
+    return err;
+  }
+
+  return 0;
+}
+
 static int input_wait_intrfc(void) {
   int err;
 
@@ -188,11 +277,64 @@ static int input_wait_intrfc(void) {
  *    PRIVATE API
  ******************************************************************************/
 static int input_init(struct InputSubsystem *subsystem) {
+  int err;
+
+  input_private_ops->destroy(subsystem);
+
   InputSubsystem_devices_init(subsystem);
+  InputSubsystem_ready_watches_init(subsystem);
+
+  subsystem->watches_length = 0;
+  subsystem->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (subsystem->epoll_fd == -1) {
+    return errno;
+  }
+
+  subsystem->stop_watch = (struct InputWatch){
+      .fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK),
+      .events = EPOLLIN,
+      .callback = input_private_ops->stop_watch_callback,
+  };
+  if (subsystem->stop_watch.fd == -1) {
+    err = errno;
+    close(subsystem->epoll_fd);
+    subsystem->epoll_fd = -1;
+    return err;
+  }
+
+  err = input_private_ops->add_watch(subsystem, &subsystem->stop_watch);
+  if (err) {
+    close(subsystem->stop_watch.fd);
+    close(subsystem->epoll_fd);
+    subsystem->epoll_fd = -1;
+    return err;
+  }
+
+  // Stop watch is not device's watch.
+  subsystem->watches_length = 0;
+  subsystem->is_initialized = true;
 
   return 0;
 }
 
+static void input_destroy(struct InputSubsystem *subsystem) {
+  if (subsystem->is_running) {
+    input_private_ops->stop(subsystem);
+    input_private_ops->join_loop(subsystem);
+  }
+
+  if (!subsystem->is_initialized) {
+    return;
+  }
+
+  subsystem->is_initialized = false;
+
+  close(subsystem->stop_watch.fd);
+  close(subsystem->epoll_fd);
+  subsystem->epoll_fd = -1;
+  subsystem->stop_watch.fd = -1;
+}
+
 static int input_add_device(struct InputAddDeviceInput *input,
                             struct InputAddDeviceOutput *output) {
   struct InputSubsystem *input_sys;
@@ -204,6 +346,7 @@ static int input_add_device(struct InputAddDeviceInput *input,
 
   output->device_id = -1;
   input->device->callback = NULL;
+  input->device->batch_callback = NULL;
   input_sys = input->private;
 
   err = InputSubsystem_devices_append(input_sys, *input->device);
@@ -312,6 +455,7 @@ static int input_set_callback(struct InputSetCallbackInput *input,
   }
 
   device->callback = input->callback;
+  device->batch_callback = input->batch_callback;
 
   log_ops->log_info(INPUT_FILE_NAME, "Callback set successfully for ID %d",
                     input->device_id);
@@ -351,6 +495,21 @@ static int input_start(struct InputSubsystem *subsystem) {
                      device->display_name);
   }
 
+  // Loop from previous session may still be waiting for join.
+  input_private_ops->join_loop(subsystem);
+
+  subsystem->is_stopping = false;
+
+  err = pthread_create(&subsystem->thread, NULL, input_private_ops->loop,
+                       subsystem);
+  if (err) {
+    log_ops->log_err(INPUT_FILE_NAME, "Unable to start input loop: %s",
+                     strerror(err));
+    return err;
+  }
+
+  subsystem->is_running = true;
+
   return 0;
 }
 
@@ -385,11 +544,44 @@ static int input_stop(struct InputSubsystem *subsystem) {
     // Once device is stopped we want to deregister callback.
     // This indicates that device stopped running.
     device->callback = NULL;
+    device->batch_callback = NULL;
 
     log_ops->log_err(INPUT_FILE_NAME, "Stoped device '%d:%s'", i,
                      device->display_name);
   }
 
+  if (!subsystem->is_running) {
+    return 0;
+  }
+
+  err = input_private_ops->request_stop(subsystem);
+  if (err) {
+    return err;
+  }
+
+  // Loop's own thread can't join itself, it is joined by wait instead.
+  if (!pthread_equal(pthread_self(), subsystem->thread)) {
+    input_private_ops->join_loop(subsystem);
+  }
+
+  return 0;
+}
+
+static int input_request_stop(struct InputSubsystem *subsystem) {
+  if (!subsystem) {
+    return EINVAL;
+  }
+
+  if (!subsystem->is_running) {
+    return 0;
+  }
+
+  // Eventfd wakes the loop up, no matter if it is blocked in epoll_wait or
+  //  it is dispatching events right now.
+  if (eventfd_write(subsystem->stop_watch.fd, 1) == -1) {
+    return errno;
+  }
+
   return 0;
 }
 
@@ -425,30 +617,201 @@ static int input_wait(struct InputSubsystem *subsystem) {
                      device->display_name);
   }
 
+  input_private_ops->join_loop(subsystem);
+
   return 0;
 }
 
+static int input_add_watch(struct InputSubsystem *subsystem,
+                           struct InputWatch *watch) {
+  struct epoll_event event = {.events = watch->events, .data.ptr = watch};
+  int err;
+
+  if (watch->is_added) {
+    return 0;
+  }
+
+  if (epoll_ctl(subsystem->epoll_fd, EPOLL_CTL_ADD, watch->fd, &event) == -1) {
+    if (errno != EPERM) {
+      return errno;
+    }
+
+    err = InputSubsystem_ready_watches_append(subsystem, watch);
+    if (err) {
+      return err;
+    }
+  }
+
+  watch->is_added = true;
+  subsystem->watches_length++;
+
+  return 0;
+}
+
+static int input_remove_watch(struct InputSubsystem *subsystem,
+                              struct InputWatch *watch) {
+  struct InputWatch **ready_watch;
+  size_t i;
+
+  if (!watch->is_added) {
+    return 0;
+  }
+
+  // Events which are already fetched by the loop are skipped once watch is
+  //  not added anymore.
+  watch->is_added = false;
+  subsystem->watches_length--;
+
+  for (i = 0; i < InputSubsystem_ready_watches_length(subsystem); i++) {
+    InputSubsystem_ready_watches_get(subsystem, i, &ready_watch);
+    if (*ready_watch == watch) {
+      *ready_watch =
+          subsystem->ready_watches[subsystem->ready_watches_offset - 1];
+      subsystem->ready_watches_offset--;
+      return 0;
+    }
+  }
+
+  if (epoll_ctl(subsystem->epoll_fd, EPOLL_CTL_DEL, watch->fd, NULL) == -1) {
+    return errno;
+  }
+
+  return 0;
+}
+
+static int input_modify_watch(struct InputSubsystem *subsystem,
+                              struct InputWatch *watch, uint32_t events) {
+  struct epoll_event event = {.events = events, .data.ptr = watch};
+  struct InputWatch **ready_watch;
+
+  watch->events = events;
+
+  if (!watch->is_added) {
+    return 0;
+  }
+
+  // Always ready watches are not known to epoll, loop reads their events
+  //  from the watch itself.
+  for (size_t i = 0; i < InputSubsystem_ready_watches_length(subsystem); i++) {
+    InputSubsystem_ready_watches_get(subsystem, i, &ready_watch);
+    if (*ready_watch == watch) {
+      return 0;
+    }
+  }
+
+  if (epoll_ctl(subsystem->epoll_fd, EPOLL_CTL_MOD, watch->fd, &event) == -1) {
+    return errno;
+  }
+
+  return 0;
+}
+
+static void *input_loop(void *arg) {
+  struct epoll_event events[INPUT_EVENTS_MAX];
+  struct InputSubsystem *subsystem = arg;
+  struct InputWatch **ready_watch;
+  struct InputWatch *watch;
+  int timeout;
+  int count;
+
+  log_ops->log_info(INPUT_FILE_NAME, "Input loop started.");
+
+  while (!subsystem->is_stopping && subsystem->watches_length > 0) {
+    timeout = InputSubsystem_ready_watches_length(subsystem) ? 0 : -1;
+
+    count = epoll_wait(subsystem->epoll_fd, events, INPUT_EVENTS_MAX, timeout);
+    if (count == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      log_ops->log_err(INPUT_FILE_NAME, "Input loop failed: %s",
+                       strerror(errno));
+      break;
+    }
+
+    for (int i = 0; i < count && !subsystem->is_stopping; i++) {
+      watch = events[i].data.ptr;
+      if (!watch->is_added) {
+        continue;
+      }
+
+      watch->callback(watch, events[i].events);
+    }
+
+    // Walked backwards, so callback may remove its own watch.
+    for (size_t i = InputSubsystem_ready_watches_length(subsystem);
+         i > 0 && !subsystem->is_stopping; i--) {
+      if (InputSubsystem_ready_watches_get(subsystem, i - 1, &ready_watch)) {
+        continue;
+      }
+
+      watch = *ready_watch;
+      watch->callback(watch, watch->events & (EPOLLIN | EPOLLOUT));
+    }
+  }
+
+  log_ops->log_info(INPUT_FILE_NAME, "Input loop exiting.");
+
+  return NULL;
+}
+
+static void input_join_loop(struct InputSubsystem *subsystem) {
+  eventfd_t value;
+
+  if (!subsystem->is_running) {
+    return;
+  }
+
+  pthread_join(subsystem->thread, NULL);
+  subsystem->is_running = false;
+
+  // Drain stop request, so next session's loop does not exit right away.
+  eventfd_read(subsystem->stop_watch.fd, &value);
+}
+
+static void input_stop_watch_callback(struct InputWatch *watch,
+                                      uint32_t events) {
+  struct InputSubsystem *subsystem =
+      INPUT_WATCH_CONTAINER(watch, struct InputSubsystem, stop_watch);
+  (void)events;
+
+  subsystem->is_stopping = true;
+}
+
 /*******************************************************************************
  *    MODULARITY BOILERCODE
  ******************************************************************************/
 static struct InputOps input_ops = {.init = input_init_intrfc,
+                                    .destroy = input_destroy_intrfc,
                                     .stop = input_stop_intrfc,
+                                    .request_stop = input_request_stop_intrfc,
                                     .wait = input_wait_intrfc,
                                     .start = input_start_intrfc,
                                     .add_device = input_add_device_intrfc,
                                     .get_device = input_get_device_intrfc,
                                     .set_callback = input_set_callback_intrfc,
                                     .get_device_extended =
-                                        input_get_device_extended};
+                                        input_get_device_extended,
+                                    .add_watch = input_add_watch_intrfc,
+                                    .remove_watch = input_remove_watch_intrfc,
+                                    .modify_watch = input_modify_watch_intrfc};
 
 static struct InputPrivateOps input_private_ops_ = {
     .init = input_init,
     .stop = input_stop,
+    .request_stop = input_request_stop,
     .wait = input_wait,
     .start = input_start,
     .add_device = input_add_device,
     .get_device = input_get_device,
     .set_device_callback = input_set_callback,
+    .destroy = input_destroy,
+    .add_watch = input_add_watch,
+    .remove_watch = input_remove_watch,
+    .modify_watch = input_modify_watch,
+    .loop = input_loop,
+    .join_loop = input_join_loop,
+    .stop_watch_callback = input_stop_watch_callback,
 };
 
 struct InputOps *get_input_ops(void) {
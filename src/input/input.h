@@ -10,7 +10,9 @@
 /*******************************************************************************
  *    IMPORTS
  ******************************************************************************/
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "init/init.h"
 #include "input/input_common.h"
@@ -25,6 +27,7 @@
 
 struct InputSetCallbackInput {
   input_callback_func_t callback;
+  input_batch_callback_func_t batch_callback;
   input_device_id_t device_id;
   void *private;
 };
@@ -69,11 +72,32 @@ struct InputGetDeviceExtendedOutput {
   input_device_id_t device_id;
 };
 
+// Input subsystem runs single event loop for all devices. Device embeds
+//  watch in its own state, sets fd, epoll events and callback and adds it
+//  while it is started. Callback is called from loop's thread whenever fd
+//  becomes ready, owner can be recovered with INPUT_WATCH_CONTAINER.
+struct InputWatch;
+
+typedef void (*input_watch_func_t)(struct InputWatch *watch, uint32_t events);
+
+struct InputWatch {
+  int fd;
+  uint32_t events;
+  input_watch_func_t callback;
+  bool is_added;
+};
+
+#define INPUT_WATCH_CONTAINER(watch, type, member)                             \
+  ((type *)((char *)(watch)-offsetof(type, member)))
+
 struct InputOps {
   int (*init)(void);
   void (*destroy)(void);
   int (*start)(void);
   int (*stop)(void);
+  // Only tells the loop to exit and returns, so it is safe to call from any
+  //  thread. Devices are stopped by stop, once wait returns.
+  int (*request_stop)(void);
   int (*wait)(void);
   int (*set_callback)(struct InputSetCallbackInput,
                       struct InputSetCallbackOutput *);
@@ -81,6 +105,11 @@ struct InputOps {
   int (*get_device)(struct InputGetDeviceInput, struct InputGetDeviceOutput *);
   int (*get_device_extended)(struct InputGetDeviceExtendedInput *,
                              struct InputGetDeviceExtendedOutput *);
+  int (*add_watch)(struct InputWatch *watch);
+  int (*remove_watch)(struct InputWatch *watch);
+  // Changes epoll events of already added watch, e.g. to wait until
+  //  socket is writable again.
+  int (*modify_watch)(struct InputWatch *watch, uint32_t events);
 };
 
 struct InputOps *get_input_ops(void);
@@ -1,6 +1,8 @@
 #ifndef INPUT_COMMON_H
 #define INPUT_COMMON_H
 
+#include <stddef.h>
+
 enum InputEvents {
   INPUT_EVENT_NONE = 0,
   INPUT_EVENT_UP,
@@ -14,9 +16,16 @@ enum InputEvents {
 
 typedef int input_device_id_t;
 
+// Devices never pass more events than this to batch callback at once.
+#define INPUT_BATCH_LENGTH_MAX 4097
+
 typedef int (*input_wait_func_t)(void);
 typedef int (*input_stop_func_t)(void);
 typedef int (*input_start_func_t)(void);
 typedef int (*input_callback_func_t)(enum InputEvents, input_device_id_t);
+// Receives all events which arrived together, so they can be processed at
+//  once instead of one by one.
+typedef int (*input_batch_callback_func_t)(const enum InputEvents *, size_t,
+                                           input_device_id_t);
 
 #endif
@@ -8,6 +8,7 @@
  ******************************************************************************/
 #include <errno.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "input/input_common.h"
@@ -16,6 +17,12 @@
 /*******************************************************************************
  *    PRIVATE FUNCTIONS
  ******************************************************************************/
+static const char *input_events_names[] = {
+    [INPUT_EVENT_UP] = "up",         [INPUT_EVENT_DOWN] = "down",
+    [INPUT_EVENT_LEFT] = "left",     [INPUT_EVENT_RIGHT] = "right",
+    [INPUT_EVENT_SELECT] = "select", [INPUT_EVENT_EXIT] = "exit",
+};
+
 static int init_input_device(struct InputDevice *device,
                              input_wait_func_t wait_func,
                              input_stop_func_t stop_func,
@@ -33,11 +40,39 @@ static int init_input_device(struct InputDevice *device,
   return 0;
 }
 
+static int parse_input_event(const char *token, enum InputEvents *input_event) {
+  char *end;
+  long value;
+
+  if (!token || !input_event) {
+    return EINVAL;
+  }
+
+  for (size_t i = 0;
+       i < sizeof(input_events_names) / sizeof(input_events_names[0]); i++) {
+    if (input_events_names[i] && strcmp(token, input_events_names[i]) == 0) {
+      *input_event = i;
+      return 0;
+    }
+  }
+
+  value = strtol(token, &end, 10);
+  if (end == token || *end || value <= INPUT_EVENT_NONE ||
+      value >= INPUT_EVENT_INVALID) {
+    return EINVAL;
+  }
+
+  *input_event = value;
+
+  return 0;
+}
+
 /*******************************************************************************
  *    PUBLIC OPERATIONS
  ******************************************************************************/
 static struct InputDeviceOps input_device_ops = {
     .init_device = init_input_device,
+    .parse_event = parse_input_event,
 };
 
 struct InputDeviceOps *get_input_device_ops(void) {
@@ -58,11 +58,16 @@ struct InputDevice {
   input_start_func_t start;
   const char *display_name;
   input_callback_func_t callback;
+  // Optional, devices fall back to callback if it is not set.
+  input_batch_callback_func_t batch_callback;
 };
 
 struct InputDeviceOps {
   int (*init_device)(struct InputDevice *, input_wait_func_t, input_stop_func_t,
                      input_start_func_t, const char *);
+  // Devices reading events as text accept them by name (`up`, `down`,
+  //  `left`, `right`, `select`, `exit`) or by number.
+  int (*parse_event)(const char *token, enum InputEvents *input_event);
 };
 
 struct InputDeviceOps *get_input_device_ops(void);
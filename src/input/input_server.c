@@ -0,0 +1,345 @@
+/*******************************************************************************
+ * @file input_server.c
+ * @brief Scaffolding shared by servers running on input subsystem's loop.
+ *
+ * Listening socket is non blocking and every readiness accepts all pending
+ * clients. Connections pool holds only indexes, owner keeps connections
+ * themselves in array of the same length, so nothing is allocated per
+ * client.
+ *
+ ******************************************************************************/
+#define _GNU_SOURCE // accept4
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "static_array_lib.h"
+
+// App's internal libs
+#include "input/input.h"
+#include "input/input_common.h"
+#include "input/input_device.h"
+#include "input/input_server.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+typedef struct InputServer InputServer;
+
+SARRS_DECL(InputServer, free_connections, size_t,
+           INPUT_SERVER_CONNECTIONS_MAX);
+
+static void input_server_process_listen(struct InputWatch *watch,
+                                        uint32_t events);
+static int input_server_listen(struct InputServer *server);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int input_server_init(struct InputServer *server, const char *name,
+                             size_t users_length, size_t connections_length,
+                             struct InputServerHandlers handlers) {
+  struct LoggingUtilsOps *logging_ops = get_logging_utils_ops();
+  struct InputDeviceOps *input_device_ops = get_input_device_ops();
+  struct InputAddDeviceOutput add_device_output;
+  struct InputDevice input_device;
+  struct InputServerUser *user;
+  int err;
+
+  if (users_length > INPUT_SERVER_USERS_MAX ||
+      connections_length > INPUT_SERVER_CONNECTIONS_MAX) {
+    return EINVAL;
+  }
+
+  server->name = name;
+  server->users_length = users_length;
+  server->connections_length = connections_length;
+  server->handlers = handlers;
+  server->listen_watch.fd = -1;
+  server->spare_fd = -1;
+
+  for (size_t i = 0; i < users_length; i++) {
+    user = &server->users[i];
+    snprintf(user->device_name, sizeof(user->device_name), "%s%zu", name,
+             i + 1);
+
+    err = input_device_ops->init_device(&input_device, handlers.wait,
+                                        handlers.stop, handlers.start,
+                                        user->device_name);
+    if (err) {
+      logging_ops->log_err(name, "Input device initialization failed: %s",
+                           strerror(err));
+      return err;
+    }
+
+    err = get_input_ops()->add_device(
+        (struct InputAddDeviceInput){.device = &input_device},
+        &add_device_output);
+    if (err) {
+      logging_ops->log_err(name, "Adding input device failed: %s",
+                           strerror(err));
+      return err;
+    }
+
+    user->device_id = add_device_output.device_id;
+  }
+
+  return 0;
+}
+
+static int input_server_parse_address(struct InputServer *server,
+                                      const char *address) {
+  const char unix_prefix[] = "unix:";
+  const char tcp_prefix[] = "tcp:";
+  const char *value;
+  char *end;
+  long port;
+
+  if (strncmp(address, unix_prefix, sizeof(unix_prefix) - 1) == 0) {
+    value = address + sizeof(unix_prefix) - 1;
+    if (*value == 0 ||
+        strlen(value) >= sizeof(server->unix_address.sun_path)) {
+      return EINVAL;
+    }
+
+    server->domain = AF_UNIX;
+    server->unix_address = (struct sockaddr_un){.sun_family = AF_UNIX};
+    strcpy(server->unix_address.sun_path, value);
+
+    return 0;
+  }
+
+  if (strncmp(address, tcp_prefix, sizeof(tcp_prefix) - 1) == 0) {
+    value = address + sizeof(tcp_prefix) - 1;
+    port = strtol(value, &end, 10);
+    if (end == value || *end || port <= 0 || port > UINT16_MAX) {
+      return EINVAL;
+    }
+
+    // Remote players are expected to come through a proxy, server itself
+    //  is never exposed.
+    server->domain = AF_INET;
+    server->tcp_address = (struct sockaddr_in){
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+
+    return 0;
+  }
+
+  return EINVAL;
+}
+
+static int input_server_start(struct InputServer *server) {
+  struct InputGetDeviceOutput get_device;
+  struct InputServerUser *user;
+  int err;
+
+  // Devices' callbacks are set by now, they do not change until the stop.
+  for (size_t i = 0; i < server->users_length; i++) {
+    user = &server->users[i];
+
+    err = get_input_ops()->get_device(
+        (struct InputGetDeviceInput){.device_id = user->device_id},
+        &get_device);
+    if (err) {
+      return err;
+    }
+
+    user->callback = get_device.device->callback;
+    user->batch_callback = get_device.device->batch_callback;
+  }
+
+  InputServer_free_connections_init(server);
+  for (size_t i = server->connections_length; i > 0; i--) {
+    InputServer_free_connections_append(server, i - 1);
+  }
+
+  server->accepted = 0;
+  server->rejected = 0;
+
+  server->spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+  if (server->spare_fd == -1) {
+    return errno;
+  }
+
+  err = input_server_listen(server);
+  if (err) {
+    close(server->spare_fd);
+    server->spare_fd = -1;
+    return err;
+  }
+
+  return 0;
+}
+
+static void input_server_stop(struct InputServer *server) {
+  if (server->listen_watch.fd == -1) {
+    return;
+  }
+
+  get_input_ops()->remove_watch(&server->listen_watch);
+  close(server->listen_watch.fd);
+  server->listen_watch.fd = -1;
+
+  close(server->spare_fd);
+  server->spare_fd = -1;
+
+  if (server->domain == AF_UNIX) {
+    unlink(server->unix_address.sun_path);
+  }
+}
+
+static int input_server_accept_client(struct InputServer *server, int fd,
+                                      size_t *index) {
+  int err;
+
+  if (InputServer_free_connections_length(server) == 0) {
+    server->rejected++;
+    return ENOSPC;
+  }
+
+  *index = server->free_connections[--server->free_connections_offset];
+
+  err = server->handlers.open_connection(fd, *index);
+  if (err) {
+    InputServer_free_connections_append(server, *index);
+    server->rejected++;
+    return err;
+  }
+
+  server->accepted++;
+
+  return 0;
+}
+
+// Out of fds, pending client would keep listening socket readable forever,
+//  so it is accepted on spare fd and closed right away.
+static void input_server_reject_client(struct InputServer *server) {
+  int fd;
+
+  get_logging_utils_ops()->log_err(server->name, "Out of file descriptors");
+
+  close(server->spare_fd);
+  fd = accept(server->listen_watch.fd, NULL, NULL);
+  if (fd != -1) {
+    close(fd);
+    server->rejected++;
+  }
+  server->spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+}
+
+// Connection's fd is already taken care of by the owner.
+static void input_server_release_connection(struct InputServer *server,
+                                            size_t index) {
+  InputServer_free_connections_append(server, index);
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int input_server_listen(struct InputServer *server) {
+  struct sockaddr *address;
+  socklen_t address_length;
+  int reuse = 1;
+  int fd;
+  int err;
+
+  fd = socket(server->domain, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    return errno;
+  }
+
+  if (server->domain == AF_UNIX) {
+    // Socket left behind by previous session would fail the bind.
+    unlink(server->unix_address.sun_path);
+    address = (struct sockaddr *)&server->unix_address;
+    address_length = sizeof(server->unix_address);
+  } else {
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    address = (struct sockaddr *)&server->tcp_address;
+    address_length = sizeof(server->tcp_address);
+  }
+
+  if (bind(fd, address, address_length) == -1 ||
+      listen(fd, SOMAXCONN) == -1) {
+    err = errno;
+    close(fd);
+    return err;
+  }
+
+  server->listen_watch = (struct InputWatch){
+      .fd = fd,
+      .events = EPOLLIN,
+      .callback = input_server_process_listen,
+  };
+
+  return 0;
+}
+
+static void input_server_process_listen(struct InputWatch *watch,
+                                        uint32_t events) {
+  struct InputServer *server =
+      INPUT_WATCH_CONTAINER(watch, struct InputServer, listen_watch);
+  size_t index;
+  int fd;
+  (void)events;
+
+  for (;;) {
+    fd = accept4(watch->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd == -1) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+
+      if (errno == EMFILE || errno == ENFILE) {
+        input_server_reject_client(server);
+        continue;
+      }
+
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        get_logging_utils_ops()->log_err(server->name,
+                                         "Unable to accept client: %s",
+                                         strerror(errno));
+      }
+
+      return;
+    }
+
+    if (input_server_accept_client(server, fd, &index)) {
+      close(fd);
+    }
+  }
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct InputServerOps input_server_ops = {
+    .init = input_server_init,
+    .parse_address = input_server_parse_address,
+    .start = input_server_start,
+    .stop = input_server_stop,
+    .accept_client = input_server_accept_client,
+    .reject_client = input_server_reject_client,
+    .release_connection = input_server_release_connection,
+};
+
+struct InputServerOps *get_input_server_ops(void) { return &input_server_ops; }
@@ -0,0 +1,93 @@
+#ifndef INPUT_SERVER_H
+#define INPUT_SERVER_H
+/*******************************************************************************
+ * @file input_server.h
+ * @brief Scaffolding shared by servers running on input subsystem's loop.
+ *
+ * Server registers `<name><n>` input device for every user, so game tells
+ * remote players apart the same way it tells apart local ones. Once
+ * started, it listens on Unix socket (`unix:<path>`) or on localhost TCP
+ * port (`tcp:<port>`), accepts clients and hands out slots of owner's
+ * connections pool. Everything clients send is left to the owner.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <netinet/in.h>
+#include <stddef.h>
+#include <sys/un.h>
+
+#include "static_array_lib.h"
+
+#include "input/input.h"
+#include "input/input_common.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define INPUT_SERVER_ADDRESS_MAX 128
+#define INPUT_SERVER_DEVICE_NAME_MAX 16
+#define INPUT_SERVER_USERS_MAX 10
+#define INPUT_SERVER_CONNECTIONS_MAX 4096
+
+struct InputServerUser {
+  char device_name[INPUT_SERVER_DEVICE_NAME_MAX];
+  input_device_id_t device_id;
+  // Captured on start, NULL if user does not play over the server.
+  input_callback_func_t callback;
+  input_batch_callback_func_t batch_callback;
+};
+
+struct InputServerHandlers {
+  // Users' devices share the server, every one of them gets these.
+  input_start_func_t start;
+  input_stop_func_t stop;
+  input_wait_func_t wait;
+  // Takes accepted client's fd into connection's slot, which is already
+  //  taken from the pool. Returns errno if client is turned away, slot goes
+  //  back to the pool then and fd is closed by caller.
+  int (*open_connection)(int fd, size_t index);
+};
+
+struct InputServer {
+  const char *name;
+  size_t users_length;
+  size_t connections_length;
+  struct InputServerHandlers handlers;
+  int domain;
+  struct sockaddr_un unix_address;
+  struct sockaddr_in tcp_address;
+  struct InputServerUser users[INPUT_SERVER_USERS_MAX];
+  // Added by the owner, unless its clients are accepted some other way.
+  struct InputWatch listen_watch;
+  // Kept open, so server can still turn clients away once out of fds.
+  int spare_fd;
+  // Connections which are not used, next one is taken from the end.
+  SARRS_FIELD(free_connections, size_t, INPUT_SERVER_CONNECTIONS_MAX);
+  size_t accepted;
+  size_t rejected;
+};
+
+struct InputServerOps {
+  int (*init)(struct InputServer *server, const char *name,
+              size_t users_length, size_t connections_length,
+              struct InputServerHandlers handlers);
+  int (*parse_address)(struct InputServer *server, const char *address);
+  // Captures users' callbacks, fills the pool and starts listening.
+  int (*start)(struct InputServer *server);
+  // Owner closes its connections first.
+  void (*stop)(struct InputServer *server);
+  // Fd is left to caller if client is turned away.
+  int (*accept_client)(struct InputServer *server, int fd, size_t *index);
+  void (*reject_client)(struct InputServer *server);
+  void (*release_connection)(struct InputServer *server, size_t index);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct InputServerOps *get_input_server_ops(void);
+
+#endif // INPUT_SERVER_H
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * @file input_timer.c
+ * @brief Timers pacing devices driven from input subsystem's event loop.
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+// App's internal libs
+#include "input/input.h"
+#include "input/input_timer.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define INPUT_TIMER_NS_PER_S 1000000000ULL
+#define INPUT_TIMER_BACKOFF_NS (1000 * 1000)
+
+static char module_id[] = "input_timer";
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int input_timer_set(struct InputWatch *watch, uint64_t deadline_ns) {
+  struct itimerspec timeout = {
+      .it_value = {.tv_sec = deadline_ns / INPUT_TIMER_NS_PER_S,
+                   .tv_nsec = deadline_ns % INPUT_TIMER_NS_PER_S},
+  };
+  int err;
+
+  if (timerfd_settime(watch->fd, TFD_TIMER_ABSTIME, &timeout, NULL) == -1) {
+    err = errno;
+    get_logging_utils_ops()->log_err(module_id, "Unable to set timer: %s",
+                                     strerror(err));
+    return err;
+  }
+
+  return 0;
+}
+
+static int input_timer_start(struct InputWatch *watch,
+                             input_watch_func_t callback,
+                             uint64_t deadline_ns) {
+  int err;
+
+  *watch = (struct InputWatch){
+      .fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC),
+      .events = EPOLLIN,
+      .callback = callback,
+  };
+  if (watch->fd == -1) {
+    return errno;
+  }
+
+  err = input_timer_set(watch, deadline_ns);
+  if (err) {
+    goto error;
+  }
+
+  err = get_input_ops()->add_watch(watch);
+  if (err) {
+    goto error;
+  }
+
+  return 0;
+
+error:
+  close(watch->fd);
+  watch->fd = -1;
+
+  return err;
+}
+
+static void input_timer_stop(struct InputWatch *watch) {
+  if (watch->fd == -1) {
+    return;
+  }
+
+  get_input_ops()->remove_watch(watch);
+
+  close(watch->fd);
+  watch->fd = -1;
+}
+
+static bool input_timer_consume(struct InputWatch *watch) {
+  uint64_t expirations;
+
+  return read(watch->fd, &expirations, sizeof(expirations)) ==
+         sizeof(expirations);
+}
+
+static int input_timer_back_off(struct InputWatch *watch, uint64_t now_ns) {
+  return input_timer_set(watch, now_ns + INPUT_TIMER_BACKOFF_NS);
+}
+
+static uint64_t input_timer_get_timestamp(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * INPUT_TIMER_NS_PER_S + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct InputTimerOps input_timer_ops = {
+    .start = input_timer_start,
+    .stop = input_timer_stop,
+    .set = input_timer_set,
+    .consume = input_timer_consume,
+    .back_off = input_timer_back_off,
+    .get_timestamp = input_timer_get_timestamp,
+};
+
+struct InputTimerOps *get_input_timer_ops(void) { return &input_timer_ops; }
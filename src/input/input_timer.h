@@ -0,0 +1,45 @@
+#ifndef INPUT_TIMER_H
+#define INPUT_TIMER_H
+/*******************************************************************************
+ * @file input_timer.h
+ * @brief Timers pacing devices driven from input subsystem's event loop.
+ *
+ * Devices which do not own any thread, like replay and generator, keep
+ * timerfd watched by input's loop and deliver events whenever it fires.
+ * Deadlines are absolute CLOCK_MONOTONIC nanoseconds, deadline which is
+ * already in the past fires right away.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "input/input.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+struct InputTimerOps {
+  // Creates timer armed for the deadline and adds it to input's loop.
+  int (*start)(struct InputWatch *watch, input_watch_func_t callback,
+               uint64_t deadline_ns);
+  void (*stop)(struct InputWatch *watch);
+  int (*set)(struct InputWatch *watch, uint64_t deadline_ns);
+  // Consumes timer's expirations, false means the timer did not fire.
+  bool (*consume)(struct InputWatch *watch);
+  // Callback returned ENOBUFS, game can't take more events right now. Event
+  //  stays pending and timer fires again once game had a moment to catch
+  //  up.
+  int (*back_off)(struct InputWatch *watch, uint64_t now_ns);
+  uint64_t (*get_timestamp)(void);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct InputTimerOps *get_input_timer_ops(void);
+
+#endif // INPUT_TIMER_H
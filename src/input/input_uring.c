@@ -0,0 +1,777 @@
+/*******************************************************************************
+ * @file input_uring.c
+ * @brief io_uring backend for servers running on input's loop.
+ *
+ * Ring is driven with raw syscalls, so build needs only kernel headers. All
+ * completions available at once are processed as one batch: requests they
+ * queue (re-armed multishots, closes) are submitted and buffers they used
+ * are handed back to the kernel once, after the whole batch. Closing client
+ * is an async cancel of its receive linked with close of its fd, so it costs
+ * no syscall of its own either.
+ *
+ * Request's user data packs its type, client's id and generation of the
+ * client's slot. Slot's generation changes every time it is reused, so
+ * completions still on their way for previous client are recognized and
+ * dropped.
+ *
+ ******************************************************************************/
+#define _GNU_SOURCE // syscall
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifdef TTT_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+// App's internal libs
+#include "input/input.h"
+#include "input/input_uring.h"
+#include "utils/logging_utils.h"
+
+#ifdef TTT_IO_URING
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define URING_SQ_ENTRIES 256
+// Every client can have receive and close completions waiting at once.
+#define URING_CQ_ENTRIES (4 * INPUT_URING_CONNECTIONS_MAX)
+// Has to be power of two.
+#define URING_BUFFERS_AMOUNT 1024
+#define URING_BUFFER_SIZE 1024
+#define URING_BUFFER_GROUP 0
+#define URING_GENERATION_MASK 0xFFFFFFu
+#define URING_USER_DATA(type, generation, id)                                  \
+  ((uint64_t)(type) << 56 |                                                    \
+   (uint64_t)((generation) & URING_GENERATION_MASK) << 32 | (uint32_t)(id))
+
+enum UringRequests {
+  URING_REQUEST_ACCEPT = 1,
+  URING_REQUEST_RECEIVE,
+  URING_REQUEST_CANCEL,
+  URING_REQUEST_CLOSE,
+};
+
+struct UringConnection {
+  int fd;
+  uint32_t generation;
+  bool is_open;
+};
+
+typedef struct InputUring {
+  int fd;
+  struct InputWatch watch;
+  int listen_fd;
+  struct InputUringHandlers handlers;
+  // Submission queue, entries are queued locally and kernel sees them only
+  //  once they are submitted.
+  void *sq_memory;
+  size_t sq_memory_size;
+  struct io_uring_sqe *sqes;
+  size_t sqes_size;
+  uint32_t *sq_head;
+  uint32_t *sq_tail;
+  uint32_t *sq_mask;
+  uint32_t *sq_flags;
+  uint32_t sq_entries;
+  uint32_t sq_local_tail;
+  uint32_t sq_pending;
+  // Completion queue shares the mapping with submission queue.
+  uint32_t *cq_head;
+  uint32_t *cq_tail;
+  uint32_t *cq_mask;
+  struct io_uring_cqe *cqes;
+  // Ring of provided buffers followed by the buffers themselves.
+  void *buffers_memory;
+  size_t buffers_memory_size;
+  struct io_uring_buf_ring *buffers_ring;
+  char *buffers;
+  uint16_t buffers_tail;
+  struct UringConnection connections[INPUT_URING_CONNECTIONS_MAX];
+  size_t closes_pending;
+  bool is_accept_armed;
+  struct InputUringStats stats;
+  bool is_started;
+} InputUring;
+
+struct InputUringPrivateOps {
+  int (*map_ring)(struct InputUring *ring);
+  int (*map_buffers)(struct InputUring *ring);
+  void (*release)(struct InputUring *ring);
+  int (*get_sqes)(struct InputUring *ring, struct io_uring_sqe **sqes,
+                  size_t sqes_length);
+  int (*submit)(struct InputUring *ring, uint32_t min_complete);
+  int (*queue_accept)(struct InputUring *ring);
+  int (*queue_receive)(struct InputUring *ring, size_t id);
+  void (*process_ring)(struct InputWatch *watch, uint32_t events);
+  void (*reap)(struct InputUring *ring);
+  void (*process_completion)(struct InputUring *ring,
+                             const struct io_uring_cqe *cqe);
+  void (*process_accept)(struct InputUring *ring, int result,
+                         uint32_t flags);
+  void (*process_receive)(struct InputUring *ring, size_t id,
+                          uint32_t generation, int result, uint32_t flags);
+  void (*recycle_buffer)(struct InputUring *ring, uint16_t buffer_id);
+  void (*close_slot)(struct InputUring *ring, size_t id);
+};
+
+static char module_id[] = "input_uring";
+static struct InputUring input_uring;
+static struct InputOps *input_ops;
+static struct LoggingUtilsOps *logging_ops;
+static struct InputUringPrivateOps *uring_priv_ops;
+struct InputUringPrivateOps *get_input_uring_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static bool input_uring_is_supported(void) { return true; }
+
+static int input_uring_start(int listen_fd,
+                             struct InputUringHandlers handlers) {
+  struct InputUring *ring = &input_uring;
+  int err;
+
+  if (listen_fd < 0 || !handlers.accept || !handlers.reject ||
+      !handlers.receive || !handlers.close) {
+    return EINVAL;
+  }
+
+  if (ring->is_started) {
+    return EALREADY;
+  }
+
+  uring_priv_ops = get_input_uring_priv_ops();
+  logging_ops = get_logging_utils_ops();
+  input_ops = get_input_ops();
+
+  ring->fd = -1;
+  ring->listen_fd = listen_fd;
+  ring->handlers = handlers;
+  ring->sq_memory = NULL;
+  ring->sqes = NULL;
+  ring->buffers_memory = NULL;
+  ring->closes_pending = 0;
+  ring->is_accept_armed = false;
+  ring->stats = (struct InputUringStats){0};
+
+  for (size_t i = 0; i < INPUT_URING_CONNECTIONS_MAX; i++) {
+    ring->connections[i].fd = -1;
+    ring->connections[i].is_open = false;
+  }
+
+  err = uring_priv_ops->map_ring(ring);
+  if (err) {
+    goto error;
+  }
+
+  err = uring_priv_ops->map_buffers(ring);
+  if (err) {
+    goto error;
+  }
+
+  ring->is_started = true;
+
+  err = uring_priv_ops->queue_accept(ring);
+  if (err) {
+    goto error;
+  }
+
+  err = uring_priv_ops->submit(ring, 0);
+  if (err) {
+    goto error;
+  }
+
+  ring->watch = (struct InputWatch){
+      .fd = ring->fd,
+      .events = EPOLLIN,
+      .callback = uring_priv_ops->process_ring,
+  };
+
+  err = input_ops->add_watch(&ring->watch);
+  if (err) {
+    goto error;
+  }
+
+  return 0;
+
+error:
+  ring->is_started = false;
+  uring_priv_ops->release(ring);
+  return err;
+}
+
+static void input_uring_stop(void) {
+  struct InputUring *ring = &input_uring;
+  struct io_uring_sqe *sqe;
+
+  if (!ring->is_started) {
+    return;
+  }
+
+  ring->is_started = false;
+  input_ops->remove_watch(&ring->watch);
+
+  for (size_t i = 0; i < INPUT_URING_CONNECTIONS_MAX; i++) {
+    uring_priv_ops->close_slot(ring, i);
+  }
+
+  if (ring->is_accept_armed && uring_priv_ops->get_sqes(ring, &sqe, 1) == 0) {
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = URING_USER_DATA(URING_REQUEST_ACCEPT, 0, 0);
+    sqe->user_data = URING_USER_DATA(URING_REQUEST_CANCEL, 0, 0);
+  }
+
+  // Closes are waited for, so no client's fd outlives the server, same for
+  //  accept, which would keep listening socket alive.
+  while (ring->closes_pending > 0 || ring->is_accept_armed) {
+    if (uring_priv_ops->submit(ring, 1)) {
+      break;
+    }
+    uring_priv_ops->reap(ring);
+  }
+
+  uring_priv_ops->release(ring);
+}
+
+static void input_uring_close_connection(size_t id) {
+  if (!input_uring.is_started || id >= INPUT_URING_CONNECTIONS_MAX) {
+    return;
+  }
+
+  uring_priv_ops->close_slot(&input_uring, id);
+}
+
+static void input_uring_get_stats(struct InputUringStats *stats) {
+  if (!stats) {
+    return;
+  }
+
+  *stats = input_uring.stats;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int input_uring_map_ring(struct InputUring *ring) {
+  struct io_uring_params params = {
+      .flags = IORING_SETUP_CQSIZE,
+      .cq_entries = URING_CQ_ENTRIES,
+  };
+  size_t cq_memory_size;
+  uint32_t *sq_array;
+
+  ring->fd = syscall(__NR_io_uring_setup, URING_SQ_ENTRIES, &params);
+  if (ring->fd == -1) {
+    return errno;
+  }
+
+  // Kernels without these are older than multishot receive anyway.
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+      !(params.features & IORING_FEAT_NODROP)) {
+    return ENOTSUP;
+  }
+
+  ring->sq_memory_size =
+      params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_memory_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  if (cq_memory_size > ring->sq_memory_size) {
+    ring->sq_memory_size = cq_memory_size;
+  }
+
+  ring->sq_memory =
+      mmap(NULL, ring->sq_memory_size, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  if (ring->sq_memory == MAP_FAILED) {
+    ring->sq_memory = NULL;
+    return errno;
+  }
+
+  ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  if (ring->sqes == MAP_FAILED) {
+    ring->sqes = NULL;
+    return errno;
+  }
+
+  ring->sq_head = (uint32_t *)((char *)ring->sq_memory + params.sq_off.head);
+  ring->sq_tail = (uint32_t *)((char *)ring->sq_memory + params.sq_off.tail);
+  ring->sq_mask =
+      (uint32_t *)((char *)ring->sq_memory + params.sq_off.ring_mask);
+  ring->sq_flags = (uint32_t *)((char *)ring->sq_memory + params.sq_off.flags);
+  ring->sq_entries = params.sq_entries;
+  ring->sq_local_tail = *ring->sq_tail;
+  ring->sq_pending = 0;
+
+  // Entries are always taken in order, so the indirection array stays the
+  //  identity.
+  sq_array = (uint32_t *)((char *)ring->sq_memory + params.sq_off.array);
+  for (uint32_t i = 0; i < params.sq_entries; i++) {
+    sq_array[i] = i;
+  }
+
+  ring->cq_head = (uint32_t *)((char *)ring->sq_memory + params.cq_off.head);
+  ring->cq_tail = (uint32_t *)((char *)ring->sq_memory + params.cq_off.tail);
+  ring->cq_mask =
+      (uint32_t *)((char *)ring->sq_memory + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe *)((char *)ring->sq_memory +
+                                       params.cq_off.cqes);
+
+  return 0;
+}
+
+static int input_uring_map_buffers(struct InputUring *ring) {
+  size_t ring_size = URING_BUFFERS_AMOUNT * sizeof(struct io_uring_buf);
+  struct io_uring_buf_reg buffers_reg;
+
+  // Buffers' ring has to be page aligned, so it is mapped rather than
+  //  allocated.
+  ring->buffers_memory_size =
+      ring_size + URING_BUFFERS_AMOUNT * URING_BUFFER_SIZE;
+  ring->buffers_memory =
+      mmap(NULL, ring->buffers_memory_size, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+  if (ring->buffers_memory == MAP_FAILED) {
+    ring->buffers_memory = NULL;
+    return errno;
+  }
+
+  ring->buffers_ring = ring->buffers_memory;
+  ring->buffers = (char *)ring->buffers_memory + ring_size;
+  ring->buffers_tail = 0;
+
+  buffers_reg = (struct io_uring_buf_reg){
+      .ring_addr = (uintptr_t)ring->buffers_ring,
+      .ring_entries = URING_BUFFERS_AMOUNT,
+      .bgid = URING_BUFFER_GROUP,
+  };
+
+  if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PBUF_RING,
+              &buffers_reg, 1) == -1) {
+    return errno;
+  }
+
+  for (uint16_t i = 0; i < URING_BUFFERS_AMOUNT; i++) {
+    uring_priv_ops->recycle_buffer(ring, i);
+  }
+
+  __atomic_store_n(&ring->buffers_ring->tail, ring->buffers_tail,
+                   __ATOMIC_RELEASE);
+
+  return 0;
+}
+
+static void input_uring_release(struct InputUring *ring) {
+  // Kernel keeps registered buffers pinned until the ring is gone.
+  if (ring->fd != -1) {
+    close(ring->fd);
+    ring->fd = -1;
+  }
+
+  if (ring->buffers_memory) {
+    munmap(ring->buffers_memory, ring->buffers_memory_size);
+    ring->buffers_memory = NULL;
+  }
+
+  if (ring->sqes) {
+    munmap(ring->sqes, ring->sqes_size);
+    ring->sqes = NULL;
+  }
+
+  if (ring->sq_memory) {
+    munmap(ring->sq_memory, ring->sq_memory_size);
+    ring->sq_memory = NULL;
+  }
+}
+
+// Entries are taken at once, so linked ones never end up in different
+//  submissions.
+static int input_uring_get_sqes(struct InputUring *ring,
+                                struct io_uring_sqe **sqes,
+                                size_t sqes_length) {
+  uint32_t head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+  int err;
+
+  if (ring->sq_entries - (ring->sq_local_tail - head) < sqes_length) {
+    // Queue is full, what is queued so far goes to kernel early.
+    err = uring_priv_ops->submit(ring, 0);
+    if (err) {
+      return err;
+    }
+
+    head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if (ring->sq_entries - (ring->sq_local_tail - head) < sqes_length) {
+      return EBUSY;
+    }
+  }
+
+  for (size_t i = 0; i < sqes_length; i++) {
+    sqes[i] = &ring->sqes[ring->sq_local_tail++ & *ring->sq_mask];
+    memset(sqes[i], 0, sizeof(*sqes[i]));
+  }
+
+  ring->sq_pending += sqes_length;
+
+  return 0;
+}
+
+static int input_uring_submit(struct InputUring *ring, uint32_t min_complete) {
+  uint32_t flags = 0;
+  int submitted;
+
+  // Completions kernel had no room for are moved to the ring on enter.
+  if (min_complete > 0 || __atomic_load_n(ring->sq_flags, __ATOMIC_RELAXED) &
+                              IORING_SQ_CQ_OVERFLOW) {
+    flags |= IORING_ENTER_GETEVENTS;
+  }
+
+  if (ring->sq_pending == 0 && !flags) {
+    return 0;
+  }
+
+  __atomic_store_n(ring->sq_tail, ring->sq_local_tail, __ATOMIC_RELEASE);
+
+  do {
+    submitted = syscall(__NR_io_uring_enter, ring->fd, ring->sq_pending,
+                        min_complete, flags, NULL, 0);
+    ring->stats.enters++;
+  } while (submitted == -1 && errno == EINTR);
+
+  if (submitted == -1) {
+    return errno;
+  }
+
+  ring->stats.submissions += submitted;
+  ring->sq_pending -= submitted;
+
+  return 0;
+}
+
+static int input_uring_queue_accept(struct InputUring *ring) {
+  struct io_uring_sqe *sqe;
+  int err;
+
+  err = uring_priv_ops->get_sqes(ring, &sqe, 1);
+  if (err) {
+    return err;
+  }
+
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = ring->listen_fd;
+  sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+  sqe->accept_flags = SOCK_CLOEXEC;
+  sqe->user_data = URING_USER_DATA(URING_REQUEST_ACCEPT, 0, 0);
+
+  ring->is_accept_armed = true;
+
+  return 0;
+}
+
+static int input_uring_queue_receive(struct InputUring *ring, size_t id) {
+  struct UringConnection *connection = &ring->connections[id];
+  struct io_uring_sqe *sqe;
+  int err;
+
+  err = uring_priv_ops->get_sqes(ring, &sqe, 1);
+  if (err) {
+    return err;
+  }
+
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = connection->fd;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = URING_BUFFER_GROUP;
+  sqe->user_data =
+      URING_USER_DATA(URING_REQUEST_RECEIVE, connection->generation, id);
+
+  return 0;
+}
+
+static void input_uring_process_ring(struct InputWatch *watch,
+                                     uint32_t events) {
+  struct InputUring *ring =
+      INPUT_WATCH_CONTAINER(watch, struct InputUring, watch);
+  int err;
+  (void)events;
+
+  if (!ring->is_started) {
+    return;
+  }
+
+  uring_priv_ops->reap(ring);
+
+  err = uring_priv_ops->submit(ring, 0);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to submit requests: %s",
+                         strerror(err));
+  }
+}
+
+static void input_uring_reap(struct InputUring *ring) {
+  uint32_t head = *ring->cq_head;
+  uint32_t tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+  while (head != tail) {
+    for (; head != tail; head++) {
+      uring_priv_ops->process_completion(ring,
+                                         &ring->cqes[head & *ring->cq_mask]);
+      ring->stats.completions++;
+    }
+
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+  }
+
+  __atomic_store_n(&ring->buffers_ring->tail, ring->buffers_tail,
+                   __ATOMIC_RELEASE);
+}
+
+static void input_uring_process_completion(struct InputUring *ring,
+                                           const struct io_uring_cqe *cqe) {
+  uint32_t generation = (cqe->user_data >> 32) & URING_GENERATION_MASK;
+  size_t id = (uint32_t)cqe->user_data;
+
+  switch (cqe->user_data >> 56) {
+  case URING_REQUEST_ACCEPT:
+    uring_priv_ops->process_accept(ring, cqe->res, cqe->flags);
+    break;
+  case URING_REQUEST_RECEIVE:
+    uring_priv_ops->process_receive(ring, id, generation, cqe->res,
+                                    cqe->flags);
+    break;
+  case URING_REQUEST_CLOSE:
+    ring->closes_pending--;
+    break;
+  default:
+    break;
+  }
+}
+
+static void input_uring_process_accept(struct InputUring *ring, int result,
+                                       uint32_t flags) {
+  struct UringConnection *connection;
+  size_t id;
+  int err;
+
+  if (!(flags & IORING_CQE_F_MORE)) {
+    ring->is_accept_armed = false;
+  }
+
+  if (result < 0) {
+    // Out of fds, pending client would fail the accept forever, so server
+    //  turns it away.
+    if (result == -EMFILE || result == -ENFILE) {
+      ring->handlers.reject();
+    } else if (result != -ECANCELED && result != -ECONNABORTED &&
+               result != -EINTR) {
+      logging_ops->log_err(module_id, "Unable to accept client: %s",
+                           strerror(-result));
+      return;
+    }
+  }
+
+  // Kernel ends multishot accept e.g. if it runs out of memory.
+  if (ring->is_started && !ring->is_accept_armed) {
+    err = uring_priv_ops->queue_accept(ring);
+    if (err) {
+      logging_ops->log_err(module_id, "Unable to accept clients: %s",
+                           strerror(err));
+    }
+  }
+
+  if (result < 0) {
+    return;
+  }
+
+  if (!ring->is_started || ring->handlers.accept(result, &id) ||
+      id >= INPUT_URING_CONNECTIONS_MAX) {
+    close(result);
+    return;
+  }
+
+  connection = &ring->connections[id];
+  connection->fd = result;
+  connection->generation = (connection->generation + 1) &
+                           URING_GENERATION_MASK;
+  connection->is_open = true;
+
+  err = uring_priv_ops->queue_receive(ring, id);
+  if (err) {
+    close(result);
+    connection->is_open = false;
+    ring->handlers.close(id);
+  }
+}
+
+static void input_uring_process_receive(struct InputUring *ring, size_t id,
+                                        uint32_t generation, int result,
+                                        uint32_t flags) {
+  struct UringConnection *connection;
+  uint16_t buffer_id = flags >> IORING_CQE_BUFFER_SHIFT;
+  bool is_current;
+  int err;
+
+  if (id >= INPUT_URING_CONNECTIONS_MAX) {
+    return;
+  }
+
+  connection = &ring->connections[id];
+  is_current = connection->is_open && connection->generation == generation;
+
+  if (is_current && result > 0 && (flags & IORING_CQE_F_BUFFER)) {
+    err = ring->handlers.receive(
+        id, ring->buffers + (size_t)buffer_id * URING_BUFFER_SIZE, result);
+    if (err) {
+      uring_priv_ops->close_slot(ring, id);
+    }
+  }
+
+  // Completion of stale or cancelled request can still carry a buffer.
+  if (flags & IORING_CQE_F_BUFFER) {
+    uring_priv_ops->recycle_buffer(ring, buffer_id);
+  }
+
+  if (!is_current || !connection->is_open || (flags & IORING_CQE_F_MORE)) {
+    return;
+  }
+
+  // Receive ends once kernel runs out of buffers, they are given back
+  //  before it is submitted again.
+  if (result > 0 || result == -ENOBUFS) {
+    err = uring_priv_ops->queue_receive(ring, id);
+    if (!err) {
+      return;
+    }
+  }
+
+  // Peer closed connection or it broke, there is nothing more to read.
+  uring_priv_ops->close_slot(ring, id);
+  ring->handlers.close(id);
+}
+
+static void input_uring_recycle_buffer(struct InputUring *ring,
+                                       uint16_t buffer_id) {
+  struct io_uring_buf *buffer =
+      &ring->buffers_ring
+           ->bufs[ring->buffers_tail++ & (URING_BUFFERS_AMOUNT - 1)];
+
+  buffer->addr =
+      (uintptr_t)(ring->buffers + (size_t)buffer_id * URING_BUFFER_SIZE);
+  buffer->len = URING_BUFFER_SIZE;
+  buffer->bid = buffer_id;
+}
+
+static void input_uring_close_slot(struct InputUring *ring, size_t id) {
+  struct UringConnection *connection = &ring->connections[id];
+  struct io_uring_sqe *sqes[2];
+
+  if (!connection->is_open) {
+    return;
+  }
+
+  connection->is_open = false;
+
+  if (uring_priv_ops->get_sqes(ring, sqes, 2)) {
+    // Shutdown ends pending receive, ring would hold the socket otherwise.
+    shutdown(connection->fd, SHUT_RDWR);
+    close(connection->fd);
+    connection->fd = -1;
+    return;
+  }
+
+  // Close waits for the cancel, whatever its result is.
+  sqes[0]->opcode = IORING_OP_ASYNC_CANCEL;
+  sqes[0]->flags = IOSQE_IO_HARDLINK;
+  sqes[0]->addr = URING_USER_DATA(URING_REQUEST_RECEIVE,
+                                  connection->generation, id);
+  sqes[0]->user_data =
+      URING_USER_DATA(URING_REQUEST_CANCEL, connection->generation, id);
+
+  sqes[1]->opcode = IORING_OP_CLOSE;
+  sqes[1]->fd = connection->fd;
+  sqes[1]->user_data =
+      URING_USER_DATA(URING_REQUEST_CLOSE, connection->generation, id);
+
+  connection->fd = -1;
+  ring->closes_pending++;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct InputUringPrivateOps input_uring_priv_ops_ = {
+    .map_ring = input_uring_map_ring,
+    .map_buffers = input_uring_map_buffers,
+    .release = input_uring_release,
+    .get_sqes = input_uring_get_sqes,
+    .submit = input_uring_submit,
+    .queue_accept = input_uring_queue_accept,
+    .queue_receive = input_uring_queue_receive,
+    .process_ring = input_uring_process_ring,
+    .reap = input_uring_reap,
+    .process_completion = input_uring_process_completion,
+    .process_accept = input_uring_process_accept,
+    .process_receive = input_uring_process_receive,
+    .recycle_buffer = input_uring_recycle_buffer,
+    .close_slot = input_uring_close_slot,
+};
+
+struct InputUringPrivateOps *get_input_uring_priv_ops(void) {
+  return &input_uring_priv_ops_;
+}
+
+#else
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+// Backend is not compiled in, servers stay on epoll.
+static bool input_uring_is_supported(void) { return false; }
+
+static int input_uring_start(int listen_fd,
+                             struct InputUringHandlers handlers) {
+  (void)listen_fd;
+  (void)handlers;
+
+  return ENOTSUP;
+}
+
+static void input_uring_stop(void) {}
+
+static void input_uring_close_connection(size_t id) { (void)id; }
+
+static void input_uring_get_stats(struct InputUringStats *stats) {
+  if (!stats) {
+    return;
+  }
+
+  *stats = (struct InputUringStats){0};
+}
+#endif // TTT_IO_URING
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct InputUringOps input_uring_ops = {
+    .is_supported = input_uring_is_supported,
+    .start = input_uring_start,
+    .stop = input_uring_stop,
+    .close_connection = input_uring_close_connection,
+    .get_stats = input_uring_get_stats,
+};
+
+struct InputUringOps *get_input_uring_ops(void) { return &input_uring_ops; }
@@ -0,0 +1,68 @@
+#ifndef INPUT_URING_H
+#define INPUT_URING_H
+/*******************************************************************************
+ * @file input_uring.h
+ * @brief io_uring backend for servers running on input's loop.
+ *
+ * Backend accepts clients of a listening socket and receives their data
+ * through a single ring, instead of one epoll watch and one read per
+ * client. Accept and receive are multishot, so each is submitted once per
+ * listening socket or client, received data lands in buffers registered
+ * with the kernel up front, and all requests queued while completions are
+ * processed are submitted with one syscall. Ring itself is watched from
+ * input's loop, so its owner still runs on the same thread as with epoll.
+ *
+ * Backend is compiled in only if build is configured with `-Dio_uring=
+ * enabled`, otherwise is_supported returns false and start fails with
+ * ENOTSUP. Kernel has to be at least 6.0.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define INPUT_URING_CONNECTIONS_MAX 4096
+
+struct InputUringHandlers {
+  // Takes accepted client's fd and returns its id, which is lower than
+  //  INPUT_URING_CONNECTIONS_MAX, or errno if client is turned away, its fd
+  //  is closed by backend then.
+  int (*accept)(int fd, size_t *id);
+  // Called when process runs out of fds while client waits to be accepted.
+  void (*reject)(void);
+  // Returns non zero if client should be closed.
+  int (*receive)(size_t id, const char *data, size_t length);
+  // Client disconnected or its connection broke, fd is closed by backend.
+  void (*close)(size_t id);
+};
+
+struct InputUringStats {
+  // Requests handed to the kernel.
+  size_t submissions;
+  // Syscalls made to submit requests or wait for their completions.
+  size_t enters;
+  size_t completions;
+};
+
+struct InputUringOps {
+  bool (*is_supported)(void);
+  // Listening socket stays owned by caller, it is closed after stop.
+  int (*start)(int listen_fd, struct InputUringHandlers handlers);
+  void (*stop)(void);
+  // Closes client in the background, its handlers are not called anymore.
+  void (*close_connection)(size_t id);
+  void (*get_stats)(struct InputUringStats *stats);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct InputUringOps *get_input_uring_ops(void);
+
+#endif // INPUT_URING_H
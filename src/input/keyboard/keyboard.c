@@ -1,6 +1,11 @@
 /*******************************************************************************
  * @file keyboard.c
  * @brief Refactored Keyboard subsystem implementation
+ *
+ * Keyboard does not own any thread, it watches stdin from input subsystem's
+ * event loop and processes whatever is available once stdin is readable.
+ * Bytes are decoded into keys first, so escape sequences of arrows and
+ * other special keys reach key mappings as single keys.
  ******************************************************************************/
 
 /*******************************************************************************
@@ -8,14 +13,14 @@
  ******************************************************************************/
 // C standard library
 #include <errno.h>
-#include <poll.h>
-#include <pthread.h>
-#include <signal.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 
 #include "static_array_lib.h"
@@ -25,6 +30,7 @@
 #include "input/input.h"
 #include "input/input_common.h"
 #include "input/keyboard/keyboard.h"
+#include "input/keyboard/keyboard_decoder.h"
 #include "input/keyboard/keyboard_keys_mapping.h"
 #include "utils/logging_utils.h"
 #include "utils/signals_utils.h"
@@ -34,33 +40,73 @@
  *    PRIVATE DECLARATIONS & DEFINITIONS
  ******************************************************************************/
 #define KEYBOARD_KEYS_MAPPINGS_MAX 10
-#define KEYBOARD_STDIN_BUFFER_MAX 10
+// Big enough for pasted text or piped script, every byte may be a key.
+#define KEYBOARD_STDIN_BUFFER_MAX 4096
+// Escape pending from previous read may become one more key.
+#define KEYBOARD_KEYS_MAX (KEYBOARD_STDIN_BUFFER_MAX + 1)
+
+_Static_assert(KEYBOARD_KEYS_MAX <= INPUT_BATCH_LENGTH_MAX,
+               "Whole read has to fit into one batch");
+// Terminals send whole escape sequence at once, anything slower is a user
+//  pressing escape key.
+#define KEYBOARD_ESCAPE_TIMEOUT_MS 100
+
+// Mapping resolved to everything needed for decoding and delivering the
+//  events. Dispatch table is built when keyboard starts and only read
+//  afterwards, so reading stdin needs no device lookups.
+struct KeyboardDispatch {
+  enum InputEvents keys[KEYBOARD_KEYS_TABLE_LENGTH];
+  // Used only by mappings which do not have keys table.
+  keyboard_key_mapping_callback_t decode;
+  input_callback_func_t callback;
+  input_batch_callback_func_t batch_callback;
+  input_device_id_t device_id;
+};
 
 typedef struct KeyboardSubsystem {
-  pthread_t thread;
+  struct InputWatch watch;
+  // Timer flushing unfinished escape sequence, runs on input's loop too.
+  struct InputWatch escape_watch;
   bool is_initialized;
   size_t stdin_buffer_count;
   char stdin_buffer[KEYBOARD_STDIN_BUFFER_MAX];
+  // Decoder is kept across reads, sequences may be split between them.
+  struct KeyboardDecoder decoder;
+  size_t keys_count;
+  keyboard_key_t keys[KEYBOARD_KEYS_MAX];
+  enum InputEvents input_events[KEYBOARD_KEYS_MAX];
   SARRS_FIELD(keys_mappings, struct KeyboardKeysMapping,
               KEYBOARD_KEYS_MAPPINGS_MAX);
+  SARRS_FIELD(dispatches, struct KeyboardDispatch, KEYBOARD_KEYS_MAPPINGS_MAX);
 } KeyboardSubsystem;
 
 SARRS_DECL(KeyboardSubsystem, keys_mappings, struct KeyboardKeysMapping,
            KEYBOARD_KEYS_MAPPINGS_MAX);
+SARRS_DECL(KeyboardSubsystem, dispatches, struct KeyboardDispatch,
+           KEYBOARD_KEYS_MAPPINGS_MAX);
 
 struct KeyboardPrivateOps {
   int (*init)(struct KeyboardSubsystem *);
   void (*destroy)(struct KeyboardSubsystem *);
-  void (*read_stdin)(struct KeyboardSubsystem *);
-  int (*start_thread)(struct KeyboardSubsystem *);
-  void (*stop_thread)(struct KeyboardSubsystem *);
-  void *(*process_stdin)(struct KeyboardSubsystem *);
+  int (*read_stdin)(struct KeyboardSubsystem *);
+  int (*start_watch)(struct KeyboardSubsystem *);
+  void (*stop_watch)(struct KeyboardSubsystem *);
+  void (*process_stdin)(struct InputWatch *, uint32_t);
+  void (*process_escape_timeout)(struct InputWatch *, uint32_t);
+  int (*set_escape_timeout)(struct KeyboardSubsystem *, bool is_armed);
   void (*execute_callbacks)(struct KeyboardSubsystem *);
+  int (*build_dispatches)(struct KeyboardSubsystem *);
+  int (*decode)(struct KeyboardSubsystem *, struct KeyboardDispatch *,
+                size_t *);
+  int (*deliver_events)(struct KeyboardDispatch *dispatch,
+                        const enum InputEvents *input_events,
+                        size_t input_events_length);
   int (*add_keys_mapping)(struct KeyboardAddKeysMappingInput *,
                           struct KeyboardAddKeysMappingOutput *);
 };
 
 static struct InputOps *input_ops;
+static struct KeyboardDecoderOps *decoder_ops;
 static const char module_id[] = "keyboard";
 static struct SignalUtilsOps *signals_ops;
 static struct LoggingUtilsOps *logging_ops;
@@ -80,6 +126,7 @@ static int keyboard_init_intrfc(void) {
   keyboard_priv_ops = get_keyboard_priv_ops();
   input_ops = get_input_ops();
   signals_ops = get_signal_utils_ops();
+  decoder_ops = get_keyboard_decoder_ops();
 
   err = keyboard_priv_ops->init(&keyboard_subsystem);
   if (err) {
@@ -92,24 +139,24 @@ static int keyboard_init_intrfc(void) {
   return 0;
 }
 
-static int keyboard_start_thread_intrfc(void) {
+static int keyboard_start_watch_intrfc(void) {
   int err;
 
-  err = keyboard_priv_ops->start_thread(&keyboard_subsystem);
+  err = keyboard_priv_ops->start_watch(&keyboard_subsystem);
   if (err) {
-    logging_ops->log_err(module_id, "Failed to start keyboard thread: %s",
+    logging_ops->log_err(module_id, "Failed to start watching stdin: %s",
                          strerror(err));
     return err;
   }
 
-  logging_ops->log_info(module_id, "Keyboard thread started.");
+  logging_ops->log_info(module_id, "Keyboard started.");
   return 0;
 }
 
-static int keyboard_stop_thread_intrfc(void) {
-  keyboard_priv_ops->stop_thread(&keyboard_subsystem);
+static int keyboard_stop_watch_intrfc(void) {
+  keyboard_priv_ops->stop_watch(&keyboard_subsystem);
 
-  logging_ops->log_info(module_id, "Keyboard thread stopped.");
+  logging_ops->log_info(module_id, "Keyboard stopped.");
 
   return 0;
 }
@@ -137,35 +184,14 @@ keyboard_add_keys_mapping_intrfc(struct KeyboardAddKeysMappingInput *input,
   return 0;
 }
 
-static int keyboard_wait_intrfc(void) {
-  if (!keyboard_subsystem.is_initialized) {
-    logging_ops->log_info(
-        module_id, "Keyboard subsystem is not running. Nothing to wait for.");
-    return 0;
-  }
-
-  logging_ops->log_info(module_id, "Waiting for keyboard thread to finish.");
-
-  if (keyboard_subsystem.thread) {
-    int err = pthread_join(keyboard_subsystem.thread, NULL);
-    if (err) {
-      logging_ops->log_err(module_id, "Failed to join keyboard thread: %s",
-                           strerror(err));
-      return err;
-    }
-    keyboard_subsystem.thread = 0;
-  }
-
-  logging_ops->log_info(module_id,
-                        "Keyboard thread has finished successfully.");
-  return 0;
-}
+// Keyboard runs on input's loop, input subsystem waits for the loop itself.
+static int keyboard_wait_intrfc(void) { return 0; }
 
 static void keyboard_destroy_intrfc(void) {
   // Check if the keyboard subsystem is initialized
   if (keyboard_subsystem.is_initialized) {
-    // Stop the keyboard thread if running
-    keyboard_stop_thread_intrfc();
+    // Stop watching stdin if running
+    keyboard_stop_watch_intrfc();
   }
 
   // Perform any additional cleanup using private destroy function
@@ -185,8 +211,10 @@ static int keyboard_init(struct KeyboardSubsystem *keyboard) {
     return EINVAL;
 
   KeyboardSubsystem_keys_mappings_init(keyboard);
+  KeyboardSubsystem_dispatches_init(keyboard);
 
   keyboard->is_initialized = false;
+  keyboard->escape_watch.fd = -1;
 
   signals_ops->add_handler(keyboard_destroy_signal_handler);
 
@@ -204,7 +232,7 @@ static void keyboard_destroy(struct KeyboardSubsystem *keyboard) {
   terminal_ops->enable_canonical_mode(STDIN_FILENO);
 }
 
-static int keyboard_start_thread(struct KeyboardSubsystem *keyboard) {
+static int keyboard_start_watch(struct KeyboardSubsystem *keyboard) {
   int err;
 
   if (!keyboard)
@@ -213,73 +241,150 @@ static int keyboard_start_thread(struct KeyboardSubsystem *keyboard) {
   if (keyboard->is_initialized)
     return 0;
 
-  keyboard->is_initialized = true;
-  err = pthread_create(&keyboard->thread, NULL,
-                       (void *)keyboard_priv_ops->process_stdin, keyboard);
+  // Devices' callbacks are set by now, they do not change until the stop.
+  err = keyboard_priv_ops->build_dispatches(keyboard);
   if (err) {
-    keyboard->is_initialized = false;
-    logging_ops->log_err(module_id, "Unable to start keyboard thread: %s",
+    logging_ops->log_err(module_id, "Unable to build dispatch table: %s",
                          strerror(err));
     return err;
   }
 
+  decoder_ops->init(&keyboard->decoder);
+
+  keyboard->watch = (struct InputWatch){
+      .fd = STDIN_FILENO,
+      .events = EPOLLIN,
+      .callback = keyboard_priv_ops->process_stdin,
+  };
+
+  keyboard->escape_watch = (struct InputWatch){
+      .fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC),
+      .events = EPOLLIN,
+      .callback = keyboard_priv_ops->process_escape_timeout,
+  };
+  if (keyboard->escape_watch.fd == -1) {
+    err = errno;
+    logging_ops->log_err(module_id, "Unable to create escape timer: %s",
+                         strerror(err));
+    return err;
+  }
+
+  keyboard->is_initialized = true;
+
+  err = input_ops->add_watch(&keyboard->watch);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to watch stdin: %s",
+                         strerror(err));
+    goto error;
+  }
+
+  err = input_ops->add_watch(&keyboard->escape_watch);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to watch escape timer: %s",
+                         strerror(err));
+    input_ops->remove_watch(&keyboard->watch);
+    goto error;
+  }
+
   return 0;
+
+error:
+  keyboard->is_initialized = false;
+  close(keyboard->escape_watch.fd);
+  keyboard->escape_watch.fd = -1;
+
+  return err;
 }
 
-static void keyboard_stop_thread(struct KeyboardSubsystem *keyboard) {
+static void keyboard_stop_watch(struct KeyboardSubsystem *keyboard) {
   if (!keyboard || !keyboard->is_initialized)
     return;
 
   keyboard->is_initialized = false;
 
-  if (keyboard->thread) {
-    pthread_kill(keyboard->thread, SIGUSR1);
-    pthread_join(keyboard->thread, NULL);
-    keyboard->thread = 0;
-  }
+  input_ops->remove_watch(&keyboard->watch);
+  input_ops->remove_watch(&keyboard->escape_watch);
+
+  close(keyboard->escape_watch.fd);
+  keyboard->escape_watch.fd = -1;
 }
 
-static void keyboard_read_stdin(struct KeyboardSubsystem *keyboard) {
+static int keyboard_read_stdin(struct KeyboardSubsystem *keyboard) {
   ssize_t bytes_read;
 
   if (!keyboard || !keyboard->is_initialized)
-    return;
+    return EINVAL;
 
-  bytes_read =
-      read(STDIN_FILENO, keyboard->stdin_buffer, KEYBOARD_STDIN_BUFFER_MAX - 1);
+  do {
+    bytes_read = read(STDIN_FILENO, keyboard->stdin_buffer,
+                      KEYBOARD_STDIN_BUFFER_MAX - 1);
+  } while (bytes_read < 0 && errno == EINTR);
 
   if (bytes_read < 0) {
     logging_ops->log_err(module_id, "Unable to read from stdin: %s",
                          strerror(errno));
-    return;
+    return errno;
   }
 
   keyboard->stdin_buffer_count = bytes_read;
 
-  if (bytes_read != 0) {
-    keyboard->stdin_buffer[bytes_read] = '\0';
+  if (bytes_read == 0) {
+    return ENODATA;
   }
+
+  keyboard->stdin_buffer[bytes_read] = '\0';
+
+  return 0;
 }
 
+// Hot path, runs for every read. Errors are the only thing logged here.
 static void keyboard_execute_callbacks(struct KeyboardSubsystem *keyboard) {
-  struct KeyboardKeysMappingCallbackOutput keyboard_callback_output;
-  struct InputGetDeviceOutput get_device_output;
-  struct KeyboardKeysMapping *keys_mapping;
-  size_t i;
+  struct KeyboardDispatch *dispatch;
+  size_t input_events_length;
   int err;
 
   if (!keyboard || !keyboard->is_initialized)
     return;
 
-  for (i = 0; i < KeyboardSubsystem_keys_mappings_length(keyboard); i++) {
-    err = KeyboardSubsystem_keys_mappings_get(keyboard, i, &keys_mapping);
+  for (size_t i = 0; i < KeyboardSubsystem_dispatches_length(keyboard); i++) {
+    KeyboardSubsystem_dispatches_get(keyboard, i, &dispatch);
+
+    err = keyboard_priv_ops->decode(keyboard, dispatch, &input_events_length);
+    if (err) {
+      logging_ops->log_err(module_id,
+                           "Unable to decode keys for device %d: %s",
+                           dispatch->device_id, strerror(err));
+      return;
+    }
+
+    if (input_events_length == 0) {
+      continue;
+    }
+
+    err = keyboard_priv_ops->deliver_events(dispatch, keyboard->input_events,
+                                            input_events_length);
     if (err) {
-      logging_ops->log_err(module_id, "Unable to find keys mapping for %d: %s",
-                           i, strerror(err));
+      logging_ops->log_err(module_id,
+                           "Unable to process input callback for device %d: %s",
+                           dispatch->device_id, strerror(err));
       return;
     }
+  }
+}
+
+// Resolves every mapping whose device has a callback, mappings of devices
+//  which are not used by the game are left out.
+static int keyboard_build_dispatches(struct KeyboardSubsystem *keyboard) {
+  struct InputGetDeviceOutput get_device_output;
+  struct KeyboardKeysMapping *keys_mapping;
+  struct KeyboardDispatch dispatch;
+  int err;
 
-    memset(&get_device_output, 0, sizeof(struct InputGetDeviceOutput));
+  KeyboardSubsystem_dispatches_init(keyboard);
+
+  for (size_t i = 0; i < KeyboardSubsystem_keys_mappings_length(keyboard);
+       i++) {
+    KeyboardSubsystem_keys_mappings_get(keyboard, i, &keys_mapping);
 
     err = input_ops->get_device(
         (struct InputGetDeviceInput){.device_id = keys_mapping->device_id},
@@ -287,7 +392,7 @@ static void keyboard_execute_callbacks(struct KeyboardSubsystem *keyboard) {
     if (err) {
       logging_ops->log_err(module_id, "Getting input device failed for %s: %s",
                            keys_mapping->display_name, strerror(err));
-      return;
+      return err;
     }
 
     if (!get_device_output.device->callback) {
@@ -296,49 +401,96 @@ static void keyboard_execute_callbacks(struct KeyboardSubsystem *keyboard) {
       continue;
     }
 
-    memset(&keyboard_callback_output, 0,
-           sizeof(struct KeyboardKeysMappingCallbackOutput));
+    dispatch = (struct KeyboardDispatch){
+        .decode = keys_mapping->keys ? NULL : keys_mapping->callback,
+        .callback = get_device_output.device->callback,
+        .batch_callback = get_device_output.device->batch_callback,
+        .device_id = keys_mapping->device_id,
+    };
+
+    if (keys_mapping->keys) {
+      memcpy(dispatch.keys, keys_mapping->keys, sizeof(dispatch.keys));
+    }
+
+    err = KeyboardSubsystem_dispatches_append(keyboard, dispatch);
+    if (err) {
+      return err;
+    }
+
+    logging_ops->log_info(module_id, "Dispatching %s to device %d",
+                          keys_mapping->display_name, keys_mapping->device_id);
+  }
+
+  return 0;
+}
+
+// Fills keyboard's events vector from stdin buffer.
+static int keyboard_decode(struct KeyboardSubsystem *keyboard,
+                           struct KeyboardDispatch *dispatch,
+                           size_t *input_events_length) {
+  struct KeyboardKeysMappingCallbackOutput output;
+  enum InputEvents input_event;
+  size_t length = 0;
+  int err;
+
+  if (dispatch->decode) {
+    // Flushed escape has no bytes, these mappings see only raw stdin.
+    if (keyboard->stdin_buffer_count == 0) {
+      *input_events_length = 0;
+      return 0;
+    }
+
+    output = (struct KeyboardKeysMappingCallbackOutput){
+        .input_events = keyboard->input_events,
+        .input_events_max = KEYBOARD_KEYS_MAX,
+    };
 
-    err = keys_mapping->callback(
+    err = dispatch->decode(
         &(struct KeyboardKeysMappingCallbackInput){
             .buffer = keyboard->stdin_buffer,
             .n = keyboard->stdin_buffer_count},
-        &keyboard_callback_output);
+        &output);
     if (err) {
-      logging_ops->log_err(
-          module_id,
-          "Unable to process keyboard callback for keys mappings %s: %s",
-          keys_mapping->display_name, strerror(err));
-
-      return;
+      return err;
     }
 
-    logging_ops->log_info(module_id, "Executed keyboard callback for %s",
-                          keys_mapping->display_name);
+    *input_events_length = output.input_events_length;
 
-    if (keyboard_callback_output.input_event == INPUT_EVENT_NONE) {
-      logging_ops->log_info(module_id,
-                            "No input event in keys mappings %s callback",
-                            keys_mapping->display_name);
-      continue;
-    }
+    return 0;
+  }
 
-    err = get_device_output.device->callback(
-        keyboard_callback_output.input_event, keys_mapping->device_id);
-    if (err) {
-      logging_ops->log_err(
-          module_id, "Unable to process input callback for keys mapping %s: %s",
-          keys_mapping->display_name, strerror(err));
-      return;
+  // Events vector is as long as keys vector, so it can't overflow.
+  for (size_t i = 0; i < keyboard->keys_count; i++) {
+    input_event = dispatch->keys[keyboard->keys[i]];
+    if (input_event != INPUT_EVENT_NONE) {
+      keyboard->input_events[length++] = input_event;
     }
+  }
+
+  *input_events_length = length;
+
+  return 0;
+}
+
+// Whole burst goes to the game at once if device supports it.
+static int keyboard_deliver_events(struct KeyboardDispatch *dispatch,
+                                   const enum InputEvents *input_events,
+                                   size_t input_events_length) {
+  int err;
 
-    logging_ops->log_info(module_id, "Executed input callback for %s",
-                          keys_mapping->display_name);
+  if (dispatch->batch_callback) {
+    return dispatch->batch_callback(input_events, input_events_length,
+                                    dispatch->device_id);
   }
 
-  logging_ops->log_info(module_id, "Executed all callbacks");
+  for (size_t i = 0; i < input_events_length; i++) {
+    err = dispatch->callback(input_events[i], dispatch->device_id);
+    if (err) {
+      return err;
+    }
+  }
 
-  return;
+  return 0;
 }
 
 static int
@@ -364,38 +516,104 @@ keyboard_add_keys_mapping(struct KeyboardAddKeysMappingInput *input,
   return 0;
 }
 
-static void keyboard_signal_handler(int sig) {
-  // You can use SIGUSR1 to interrupt or terminate all input threads.
-  if (sig == SIGUSR1) {
-    logging_ops->log_info(module_id,
-                          "Thread received signal SIGUSR1. Exiting.");
+static void keyboard_process_stdin(struct InputWatch *watch,
+                                   uint32_t events) {
+  struct KeyboardSubsystem *keyboard =
+      INPUT_WATCH_CONTAINER(watch, struct KeyboardSubsystem, watch);
+  int err;
 
-    pthread_exit(NULL);
+  if (!keyboard->is_initialized) {
+    return;
   }
+
+  keyboard->keys_count = 0;
+
+  err = EIO;
+  if (events & EPOLLIN) {
+    err = keyboard_priv_ops->read_stdin(keyboard);
+  }
+
+  // Closed or broken stdin would wake the loop up forever, there is
+  //  nothing more to read from it.
+  if (err == ENODATA || err == EIO || err == EBADF) {
+    logging_ops->log_info(module_id, "Stdin closed, stopping keyboard.");
+    keyboard->stdin_buffer_count = 0;
+    if (decoder_ops->flush(&keyboard->decoder, keyboard->keys,
+                           KEYBOARD_KEYS_MAX, &keyboard->keys_count) == 0 &&
+        keyboard->keys_count > 0) {
+      keyboard_priv_ops->execute_callbacks(keyboard);
+    }
+    keyboard_priv_ops->stop_watch(keyboard);
+    return;
+  }
+
+  if (err) {
+    return;
+  }
+
+  err = decoder_ops->feed(&keyboard->decoder, keyboard->stdin_buffer,
+                          keyboard->stdin_buffer_count, keyboard->keys,
+                          KEYBOARD_KEYS_MAX, &keyboard->keys_count);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to decode stdin: %s",
+                         strerror(err));
+    return;
+  }
+
+  // Every read restarts the timeout, so only a pause ends the sequence.
+  keyboard_priv_ops->set_escape_timeout(
+      keyboard, decoder_ops->is_pending(&keyboard->decoder));
+
+  // Execute registered callbacks after processing input
+  keyboard_priv_ops->execute_callbacks(keyboard);
 }
 
-static void *keyboard_process_stdin(struct KeyboardSubsystem *keyboard) {
-  if (!keyboard || !keyboard->is_initialized) {
-    logging_ops->log_err(
-        module_id, "Keyboard subsystem is not initialized. Exiting thread.");
-    return NULL;
+static void keyboard_process_escape_timeout(struct InputWatch *watch,
+                                            uint32_t events) {
+  struct KeyboardSubsystem *keyboard =
+      INPUT_WATCH_CONTAINER(watch, struct KeyboardSubsystem, escape_watch);
+  uint64_t expirations;
+  (void)events;
+
+  if (!keyboard->is_initialized) {
+    return;
   }
 
-  // Handle signal to terminate the thread
-  signal(SIGUSR1, keyboard_signal_handler);
+  // Timer may have been disarmed after it expired, nothing to flush then.
+  if (read(watch->fd, &expirations, sizeof(expirations)) !=
+          sizeof(expirations) ||
+      !decoder_ops->is_pending(&keyboard->decoder)) {
+    return;
+  }
 
-  logging_ops->log_info(module_id, "Keyboard processing thread started.");
+  keyboard->keys_count = 0;
+  keyboard->stdin_buffer_count = 0;
 
-  while (keyboard->is_initialized) {
-    // Reuse `keyboard_read_stdin` to process input
-    keyboard_priv_ops->read_stdin(keyboard);
+  if (decoder_ops->flush(&keyboard->decoder, keyboard->keys,
+                         KEYBOARD_KEYS_MAX, &keyboard->keys_count)) {
+    return;
+  }
 
-    // Execute registered callbacks after processing input
+  if (keyboard->keys_count > 0) {
     keyboard_priv_ops->execute_callbacks(keyboard);
   }
+}
+
+static int keyboard_set_escape_timeout(struct KeyboardSubsystem *keyboard,
+                                       bool is_armed) {
+  struct itimerspec timeout = {0};
+
+  if (is_armed) {
+    timeout.it_value.tv_nsec = KEYBOARD_ESCAPE_TIMEOUT_MS * 1000 * 1000;
+  }
 
-  logging_ops->log_info(module_id, "Keyboard processing thread exiting.");
-  return NULL;
+  if (timerfd_settime(keyboard->escape_watch.fd, 0, &timeout, NULL) == -1) {
+    logging_ops->log_err(module_id, "Unable to set escape timeout: %s",
+                         strerror(errno));
+    return errno;
+  }
+
+  return 0;
 }
 
 /*******************************************************************************
@@ -405,8 +623,8 @@ static struct KeyboardOps keyboard_ops = {
     .init = keyboard_init_intrfc,
     .destroy = keyboard_destroy_intrfc,
     .wait = keyboard_wait_intrfc,
-    .stop = keyboard_stop_thread_intrfc,
-    .start = keyboard_start_thread_intrfc,
+    .stop = keyboard_stop_watch_intrfc,
+    .start = keyboard_start_watch_intrfc,
     .add_keys_mapping = keyboard_add_keys_mapping_intrfc,
 };
 
@@ -414,10 +632,15 @@ static struct KeyboardPrivateOps keyboard_priv_ops_ = {
     .init = keyboard_init,
     .destroy = keyboard_destroy,
     .read_stdin = keyboard_read_stdin,
-    .stop_thread = keyboard_stop_thread,
-    .start_thread = keyboard_start_thread,
+    .stop_watch = keyboard_stop_watch,
+    .start_watch = keyboard_start_watch,
     .process_stdin = keyboard_process_stdin,
+    .process_escape_timeout = keyboard_process_escape_timeout,
+    .set_escape_timeout = keyboard_set_escape_timeout,
     .execute_callbacks = keyboard_execute_callbacks,
+    .build_dispatches = keyboard_build_dispatches,
+    .decode = keyboard_decode,
+    .deliver_events = keyboard_deliver_events,
     .add_keys_mapping = keyboard_add_keys_mapping,
 };
 
@@ -0,0 +1,306 @@
+/*******************************************************************************
+ * @file keyboard_decoder.c
+ * @brief Streaming decoder of terminal input.
+ *
+ * Recognises sequences sent by xterm compatible terminals:
+ *  - `ESC [ <params> <final>` (CSI), f.e. `ESC [ A` or `ESC [ 1 ; 5 A`,
+ *  - `ESC [ <number> ~`, f.e. `ESC [ 3 ~` for delete,
+ *  - `ESC O <final>` (SS3), sent for arrows in application mode and F1-F4.
+ * Modifiers are ignored, ctrl+up is just up. Unknown sequences are
+ * consumed without producing any key.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// App's internal libs
+#include "input/keyboard/keyboard_decoder.h"
+#include "input/keyboard/keyboard_keys_mapping.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+// Parameters bigger than any known key are not accumulated any further.
+#define KEYBOARD_DECODER_PARAM_MAX 100
+
+enum KeyboardDecoderActions {
+  // Only moves to the next state.
+  KEYBOARD_DECODER_IGNORE = 0,
+  KEYBOARD_DECODER_EMIT_BYTE,
+  KEYBOARD_DECODER_EMIT_KEY,
+  KEYBOARD_DECODER_PARAM_DIGIT,
+  KEYBOARD_DECODER_PARAM_END,
+  KEYBOARD_DECODER_EMIT_TILDE_KEY,
+  // Sequence is broken, byte is processed again from the ground state.
+  KEYBOARD_DECODER_RESTART,
+  // Same as restart, but escape seen before is emitted first (f.e. alt+x).
+  KEYBOARD_DECODER_EMIT_ESCAPE_RESTART,
+};
+
+struct KeyboardDecoderTransition {
+  uint8_t action;     // enum KeyboardDecoderActions
+  uint8_t next_state; // enum KeyboardDecoderStates
+  keyboard_key_t key;
+};
+
+struct KeyboardDecoderPrivateOps {
+  void (*build_table)(void);
+  void (*set_range)(enum KeyboardDecoderStates state, int first, int last,
+                    struct KeyboardDecoderTransition transition);
+  void (*set_key)(enum KeyboardDecoderStates state, char byte,
+                  keyboard_key_t key);
+};
+
+static struct KeyboardDecoderTransition
+    decoder_table[KEYBOARD_DECODER_STATES_LENGTH][UCHAR_MAX + 1];
+static bool is_decoder_table_built;
+
+// Actions which may append a key, free space is checked before them.
+static const bool decoder_action_emits[] = {
+    [KEYBOARD_DECODER_EMIT_BYTE] = true,
+    [KEYBOARD_DECODER_EMIT_KEY] = true,
+    [KEYBOARD_DECODER_EMIT_TILDE_KEY] = true,
+    [KEYBOARD_DECODER_EMIT_ESCAPE_RESTART] = true,
+};
+
+// Keys of `ESC [ <number> ~` sequences, indexed by the number.
+static const keyboard_key_t decoder_tilde_keys[] = {
+    [1] = KEYBOARD_KEY_HOME,      [2] = KEYBOARD_KEY_INSERT,
+    [3] = KEYBOARD_KEY_DELETE,    [4] = KEYBOARD_KEY_END,
+    [5] = KEYBOARD_KEY_PAGE_UP,   [6] = KEYBOARD_KEY_PAGE_DOWN,
+    [7] = KEYBOARD_KEY_HOME,      [8] = KEYBOARD_KEY_END,
+    [11] = KEYBOARD_KEY_F1,       [12] = KEYBOARD_KEY_F2,
+    [13] = KEYBOARD_KEY_F3,       [14] = KEYBOARD_KEY_F4,
+};
+
+static struct KeyboardDecoderPrivateOps *decoder_priv_ops;
+struct KeyboardDecoderPrivateOps *get_keyboard_decoder_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static void keyboard_decoder_init(struct KeyboardDecoder *decoder) {
+  decoder_priv_ops = get_keyboard_decoder_priv_ops();
+
+  if (!is_decoder_table_built) {
+    decoder_priv_ops->build_table();
+    is_decoder_table_built = true;
+  }
+
+  *decoder = (struct KeyboardDecoder){.state = KEYBOARD_DECODER_GROUND};
+}
+
+static int keyboard_decoder_feed(struct KeyboardDecoder *decoder,
+                                 const char *buffer, size_t n,
+                                 keyboard_key_t *keys, size_t keys_max,
+                                 size_t *keys_length) {
+  const struct KeyboardDecoderTransition *transition;
+  unsigned char byte;
+  keyboard_key_t key;
+  size_t length = *keys_length;
+  size_t i = 0;
+
+  while (i < n) {
+    byte = (unsigned char)buffer[i];
+    transition = &decoder_table[decoder->state][byte];
+
+    if (decoder_action_emits[transition->action] && length >= keys_max) {
+      *keys_length = length;
+      return ENOBUFS;
+    }
+
+    switch (transition->action) {
+    case KEYBOARD_DECODER_EMIT_BYTE:
+      keys[length++] = byte;
+      break;
+    case KEYBOARD_DECODER_EMIT_KEY:
+      keys[length++] = transition->key;
+      break;
+    case KEYBOARD_DECODER_PARAM_DIGIT:
+      if (!decoder->is_param_done &&
+          decoder->param < KEYBOARD_DECODER_PARAM_MAX) {
+        decoder->param = decoder->param * 10 + (byte - '0');
+      }
+      break;
+    case KEYBOARD_DECODER_PARAM_END:
+      decoder->is_param_done = true;
+      break;
+    case KEYBOARD_DECODER_EMIT_TILDE_KEY:
+      if (decoder->param <
+          sizeof(decoder_tilde_keys) / sizeof(keyboard_key_t)) {
+        key = decoder_tilde_keys[decoder->param];
+        if (key) {
+          keys[length++] = key;
+        }
+      }
+      break;
+    case KEYBOARD_DECODER_EMIT_ESCAPE_RESTART:
+      keys[length++] = KEYBOARD_KEY_ESCAPE;
+      /* fallthrough */
+    case KEYBOARD_DECODER_RESTART:
+      decoder->state = KEYBOARD_DECODER_GROUND;
+      // Byte is not consumed, ground state processes it again.
+      continue;
+    default:
+      break;
+    }
+
+    if (transition->next_state == KEYBOARD_DECODER_CSI &&
+        decoder->state != KEYBOARD_DECODER_CSI) {
+      decoder->param = 0;
+      decoder->is_param_done = false;
+    }
+
+    decoder->state = transition->next_state;
+    i++;
+  }
+
+  *keys_length = length;
+
+  return 0;
+}
+
+static int keyboard_decoder_flush(struct KeyboardDecoder *decoder,
+                                  keyboard_key_t *keys, size_t keys_max,
+                                  size_t *keys_length) {
+  if (decoder->state == KEYBOARD_DECODER_ESCAPE) {
+    if (*keys_length >= keys_max) {
+      return ENOBUFS;
+    }
+
+    keys[(*keys_length)++] = KEYBOARD_KEY_ESCAPE;
+  }
+
+  decoder->state = KEYBOARD_DECODER_GROUND;
+
+  return 0;
+}
+
+static bool keyboard_decoder_is_pending(const struct KeyboardDecoder *decoder) {
+  return decoder->state != KEYBOARD_DECODER_GROUND;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static void keyboard_decoder_build_table(void) {
+  struct KeyboardDecoderTransition to_csi = {
+      .action = KEYBOARD_DECODER_IGNORE, .next_state = KEYBOARD_DECODER_CSI};
+  struct KeyboardDecoderTransition to_ground = {
+      .action = KEYBOARD_DECODER_IGNORE, .next_state = KEYBOARD_DECODER_GROUND};
+  struct KeyboardDecoderTransition restart = {
+      .action = KEYBOARD_DECODER_RESTART};
+
+  // Ground, every byte is a key, escape starts a sequence.
+  decoder_priv_ops->set_range(
+      KEYBOARD_DECODER_GROUND, 0, UCHAR_MAX,
+      (struct KeyboardDecoderTransition){
+          .action = KEYBOARD_DECODER_EMIT_BYTE,
+          .next_state = KEYBOARD_DECODER_GROUND});
+  decoder_priv_ops->set_range(
+      KEYBOARD_DECODER_GROUND, KEYBOARD_KEY_ESCAPE, KEYBOARD_KEY_ESCAPE,
+      (struct KeyboardDecoderTransition){
+          .action = KEYBOARD_DECODER_IGNORE,
+          .next_state = KEYBOARD_DECODER_ESCAPE});
+
+  // Escape, anything but sequence introducer means escape was a key.
+  decoder_priv_ops->set_range(
+      KEYBOARD_DECODER_ESCAPE, 0, UCHAR_MAX,
+      (struct KeyboardDecoderTransition){
+          .action = KEYBOARD_DECODER_EMIT_ESCAPE_RESTART});
+  decoder_priv_ops->set_range(KEYBOARD_DECODER_ESCAPE, '[', '[', to_csi);
+  decoder_priv_ops->set_range(
+      KEYBOARD_DECODER_ESCAPE, 'O', 'O',
+      (struct KeyboardDecoderTransition){
+          .action = KEYBOARD_DECODER_IGNORE,
+          .next_state = KEYBOARD_DECODER_SS3});
+
+  // CSI, parameters and intermediates until final byte.
+  decoder_priv_ops->set_range(KEYBOARD_DECODER_CSI, 0, UCHAR_MAX, restart);
+  decoder_priv_ops->set_range(KEYBOARD_DECODER_CSI, 0x20, 0x3f, to_csi);
+  decoder_priv_ops->set_range(
+      KEYBOARD_DECODER_CSI, '0', '9',
+      (struct KeyboardDecoderTransition){
+          .action = KEYBOARD_DECODER_PARAM_DIGIT,
+          .next_state = KEYBOARD_DECODER_CSI});
+  decoder_priv_ops->set_range(
+      KEYBOARD_DECODER_CSI, ';', ';',
+      (struct KeyboardDecoderTransition){
+          .action = KEYBOARD_DECODER_PARAM_END,
+          .next_state = KEYBOARD_DECODER_CSI});
+  decoder_priv_ops->set_range(KEYBOARD_DECODER_CSI, 0x40, 0x7e, to_ground);
+  decoder_priv_ops->set_range(
+      KEYBOARD_DECODER_CSI, '~', '~',
+      (struct KeyboardDecoderTransition){
+          .action = KEYBOARD_DECODER_EMIT_TILDE_KEY,
+          .next_state = KEYBOARD_DECODER_GROUND});
+
+  // SS3, exactly one final byte.
+  decoder_priv_ops->set_range(KEYBOARD_DECODER_SS3, 0, UCHAR_MAX, restart);
+  decoder_priv_ops->set_range(KEYBOARD_DECODER_SS3, 0x40, 0x7e, to_ground);
+  decoder_priv_ops->set_key(KEYBOARD_DECODER_SS3, 'P', KEYBOARD_KEY_F1);
+  decoder_priv_ops->set_key(KEYBOARD_DECODER_SS3, 'Q', KEYBOARD_KEY_F2);
+  decoder_priv_ops->set_key(KEYBOARD_DECODER_SS3, 'R', KEYBOARD_KEY_F3);
+  decoder_priv_ops->set_key(KEYBOARD_DECODER_SS3, 'S', KEYBOARD_KEY_F4);
+
+  // Both CSI and SS3 use the same final bytes for cursor keys.
+  for (enum KeyboardDecoderStates state = KEYBOARD_DECODER_CSI;
+       state <= KEYBOARD_DECODER_SS3; state++) {
+    decoder_priv_ops->set_key(state, 'A', KEYBOARD_KEY_UP);
+    decoder_priv_ops->set_key(state, 'B', KEYBOARD_KEY_DOWN);
+    decoder_priv_ops->set_key(state, 'C', KEYBOARD_KEY_RIGHT);
+    decoder_priv_ops->set_key(state, 'D', KEYBOARD_KEY_LEFT);
+    decoder_priv_ops->set_key(state, 'H', KEYBOARD_KEY_HOME);
+    decoder_priv_ops->set_key(state, 'F', KEYBOARD_KEY_END);
+  }
+}
+
+static void
+keyboard_decoder_set_range(enum KeyboardDecoderStates state, int first,
+                           int last,
+                           struct KeyboardDecoderTransition transition) {
+  for (int byte = first; byte <= last; byte++) {
+    decoder_table[state][byte] = transition;
+  }
+}
+
+static void keyboard_decoder_set_key(enum KeyboardDecoderStates state,
+                                     char byte, keyboard_key_t key) {
+  decoder_table[state][(unsigned char)byte] =
+      (struct KeyboardDecoderTransition){
+          .action = KEYBOARD_DECODER_EMIT_KEY,
+          .next_state = KEYBOARD_DECODER_GROUND,
+          .key = key};
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct KeyboardDecoderPrivateOps keyboard_decoder_priv_ops_ = {
+    .build_table = keyboard_decoder_build_table,
+    .set_range = keyboard_decoder_set_range,
+    .set_key = keyboard_decoder_set_key,
+};
+
+struct KeyboardDecoderPrivateOps *get_keyboard_decoder_priv_ops(void) {
+  return &keyboard_decoder_priv_ops_;
+}
+
+static struct KeyboardDecoderOps keyboard_decoder_ops = {
+    .init = keyboard_decoder_init,
+    .feed = keyboard_decoder_feed,
+    .flush = keyboard_decoder_flush,
+    .is_pending = keyboard_decoder_is_pending,
+};
+
+struct KeyboardDecoderOps *get_keyboard_decoder_ops(void) {
+  return &keyboard_decoder_ops;
+}
@@ -0,0 +1,62 @@
+#ifndef KEYBOARD_DECODER_H
+#define KEYBOARD_DECODER_H
+/*******************************************************************************
+ * @file keyboard_decoder.h
+ * @brief Streaming decoder of terminal input.
+ *
+ * Turns bytes read from the terminal into keys. Plain bytes are keys on
+ * their own, escape sequences sent for arrows, home/end, function keys etc.
+ * become single special key. Decoder keeps its state between feeds, so a
+ * sequence split across several reads is still recognised. Every byte is
+ * handled by one lookup in the transition table, nothing is ever rescanned.
+ *
+ * Lone escape can't be told apart from the start of a sequence until next
+ * byte arrives, so caller flushes the decoder once nothing came for a while.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "input/keyboard/keyboard_keys_mapping.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+enum KeyboardDecoderStates {
+  KEYBOARD_DECODER_GROUND = 0,
+  KEYBOARD_DECODER_ESCAPE,
+  KEYBOARD_DECODER_CSI,
+  KEYBOARD_DECODER_SS3,
+  KEYBOARD_DECODER_STATES_LENGTH,
+};
+
+struct KeyboardDecoder {
+  enum KeyboardDecoderStates state;
+  // First numeric parameter of CSI sequence, f.e. 3 in `ESC [ 3 ~`.
+  unsigned int param;
+  bool is_param_done;
+};
+
+struct KeyboardDecoderOps {
+  void (*init)(struct KeyboardDecoder *decoder);
+  // Appends decoded keys to `keys`, at most one key is produced per byte
+  //  plus one for escape pending from previous feed.
+  int (*feed)(struct KeyboardDecoder *decoder, const char *buffer, size_t n,
+              keyboard_key_t *keys, size_t keys_max, size_t *keys_length);
+  // Gives up on unfinished sequence, pending escape becomes escape key.
+  int (*flush)(struct KeyboardDecoder *decoder, keyboard_key_t *keys,
+               size_t keys_max, size_t *keys_length);
+  bool (*is_pending)(const struct KeyboardDecoder *decoder);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct KeyboardDecoderOps *get_keyboard_decoder_ops(void);
+
+#endif // KEYBOARD_DECODER_H
@@ -12,6 +12,7 @@ static int keyboard_keys_mapping_init(struct KeyboardKeysMapping *mapping,
   }
 
   mapping->callback = callback;
+  mapping->keys = NULL;
   mapping->device_id = device_id;
   mapping->display_name = display_name;
 
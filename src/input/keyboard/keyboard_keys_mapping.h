@@ -3,7 +3,9 @@
 /*******************************************************************************
  *    IMPORTS
  ******************************************************************************/
+#include <limits.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "input/input.h"
 #include "input/input_common.h"
@@ -12,13 +14,43 @@
 /*******************************************************************************
  *    PUBLIC API
  ******************************************************************************/
+// Keys below 256 are plain bytes read from stdin, keys above are decoded
+//  from terminal's escape sequences.
+enum KeyboardKeys {
+  KEYBOARD_KEY_ESCAPE = '\033',
+  KEYBOARD_KEY_UP = UCHAR_MAX + 1,
+  KEYBOARD_KEY_DOWN,
+  KEYBOARD_KEY_RIGHT,
+  KEYBOARD_KEY_LEFT,
+  KEYBOARD_KEY_HOME,
+  KEYBOARD_KEY_END,
+  KEYBOARD_KEY_INSERT,
+  KEYBOARD_KEY_DELETE,
+  KEYBOARD_KEY_PAGE_UP,
+  KEYBOARD_KEY_PAGE_DOWN,
+  KEYBOARD_KEY_F1,
+  KEYBOARD_KEY_F2,
+  KEYBOARD_KEY_F3,
+  KEYBOARD_KEY_F4,
+  KEYBOARD_KEYS_LENGTH,
+};
+
+typedef uint16_t keyboard_key_t;
+
+// Every key is one entry in keys table.
+#define KEYBOARD_KEYS_TABLE_LENGTH KEYBOARD_KEYS_LENGTH
+
 struct KeyboardKeysMappingCallbackInput {
   size_t n;
   char *buffer;
 };
 
+// Events vector is provided by keyboard, mapping appends one event for
+//  every recognised key, in order in which keys were pressed.
 struct KeyboardKeysMappingCallbackOutput {
-  enum InputEvents input_event;
+  enum InputEvents *input_events;
+  size_t input_events_max;
+  size_t input_events_length;
 };
 
 typedef int (*keyboard_key_mapping_callback_t)(
@@ -27,6 +59,10 @@ typedef int (*keyboard_key_mapping_callback_t)(
 
 struct KeyboardKeysMapping {
   keyboard_key_mapping_callback_t callback;
+  // Optional, mapping which translates every byte on its own can give its
+  //  lookup table with KEYBOARD_KEYS_TABLE_LENGTH entries. Keyboard then
+  //  decodes bytes itself and callback is not called.
+  const enum InputEvents *keys;
   input_device_id_t device_id;
   const char *display_name;
 };
@@ -16,6 +16,16 @@ struct KeyboardKeysMapping1PrivOps {
   keyboard_key_mapping_callback_t keyboard_callback;
 };
 
+static const enum InputEvents keys_mapping1_keys[KEYBOARD_KEYS_TABLE_LENGTH] = {
+    ['w'] = INPUT_EVENT_UP,      ['s'] = INPUT_EVENT_DOWN,
+    ['a'] = INPUT_EVENT_LEFT,    ['d'] = INPUT_EVENT_RIGHT,
+    ['\n'] = INPUT_EVENT_SELECT, ['q'] = INPUT_EVENT_EXIT,
+    [KEYBOARD_KEY_UP] = INPUT_EVENT_UP,
+    [KEYBOARD_KEY_DOWN] = INPUT_EVENT_DOWN,
+    [KEYBOARD_KEY_LEFT] = INPUT_EVENT_LEFT,
+    [KEYBOARD_KEY_RIGHT] = INPUT_EVENT_RIGHT,
+};
+
 static struct InputOps *input_ops;
 static struct LoggingUtilsOps *logging_ops;
 static struct KeyboardKeysMapping1Subsystem keys_mapping1;
@@ -71,6 +81,8 @@ static int keyboard_keys_mapping1_init(void) {
     return err;
   }
 
+  keyboard_keys_mapping.keys = keys_mapping1_keys;
+
   err = keyboard_ops->add_keys_mapping(
       &(struct KeyboardAddKeysMappingInput){
           .keys_mapping = &keyboard_keys_mapping,
@@ -94,34 +106,21 @@ static int keyboard_keys_mapping1_callback(
   enum InputEvents input_event;
   size_t i;
 
-  input_event = INPUT_EVENT_NONE;
+  output->input_events_length = 0;
 
   for (i = 0; i < input->n; i++) {
-    switch (input->buffer[i]) {
-    case 'w':
-      input_event = INPUT_EVENT_UP;
-      break;
-    case 's':
-      input_event = INPUT_EVENT_DOWN;
-      break;
-    case 'a':
-      input_event = INPUT_EVENT_LEFT;
-      break;
-    case 'd':
-      input_event = INPUT_EVENT_RIGHT;
-      break;
-    case '\n':
-      input_event = INPUT_EVENT_SELECT;
-      break;
-    case 'q':
-      input_event = INPUT_EVENT_EXIT;
-      break;
-    default:
-      break;
+    input_event = keys_mapping1_keys[(unsigned char)input->buffer[i]];
+
+    if (input_event == INPUT_EVENT_NONE) {
+      continue;
+    }
+
+    if (output->input_events_length >= output->input_events_max) {
+      return ENOBUFS;
     }
-  }
 
-  output->input_event = input_event;
+    output->input_events[output->input_events_length++] = input_event;
+  }
 
   return 0;
 }
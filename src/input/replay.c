@@ -0,0 +1,417 @@
+/*******************************************************************************
+ * @file replay.c
+ * @brief Input device replaying recorded event streams.
+ *
+ * Replay does not own any thread, it is driven by a timer watched from input
+ * subsystem's event loop. Recording is streamed line by line, only the next
+ * event is kept in memory. With original pacing timer is armed for the
+ * moment next event is due, relative to the first event of the recording.
+ * In fast mode timer fires right away and every loop's iteration delivers
+ * a chunk of events, so the loop still gets to stop requests in between.
+ *
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L // strtok_r
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// App's internal libs
+#include "config/config.h"
+#include "input/input.h"
+#include "input/input_common.h"
+#include "input/input_device.h"
+#include "input/input_timer.h"
+#include "input/replay.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define REPLAY_PATH_MAX 256
+#define REPLAY_LINE_MAX 128
+// Events delivered on single loop's iteration in fast mode.
+#define REPLAY_CHUNK_MAX 256
+
+enum ReplayPacings {
+  REPLAY_PACING_ORIGINAL = 0,
+  REPLAY_PACING_FAST,
+};
+
+struct ReplayRecord {
+  uint64_t timestamp_us;
+  input_device_id_t device_id;
+  enum InputEvents input_event;
+};
+
+struct InputReplay {
+  char path[REPLAY_PATH_MAX];
+  enum ReplayPacings pacing;
+  input_device_id_t device_id;
+  input_callback_func_t callback;
+  FILE *file;
+  size_t line_number;
+  // Read from the file but not delivered yet.
+  struct ReplayRecord record;
+  uint64_t first_timestamp_us;
+  uint64_t start_ns;
+  size_t events;
+  struct InputWatch watch;
+  bool is_started;
+};
+
+struct InputReplayPrivateOps {
+  int (*start)(struct InputReplay *replay);
+  void (*stop)(struct InputReplay *replay);
+  int (*read_record)(struct InputReplay *replay);
+  int (*parse_record)(char *line, struct ReplayRecord *record);
+  void (*process_timer)(struct InputWatch *watch, uint32_t events);
+};
+
+static char module_id[] = INPUT_REPLAY_DISP_NAME;
+static struct InputReplay replay;
+static struct InputOps *input_ops;
+static struct InputDeviceOps *input_device_ops;
+static struct InputTimerOps *timer_ops;
+static struct ConfigOps *config_ops;
+static struct LoggingUtilsOps *logging_ops;
+static struct InputReplayPrivateOps *replay_priv_ops;
+struct InputReplayPrivateOps *get_input_replay_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int input_replay_start(void);
+static int input_replay_stop(void);
+static int input_replay_wait(void);
+
+static int input_replay_init(void) {
+  struct InputAddDeviceOutput add_device_output;
+  struct InputDevice input_device;
+  char pacing[CONFIG_VARIABLE_MAX];
+  int err;
+
+  replay_priv_ops = get_input_replay_priv_ops();
+  logging_ops = get_logging_utils_ops();
+  config_ops = get_config_ops();
+  input_ops = get_input_ops();
+  input_device_ops = get_input_device_ops();
+  timer_ops = get_input_timer_ops();
+
+  replay.file = NULL;
+  replay.watch.fd = -1;
+  replay.is_started = false;
+
+  err = config_ops->read_var(INPUT_REPLAY_PATH_VAR_NAME,
+                             INPUT_REPLAY_PATH_DEFAULT, replay.path,
+                             sizeof(replay.path));
+  if (err) {
+    return err;
+  }
+
+  err = config_ops->read_var(INPUT_REPLAY_PACING_VAR_NAME,
+                             INPUT_REPLAY_PACING_ORIGINAL, pacing,
+                             sizeof(pacing));
+  if (err) {
+    return err;
+  }
+
+  if (strcmp(pacing, INPUT_REPLAY_PACING_ORIGINAL) == 0) {
+    replay.pacing = REPLAY_PACING_ORIGINAL;
+  } else if (strcmp(pacing, INPUT_REPLAY_PACING_FAST) == 0) {
+    replay.pacing = REPLAY_PACING_FAST;
+  } else {
+    logging_ops->log_err(module_id, "Unknown replay pacing: %s", pacing);
+    return EINVAL;
+  }
+
+  err = input_device_ops->init_device(&input_device, input_replay_wait,
+                                      input_replay_stop, input_replay_start,
+                                      INPUT_REPLAY_DISP_NAME);
+  if (err) {
+    logging_ops->log_err(module_id, "Input device initialization failed: %s",
+                         strerror(err));
+    return err;
+  }
+
+  err = input_ops->add_device(
+      (struct InputAddDeviceInput){.device = &input_device},
+      &add_device_output);
+  if (err) {
+    logging_ops->log_err(module_id, "Adding input device failed: %s",
+                         strerror(err));
+    return err;
+  }
+
+  replay.device_id = add_device_output.device_id;
+
+  return 0;
+}
+
+static void input_replay_destroy(void) {
+  if (replay.is_started) {
+    replay_priv_ops->stop(&replay);
+  }
+}
+
+static int input_replay_start(void) {
+  int err;
+
+  err = replay_priv_ops->start(&replay);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to replay %s: %s", replay.path,
+                         strerror(err));
+    return err;
+  }
+
+  return 0;
+}
+
+static int input_replay_stop(void) {
+  replay_priv_ops->stop(&replay);
+
+  return 0;
+}
+
+// Replay runs on input's loop, input subsystem waits for the loop itself.
+static int input_replay_wait(void) { return 0; }
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int input_replay_start_replay(struct InputReplay *replay) {
+  struct InputGetDeviceOutput get_device;
+  int err;
+
+  if (replay->is_started) {
+    return 0;
+  }
+
+  // Device's callback is set by now, it does not change until the stop.
+  err = input_ops->get_device(
+      (struct InputGetDeviceInput){.device_id = replay->device_id},
+      &get_device);
+  if (err) {
+    return err;
+  }
+
+  replay->callback = get_device.device->callback;
+  replay->line_number = 0;
+  replay->events = 0;
+
+  replay->file = fopen(replay->path, "r");
+  if (!replay->file) {
+    return errno;
+  }
+
+  err = replay_priv_ops->read_record(replay);
+  if (err) {
+    fclose(replay->file);
+    replay->file = NULL;
+    // Empty recording has nothing to replay, it is not an error.
+    return err == ENODATA ? 0 : err;
+  }
+
+  replay->first_timestamp_us = replay->record.timestamp_us;
+
+  replay->start_ns = timer_ops->get_timestamp();
+
+  err = timer_ops->start(&replay->watch, replay_priv_ops->process_timer,
+                         replay->start_ns);
+  if (err) {
+    goto error;
+  }
+
+  replay->is_started = true;
+
+  logging_ops->log_info(module_id, "Replaying %s", replay->path);
+
+  return 0;
+
+error:
+  fclose(replay->file);
+  replay->file = NULL;
+
+  return err;
+}
+
+static void input_replay_stop_replay(struct InputReplay *replay) {
+  if (!replay->is_started) {
+    return;
+  }
+
+  replay->is_started = false;
+
+  timer_ops->stop(&replay->watch);
+
+  fclose(replay->file);
+  replay->file = NULL;
+
+  logging_ops->log_info(module_id, "Replayed %zu events from %s",
+                        replay->events, replay->path);
+}
+
+// Returns ENODATA once whole recording was read.
+static int input_replay_read_record(struct InputReplay *replay) {
+  char line[REPLAY_LINE_MAX];
+  size_t length;
+  char *start;
+  int err;
+
+  while (fgets(line, sizeof(line), replay->file)) {
+    replay->line_number++;
+
+    // Recording is text, NUL byte at the start of the line means it is
+    //  corrupted.
+    length = strlen(line);
+    if (length == 0) {
+      logging_ops->log_err(module_id, "Line %zu of %s is malformed",
+                           replay->line_number, replay->path);
+      return EINVAL;
+    }
+
+    if (line[length - 1] != '\n' && !feof(replay->file)) {
+      logging_ops->log_err(module_id, "Line %zu of %s is too long",
+                           replay->line_number, replay->path);
+      return EINVAL;
+    }
+
+    start = line + strspn(line, " \t\r\n");
+    if (*start == 0 || *start == '#') {
+      continue;
+    }
+
+    err = replay_priv_ops->parse_record(start, &replay->record);
+    if (err) {
+      logging_ops->log_err(module_id, "Invalid event at line %zu of %s",
+                           replay->line_number, replay->path);
+      return err;
+    }
+
+    return 0;
+  }
+
+  if (ferror(replay->file)) {
+    return EIO;
+  }
+
+  return ENODATA;
+}
+
+static int input_replay_parse_record(char *line, struct ReplayRecord *record) {
+  const char delimiters[] = " \t\r\n";
+  char *tokens[3];
+  char *saveptr;
+  char *end;
+  long device_id;
+
+  tokens[0] = strtok_r(line, delimiters, &saveptr);
+  for (size_t i = 1; i < sizeof(tokens) / sizeof(tokens[0]); i++) {
+    tokens[i] = strtok_r(NULL, delimiters, &saveptr);
+    if (!tokens[i]) {
+      return EINVAL;
+    }
+  }
+
+  if (strtok_r(NULL, delimiters, &saveptr)) {
+    return EINVAL;
+  }
+
+  errno = 0;
+  record->timestamp_us = strtoull(tokens[0], &end, 10);
+  if (errno || *end || tokens[0][0] == '-') {
+    return EINVAL;
+  }
+
+  device_id = strtol(tokens[1], &end, 10);
+  if (errno || *end || device_id < 0) {
+    return EINVAL;
+  }
+
+  record->device_id = device_id;
+
+  return input_device_ops->parse_event(tokens[2], &record->input_event);
+}
+
+static void input_replay_process_timer(struct InputWatch *watch,
+                                       uint32_t events) {
+  struct InputReplay *replay =
+      INPUT_WATCH_CONTAINER(watch, struct InputReplay, watch);
+  uint64_t due_ns;
+  uint64_t now;
+  int err;
+  (void)events;
+
+  if (!replay->is_started || !timer_ops->consume(watch)) {
+    return;
+  }
+
+  now = timer_ops->get_timestamp();
+
+  for (size_t i = 0; i < REPLAY_CHUNK_MAX; i++) {
+    if (replay->pacing == REPLAY_PACING_ORIGINAL) {
+      // Events recorded out of order are simply late, they go right away.
+      due_ns = replay->start_ns;
+      if (replay->record.timestamp_us > replay->first_timestamp_us) {
+        due_ns +=
+            (replay->record.timestamp_us - replay->first_timestamp_us) * 1000;
+      }
+
+      if (due_ns > now) {
+        timer_ops->set(watch, due_ns);
+        return;
+      }
+    }
+
+    err = replay->callback(replay->record.input_event, replay->device_id);
+    if (err == ENOBUFS) {
+      timer_ops->back_off(watch, now);
+      return;
+    }
+
+    if (err) {
+      logging_ops->log_err(module_id, "Unable to deliver event at line %zu: %s",
+                           replay->line_number, strerror(err));
+    } else {
+      replay->events++;
+    }
+
+    if (replay_priv_ops->read_record(replay)) {
+      replay_priv_ops->stop(replay);
+      return;
+    }
+  }
+
+  // Chunk is done, let the loop dispatch other watches before next one.
+  timer_ops->set(watch, now);
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct InputReplayPrivateOps input_replay_priv_ops_ = {
+    .start = input_replay_start_replay,
+    .stop = input_replay_stop_replay,
+    .read_record = input_replay_read_record,
+    .parse_record = input_replay_parse_record,
+    .process_timer = input_replay_process_timer,
+};
+
+struct InputReplayPrivateOps *get_input_replay_priv_ops(void) {
+  return &input_replay_priv_ops_;
+}
+
+static struct InputReplayOps input_replay_ops = {
+    .init = input_replay_init,
+    .destroy = input_replay_destroy,
+};
+
+struct InputReplayOps *get_input_replay_ops(void) { return &input_replay_ops; }
@@ -0,0 +1,38 @@
+#ifndef INPUT_REPLAY_H
+#define INPUT_REPLAY_H
+/*******************************************************************************
+ * @file replay.h
+ * @brief Input device replaying recorded event streams.
+ *
+ * Every line of the recording holds one event: timestamp in microseconds,
+ * id of the device which produced the event and the event itself, either
+ * by name (`up`, `down`, `left`, `right`, `select`, `exit`) or by its
+ * number. Blank lines and lines starting with `#` are skipped.
+ *
+ * Events are fed either with their original pacing or as fast as the game
+ * takes them. All of them come from replay device, so users selecting it
+ * share it the same way they share a keyboard mapping.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define INPUT_REPLAY_DISP_NAME "replay"
+#define INPUT_REPLAY_PATH_VAR_NAME "replay_path"
+#define INPUT_REPLAY_PATH_DEFAULT "session.replay"
+#define INPUT_REPLAY_PACING_VAR_NAME "replay_pacing"
+#define INPUT_REPLAY_PACING_ORIGINAL "original"
+#define INPUT_REPLAY_PACING_FAST "fast"
+
+struct InputReplayOps {
+  int (*init)(void);
+  void (*destroy)(void);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct InputReplayOps *get_input_replay_ops(void);
+
+#endif // INPUT_REPLAY_H
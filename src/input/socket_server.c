@@ -0,0 +1,788 @@
+/*******************************************************************************
+ * @file socket_server.c
+ * @brief Input devices fed by remote players over a socket.
+ *
+ * Server does not own any thread, listening socket and every connection are
+ * watched from input subsystem's event loop, all of them non blocking. Idle
+ * connection costs only its slot in the connections pool, nothing is
+ * allocated per connection or per message. Each readiness is served with
+ * a single read, epoll reports connection again if there is more data, so
+ * one busy client can't starve the others. Events read at once for one
+ * user are delivered to the game as one batch.
+ *
+ * Binary clients (see wire_protocol.h) are told apart by their first byte
+ * and share everything past parsing with text ones. Acks are written
+ * right away, once per read, socket buffer always has room for a few bytes
+ * unless client stopped reading, its acks are folded into later ones then.
+ *
+ * If io_uring backend is compiled in, clients are accepted and read through
+ * the ring instead, and epoll is used only if the ring can't be set up.
+ * Everything past the received bytes is the same for both backends.
+ *
+ ******************************************************************************/
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// App's internal libs
+#include "config/config.h"
+#include "input/input.h"
+#include "input/input_common.h"
+#include "input/input_device.h"
+#include "input/input_server.h"
+#include "input/input_uring.h"
+#include "input/socket_server.h"
+#include "input/wire_protocol.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define SOCKET_LINE_MAX 32
+#define SOCKET_READ_MAX 4096
+// Shortest line is a digit followed by newline.
+#define SOCKET_EVENTS_MAX (SOCKET_READ_MAX / 2 + 1)
+#define SOCKET_USER_COMMAND "user "
+// Hello and the longest ack frame.
+#define SOCKET_OUTPUT_MAX 16
+
+_Static_assert(SOCKET_EVENTS_MAX <= INPUT_BATCH_LENGTH_MAX,
+               "Whole read has to fit into one batch");
+_Static_assert(INPUT_SOCKET_CONNECTIONS_MAX <= INPUT_URING_CONNECTIONS_MAX,
+               "Connection's index has to be valid ring's id");
+_Static_assert(INPUT_SOCKET_CONNECTIONS_MAX <= INPUT_SERVER_CONNECTIONS_MAX &&
+                   INPUT_SOCKET_USERS_MAX <= INPUT_SERVER_USERS_MAX,
+               "Server does not fit into shared scaffolding");
+
+enum SocketBackends {
+  SOCKET_BACKEND_EPOLL,
+  SOCKET_BACKEND_URING,
+};
+
+enum SocketProtocols {
+  SOCKET_PROTOCOL_UNKNOWN,
+  SOCKET_PROTOCOL_TEXT,
+  // Binary client's version did not arrive yet.
+  SOCKET_PROTOCOL_HELLO,
+  SOCKET_PROTOCOL_BINARY,
+};
+
+struct SocketConnection {
+  struct InputWatch watch;
+  enum SocketProtocols protocol;
+  // Line or frame split between reads.
+  union {
+    char line[SOCKET_LINE_MAX];
+    uint8_t frame[INPUT_WIRE_FRAME_MAX];
+  };
+  size_t line_length;
+  size_t frame_length;
+  uint8_t output[SOCKET_OUTPUT_MAX];
+  size_t output_length;
+  uint32_t acks_pending;
+  // User connection plays for, -1 until client tells who it is.
+  int user;
+};
+
+struct InputSocket {
+  char address[INPUT_SERVER_ADDRESS_MAX];
+  struct InputServer base;
+  struct SocketConnection connections[INPUT_SOCKET_CONNECTIONS_MAX];
+  struct InputSocketStats stats;
+  enum SocketBackends backend;
+  bool is_started;
+};
+
+struct InputSocketPrivateOps {
+  int (*start)(struct InputSocket *server);
+  void (*stop)(struct InputSocket *server);
+  int (*open_connection)(int fd, size_t index);
+  void (*process_connection)(struct InputWatch *watch, uint32_t events);
+  int (*process_data)(struct InputSocket *server,
+                      struct SocketConnection *connection, const char *data,
+                      size_t length);
+  int (*process_lines)(struct InputSocket *server,
+                       struct SocketConnection *connection, const char *data,
+                       size_t length);
+  int (*process_frames)(struct InputSocket *server,
+                        struct SocketConnection *connection,
+                        const uint8_t *data, size_t length);
+  int (*process_frame)(struct InputSocket *server,
+                       struct SocketConnection *connection,
+                       const uint8_t *data, size_t length,
+                       size_t *frame_length);
+  void (*send_output)(struct InputSocket *server,
+                      struct SocketConnection *connection);
+  int (*process_line)(struct InputSocket *server,
+                      struct SocketConnection *connection,
+                      enum InputEvents *input_events,
+                      size_t *input_events_length);
+  void (*deliver_events)(struct InputSocket *server, int user,
+                         const enum InputEvents *input_events,
+                         size_t input_events_length);
+  void (*close_connection)(struct InputSocket *server,
+                           struct SocketConnection *connection);
+  void (*release_connection)(struct InputSocket *server,
+                             struct SocketConnection *connection);
+  int (*uring_accept)(int fd, size_t *index);
+  void (*uring_reject)(void);
+  int (*uring_receive)(size_t index, const char *data, size_t length);
+  void (*uring_close)(size_t index);
+};
+
+static char module_id[] = INPUT_SOCKET_DISP_NAME;
+static struct InputSocket socket_server;
+static struct InputOps *input_ops;
+static struct ConfigOps *config_ops;
+static struct InputDeviceOps *input_device_ops;
+static struct InputServerOps *input_server_ops;
+static struct InputUringOps *input_uring_ops;
+static struct InputWireOps *input_wire_ops;
+static struct LoggingUtilsOps *logging_ops;
+static struct InputSocketPrivateOps *socket_priv_ops;
+struct InputSocketPrivateOps *get_input_socket_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int input_socket_start(void);
+static int input_socket_stop(void);
+static int input_socket_wait(void);
+
+static int input_socket_init(void) {
+  int err;
+
+  socket_priv_ops = get_input_socket_priv_ops();
+  logging_ops = get_logging_utils_ops();
+  config_ops = get_config_ops();
+  input_ops = get_input_ops();
+  input_device_ops = get_input_device_ops();
+  input_server_ops = get_input_server_ops();
+  input_uring_ops = get_input_uring_ops();
+  input_wire_ops = get_input_wire_ops();
+
+  socket_server.is_started = false;
+
+  err = config_ops->read_var(INPUT_SOCKET_ADDRESS_VAR_NAME,
+                             INPUT_SOCKET_ADDRESS_DEFAULT,
+                             socket_server.address,
+                             sizeof(socket_server.address));
+  if (err) {
+    return err;
+  }
+
+  err = input_server_ops->parse_address(&socket_server.base,
+                                        socket_server.address);
+  if (err) {
+    logging_ops->log_err(module_id, "Invalid %s value: %s",
+                         INPUT_SOCKET_ADDRESS_VAR_NAME, socket_server.address);
+    return err;
+  }
+
+  return input_server_ops->init(
+      &socket_server.base, INPUT_SOCKET_DISP_NAME, INPUT_SOCKET_USERS_MAX,
+      INPUT_SOCKET_CONNECTIONS_MAX,
+      (struct InputServerHandlers){
+          .start = input_socket_start,
+          .stop = input_socket_stop,
+          .wait = input_socket_wait,
+          .open_connection = socket_priv_ops->open_connection,
+      });
+}
+
+static void input_socket_destroy(void) {
+  if (socket_server.is_started) {
+    socket_priv_ops->stop(&socket_server);
+  }
+}
+
+static void input_socket_get_stats(struct InputSocketStats *stats) {
+  if (!stats) {
+    return;
+  }
+
+  *stats = socket_server.stats;
+  stats->accepted = socket_server.base.accepted;
+  stats->rejected = socket_server.base.rejected;
+}
+
+// All users' devices share one server, it is started by the first of them.
+static int input_socket_start(void) {
+  int err;
+
+  err = socket_priv_ops->start(&socket_server);
+  if (err) {
+    logging_ops->log_err(module_id, "Unable to start server on %s: %s",
+                         socket_server.address, strerror(err));
+    return err;
+  }
+
+  return 0;
+}
+
+static int input_socket_stop(void) {
+  socket_priv_ops->stop(&socket_server);
+
+  return 0;
+}
+
+// Server runs on input's loop, input subsystem waits for the loop itself.
+static int input_socket_wait(void) { return 0; }
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int input_socket_start_server(struct InputSocket *server) {
+  int err;
+
+  if (server->is_started) {
+    return 0;
+  }
+
+  for (size_t i = 0; i < INPUT_SOCKET_CONNECTIONS_MAX; i++) {
+    server->connections[i].watch.fd = -1;
+  }
+
+  server->stats = (struct InputSocketStats){0};
+
+  err = input_server_ops->start(&server->base);
+  if (err) {
+    return err;
+  }
+
+  server->backend = SOCKET_BACKEND_EPOLL;
+  if (input_uring_ops->is_supported()) {
+    err = input_uring_ops->start(
+        server->base.listen_watch.fd,
+        (struct InputUringHandlers){
+            .accept = socket_priv_ops->uring_accept,
+            .reject = socket_priv_ops->uring_reject,
+            .receive = socket_priv_ops->uring_receive,
+            .close = socket_priv_ops->uring_close,
+        });
+    if (err) {
+      logging_ops->log_err(module_id, "Unable to set up io_uring: %s",
+                           strerror(err));
+    } else {
+      server->backend = SOCKET_BACKEND_URING;
+    }
+  }
+
+  // Ring accepts clients itself.
+  if (server->backend == SOCKET_BACKEND_EPOLL) {
+    err = input_ops->add_watch(&server->base.listen_watch);
+    if (err) {
+      input_server_ops->stop(&server->base);
+      return err;
+    }
+  }
+
+  server->is_started = true;
+
+  logging_ops->log_info(module_id, "Listening on %s with %s",
+                        server->address,
+                        server->backend == SOCKET_BACKEND_URING ? "io_uring"
+                                                                : "epoll");
+
+  return 0;
+}
+
+static void input_socket_stop_server(struct InputSocket *server) {
+  struct InputUringStats uring_stats;
+
+  if (!server->is_started) {
+    return;
+  }
+
+  server->is_started = false;
+
+  for (size_t i = 0; i < INPUT_SOCKET_CONNECTIONS_MAX; i++) {
+    if (server->connections[i].watch.fd != -1) {
+      socket_priv_ops->close_connection(server, &server->connections[i]);
+    }
+  }
+
+  if (server->backend == SOCKET_BACKEND_URING) {
+    // Ring waits for connections' closes it still has queued.
+    input_uring_ops->stop();
+    input_uring_ops->get_stats(&uring_stats);
+    logging_ops->log_info(module_id,
+                          "io_uring submitted %zu requests and completed "
+                          "%zu in %zu syscalls",
+                          uring_stats.submissions, uring_stats.completions,
+                          uring_stats.enters);
+  }
+
+  input_server_ops->stop(&server->base);
+
+  logging_ops->log_info(module_id,
+                        "Accepted %zu clients, rejected %zu, received %zu "
+                        "events in %zu frames, %zu protocol errors",
+                        server->base.accepted, server->base.rejected,
+                        server->stats.events, server->stats.frames,
+                        server->stats.protocol_errors);
+}
+
+static int input_socket_open_connection(int fd, size_t index) {
+  struct SocketConnection *connection = &socket_server.connections[index];
+  int err;
+
+  *connection = (struct SocketConnection){
+      .watch = {.fd = fd,
+                .events = EPOLLIN | EPOLLRDHUP,
+                .callback = socket_priv_ops->process_connection},
+      .protocol = SOCKET_PROTOCOL_UNKNOWN,
+      .line_length = 0,
+      .frame_length = 0,
+      .output_length = 0,
+      .acks_pending = 0,
+      .user = -1,
+  };
+
+  // Ring receives client's data itself.
+  if (socket_server.backend == SOCKET_BACKEND_EPOLL) {
+    err = input_ops->add_watch(&connection->watch);
+    if (err) {
+      connection->watch.fd = -1;
+      return err;
+    }
+  }
+
+  return 0;
+}
+
+static void input_socket_process_connection(struct InputWatch *watch,
+                                            uint32_t events) {
+  struct SocketConnection *connection =
+      INPUT_WATCH_CONTAINER(watch, struct SocketConnection, watch);
+  struct InputSocket *server = &socket_server;
+  char buffer[SOCKET_READ_MAX];
+  ssize_t bytes_read;
+  (void)events;
+
+  if (!server->is_started) {
+    return;
+  }
+
+  bytes_read = read(watch->fd, buffer, sizeof(buffer));
+  if (bytes_read == -1 &&
+      (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+    return;
+  }
+
+  // Peer closed connection or it broke, there is nothing more to read.
+  if (bytes_read <= 0 || socket_priv_ops->process_data(server, connection,
+                                                       buffer, bytes_read)) {
+    socket_priv_ops->close_connection(server, connection);
+  }
+}
+
+// Returns error if client broke the protocol, events parsed before the
+//  invalid line or frame are still delivered.
+static int input_socket_process_data(struct InputSocket *server,
+                                     struct SocketConnection *connection,
+                                     const char *data, size_t length) {
+  uint8_t version;
+  int err;
+
+  // Text lines never start with the magic byte.
+  if (connection->protocol == SOCKET_PROTOCOL_UNKNOWN) {
+    connection->protocol = (uint8_t)data[0] == INPUT_WIRE_MAGIC
+                               ? SOCKET_PROTOCOL_HELLO
+                               : SOCKET_PROTOCOL_TEXT;
+    if (connection->protocol == SOCKET_PROTOCOL_HELLO) {
+      data++;
+      length--;
+    }
+  }
+
+  if (connection->protocol == SOCKET_PROTOCOL_TEXT) {
+    return socket_priv_ops->process_lines(server, connection, data, length);
+  }
+
+  if (connection->protocol == SOCKET_PROTOCOL_HELLO && length > 0) {
+    // Client may speak newer version, server answers with its own then.
+    version = (uint8_t)data[0];
+    if (version == 0) {
+      server->stats.protocol_errors++;
+      logging_ops->log_err(module_id, "Closing client, invalid version");
+      return EPROTO;
+    }
+    if (version > INPUT_WIRE_VERSION) {
+      version = INPUT_WIRE_VERSION;
+    }
+
+    connection->output[connection->output_length++] = INPUT_WIRE_MAGIC;
+    connection->output[connection->output_length++] = version;
+    connection->protocol = SOCKET_PROTOCOL_BINARY;
+    data++;
+    length--;
+  }
+
+  err = 0;
+  if (connection->protocol == SOCKET_PROTOCOL_BINARY && length > 0) {
+    err = socket_priv_ops->process_frames(server, connection,
+                                          (const uint8_t *)data, length);
+  }
+
+  if (!err) {
+    socket_priv_ops->send_output(server, connection);
+  }
+
+  return err;
+}
+
+static int input_socket_process_lines(struct InputSocket *server,
+                                      struct SocketConnection *connection,
+                                      const char *data, size_t length) {
+  enum InputEvents input_events[SOCKET_EVENTS_MAX];
+  size_t input_events_length = 0;
+  int user;
+  int err;
+
+  for (size_t i = 0; i < length; i++) {
+    if (data[i] != '\n') {
+      if (connection->line_length + 1 >= SOCKET_LINE_MAX) {
+        err = EPROTO;
+        goto error;
+      }
+
+      connection->line[connection->line_length++] = data[i];
+      continue;
+    }
+
+    connection->line[connection->line_length] = 0;
+
+    // Events read so far belong to previous user.
+    user = connection->user;
+    err = socket_priv_ops->process_line(server, connection, input_events,
+                                        &input_events_length);
+    if (err) {
+      goto error;
+    }
+
+    if (user != connection->user && input_events_length > 0) {
+      socket_priv_ops->deliver_events(server, user, input_events,
+                                      input_events_length);
+      input_events_length = 0;
+    }
+
+    connection->line_length = 0;
+  }
+
+  if (input_events_length > 0) {
+    socket_priv_ops->deliver_events(server, connection->user, input_events,
+                                    input_events_length);
+  }
+
+  return 0;
+
+error:
+  if (input_events_length > 0) {
+    socket_priv_ops->deliver_events(server, connection->user, input_events,
+                                    input_events_length);
+  }
+
+  server->stats.protocol_errors++;
+  logging_ops->log_err(module_id, "Closing client, invalid line: %.*s",
+                       (int)connection->line_length, connection->line);
+
+  return err;
+}
+
+static int input_socket_process_frames(struct InputSocket *server,
+                                       struct SocketConnection *connection,
+                                       const uint8_t *data, size_t length) {
+  size_t frame_length;
+  size_t copied;
+  int err;
+
+  while (length > 0) {
+    // Frames are processed straight from the read buffer, only the one
+    //  split between reads is copied.
+    if (connection->frame_length == 0) {
+      err = socket_priv_ops->process_frame(server, connection, data, length,
+                                           &frame_length);
+      if (err == EAGAIN) {
+        memcpy(connection->frame, data, length);
+        connection->frame_length = length;
+        return 0;
+      }
+      if (err) {
+        goto error;
+      }
+
+      data += frame_length;
+      length -= frame_length;
+      continue;
+    }
+
+    copied = sizeof(connection->frame) - connection->frame_length;
+    if (copied > length) {
+      copied = length;
+    }
+    memcpy(connection->frame + connection->frame_length, data, copied);
+
+    err = socket_priv_ops->process_frame(server, connection, connection->frame,
+                                         connection->frame_length + copied,
+                                         &frame_length);
+    if (err == EAGAIN) {
+      connection->frame_length += copied;
+      return 0;
+    }
+    if (err) {
+      goto error;
+    }
+
+    copied = frame_length - connection->frame_length;
+    connection->frame_length = 0;
+    data += copied;
+    length -= copied;
+  }
+
+  return 0;
+
+error:
+  server->stats.protocol_errors++;
+  logging_ops->log_err(module_id, "Closing client, invalid frame: %s",
+                       strerror(err));
+  return err;
+}
+
+// Returns EAGAIN if frame is not complete yet, nothing is delivered then.
+static int input_socket_process_frame(struct InputSocket *server,
+                                      struct SocketConnection *connection,
+                                      const uint8_t *data, size_t length,
+                                      size_t *frame_length) {
+  struct InputWireRecord record;
+  struct InputWireFrame frame;
+  int err;
+
+  err = input_wire_ops->parse_frame(data, length, &frame);
+  if (err) {
+    return err;
+  }
+
+  server->stats.frames++;
+
+  while ((err = input_wire_ops->parse_record(&frame, &record)) == 0) {
+    // Clients only ever send moves, for users playing over the socket.
+    if (record.kind != INPUT_WIRE_EVENTS ||
+        record.user > INPUT_SOCKET_USERS_MAX ||
+        !server->base.users[record.user - 1].callback) {
+      return EPROTO;
+    }
+
+    socket_priv_ops->deliver_events(server, record.user - 1, record.events,
+                                    record.events_length);
+    connection->acks_pending++;
+  }
+
+  if (err != ENOENT) {
+    return err;
+  }
+
+  *frame_length = frame.frame_length;
+
+  return 0;
+}
+
+static void input_socket_send_output(struct InputSocket *server,
+                                     struct SocketConnection *connection) {
+  uint8_t payload[1 + INPUT_WIRE_VARINT_MAX];
+  size_t payload_length = 0;
+  ssize_t bytes_written;
+  (void)server;
+
+  // Acks are cumulative, ones which can't be written now are folded into
+  //  the next ack. Ack's length prefix is always a single byte.
+  if (connection->acks_pending > 0 &&
+      sizeof(connection->output) - connection->output_length >
+          sizeof(payload)) {
+    input_wire_ops->compose_ack(payload, &payload_length,
+                                connection->acks_pending);
+    connection->output_length += input_wire_ops->compose_frame(
+        payload, payload_length,
+        connection->output + connection->output_length);
+    connection->acks_pending = 0;
+  }
+
+  if (connection->output_length == 0) {
+    return;
+  }
+
+  // Broken connection is noticed by the next read.
+  bytes_written = send(connection->watch.fd, connection->output,
+                       connection->output_length,
+                       MSG_DONTWAIT | MSG_NOSIGNAL);
+  if (bytes_written <= 0) {
+    return;
+  }
+
+  memmove(connection->output, connection->output + bytes_written,
+          connection->output_length - bytes_written);
+  connection->output_length -= bytes_written;
+}
+
+static int input_socket_process_line(struct InputSocket *server,
+                                     struct SocketConnection *connection,
+                                     enum InputEvents *input_events,
+                                     size_t *input_events_length) {
+  const size_t command_length = sizeof(SOCKET_USER_COMMAND) - 1;
+  char *line = connection->line;
+  enum InputEvents input_event;
+  size_t length;
+  char *end;
+  long user;
+
+  length = connection->line_length;
+  if (length > 0 && line[length - 1] == '\r') {
+    line[--length] = 0;
+  }
+
+  if (length == 0) {
+    return 0;
+  }
+
+  if (strncmp(line, SOCKET_USER_COMMAND, command_length) == 0) {
+    user = strtol(line + command_length, &end, 10);
+    if (end == line + command_length || *end || user < 1 ||
+        user > INPUT_SOCKET_USERS_MAX) {
+      return EPROTO;
+    }
+
+    // User does not play over the socket, nobody would take the events.
+    if (!server->base.users[user - 1].callback) {
+      return EPROTO;
+    }
+
+    connection->user = user - 1;
+
+    return 0;
+  }
+
+  if (connection->user == -1 ||
+      input_device_ops->parse_event(line, &input_event)) {
+    return EPROTO;
+  }
+
+  input_events[(*input_events_length)++] = input_event;
+
+  return 0;
+}
+
+static void input_socket_deliver_events(struct InputSocket *server, int user,
+                                        const enum InputEvents *input_events,
+                                        size_t input_events_length) {
+  struct InputServerUser *socket_user = &server->base.users[user];
+
+  server->stats.events += input_events_length;
+
+  // Game drops events it has no room for, same as for keyboard.
+  if (socket_user->batch_callback) {
+    socket_user->batch_callback(input_events, input_events_length,
+                                socket_user->device_id);
+    return;
+  }
+
+  for (size_t i = 0; i < input_events_length; i++) {
+    socket_user->callback(input_events[i], socket_user->device_id);
+  }
+}
+
+static void input_socket_close_connection(struct InputSocket *server,
+                                          struct SocketConnection *connection) {
+  if (server->backend == SOCKET_BACKEND_URING) {
+    input_uring_ops->close_connection(connection - server->connections);
+  } else {
+    input_ops->remove_watch(&connection->watch);
+    close(connection->watch.fd);
+  }
+
+  socket_priv_ops->release_connection(server, connection);
+}
+
+// Gives connection's slot back, its fd is already taken care of.
+static void
+input_socket_release_connection(struct InputSocket *server,
+                                struct SocketConnection *connection) {
+  connection->watch.fd = -1;
+
+  input_server_ops->release_connection(&server->base,
+                                       connection - server->connections);
+}
+
+// Ring's handlers, connection's index is its id in the ring.
+static int input_socket_uring_accept(int fd, size_t *index) {
+  return input_server_ops->accept_client(&socket_server.base, fd, index);
+}
+
+static void input_socket_uring_reject(void) {
+  input_server_ops->reject_client(&socket_server.base);
+}
+
+static int input_socket_uring_receive(size_t index, const char *data,
+                                      size_t length) {
+  struct SocketConnection *connection = &socket_server.connections[index];
+  int err;
+
+  err = socket_priv_ops->process_data(&socket_server, connection, data,
+                                      length);
+  if (err) {
+    // Ring closes the client itself.
+    socket_priv_ops->release_connection(&socket_server, connection);
+  }
+
+  return err;
+}
+
+static void input_socket_uring_close(size_t index) {
+  socket_priv_ops->release_connection(&socket_server,
+                                      &socket_server.connections[index]);
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct InputSocketPrivateOps input_socket_priv_ops_ = {
+    .start = input_socket_start_server,
+    .stop = input_socket_stop_server,
+    .open_connection = input_socket_open_connection,
+    .process_connection = input_socket_process_connection,
+    .process_data = input_socket_process_data,
+    .process_lines = input_socket_process_lines,
+    .process_frames = input_socket_process_frames,
+    .process_frame = input_socket_process_frame,
+    .send_output = input_socket_send_output,
+    .process_line = input_socket_process_line,
+    .deliver_events = input_socket_deliver_events,
+    .close_connection = input_socket_close_connection,
+    .release_connection = input_socket_release_connection,
+    .uring_accept = input_socket_uring_accept,
+    .uring_reject = input_socket_uring_reject,
+    .uring_receive = input_socket_uring_receive,
+    .uring_close = input_socket_uring_close,
+};
+
+struct InputSocketPrivateOps *get_input_socket_priv_ops(void) {
+  return &input_socket_priv_ops_;
+}
+
+static struct InputSocketOps input_socket_ops = {
+    .init = input_socket_init,
+    .destroy = input_socket_destroy,
+    .get_stats = input_socket_get_stats,
+};
+
+struct InputSocketOps *get_input_socket_ops(void) { return &input_socket_ops; }
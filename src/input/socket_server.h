@@ -0,0 +1,54 @@
+#ifndef INPUT_SOCKET_SERVER_H
+#define INPUT_SOCKET_SERVER_H
+/*******************************************************************************
+ * @file socket_server.h
+ * @brief Input devices fed by remote players over a socket.
+ *
+ * Server listens on Unix socket (`unix:<path>`) or on localhost TCP port
+ * (`tcp:<port>`) and accepts any number of clients up to the connections
+ * limit. Protocol is line based: client first tells which user it plays
+ * for with `user <n>`, every following line is a single event, either by
+ * name (`up`, `down`, `left`, `right`, `select`, `exit`) or by its number.
+ * Events are routed to `socket<n>` device, so n-th user selects it with
+ * `user<n>_input=socket<n>`.
+ *
+ * Clients can speak compact binary protocol instead, see wire_protocol.h,
+ * which carries many moves per frame and acknowledges them.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define INPUT_SOCKET_DISP_NAME "socket"
+#define INPUT_SOCKET_ADDRESS_VAR_NAME "socket_address"
+#define INPUT_SOCKET_ADDRESS_DEFAULT "unix:/tmp/ttt.sock"
+#define INPUT_SOCKET_USERS_MAX 10
+#define INPUT_SOCKET_CONNECTIONS_MAX 4096
+
+struct InputSocketStats {
+  size_t accepted;
+  size_t rejected;
+  size_t events;
+  // Frames sent by binary clients.
+  size_t frames;
+  size_t protocol_errors;
+};
+
+struct InputSocketOps {
+  int (*init)(void);
+  void (*destroy)(void);
+  void (*get_stats)(struct InputSocketStats *stats);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct InputSocketOps *get_input_socket_ops(void);
+
+#endif // INPUT_SOCKET_SERVER_H
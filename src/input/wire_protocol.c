@@ -0,0 +1,445 @@
+/*******************************************************************************
+ * @file wire_protocol.c
+ * @brief Binary protocol spoken by socket server next to the text one.
+ *
+ * Codec only, it never touches a socket, so server and client library
+ * share it. Nothing is allocated, records are parsed straight from the
+ * buffer frame was read into.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// App's internal libs
+#include "game/user_move.h"
+#include "input/input_common.h"
+#include "input/wire_protocol.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define INPUT_WIRE_KIND_BITS 2
+#define INPUT_WIRE_KIND_MASK 0x3
+
+struct InputWirePrivateOps {
+  bool (*is_event_valid)(uint32_t value);
+  int (*parse_varints)(struct InputWireFrame *frame, uint32_t **values,
+                       size_t values_length);
+  int (*compose_record)(uint8_t *payload, size_t *payload_length,
+                        const uint32_t *values, size_t values_length);
+};
+
+// Codec runs on many threads at once, so its ops are bound when the program
+//  loads instead of by every call.
+static struct InputWireOps input_wire_ops_;
+static struct InputWirePrivateOps input_wire_priv_ops_;
+static struct InputWireOps *input_wire_ops = &input_wire_ops_;
+static struct InputWirePrivateOps *input_wire_priv_ops = &input_wire_priv_ops_;
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static size_t input_wire_encode_varint(uint32_t value, uint8_t *buffer) {
+  size_t length = 0;
+
+  while (value >= 0x80) {
+    buffer[length++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  buffer[length++] = (uint8_t)value;
+
+  return length;
+}
+
+static int input_wire_decode_varint(const uint8_t *buffer, size_t length,
+                                    uint32_t *value, size_t *value_length) {
+  uint32_t result = 0;
+
+  for (size_t i = 0; i < INPUT_WIRE_VARINT_MAX; i++) {
+    if (i == length) {
+      return EAGAIN;
+    }
+
+    // Fifth byte carries only four highest bits of 32 bit value.
+    if (i == INPUT_WIRE_VARINT_MAX - 1 && buffer[i] > 0x0F) {
+      return EPROTO;
+    }
+
+    result |= (uint32_t)(buffer[i] & 0x7F) << (7 * i);
+    if (!(buffer[i] & 0x80)) {
+      *value = result;
+      *value_length = i + 1;
+      return 0;
+    }
+  }
+
+  return EPROTO;
+}
+
+static int input_wire_parse_frame(const uint8_t *buffer, size_t length,
+                                  struct InputWireFrame *frame) {
+  size_t prefix_length;
+  uint32_t payload_length;
+  int err;
+
+  if (!buffer || !frame) {
+    return EINVAL;
+  }
+
+  err = input_wire_ops->decode_varint(buffer, length, &payload_length,
+                                      &prefix_length);
+  if (err == EPROTO) {
+    return EMSGSIZE;
+  }
+  if (err) {
+    return err;
+  }
+
+  if (payload_length == 0 || payload_length > INPUT_WIRE_PAYLOAD_MAX) {
+    return EMSGSIZE;
+  }
+
+  if (length - prefix_length < payload_length) {
+    return EAGAIN;
+  }
+
+  *frame = (struct InputWireFrame){
+      .payload = buffer + prefix_length,
+      .payload_length = payload_length,
+      .frame_length = prefix_length + payload_length,
+      .offset = 0,
+  };
+
+  return 0;
+}
+
+static int input_wire_parse_record(struct InputWireFrame *frame,
+                                   struct InputWireRecord *record) {
+  const uint8_t *packed_events;
+  size_t packed_length;
+  size_t value_length;
+  uint32_t value;
+  uint32_t head;
+  int err;
+
+  if (!frame || !record) {
+    return EINVAL;
+  }
+
+  if (frame->offset == frame->payload_length) {
+    return ENOENT;
+  }
+
+  // Record never continues past its frame.
+  err = input_wire_ops->decode_varint(frame->payload + frame->offset,
+                                      frame->payload_length - frame->offset,
+                                      &head, &value_length);
+  if (err) {
+    return EPROTO;
+  }
+  frame->offset += value_length;
+
+  err = input_wire_ops->decode_varint(frame->payload + frame->offset,
+                                      frame->payload_length - frame->offset,
+                                      &value, &value_length);
+  if (err) {
+    return EPROTO;
+  }
+  frame->offset += value_length;
+
+  record->kind = head & INPUT_WIRE_KIND_MASK;
+  record->user = head >> INPUT_WIRE_KIND_BITS;
+
+  switch (record->kind) {
+  case INPUT_WIRE_EVENTS:
+    if (record->user == 0 || value == 0 || value > INPUT_WIRE_EVENTS_MAX) {
+      return EPROTO;
+    }
+
+    packed_length = (value + 1) / 2;
+    if (frame->payload_length - frame->offset < packed_length) {
+      return EPROTO;
+    }
+
+    packed_events = frame->payload + frame->offset;
+    for (size_t i = 0; i < value; i++) {
+      uint32_t event = i % 2 ? packed_events[i / 2] >> 4
+                             : packed_events[i / 2] & 0x0F;
+      if (!input_wire_priv_ops->is_event_valid(event)) {
+        return EPROTO;
+      }
+      record->events[i] = event;
+    }
+
+    // Padding keeps the packing canonical.
+    if (value % 2 && packed_events[packed_length - 1] >> 4) {
+      return EPROTO;
+    }
+
+    record->events_length = value;
+    record->moves = 0;
+    frame->offset += packed_length;
+
+    return 0;
+
+  case INPUT_WIRE_ACK:
+    if (record->user != 0) {
+      return EPROTO;
+    }
+
+    record->moves = value;
+    record->events_length = 0;
+
+    return 0;
+
+  case INPUT_WIRE_MOVE:
+    // Highlights stay on the server, only selects and quits are reported.
+    if (record->user == 0 || value < USER_MOVE_TYPE_SELECT_VALID ||
+        value > USER_MOVE_TYPE_QUIT) {
+      return EPROTO;
+    }
+
+    record->move_type = value;
+    record->events_length = 0;
+
+    return input_wire_priv_ops->parse_varints(
+        frame, (uint32_t *[]){&record->x, &record->y}, 2);
+
+  case INPUT_WIRE_GAME:
+    record->game = value;
+    record->events_length = 0;
+
+    switch (record->game) {
+    case INPUT_WIRE_GAME_RESULT:
+      return input_wire_priv_ops->parse_varints(
+          frame, (uint32_t *[]){&record->moves}, 1);
+
+    case INPUT_WIRE_GAME_JOIN:
+    case INPUT_WIRE_GAME_START:
+      // Only start tells the seat.
+      if ((record->user == 0) != (record->game == INPUT_WIRE_GAME_JOIN)) {
+        return EPROTO;
+      }
+
+      return input_wire_priv_ops->parse_varints(
+          frame, (uint32_t *[]){&record->users, &record->board_size}, 2);
+
+    default:
+      return EPROTO;
+    }
+
+  default:
+    return EPROTO;
+  }
+}
+
+static int input_wire_compose_events(uint8_t *payload, size_t *payload_length,
+                                     uint32_t user,
+                                     const enum InputEvents *events,
+                                     size_t events_length) {
+  uint8_t head[2 * INPUT_WIRE_VARINT_MAX];
+  size_t head_length;
+  size_t packed_length;
+  uint8_t *packed_events;
+
+  if (!payload || !payload_length || !events || user == 0 ||
+      user > UINT32_MAX >> INPUT_WIRE_KIND_BITS || events_length == 0 ||
+      events_length > INPUT_WIRE_EVENTS_MAX) {
+    return EINVAL;
+  }
+
+  for (size_t i = 0; i < events_length; i++) {
+    if (!input_wire_priv_ops->is_event_valid(events[i])) {
+      return EINVAL;
+    }
+  }
+
+  head_length = input_wire_ops->encode_varint(
+      user << INPUT_WIRE_KIND_BITS | INPUT_WIRE_EVENTS, head);
+  head_length += input_wire_ops->encode_varint(events_length,
+                                               head + head_length);
+  packed_length = (events_length + 1) / 2;
+
+  if (INPUT_WIRE_PAYLOAD_MAX - *payload_length <
+      head_length + packed_length) {
+    return ENOBUFS;
+  }
+
+  memcpy(payload + *payload_length, head, head_length);
+  packed_events = payload + *payload_length + head_length;
+  memset(packed_events, 0, packed_length);
+  for (size_t i = 0; i < events_length; i++) {
+    packed_events[i / 2] |= (uint8_t)(events[i] << (i % 2 ? 4 : 0));
+  }
+
+  *payload_length += head_length + packed_length;
+
+  return 0;
+}
+
+static int input_wire_compose_ack(uint8_t *payload, size_t *payload_length,
+                                  uint32_t moves) {
+  uint8_t record[1 + INPUT_WIRE_VARINT_MAX];
+  size_t record_length;
+
+  if (!payload || !payload_length) {
+    return EINVAL;
+  }
+
+  record[0] = INPUT_WIRE_ACK;
+  record_length = 1 + input_wire_ops->encode_varint(moves, record + 1);
+
+  if (INPUT_WIRE_PAYLOAD_MAX - *payload_length < record_length) {
+    return ENOBUFS;
+  }
+
+  memcpy(payload + *payload_length, record, record_length);
+  *payload_length += record_length;
+
+  return 0;
+}
+
+static int input_wire_compose_move(uint8_t *payload, size_t *payload_length,
+                                   uint32_t user, uint32_t move_type,
+                                   uint32_t x, uint32_t y) {
+  if (!payload || !payload_length || user == 0 ||
+      user > UINT32_MAX >> INPUT_WIRE_KIND_BITS ||
+      move_type < USER_MOVE_TYPE_SELECT_VALID ||
+      move_type > USER_MOVE_TYPE_QUIT) {
+    return EINVAL;
+  }
+
+  return input_wire_priv_ops->compose_record(
+      payload, payload_length,
+      (uint32_t[]){user << INPUT_WIRE_KIND_BITS | INPUT_WIRE_MOVE, move_type,
+                   x, y},
+      4);
+}
+
+static int input_wire_compose_result(uint8_t *payload, size_t *payload_length,
+                                     uint32_t winner, uint32_t moves) {
+  if (!payload || !payload_length ||
+      winner > UINT32_MAX >> INPUT_WIRE_KIND_BITS) {
+    return EINVAL;
+  }
+
+  return input_wire_priv_ops->compose_record(
+      payload, payload_length,
+      (uint32_t[]){winner << INPUT_WIRE_KIND_BITS | INPUT_WIRE_GAME,
+                   INPUT_WIRE_GAME_RESULT, moves},
+      3);
+}
+
+static int input_wire_compose_join(uint8_t *payload, size_t *payload_length,
+                                   uint32_t users, uint32_t board_size) {
+  if (!payload || !payload_length) {
+    return EINVAL;
+  }
+
+  return input_wire_priv_ops->compose_record(
+      payload, payload_length,
+      (uint32_t[]){INPUT_WIRE_GAME, INPUT_WIRE_GAME_JOIN, users, board_size},
+      4);
+}
+
+static int input_wire_compose_start(uint8_t *payload, size_t *payload_length,
+                                    uint32_t seat, uint32_t users,
+                                    uint32_t board_size) {
+  if (!payload || !payload_length || seat == 0 ||
+      seat > UINT32_MAX >> INPUT_WIRE_KIND_BITS) {
+    return EINVAL;
+  }
+
+  return input_wire_priv_ops->compose_record(
+      payload, payload_length,
+      (uint32_t[]){seat << INPUT_WIRE_KIND_BITS | INPUT_WIRE_GAME,
+                   INPUT_WIRE_GAME_START, users, board_size},
+      4);
+}
+
+static size_t input_wire_compose_frame(const uint8_t *payload,
+                                       size_t payload_length, uint8_t *frame) {
+  size_t prefix_length;
+
+  prefix_length = input_wire_ops->encode_varint(payload_length, frame);
+  memcpy(frame + prefix_length, payload, payload_length);
+
+  return prefix_length + payload_length;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static bool input_wire_is_event_valid(uint32_t value) {
+  return value > INPUT_EVENT_NONE && value < INPUT_EVENT_INVALID;
+}
+
+static int input_wire_parse_varints(struct InputWireFrame *frame,
+                                    uint32_t **values, size_t values_length) {
+  size_t value_length;
+
+  for (size_t i = 0; i < values_length; i++) {
+    if (input_wire_ops->decode_varint(frame->payload + frame->offset,
+                                      frame->payload_length - frame->offset,
+                                      values[i], &value_length)) {
+      return EPROTO;
+    }
+    frame->offset += value_length;
+  }
+
+  return 0;
+}
+
+static int input_wire_compose_record(uint8_t *payload, size_t *payload_length,
+                                     const uint32_t *values,
+                                     size_t values_length) {
+  uint8_t record[4 * INPUT_WIRE_VARINT_MAX];
+  size_t record_length = 0;
+
+  for (size_t i = 0; i < values_length; i++) {
+    record_length +=
+        input_wire_ops->encode_varint(values[i], record + record_length);
+  }
+
+  if (INPUT_WIRE_PAYLOAD_MAX - *payload_length < record_length) {
+    return ENOBUFS;
+  }
+
+  memcpy(payload + *payload_length, record, record_length);
+  *payload_length += record_length;
+
+  return 0;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct InputWirePrivateOps input_wire_priv_ops_ = {
+    .is_event_valid = input_wire_is_event_valid,
+    .parse_varints = input_wire_parse_varints,
+    .compose_record = input_wire_compose_record,
+};
+
+static struct InputWireOps input_wire_ops_ = {
+    .encode_varint = input_wire_encode_varint,
+    .decode_varint = input_wire_decode_varint,
+    .parse_frame = input_wire_parse_frame,
+    .parse_record = input_wire_parse_record,
+    .compose_events = input_wire_compose_events,
+    .compose_ack = input_wire_compose_ack,
+    .compose_move = input_wire_compose_move,
+    .compose_result = input_wire_compose_result,
+    .compose_join = input_wire_compose_join,
+    .compose_start = input_wire_compose_start,
+    .compose_frame = input_wire_compose_frame,
+};
+
+struct InputWireOps *get_input_wire_ops(void) { return &input_wire_ops_; }
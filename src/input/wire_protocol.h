@@ -0,0 +1,140 @@
+#ifndef INPUT_WIRE_PROTOCOL_H
+#define INPUT_WIRE_PROTOCOL_H
+/*******************************************************************************
+ * @file wire_protocol.h
+ * @brief Binary protocol spoken by socket server next to the text one.
+ *
+ * Client starts with magic byte followed by highest version it speaks,
+ * server answers with the same magic and version both will use. Text
+ * lines never start with the magic byte, so server tells the protocols
+ * apart by the first byte it reads.
+ *
+ * Everything after that is a stream of frames. Frame is its payload's
+ * length as varint followed by the payload, which is a sequence of
+ * records. Record starts with varint head, kind in its two low bits and
+ * user (counted from 1) above them:
+ *
+ *   events: head, varint count, events packed two per byte, low nibble
+ *           first, last high nibble is zero if count is odd
+ *   ack:    head with user 0, varint count of events records server
+ *           processed since its previous ack
+ *   move:   head, varint UserMoveType, varint x, varint y
+ *   game:   head, varint game record type followed by its fields:
+ *             result: varint count of valid moves, head's user is the
+ *                     winner, 0 if nobody won
+ *             join:   varint users amount, varint board size, head's user
+ *                     is 0
+ *             start:  varint users amount, varint board size, head's user
+ *                     is the seat player got
+ *
+ * Events record is one move of the user, clients send them, server answers
+ * with acks. Acks are cumulative, so server may fold several into one.
+ * Servers hosting whole sessions also report every select and quit with
+ * move record and end of every game with result record. Client asks such
+ * server to seat it with other players with join record, server answers
+ * with start record once they are all there.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+#include "input/input_common.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define INPUT_WIRE_MAGIC 0xE7
+#define INPUT_WIRE_VERSION 1
+#define INPUT_WIRE_HELLO_LENGTH 2
+// Length prefix of the longest payload still fits into one byte, it is a
+//  varint anyway, so later versions can raise the limit.
+#define INPUT_WIRE_PAYLOAD_MAX 127
+#define INPUT_WIRE_VARINT_MAX 5
+#define INPUT_WIRE_FRAME_MAX (INPUT_WIRE_PAYLOAD_MAX + 1)
+#define INPUT_WIRE_EVENTS_MAX (2 * INPUT_WIRE_PAYLOAD_MAX)
+
+enum InputWireKinds {
+  INPUT_WIRE_EVENTS = 0,
+  INPUT_WIRE_ACK = 1,
+  INPUT_WIRE_MOVE = 2,
+  INPUT_WIRE_GAME = 3,
+};
+
+enum InputWireGames {
+  INPUT_WIRE_GAME_RESULT = 0,
+  INPUT_WIRE_GAME_JOIN = 1,
+  INPUT_WIRE_GAME_START = 2,
+};
+
+struct InputWireFrame {
+  const uint8_t *payload;
+  size_t payload_length;
+  // Length prefix and payload, next frame starts right after it.
+  size_t frame_length;
+  // Offset of the next record in payload.
+  size_t offset;
+};
+
+struct InputWireRecord {
+  enum InputWireKinds kind;
+  uint32_t user;
+  // Moves acknowledged by ack record or valid moves of finished game.
+  uint32_t moves;
+  // Select or quit reported by move record.
+  uint32_t move_type;
+  uint32_t x;
+  uint32_t y;
+  enum InputWireGames game;
+  // Game asked for by join record or started by start record.
+  uint32_t users;
+  uint32_t board_size;
+  enum InputEvents events[INPUT_WIRE_EVENTS_MAX];
+  size_t events_length;
+};
+
+struct InputWireOps {
+  // Writes value into buffer, which has room for INPUT_WIRE_VARINT_MAX
+  //  bytes, and returns its length.
+  size_t (*encode_varint)(uint32_t value, uint8_t *buffer);
+  // Returns 0, EAGAIN if buffer ends in the middle of varint and EPROTO if
+  //  varint is too long.
+  int (*decode_varint)(const uint8_t *buffer, size_t length, uint32_t *value,
+                       size_t *value_length);
+  // Returns 0 once whole frame is in the buffer, EAGAIN if it is not yet
+  //  and EMSGSIZE if its payload is empty or too long.
+  int (*parse_frame)(const uint8_t *buffer, size_t length,
+                     struct InputWireFrame *frame);
+  // Returns 0 and the next record of frame, ENOENT if there is none left
+  //  and EPROTO if record is invalid.
+  int (*parse_record)(struct InputWireFrame *frame,
+                      struct InputWireRecord *record);
+  // Append record to payload, ENOBUFS if payload has no room for it.
+  int (*compose_events)(uint8_t *payload, size_t *payload_length,
+                        uint32_t user, const enum InputEvents *events,
+                        size_t events_length);
+  int (*compose_ack)(uint8_t *payload, size_t *payload_length,
+                     uint32_t moves);
+  int (*compose_move)(uint8_t *payload, size_t *payload_length, uint32_t user,
+                      uint32_t move_type, uint32_t x, uint32_t y);
+  int (*compose_result)(uint8_t *payload, size_t *payload_length,
+                        uint32_t winner, uint32_t moves);
+  int (*compose_join)(uint8_t *payload, size_t *payload_length,
+                      uint32_t users, uint32_t board_size);
+  int (*compose_start)(uint8_t *payload, size_t *payload_length,
+                       uint32_t seat, uint32_t users, uint32_t board_size);
+  // Writes length prefix and payload into frame, which has room for
+  //  INPUT_WIRE_FRAME_MAX bytes, and returns frame's length.
+  size_t (*compose_frame)(const uint8_t *payload, size_t payload_length,
+                          uint8_t *frame);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct InputWireOps *get_input_wire_ops(void);
+
+#endif // INPUT_WIRE_PROTOCOL_H
@@ -0,0 +1,199 @@
+/*******************************************************************************
+ * @file session.c
+ * @brief Game hosted by the session server.
+ *
+ * Board is a plain array of owners, so checking a win after select costs
+ * a walk over at most four lines crossing the selected cell instead of
+ * a walk over every move made so far. The walk itself is the local game's
+ * one, so both score every board the same way.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// App's internal libs
+#include "game/game_win.h"
+#include "game/user_move.h"
+#include "input/input_common.h"
+#include "session/session.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+struct SessionPrivateOps {
+  void (*move_cursor)(struct Session *session, enum InputEvents event);
+  enum UserMoveType (*select)(struct Session *session);
+  bool (*is_win)(struct Session *session);
+  bool (*is_cell_owned)(const void *board, int x, int y);
+};
+
+// Reactors run sessions on many threads at once, so ops are bound when the
+//  program loads instead of by init.
+static struct SessionPrivateOps session_priv_ops_;
+static struct SessionPrivateOps *session_priv_ops = &session_priv_ops_;
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int session_init(struct Session *session, size_t users_amount,
+                        size_t board_size) {
+  if (!session || users_amount < 2 || users_amount > SESSION_USERS_MAX ||
+      board_size <= users_amount || board_size > SESSION_BOARD_MAX) {
+    return EINVAL;
+  }
+
+  memset(session, 0, sizeof(*session));
+  session->state = SESSION_STATE_PLAY;
+  session->users_amount = users_amount;
+  session->board_size = board_size;
+  // Cursor starts where the local game's one does.
+  session->cursor = (struct UserMoveCoordinates){.x = 1, .y = 1};
+  session->winner = -1;
+
+  return 0;
+}
+
+static int session_process_events(struct Session *session, game_user_id_t user,
+                                  const enum InputEvents *events,
+                                  size_t events_length,
+                                  struct UserMove *moves,
+                                  size_t *moves_length) {
+  struct UserMove *move;
+
+  if (!session || !events || !moves || !moves_length) {
+    return EINVAL;
+  }
+
+  if (session->state != SESSION_STATE_PLAY || user != session->current_user) {
+    return EPERM;
+  }
+
+  *moves_length = 0;
+
+  for (size_t i = 0; i < events_length; i++) {
+    switch (events[i]) {
+    case INPUT_EVENT_UP:
+    case INPUT_EVENT_DOWN:
+    case INPUT_EVENT_LEFT:
+    case INPUT_EVENT_RIGHT:
+      session_priv_ops->move_cursor(session, events[i]);
+      continue;
+
+    case INPUT_EVENT_SELECT:
+    case INPUT_EVENT_EXIT:
+      break;
+
+    default:
+      continue;
+    }
+
+    move = &moves[(*moves_length)++];
+    *move = (struct UserMove){
+        .type = events[i] == INPUT_EVENT_EXIT
+                    ? USER_MOVE_TYPE_QUIT
+                    : session_priv_ops->select(session),
+        .user_id = user,
+        .coordinates = session->cursor,
+    };
+
+    if (move->type == USER_MOVE_TYPE_QUIT) {
+      session->state = SESSION_STATE_QUIT;
+    }
+
+    // Events user sent past the end of the game are dropped, as well as
+    //  ones sent past the end of the turn.
+    if (session->state != SESSION_STATE_PLAY ||
+        move->type == USER_MOVE_TYPE_SELECT_VALID) {
+      break;
+    }
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static void session_move_cursor(struct Session *session,
+                                enum InputEvents event) {
+  int max = session->board_size - 1;
+  struct UserMoveCoordinates *cursor = &session->cursor;
+
+  switch (event) {
+  case INPUT_EVENT_UP:
+    cursor->y = cursor->y == 0 ? max : cursor->y - 1;
+    break;
+  case INPUT_EVENT_DOWN:
+    cursor->y = cursor->y == max ? 0 : cursor->y + 1;
+    break;
+  case INPUT_EVENT_LEFT:
+    cursor->x = cursor->x == 0 ? max : cursor->x - 1;
+    break;
+  case INPUT_EVENT_RIGHT:
+    cursor->x = cursor->x == max ? 0 : cursor->x + 1;
+    break;
+  default:
+    break;
+  }
+}
+
+static enum UserMoveType session_select(struct Session *session) {
+  uint8_t *cell = &session->board[session->cursor.y][session->cursor.x];
+
+  if (*cell) {
+    return USER_MOVE_TYPE_SELECT_INVALID;
+  }
+
+  *cell = session->current_user + 1;
+  session->valid_moves++;
+
+  if (session_priv_ops->is_win(session)) {
+    session->state = SESSION_STATE_WIN;
+    session->winner = session->current_user;
+  } else if (session->valid_moves ==
+             session->board_size * session->board_size) {
+    session->state = SESSION_STATE_DRAW;
+  } else {
+    session->current_user =
+        (session->current_user + 1) % session->users_amount;
+  }
+
+  return USER_MOVE_TYPE_SELECT_VALID;
+}
+
+static bool session_is_win(struct Session *session) {
+  return get_game_win_ops()->is_win(session, session->board_size,
+                                    session->users_amount, session->cursor,
+                                    session_priv_ops->is_cell_owned);
+}
+
+static bool session_is_cell_owned(const void *board, int x, int y) {
+  const struct Session *session = board;
+
+  return session->board[y][x] ==
+         session->board[session->cursor.y][session->cursor.x];
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct SessionPrivateOps session_priv_ops_ = {
+    .move_cursor = session_move_cursor,
+    .select = session_select,
+    .is_win = session_is_win,
+    .is_cell_owned = session_is_cell_owned,
+};
+
+static struct SessionOps session_ops = {
+    .init = session_init,
+    .process_events = session_process_events,
+};
+
+struct SessionOps *get_session_ops(void) { return &session_ops; }
@@ -0,0 +1,74 @@
+#ifndef SESSION_SESSION_H
+#define SESSION_SESSION_H
+/*******************************************************************************
+ * @file session.h
+ * @brief Game hosted by the session server.
+ *
+ * Session plays by the same rules as the local game: users share one
+ * cursor, which wraps around the board, take turns in selecting free cells
+ * and the first one owning users amount + 1 cells in a row, column or
+ * diagonal wins. Game where every cell is taken ends with a draw, any user
+ * may quit it.
+ *
+ * Unlike the local game session keeps its whole state in struct Session,
+ * so whoever owns the struct may run any amount of sessions side by side
+ * without locking.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+#include "game/user_move.h"
+#include "input/input_common.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define SESSION_USERS_MAX 10
+#define SESSION_BOARD_MAX (SESSION_USERS_MAX + 1)
+
+enum SessionStates {
+  SESSION_STATE_PLAY,
+  SESSION_STATE_WIN,
+  SESSION_STATE_DRAW,
+  SESSION_STATE_QUIT,
+};
+
+struct Session {
+  enum SessionStates state;
+  size_t users_amount;
+  size_t board_size;
+  // Owner of every cell counted from 1, 0 for free cell.
+  uint8_t board[SESSION_BOARD_MAX][SESSION_BOARD_MAX];
+  struct UserMoveCoordinates cursor;
+  // Users are counted from 0, like in the local game.
+  game_user_id_t current_user;
+  // Valid for SESSION_STATE_WIN only.
+  game_user_id_t winner;
+  size_t valid_moves;
+};
+
+struct SessionOps {
+  // Starts new game, the first user is on turn. Returns EINVAL unless
+  //  there are at least two users and board is bigger than their amount.
+  int (*init)(struct Session *session, size_t users_amount,
+              size_t board_size);
+  // Applies user's events in order until user's turn ends, events after
+  //  valid select or quit are dropped. Every select and quit is written
+  //  into `moves`, which has room for `events_length` moves. Returns EPERM
+  //  if user is not on turn or game already ended.
+  int (*process_events)(struct Session *session, game_user_id_t user,
+                        const enum InputEvents *events, size_t events_length,
+                        struct UserMove *moves, size_t *moves_length);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct SessionOps *get_session_ops(void);
+
+#endif // SESSION_SESSION_H
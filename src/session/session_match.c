@@ -0,0 +1,328 @@
+/*******************************************************************************
+ * @file session_match.c
+ * @brief Matchmaking of players asking session server for a game.
+ *
+ * Matcher sleeps on eventfd, which every enqueue writes to after its push,
+ * so a push matcher missed while draining wakes it up once more. Players
+ * taken from bucket's ring wait in bucket's seats, which only matcher
+ * touches, until the group is complete.
+ *
+ ******************************************************************************/
+#define _GNU_SOURCE // eventfd
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+// App's internal libs
+#include "session/session.h"
+#include "session/session_match.h"
+#include "utils/ring_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+struct SessionMatchBucket {
+  struct Ring ring;
+  bool is_initialized;
+  struct SessionMatchTicket seats[SESSION_USERS_MAX];
+  size_t seats_length;
+};
+
+struct SessionMatch {
+  bool is_started;
+  pthread_t thread;
+  int wakeup_fd;
+  atomic_bool is_stopping;
+  atomic_size_t dropped;
+  session_match_callback_t callback;
+  // Owned by matcher's thread.
+  struct SessionMatchStats stats;
+  struct SessionMatchBucket buckets[SESSION_USERS_MAX + 1]
+                                   [SESSION_BOARD_MAX + 1];
+};
+
+struct SessionMatchPrivateOps {
+  void *(*run)(void *data);
+  void (*drain_bucket)(struct SessionMatchBucket *bucket, size_t users_amount,
+                       size_t board_size);
+  void (*seat_group)(struct SessionMatchGroup *group);
+  void (*drop_tickets)(const struct SessionMatchTicket *tickets,
+                       size_t tickets_length);
+  void (*release)(void);
+};
+
+static struct SessionMatch session_match;
+static struct RingUtilsOps *ring_utils_ops;
+static struct SessionMatchPrivateOps *session_match_priv_ops;
+struct SessionMatchPrivateOps *get_session_match_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int session_match_start(session_match_callback_t callback) {
+  struct SessionMatchBucket *bucket;
+  int err;
+
+  if (!callback) {
+    return EINVAL;
+  }
+
+  if (session_match.is_started) {
+    return EALREADY;
+  }
+
+  ring_utils_ops = get_ring_utils_ops();
+  session_match_priv_ops = get_session_match_priv_ops();
+
+  memset(&session_match, 0, sizeof(session_match));
+  session_match.callback = callback;
+  atomic_store(&session_match.is_stopping, false);
+  atomic_store(&session_match.dropped, 0);
+
+  session_match.wakeup_fd = eventfd(0, EFD_CLOEXEC);
+  if (session_match.wakeup_fd == -1) {
+    return errno;
+  }
+
+  for (size_t users = 2; users <= SESSION_USERS_MAX; users++) {
+    for (size_t board = users + 1; board <= SESSION_BOARD_MAX; board++) {
+      bucket = &session_match.buckets[users][board];
+      err = ring_utils_ops->init(&bucket->ring, SESSION_MATCH_QUEUE_LENGTH,
+                                 sizeof(struct SessionMatchTicket));
+      if (err) {
+        goto error;
+      }
+      bucket->is_initialized = true;
+    }
+  }
+
+  err = pthread_create(&session_match.thread, NULL,
+                       session_match_priv_ops->run, NULL);
+  if (err) {
+    goto error;
+  }
+
+  session_match.is_started = true;
+
+  return 0;
+
+error:
+  session_match_priv_ops->release();
+  return err;
+}
+
+static void session_match_stop(void) {
+  uint64_t wakeup = 1;
+
+  if (!session_match.is_started) {
+    return;
+  }
+
+  atomic_store(&session_match.is_stopping, true);
+  while (write(session_match.wakeup_fd, &wakeup, sizeof(wakeup)) == -1 &&
+         errno == EINTR)
+    ;
+  pthread_join(session_match.thread, NULL);
+
+  session_match_priv_ops->release();
+  session_match.is_started = false;
+}
+
+static int session_match_enqueue(const struct SessionMatchTicket *ticket,
+                                 size_t users_amount, size_t board_size) {
+  uint64_t wakeup = 1;
+  int err;
+
+  if (!ticket || users_amount < 2 || users_amount > SESSION_USERS_MAX ||
+      board_size <= users_amount || board_size > SESSION_BOARD_MAX) {
+    return EINVAL;
+  }
+
+  err = ring_utils_ops->push(
+      &session_match.buckets[users_amount][board_size].ring, ticket);
+  if (err) {
+    atomic_fetch_add_explicit(&session_match.dropped, 1,
+                              memory_order_relaxed);
+    return err;
+  }
+
+  // Counter can't overflow, matcher resets it by every read.
+  while (write(session_match.wakeup_fd, &wakeup, sizeof(wakeup)) == -1 &&
+         errno == EINTR)
+    ;
+
+  return 0;
+}
+
+static uint64_t session_match_get_timestamp(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+static void session_match_get_stats(struct SessionMatchStats *stats) {
+  if (!stats) {
+    return;
+  }
+
+  *stats = session_match.stats;
+  stats->dropped += atomic_load(&session_match.dropped);
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static void *session_match_run(void *data) {
+  uint64_t wakeup;
+  (void)data;
+
+  for (;;) {
+    if (read(session_match.wakeup_fd, &wakeup, sizeof(wakeup)) == -1 &&
+        errno != EINTR) {
+      break;
+    }
+
+    if (atomic_load(&session_match.is_stopping)) {
+      break;
+    }
+
+    for (size_t users = 2; users <= SESSION_USERS_MAX; users++) {
+      for (size_t board = users + 1; board <= SESSION_BOARD_MAX; board++) {
+        session_match_priv_ops->drain_bucket(
+            &session_match.buckets[users][board], users, board);
+      }
+    }
+  }
+
+  return NULL;
+}
+
+static void session_match_drain_bucket(struct SessionMatchBucket *bucket,
+                                       size_t users_amount,
+                                       size_t board_size) {
+  struct SessionMatchGroup group;
+
+  while (ring_utils_ops->pop(&bucket->ring,
+                             &bucket->seats[bucket->seats_length]) == 0) {
+    session_match.stats.queued++;
+
+    if (++bucket->seats_length < users_amount) {
+      continue;
+    }
+
+    group.users_amount = users_amount;
+    group.board_size = board_size;
+    memcpy(group.tickets, bucket->seats,
+           users_amount * sizeof(struct SessionMatchTicket));
+    bucket->seats_length = 0;
+
+    session_match_priv_ops->seat_group(&group);
+  }
+}
+
+static void session_match_seat_group(struct SessionMatchGroup *group) {
+  struct SessionMatchStats *stats = &session_match.stats;
+  uint64_t now = session_match_get_timestamp();
+  uint64_t wait_ns;
+  uint64_t wait_us;
+  size_t i;
+
+  if (session_match.callback(group)) {
+    session_match_priv_ops->drop_tickets(group->tickets, group->users_amount);
+    stats->dropped += group->users_amount;
+    return;
+  }
+
+  stats->sessions++;
+  stats->players += group->users_amount;
+
+  for (size_t seat = 0; seat < group->users_amount; seat++) {
+    wait_ns = now - group->tickets[seat].queued_ns;
+    stats->wait_ns_total += wait_ns;
+    if (wait_ns > stats->wait_ns_max) {
+      stats->wait_ns_max = wait_ns;
+    }
+
+    wait_us = wait_ns / 1000;
+    for (i = 0; wait_us && i < SESSION_MATCH_HISTOGRAM_LENGTH - 1; i++) {
+      wait_us >>= 1;
+    }
+    stats->wait_histogram[i]++;
+  }
+}
+
+static void
+session_match_drop_tickets(const struct SessionMatchTicket *tickets,
+                           size_t tickets_length) {
+  for (size_t i = 0; i < tickets_length; i++) {
+    close(tickets[i].fd);
+  }
+}
+
+// Players still waiting are disconnected, matcher is not running anymore.
+static void session_match_release(void) {
+  struct SessionMatchBucket *bucket;
+  struct SessionMatchTicket ticket;
+
+  for (size_t users = 2; users <= SESSION_USERS_MAX; users++) {
+    for (size_t board = users + 1; board <= SESSION_BOARD_MAX; board++) {
+      bucket = &session_match.buckets[users][board];
+      if (!bucket->is_initialized) {
+        continue;
+      }
+
+      session_match_priv_ops->drop_tickets(bucket->seats,
+                                           bucket->seats_length);
+      while (ring_utils_ops->pop(&bucket->ring, &ticket) == 0) {
+        session_match_priv_ops->drop_tickets(&ticket, 1);
+      }
+
+      ring_utils_ops->destroy(&bucket->ring);
+      bucket->is_initialized = false;
+      bucket->seats_length = 0;
+    }
+  }
+
+  close(session_match.wakeup_fd);
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct SessionMatchPrivateOps session_match_priv_ops_ = {
+    .run = session_match_run,
+    .drain_bucket = session_match_drain_bucket,
+    .seat_group = session_match_seat_group,
+    .drop_tickets = session_match_drop_tickets,
+    .release = session_match_release,
+};
+
+struct SessionMatchPrivateOps *get_session_match_priv_ops(void) {
+  return &session_match_priv_ops_;
+}
+
+static struct SessionMatchOps session_match_ops = {
+    .start = session_match_start,
+    .stop = session_match_stop,
+    .enqueue = session_match_enqueue,
+    .get_timestamp = session_match_get_timestamp,
+    .get_stats = session_match_get_stats,
+};
+
+struct SessionMatchOps *get_session_match_ops(void) {
+  return &session_match_ops;
+}
@@ -0,0 +1,87 @@
+#ifndef SESSION_SESSION_MATCH_H
+#define SESSION_SESSION_MATCH_H
+/*******************************************************************************
+ * @file session_match.h
+ * @brief Matchmaking of players asking session server for a game.
+ *
+ * Player is queued in the bucket of the game it asked for, every amount
+ * of users and board size has its own bucket. Matcher thread seats players
+ * of one bucket together in the order they came in, as soon as there are
+ * enough of them, and hands every such group to the callback, which
+ * hosts their session.
+ *
+ * Buckets are lock free rings, so reactors queueing players never wait for
+ * the matcher nor for each other unless they queue into the same bucket
+ * at the very same moment.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+#include "session/session.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+// Players one bucket holds, has to be power of two.
+#define SESSION_MATCH_QUEUE_LENGTH 1024
+#define SESSION_MATCH_HISTOGRAM_LENGTH 24
+
+struct SessionMatchTicket {
+  int fd;
+  // Protocol version player agreed to.
+  uint8_t version;
+  // CLOCK_MONOTONIC time player was queued in.
+  uint64_t queued_ns;
+};
+
+struct SessionMatchGroup {
+  size_t users_amount;
+  size_t board_size;
+  // Ticket of every seat, in order of seats.
+  struct SessionMatchTicket tickets[SESSION_USERS_MAX];
+};
+
+// Takes over group's connections, returns non zero if it can't.
+typedef int (*session_match_callback_t)(const struct SessionMatchGroup *group);
+
+struct SessionMatchStats {
+  // Players matcher took from buckets.
+  size_t queued;
+  // Players disconnected because their bucket was full or nobody could
+  //  host their session.
+  size_t dropped;
+  size_t sessions;
+  size_t players;
+  uint64_t wait_ns_total;
+  uint64_t wait_ns_max;
+  // I-th counts seated players who waited less than 2^i microseconds but
+  //  not less than (i-1)-th bound, the last one counts everybody else.
+  size_t wait_histogram[SESSION_MATCH_HISTOGRAM_LENGTH];
+};
+
+struct SessionMatchOps {
+  int (*start)(session_match_callback_t callback);
+  // Players still waiting are disconnected.
+  void (*stop)(void);
+  // May be called from any thread. Returns EINVAL if there is no such game
+  //  and ENOBUFS if its bucket is full, connection stays caller's then.
+  int (*enqueue)(const struct SessionMatchTicket *ticket,
+                 size_t users_amount, size_t board_size);
+  // CLOCK_MONOTONIC time tickets are stamped with.
+  uint64_t (*get_timestamp)(void);
+  // Stats are owned by matcher while it runs, so they are valid only once
+  //  it is stopped. They are kept until the next start.
+  void (*get_stats)(struct SessionMatchStats *stats);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct SessionMatchOps *get_session_match_ops(void);
+
+#endif // SESSION_SESSION_MATCH_H
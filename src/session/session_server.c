@@ -0,0 +1,1282 @@
+/*******************************************************************************
+ * @file session_server.c
+ * @brief Server hosting game sessions for remote clients.
+ *
+ * Reactor is a thread with its own epoll, listening socket and pool of
+ * connections. Listening sockets and pools are set up by start, so errors
+ * are reported to its caller, but pools are calloc'ed and their pages are
+ * first touched by reactor's thread, which places them close to reactor's
+ * CPU. Only stop flag and wakeup eventfd cross threads.
+ *
+ * Connection is served with a single read per readiness, like socket
+ * server's ones. Replies to a frame are built before the next frame is
+ * parsed and if client does not read them, connection stops being read
+ * until its output drains, so slow client costs only its own slot.
+ *
+ * Joining player leaves its reactor, which hands its socket to the matcher
+ * and frees its slot. Matcher pushes every group it seats into the handoff
+ * ring of the next reactor and wakes the reactor up, the reactor then opens
+ * the group's connections in its own pool. Player of a shared session who
+ * does not read replies to the others' moves is shut down instead of
+ * holding them all back, its reactor closes it once it notices.
+ *
+ ******************************************************************************/
+#define _GNU_SOURCE // accept4, CPU_SET, pthread_attr_setaffinity_np
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// App's internal libs
+#include "game/user_move.h"
+#include "input/input_common.h"
+#include "input/wire_protocol.h"
+#include "session/session.h"
+#include "session/session_match.h"
+#include "session/session_server.h"
+#include "utils/ring_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define SESSION_SERVER_EVENTS_MAX 256
+#define SESSION_SERVER_ACCEPTS_MAX 64
+#define SESSION_SERVER_INPUT_MAX (8 * INPUT_WIRE_FRAME_MAX)
+#define SESSION_SERVER_OUTPUT_MAX (32 * INPUT_WIRE_FRAME_MAX)
+// Every event of a frame is answered with at most move and result record,
+//  seven bytes together, so replies to a full frame and an ack fit into
+//  sixteen frames.
+#define SESSION_SERVER_REPLIES_MAX (16 * INPUT_WIRE_FRAME_MAX)
+// Groups matcher may hand to a reactor before it takes them, has to be
+//  power of two.
+#define SESSION_SERVER_HANDOFFS_MAX 256
+#define SESSION_SERVER_LISTEN_DATA UINT64_MAX
+#define SESSION_SERVER_WAKEUP_DATA (UINT64_MAX - 1)
+
+struct SessionConnection;
+
+struct SessionGame {
+  struct Session session;
+  // Players in order of their seats.
+  struct SessionConnection *players[SESSION_USERS_MAX];
+  size_t players_length;
+};
+
+struct SessionConnection {
+  bool is_open;
+  int fd;
+  // Version client agreed to, zero until its hello arrives.
+  uint8_t version;
+  // Output is full, connection waits for EPOLLOUT instead of EPOLLIN.
+  bool is_blocked;
+  // Connection is shut down and gets no more replies, it is closed once
+  //  reactor notices.
+  bool is_dropped;
+  // Join arrived, connection goes to matchmaking once its output drains.
+  bool is_joining;
+  uint32_t join_users;
+  uint32_t join_board;
+  uint32_t acks_pending;
+  // Shared session connection was seated in, NULL while it plays its own.
+  struct SessionGame *game;
+  size_t seat;
+  struct Session session;
+  uint8_t input[SESSION_SERVER_INPUT_MAX];
+  size_t input_length;
+  // Frame of replies being built.
+  uint8_t payload[INPUT_WIRE_PAYLOAD_MAX];
+  size_t payload_length;
+  uint8_t output[SESSION_SERVER_OUTPUT_MAX];
+  size_t output_length;
+};
+
+struct SessionReactor {
+  // Reactors are written by their own threads only, keep each on its own
+  //  cache lines.
+  _Alignas(64) pthread_t thread;
+  bool is_running;
+  int cpu;
+  int epoll_fd;
+  int listen_fd;
+  int wakeup_fd;
+  atomic_bool is_stopping;
+  // Listening socket is not watched while process is out of descriptors.
+  bool is_listen_paused;
+  struct SessionConnection *connections;
+  size_t *free_slots;
+  size_t free_length;
+  struct SessionGame *games;
+  size_t *free_games;
+  size_t free_games_length;
+  // Groups seated by matcher, reactor is their only consumer.
+  struct Ring handoffs;
+  struct SessionServerStats stats;
+};
+
+struct SessionServer {
+  bool is_started;
+  struct SessionServerConfig config;
+  uint16_t port;
+  size_t reactors_length;
+  // Reactor hosting the next group, written by matcher's thread only.
+  size_t next_reactor;
+  struct SessionReactor reactors[SESSION_SERVER_REACTORS_MAX];
+};
+
+struct SessionServerPrivateOps {
+  int (*get_cpus)(int *cpus, size_t *cpus_length);
+  int (*listen)(struct SessionServer *server, struct SessionReactor *reactor);
+  int (*prepare_reactor)(struct SessionServer *server,
+                         struct SessionReactor *reactor);
+  void (*release_reactor)(struct SessionReactor *reactor);
+  void (*stop_reactors)(struct SessionServer *server);
+  void *(*run_reactor)(void *reactor);
+  void (*accept_connections)(struct SessionReactor *reactor);
+  struct SessionConnection *(*open_connection)(struct SessionReactor *reactor,
+                                               int fd);
+  void (*close_connection)(struct SessionReactor *reactor,
+                           struct SessionConnection *connection);
+  void (*release_slot)(struct SessionReactor *reactor,
+                       struct SessionConnection *connection);
+  void (*drop_connection)(struct SessionConnection *connection);
+  int (*host_group)(const struct SessionMatchGroup *group);
+  void (*take_handoffs)(struct SessionReactor *reactor);
+  void (*seat_group)(struct SessionReactor *reactor,
+                     const struct SessionMatchGroup *group);
+  int (*join)(struct SessionReactor *reactor,
+              struct SessionConnection *connection);
+  void (*leave_game)(struct SessionReactor *reactor,
+                     struct SessionConnection *connection);
+  void (*reserve_players)(struct SessionReactor *reactor,
+                          struct SessionGame *game,
+                          struct SessionConnection *skipped);
+  void (*flush_players)(struct SessionReactor *reactor,
+                        struct SessionGame *game,
+                        struct SessionConnection *skipped);
+  void (*set_blocked)(struct SessionReactor *reactor,
+                      struct SessionConnection *connection, bool is_blocked);
+  int (*serve_connection)(struct SessionReactor *reactor,
+                          struct SessionConnection *connection,
+                          uint32_t events);
+  int (*process_input)(struct SessionReactor *reactor,
+                       struct SessionConnection *connection);
+  int (*process_frame)(struct SessionReactor *reactor,
+                       struct SessionConnection *connection,
+                       struct InputWireFrame *frame);
+  void (*reply_move)(struct SessionConnection *connection,
+                     const struct UserMove *move);
+  void (*reply_result)(struct SessionConnection *connection,
+                       struct Session *session);
+  void (*finish_payload)(struct SessionConnection *connection);
+  int (*flush)(struct SessionConnection *connection);
+};
+
+static struct SessionServer session_server;
+static struct SessionOps *session_ops;
+static struct SessionMatchOps *session_match_ops;
+static struct RingUtilsOps *ring_utils_ops;
+static struct InputWireOps *input_wire_ops;
+static struct SessionServerPrivateOps *session_server_priv_ops;
+struct SessionServerPrivateOps *get_session_server_priv_ops(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int session_server_start(const struct SessionServerConfig *config) {
+  struct SessionServer *server = &session_server;
+  int cpus[SESSION_SERVER_REACTORS_MAX];
+  struct SessionReactor *reactor;
+  size_t cpus_length;
+  pthread_attr_t attr;
+  cpu_set_t cpu_set;
+  int err;
+
+  if (!config || config->users_amount < 2 ||
+      config->users_amount > SESSION_USERS_MAX ||
+      config->reactors > SESSION_SERVER_REACTORS_MAX) {
+    return EINVAL;
+  }
+
+  if (server->is_started) {
+    return EALREADY;
+  }
+
+  session_ops = get_session_ops();
+  session_match_ops = get_session_match_ops();
+  ring_utils_ops = get_ring_utils_ops();
+  input_wire_ops = get_input_wire_ops();
+  session_server_priv_ops = get_session_server_priv_ops();
+
+  err = session_server_priv_ops->get_cpus(cpus, &cpus_length);
+  if (err) {
+    return err;
+  }
+
+  memset(server, 0, sizeof(*server));
+  server->config = *config;
+  if (server->config.connections_max == 0) {
+    server->config.connections_max = SESSION_SERVER_CONNECTIONS_DEFAULT;
+  }
+  server->port = config->port;
+  server->reactors_length = config->reactors ? config->reactors : cpus_length;
+
+  // Failed start releases every reactor, even ones it did not get to.
+  for (size_t i = 0; i < server->reactors_length; i++) {
+    reactor = &server->reactors[i];
+    reactor->epoll_fd = -1;
+    reactor->listen_fd = -1;
+    reactor->wakeup_fd = -1;
+  }
+
+  for (size_t i = 0; i < server->reactors_length; i++) {
+    reactor = &server->reactors[i];
+    // More reactors than CPUs share them round robin.
+    reactor->cpu = cpus[i % cpus_length];
+
+    err = session_server_priv_ops->prepare_reactor(server, reactor);
+    if (err) {
+      goto error;
+    }
+  }
+
+  // Matcher hands groups to reactors' rings, which are ready by now.
+  err = session_match_ops->start(session_server_priv_ops->host_group);
+  if (err) {
+    goto error;
+  }
+
+  for (size_t i = 0; i < server->reactors_length; i++) {
+    reactor = &server->reactors[i];
+
+    CPU_ZERO(&cpu_set);
+    CPU_SET(reactor->cpu, &cpu_set);
+
+    err = pthread_attr_init(&attr);
+    if (err) {
+      goto error;
+    }
+
+    err = pthread_attr_setaffinity_np(&attr, sizeof(cpu_set), &cpu_set);
+    if (!err) {
+      err = pthread_create(&reactor->thread, &attr,
+                           session_server_priv_ops->run_reactor, reactor);
+    }
+    pthread_attr_destroy(&attr);
+    if (err) {
+      goto error;
+    }
+
+    reactor->is_running = true;
+  }
+
+  server->is_started = true;
+
+  return 0;
+
+error:
+  session_server_priv_ops->stop_reactors(server);
+  return err;
+}
+
+static void session_server_stop(void) {
+  if (!session_server.is_started) {
+    return;
+  }
+
+  session_server_priv_ops->stop_reactors(&session_server);
+  session_server.is_started = false;
+}
+
+static uint16_t session_server_get_port(void) { return session_server.port; }
+
+static size_t session_server_get_reactors(void) {
+  return session_server.reactors_length;
+}
+
+static void session_server_get_stats(struct SessionServerStats *stats) {
+  struct SessionServerStats *reactor_stats;
+
+  if (!stats) {
+    return;
+  }
+
+  memset(stats, 0, sizeof(*stats));
+
+  for (size_t i = 0; i < session_server.reactors_length; i++) {
+    reactor_stats = &session_server.reactors[i].stats;
+    stats->accepted += reactor_stats->accepted;
+    stats->rejected += reactor_stats->rejected;
+    stats->frames += reactor_stats->frames;
+    stats->moves += reactor_stats->moves;
+    stats->off_turn_moves += reactor_stats->off_turn_moves;
+    stats->games += reactor_stats->games;
+    stats->protocol_errors += reactor_stats->protocol_errors;
+    stats->joins += reactor_stats->joins;
+    stats->seated += reactor_stats->seated;
+    stats->overruns += reactor_stats->overruns;
+  }
+}
+
+static void session_server_get_reactor_stats(size_t reactor,
+                                             struct SessionServerStats *stats) {
+  if (!stats) {
+    return;
+  }
+
+  if (reactor >= session_server.reactors_length) {
+    memset(stats, 0, sizeof(*stats));
+    return;
+  }
+
+  *stats = session_server.reactors[reactor].stats;
+}
+
+static void session_server_get_match_stats(struct SessionMatchStats *stats) {
+  session_match_ops = get_session_match_ops();
+  session_match_ops->get_stats(stats);
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int session_server_get_cpus(int *cpus, size_t *cpus_length) {
+  cpu_set_t cpu_set;
+
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == -1) {
+    return errno;
+  }
+
+  *cpus_length = 0;
+  for (int cpu = 0; cpu < CPU_SETSIZE &&
+                    *cpus_length < SESSION_SERVER_REACTORS_MAX;
+       cpu++) {
+    if (CPU_ISSET(cpu, &cpu_set)) {
+      cpus[(*cpus_length)++] = cpu;
+    }
+  }
+
+  return *cpus_length ? 0 : ENODEV;
+}
+
+static int session_server_listen(struct SessionServer *server,
+                                 struct SessionReactor *reactor) {
+  struct sockaddr_in address = {
+      .sin_family = AF_INET,
+      .sin_port = htons(server->port),
+      .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+  };
+  socklen_t address_length = sizeof(address);
+  int reuse = 1;
+  int fd;
+  int err;
+
+  if (server->config.host &&
+      inet_pton(AF_INET, server->config.host, &address.sin_addr) != 1) {
+    return EINVAL;
+  }
+
+  fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    return errno;
+  }
+
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  // Every reactor binds the same port, kernel balances connections.
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) == -1 ||
+      bind(fd, (struct sockaddr *)&address, sizeof(address)) == -1 ||
+      listen(fd, SOMAXCONN) == -1) {
+    goto error;
+  }
+
+  // The first reactor resolves port 0, the others bind the same one.
+  if (server->port == 0) {
+    if (getsockname(fd, (struct sockaddr *)&address, &address_length) ==
+        -1) {
+      goto error;
+    }
+    server->port = ntohs(address.sin_port);
+  }
+
+  reactor->listen_fd = fd;
+
+  return 0;
+
+error:
+  err = errno;
+  close(fd);
+  return err;
+}
+
+static int session_server_prepare_reactor(struct SessionServer *server,
+                                          struct SessionReactor *reactor) {
+  size_t connections_max = server->config.connections_max;
+  struct epoll_event event = {.events = EPOLLIN};
+  int err;
+
+  atomic_store(&reactor->is_stopping, false);
+
+  reactor->connections =
+      calloc(connections_max, sizeof(struct SessionConnection));
+  reactor->free_slots = malloc(connections_max * sizeof(size_t));
+  if (!reactor->connections || !reactor->free_slots) {
+    return ENOMEM;
+  }
+
+  // Slots are handed out from the pool's start, so connections of lightly
+  //  loaded reactor stay on few pages.
+  for (size_t i = 0; i < connections_max; i++) {
+    reactor->free_slots[i] = connections_max - 1 - i;
+  }
+  reactor->free_length = connections_max;
+
+  // Every shared session has at least two players, so pool never runs out
+  //  of games before it runs out of slots.
+  reactor->games = calloc(connections_max / 2 + 1, sizeof(struct SessionGame));
+  reactor->free_games = malloc((connections_max / 2 + 1) * sizeof(size_t));
+  if (!reactor->games || !reactor->free_games) {
+    return ENOMEM;
+  }
+
+  for (size_t i = 0; i <= connections_max / 2; i++) {
+    reactor->free_games[i] = connections_max / 2 - i;
+  }
+  reactor->free_games_length = connections_max / 2 + 1;
+
+  err = ring_utils_ops->init(&reactor->handoffs, SESSION_SERVER_HANDOFFS_MAX,
+                             sizeof(struct SessionMatchGroup));
+  if (err) {
+    return err;
+  }
+
+  reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (reactor->epoll_fd == -1) {
+    return errno;
+  }
+
+  reactor->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (reactor->wakeup_fd == -1) {
+    return errno;
+  }
+
+  err = session_server_priv_ops->listen(server, reactor);
+  if (err) {
+    return err;
+  }
+
+  event.data.u64 = SESSION_SERVER_WAKEUP_DATA;
+  if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor->wakeup_fd,
+                &event) == -1) {
+    return errno;
+  }
+
+  event.data.u64 = SESSION_SERVER_LISTEN_DATA;
+  if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor->listen_fd,
+                &event) == -1) {
+    return errno;
+  }
+
+  return 0;
+}
+
+// Groups matcher handed to reactor too late are disconnected, matcher is
+//  not running anymore.
+static void session_server_release_reactor(struct SessionReactor *reactor) {
+  int *fds[] = {&reactor->listen_fd, &reactor->wakeup_fd, &reactor->epoll_fd};
+  struct SessionMatchGroup group;
+
+  if (reactor->handoffs.items) {
+    while (ring_utils_ops->pop(&reactor->handoffs, &group) == 0) {
+      for (size_t i = 0; i < group.users_amount; i++) {
+        close(group.tickets[i].fd);
+      }
+    }
+    ring_utils_ops->destroy(&reactor->handoffs);
+  }
+
+  for (size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); i++) {
+    if (*fds[i] != -1) {
+      close(*fds[i]);
+      *fds[i] = -1;
+    }
+  }
+
+  free(reactor->connections);
+  free(reactor->free_slots);
+  free(reactor->games);
+  free(reactor->free_games);
+  reactor->connections = NULL;
+  reactor->free_slots = NULL;
+  reactor->games = NULL;
+  reactor->free_games = NULL;
+}
+
+static void session_server_stop_reactors(struct SessionServer *server) {
+  struct SessionReactor *reactor;
+  uint64_t wakeup = 1;
+
+  for (size_t i = 0; i < server->reactors_length; i++) {
+    reactor = &server->reactors[i];
+    if (reactor->is_running) {
+      atomic_store(&reactor->is_stopping, true);
+      // Counter can't overflow with a single write per reactor.
+      if (write(reactor->wakeup_fd, &wakeup, sizeof(wakeup)) == -1) {
+        continue;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < server->reactors_length; i++) {
+    reactor = &server->reactors[i];
+    if (reactor->is_running) {
+      pthread_join(reactor->thread, NULL);
+      reactor->is_running = false;
+    }
+  }
+
+  // Matcher may hand groups over until it stops, rings go last.
+  session_match_ops->stop();
+
+  for (size_t i = 0; i < server->reactors_length; i++) {
+    session_server_priv_ops->release_reactor(&server->reactors[i]);
+  }
+}
+
+static void *session_server_run_reactor(void *data) {
+  struct epoll_event events[SESSION_SERVER_EVENTS_MAX];
+  struct SessionReactor *reactor = data;
+  struct SessionConnection *connection;
+  uint64_t wakeup;
+  int events_length;
+
+  while (!atomic_load_explicit(&reactor->is_stopping,
+                               memory_order_relaxed)) {
+    events_length = epoll_wait(reactor->epoll_fd, events,
+                               SESSION_SERVER_EVENTS_MAX, -1);
+    if (events_length == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    for (int i = 0; i < events_length; i++) {
+      if (events[i].data.u64 == SESSION_SERVER_LISTEN_DATA) {
+        session_server_priv_ops->accept_connections(reactor);
+      } else if (events[i].data.u64 == SESSION_SERVER_WAKEUP_DATA) {
+        // Counter is reset before the ring is drained, so group pushed
+        //  meanwhile wakes reactor up again.
+        if (read(reactor->wakeup_fd, &wakeup, sizeof(wakeup)) == -1 &&
+            errno != EAGAIN) {
+          continue;
+        }
+        session_server_priv_ops->take_handoffs(reactor);
+      } else {
+        connection = &reactor->connections[events[i].data.u64];
+        // Closed by event earlier in the batch.
+        if (!connection->is_open) {
+          continue;
+        }
+
+        if (session_server_priv_ops->serve_connection(reactor, connection,
+                                                      events[i].events)) {
+          session_server_priv_ops->close_connection(reactor, connection);
+        }
+      }
+    }
+  }
+
+  for (size_t i = 0; i < session_server.config.connections_max; i++) {
+    if (reactor->connections[i].is_open) {
+      session_server_priv_ops->close_connection(reactor,
+                                                &reactor->connections[i]);
+    }
+  }
+
+  return NULL;
+}
+
+static void session_server_accept_connections(struct SessionReactor *reactor) {
+  int fd;
+
+  // Burst is limited, so flood of connections can't starve moves.
+  for (size_t i = 0; i < SESSION_SERVER_ACCEPTS_MAX; i++) {
+    fd = accept4(reactor->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd == -1) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+
+      // Listening socket would be reported ready again and again, it is
+      //  watched again once a connection closes.
+      if (errno == EMFILE || errno == ENFILE) {
+        epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, reactor->listen_fd, NULL);
+        reactor->is_listen_paused = true;
+      }
+      return;
+    }
+
+    if (reactor->free_length == 0) {
+      reactor->stats.rejected++;
+      close(fd);
+      continue;
+    }
+
+    if (session_server_priv_ops->open_connection(reactor, fd)) {
+      reactor->stats.accepted++;
+    }
+  }
+}
+
+// Returns NULL if connection was rejected.
+static struct SessionConnection *
+session_server_open_connection(struct SessionReactor *reactor, int fd) {
+  struct epoll_event event = {.events = EPOLLIN};
+  struct SessionConnection *connection;
+  size_t users_amount = session_server.config.users_amount;
+  size_t slot;
+  int no_delay = 1;
+
+  slot = reactor->free_slots[reactor->free_length - 1];
+  connection = &reactor->connections[slot];
+
+  // Replies are small and client waits for them, don't let Nagle hold
+  //  them back.
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+  event.data.u64 = slot;
+  if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+    reactor->stats.rejected++;
+    close(fd);
+    return NULL;
+  }
+
+  connection->is_open = true;
+  connection->fd = fd;
+  connection->version = 0;
+  connection->is_blocked = false;
+  connection->is_dropped = false;
+  connection->is_joining = false;
+  connection->acks_pending = 0;
+  connection->game = NULL;
+  connection->input_length = 0;
+  connection->payload_length = 0;
+  connection->output_length = 0;
+  session_ops->init(&connection->session, users_amount, users_amount + 1);
+
+  reactor->free_length--;
+
+  return connection;
+}
+
+static void
+session_server_close_connection(struct SessionReactor *reactor,
+                                struct SessionConnection *connection) {
+  if (connection->game) {
+    session_server_priv_ops->leave_game(reactor, connection);
+  }
+
+  close(connection->fd);
+  session_server_priv_ops->release_slot(reactor, connection);
+}
+
+// Frees connection's slot, its socket is closed or owned by somebody else.
+static void session_server_release_slot(struct SessionReactor *reactor,
+                                        struct SessionConnection *connection) {
+  struct epoll_event event = {.events = EPOLLIN,
+                              .data.u64 = SESSION_SERVER_LISTEN_DATA};
+
+  connection->is_open = false;
+  reactor->free_slots[reactor->free_length++] =
+      connection - reactor->connections;
+
+  if (reactor->is_listen_paused &&
+      epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor->listen_fd,
+                &event) == 0) {
+    reactor->is_listen_paused = false;
+  }
+}
+
+// Shut down socket is reported ready, reactor closes connection then.
+static void
+session_server_drop_connection(struct SessionConnection *connection) {
+  if (connection->is_dropped) {
+    return;
+  }
+
+  shutdown(connection->fd, SHUT_RDWR);
+  connection->is_dropped = true;
+}
+
+// Runs on matcher's thread.
+static int session_server_host_group(const struct SessionMatchGroup *group) {
+  struct SessionServer *server = &session_server;
+  struct SessionReactor *reactor;
+  uint64_t wakeup = 1;
+
+  // Groups go round robin, reactors host about the same amount of them.
+  for (size_t i = 0; i < server->reactors_length; i++) {
+    reactor =
+        &server->reactors[server->next_reactor++ % server->reactors_length];
+    if (ring_utils_ops->push(&reactor->handoffs, group)) {
+      continue;
+    }
+
+    // Counter can't overflow, reactor resets it by every read.
+    while (write(reactor->wakeup_fd, &wakeup, sizeof(wakeup)) == -1 &&
+           errno == EINTR)
+      ;
+    return 0;
+  }
+
+  return ENOBUFS;
+}
+
+static void session_server_take_handoffs(struct SessionReactor *reactor) {
+  struct SessionMatchGroup group;
+
+  while (ring_utils_ops->pop(&reactor->handoffs, &group) == 0) {
+    session_server_priv_ops->seat_group(reactor, &group);
+  }
+}
+
+static void
+session_server_seat_group(struct SessionReactor *reactor,
+                          const struct SessionMatchGroup *group) {
+  const struct SessionMatchTicket *ticket;
+  struct SessionConnection *connection;
+  struct SessionGame *game;
+
+  if (reactor->free_length < group->users_amount) {
+    for (size_t i = 0; i < group->users_amount; i++) {
+      close(group->tickets[i].fd);
+    }
+    reactor->stats.rejected += group->users_amount;
+    return;
+  }
+
+  game = &reactor->games[reactor->free_games[--reactor->free_games_length]];
+  game->players_length = 0;
+  session_ops->init(&game->session, group->users_amount, group->board_size);
+
+  for (size_t seat = 0; seat < group->users_amount; seat++) {
+    ticket = &group->tickets[seat];
+    connection = session_server_priv_ops->open_connection(reactor, ticket->fd);
+    if (!connection) {
+      continue;
+    }
+
+    // Hello was exchanged by reactor player joined on.
+    connection->version = ticket->version;
+    connection->game = game;
+    connection->seat = seat;
+    game->players[game->players_length++] = connection;
+
+    input_wire_ops->compose_start(connection->payload,
+                                  &connection->payload_length, seat + 1,
+                                  group->users_amount, group->board_size);
+  }
+
+  // Session can't be played without all of its seats.
+  if (game->players_length < group->users_amount) {
+    for (size_t i = 0; i < game->players_length; i++) {
+      game->players[i]->game = NULL;
+      session_server_priv_ops->close_connection(reactor, game->players[i]);
+    }
+    reactor->free_games[reactor->free_games_length++] =
+        game - reactor->games;
+    return;
+  }
+
+  reactor->stats.seated += group->users_amount;
+  session_server_priv_ops->flush_players(reactor, game, NULL);
+}
+
+// Hands connection over to matcher, returns non zero if it has to be
+//  closed instead.
+static int session_server_join(struct SessionReactor *reactor,
+                               struct SessionConnection *connection) {
+  struct SessionMatchTicket ticket = {
+      .fd = connection->fd,
+      .version = connection->version,
+      .queued_ns = session_match_ops->get_timestamp(),
+  };
+  int err;
+
+  // Reactor seating the player adds it to its own epoll.
+  if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL) ==
+      -1) {
+    return errno;
+  }
+
+  err = session_match_ops->enqueue(&ticket, connection->join_users,
+                                   connection->join_board);
+  if (err) {
+    return err;
+  }
+
+  reactor->stats.joins++;
+  session_server_priv_ops->release_slot(reactor, connection);
+
+  return 0;
+}
+
+// Game ends with no winner, the other players are back on their own.
+static void session_server_leave_game(struct SessionReactor *reactor,
+                                      struct SessionConnection *connection) {
+  struct SessionGame *game = connection->game;
+  struct SessionConnection *player;
+
+  session_server_priv_ops->reserve_players(reactor, game, connection);
+
+  for (size_t i = 0; i < game->players_length; i++) {
+    player = game->players[i];
+    player->game = NULL;
+    if (player != connection && !player->is_dropped) {
+      session_server_priv_ops->reply_result(player, &game->session);
+    }
+  }
+
+  session_server_priv_ops->flush_players(reactor, game, connection);
+
+  reactor->free_games[reactor->free_games_length++] = game - reactor->games;
+}
+
+// Makes room for replies to a frame in output of every player but skipped,
+//  player whose output stays full is dropped.
+static void session_server_reserve_players(struct SessionReactor *reactor,
+                                           struct SessionGame *game,
+                                           struct SessionConnection *skipped) {
+  struct SessionConnection *player;
+  int err;
+
+  for (size_t i = 0; i < game->players_length; i++) {
+    player = game->players[i];
+    if (player == skipped || player->is_dropped ||
+        sizeof(player->output) - player->output_length >=
+            SESSION_SERVER_REPLIES_MAX) {
+      continue;
+    }
+
+    err = session_server_priv_ops->flush(player);
+    if (err == EAGAIN && sizeof(player->output) - player->output_length >=
+                             SESSION_SERVER_REPLIES_MAX) {
+      session_server_priv_ops->set_blocked(reactor, player, true);
+    } else if (err) {
+      reactor->stats.overruns += err == EAGAIN;
+      session_server_priv_ops->drop_connection(player);
+    }
+  }
+}
+
+static void session_server_flush_players(struct SessionReactor *reactor,
+                                         struct SessionGame *game,
+                                         struct SessionConnection *skipped) {
+  struct SessionConnection *player;
+  int err;
+
+  for (size_t i = 0; i < game->players_length; i++) {
+    player = game->players[i];
+    if (player == skipped || player->is_dropped) {
+      continue;
+    }
+
+    err = session_server_priv_ops->flush(player);
+    if (err == EAGAIN) {
+      session_server_priv_ops->set_blocked(reactor, player, true);
+    } else if (err) {
+      session_server_priv_ops->drop_connection(player);
+    }
+  }
+}
+
+static void session_server_set_blocked(struct SessionReactor *reactor,
+                                       struct SessionConnection *connection,
+                                       bool is_blocked) {
+  struct epoll_event event = {
+      .events = is_blocked ? EPOLLOUT : EPOLLIN,
+      .data.u64 = connection - reactor->connections,
+  };
+
+  if (connection->is_blocked == is_blocked) {
+    return;
+  }
+
+  // Failure leaves connection as it was, which still makes progress.
+  if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_MOD, connection->fd, &event) ==
+      0) {
+    connection->is_blocked = is_blocked;
+  }
+}
+
+// Returns non zero if connection has to be closed.
+static int session_server_serve_connection(struct SessionReactor *reactor,
+                                           struct SessionConnection *connection,
+                                           uint32_t events) {
+  ssize_t bytes_read;
+  int err;
+
+  if (connection->is_dropped) {
+    return ECONNRESET;
+  }
+
+  if (connection->is_blocked) {
+    err = session_server_priv_ops->flush(connection);
+    if (err == EAGAIN) {
+      return 0;
+    }
+    if (err) {
+      return err;
+    }
+
+    session_server_priv_ops->set_blocked(reactor, connection, false);
+
+    // Frames left in input while output was full.
+    return session_server_priv_ops->process_input(reactor, connection);
+  }
+
+  if (!(events & (EPOLLIN | EPOLLERR | EPOLLHUP))) {
+    return 0;
+  }
+
+  bytes_read =
+      read(connection->fd, connection->input + connection->input_length,
+           sizeof(connection->input) - connection->input_length);
+  if (bytes_read == -1) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      return 0;
+    }
+    return errno;
+  }
+
+  if (bytes_read == 0) {
+    return ECONNRESET;
+  }
+
+  connection->input_length += bytes_read;
+
+  return session_server_priv_ops->process_input(reactor, connection);
+}
+
+static int session_server_process_input(struct SessionReactor *reactor,
+                                        struct SessionConnection *connection) {
+  struct InputWireFrame frame;
+  size_t offset = 0;
+  int err;
+
+  if (connection->version == 0) {
+    if (connection->input_length < INPUT_WIRE_HELLO_LENGTH) {
+      return 0;
+    }
+
+    if (connection->input[0] != INPUT_WIRE_MAGIC ||
+        connection->input[1] == 0) {
+      reactor->stats.protocol_errors++;
+      return EPROTO;
+    }
+
+    connection->version = connection->input[1] < INPUT_WIRE_VERSION
+                              ? connection->input[1]
+                              : INPUT_WIRE_VERSION;
+    connection->output[connection->output_length++] = INPUT_WIRE_MAGIC;
+    connection->output[connection->output_length++] = connection->version;
+    offset = INPUT_WIRE_HELLO_LENGTH;
+  }
+
+  for (;;) {
+    // Replies to the next frame may not fit, what's built so far goes out
+    //  first.
+    if (sizeof(connection->output) - connection->output_length <
+        SESSION_SERVER_REPLIES_MAX) {
+      err = session_server_priv_ops->flush(connection);
+      if (err) {
+        break;
+      }
+    }
+
+    if (connection->game) {
+      session_server_priv_ops->reserve_players(reactor, connection->game,
+                                               connection);
+    }
+
+    // Player waits for its seat before it sends anything else.
+    if (connection->is_joining) {
+      err = connection->input_length > offset ? EPROTO : 0;
+      if (err) {
+        reactor->stats.protocol_errors++;
+        return err;
+      }
+      break;
+    }
+
+    err = input_wire_ops->parse_frame(connection->input + offset,
+                                      connection->input_length - offset,
+                                      &frame);
+    if (err == EAGAIN) {
+      err = 0;
+      break;
+    }
+    if (!err) {
+      err = session_server_priv_ops->process_frame(reactor, connection,
+                                                   &frame);
+    }
+    if (err) {
+      reactor->stats.protocol_errors++;
+      return EPROTO;
+    }
+
+    offset += frame.frame_length;
+  }
+
+  memmove(connection->input, connection->input + offset,
+          connection->input_length - offset);
+  connection->input_length -= offset;
+
+  if (!err) {
+    err = session_server_priv_ops->flush(connection);
+  }
+
+  if (connection->game) {
+    session_server_priv_ops->flush_players(reactor, connection->game,
+                                           connection);
+  }
+
+  if (err == EAGAIN) {
+    session_server_priv_ops->set_blocked(reactor, connection, true);
+    return 0;
+  }
+
+  if (!err && connection->is_joining) {
+    return session_server_priv_ops->join(reactor, connection);
+  }
+
+  return err;
+}
+
+static int session_server_process_frame(struct SessionReactor *reactor,
+                                        struct SessionConnection *connection,
+                                        struct InputWireFrame *frame) {
+  struct UserMove moves[INPUT_WIRE_EVENTS_MAX];
+  struct SessionGame *game = connection->game;
+  struct Session *session = game ? &game->session : &connection->session;
+  // Replies go to every player of shared session.
+  struct SessionConnection **players = game ? game->players : &connection;
+  size_t players_length = game ? game->players_length : 1;
+  struct InputWireRecord record;
+  size_t moves_length;
+  int err;
+
+  reactor->stats.frames++;
+
+  while ((err = input_wire_ops->parse_record(frame, &record)) == 0) {
+    // Nothing may follow join.
+    if (connection->is_joining) {
+      return EPROTO;
+    }
+
+    if (record.kind == INPUT_WIRE_GAME && record.game == INPUT_WIRE_GAME_JOIN) {
+      if (game || record.users < 2 || record.users > SESSION_USERS_MAX ||
+          record.board_size <= record.users ||
+          record.board_size > SESSION_BOARD_MAX) {
+        return EPROTO;
+      }
+
+      connection->is_joining = true;
+      connection->join_users = record.users;
+      connection->join_board = record.board_size;
+      continue;
+    }
+
+    // Otherwise clients only ever send moves, for users of their session
+    //  or for their own seat of shared one.
+    if (record.kind != INPUT_WIRE_EVENTS ||
+        (game ? record.user != connection->seat + 1
+              : record.user > session->users_amount)) {
+      return EPROTO;
+    }
+
+    connection->acks_pending++;
+    reactor->stats.moves++;
+
+    err = session_ops->process_events(session, record.user - 1,
+                                      record.events, record.events_length,
+                                      moves, &moves_length);
+    if (err) {
+      reactor->stats.off_turn_moves++;
+      continue;
+    }
+
+    for (size_t i = 0; i < moves_length; i++) {
+      for (size_t j = 0; j < players_length; j++) {
+        if (!players[j]->is_dropped) {
+          session_server_priv_ops->reply_move(players[j], &moves[i]);
+        }
+      }
+    }
+
+    if (session->state != SESSION_STATE_PLAY) {
+      for (size_t j = 0; j < players_length; j++) {
+        if (!players[j]->is_dropped) {
+          session_server_priv_ops->reply_result(players[j], session);
+        }
+      }
+      session_ops->init(session, session->users_amount, session->board_size);
+      reactor->stats.games++;
+    }
+  }
+
+  return err == ENOENT ? 0 : err;
+}
+
+static void session_server_reply_move(struct SessionConnection *connection,
+                                      const struct UserMove *move) {
+  uint32_t user = move->user_id + 1;
+
+  if (input_wire_ops->compose_move(
+          connection->payload, &connection->payload_length, user, move->type,
+          move->coordinates.x, move->coordinates.y) == ENOBUFS) {
+    session_server_priv_ops->finish_payload(connection);
+    input_wire_ops->compose_move(connection->payload,
+                                 &connection->payload_length, user,
+                                 move->type, move->coordinates.x,
+                                 move->coordinates.y);
+  }
+}
+
+static void session_server_reply_result(struct SessionConnection *connection,
+                                        struct Session *session) {
+  uint32_t winner =
+      session->state == SESSION_STATE_WIN ? session->winner + 1 : 0;
+
+  if (input_wire_ops->compose_result(connection->payload,
+                                     &connection->payload_length, winner,
+                                     session->valid_moves) == ENOBUFS) {
+    session_server_priv_ops->finish_payload(connection);
+    input_wire_ops->compose_result(connection->payload,
+                                   &connection->payload_length, winner,
+                                   session->valid_moves);
+  }
+}
+
+static void
+session_server_finish_payload(struct SessionConnection *connection) {
+  // Room is guaranteed by SESSION_SERVER_REPLIES_MAX.
+  if (connection->payload_length == 0 ||
+      sizeof(connection->output) - connection->output_length <
+          INPUT_WIRE_FRAME_MAX) {
+    return;
+  }
+
+  connection->output_length += input_wire_ops->compose_frame(
+      connection->payload, connection->payload_length,
+      connection->output + connection->output_length);
+  connection->payload_length = 0;
+}
+
+// Returns EAGAIN if socket can't take whole output now.
+static int session_server_flush(struct SessionConnection *connection) {
+  size_t written = 0;
+  ssize_t bytes_written;
+  int err = 0;
+
+  if (connection->acks_pending > 0) {
+    if (input_wire_ops->compose_ack(connection->payload,
+                                    &connection->payload_length,
+                                    connection->acks_pending) == ENOBUFS) {
+      session_server_priv_ops->finish_payload(connection);
+      input_wire_ops->compose_ack(connection->payload,
+                                  &connection->payload_length,
+                                  connection->acks_pending);
+    }
+    connection->acks_pending = 0;
+  }
+
+  session_server_priv_ops->finish_payload(connection);
+
+  while (written < connection->output_length) {
+    bytes_written = send(connection->fd, connection->output + written,
+                         connection->output_length - written, MSG_NOSIGNAL);
+    if (bytes_written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      err = errno == EWOULDBLOCK ? EAGAIN : errno;
+      break;
+    }
+
+    written += bytes_written;
+  }
+
+  memmove(connection->output, connection->output + written,
+          connection->output_length - written);
+  connection->output_length -= written;
+
+  return err;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct SessionServerPrivateOps session_server_priv_ops_ = {
+    .get_cpus = session_server_get_cpus,
+    .listen = session_server_listen,
+    .prepare_reactor = session_server_prepare_reactor,
+    .release_reactor = session_server_release_reactor,
+    .stop_reactors = session_server_stop_reactors,
+    .run_reactor = session_server_run_reactor,
+    .accept_connections = session_server_accept_connections,
+    .open_connection = session_server_open_connection,
+    .close_connection = session_server_close_connection,
+    .release_slot = session_server_release_slot,
+    .drop_connection = session_server_drop_connection,
+    .host_group = session_server_host_group,
+    .take_handoffs = session_server_take_handoffs,
+    .seat_group = session_server_seat_group,
+    .join = session_server_join,
+    .leave_game = session_server_leave_game,
+    .reserve_players = session_server_reserve_players,
+    .flush_players = session_server_flush_players,
+    .set_blocked = session_server_set_blocked,
+    .serve_connection = session_server_serve_connection,
+    .process_input = session_server_process_input,
+    .process_frame = session_server_process_frame,
+    .reply_move = session_server_reply_move,
+    .reply_result = session_server_reply_result,
+    .finish_payload = session_server_finish_payload,
+    .flush = session_server_flush,
+};
+
+struct SessionServerPrivateOps *get_session_server_priv_ops(void) {
+  return &session_server_priv_ops_;
+}
+
+static struct SessionServerOps session_server_ops = {
+    .start = session_server_start,
+    .stop = session_server_stop,
+    .get_port = session_server_get_port,
+    .get_reactors = session_server_get_reactors,
+    .get_stats = session_server_get_stats,
+    .get_reactor_stats = session_server_get_reactor_stats,
+    .get_match_stats = session_server_get_match_stats,
+};
+
+struct SessionServerOps *get_session_server_ops(void) {
+  return &session_server_ops;
+}
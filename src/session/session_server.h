@@ -0,0 +1,87 @@
+#ifndef SESSION_SESSION_SERVER_H
+#define SESSION_SESSION_SERVER_H
+/*******************************************************************************
+ * @file session_server.h
+ * @brief Server hosting game sessions for remote clients.
+ *
+ * Server runs one reactor thread per CPU it may use, each pinned to its
+ * own CPU. Every reactor has its own listening socket bound to the same
+ * TCP port with SO_REUSEPORT, so kernel spreads new connections across
+ * reactors and the reactor which accepted a connection owns it and its
+ * session for the connection's whole life. Reactors share nothing, so
+ * serving moves never takes a lock.
+ *
+ * Clients speak the binary protocol, see wire_protocol.h. Every connection
+ * hosts its own session and plays for all of its users, server answers
+ * every select and quit with move record and end of every game with result
+ * record, after which the next game starts right away.
+ *
+ * Client may join matchmaking instead, see session_match.h. Players seated
+ * together are handed to one reactor, which hosts their shared session and
+ * sends moves to all of them. They play for their own seats only and keep
+ * playing together until one of them leaves, the others get a result with
+ * no winner then and are back on their own.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+#include "session/session_match.h"
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+#define SESSION_SERVER_REACTORS_MAX 256
+#define SESSION_SERVER_CONNECTIONS_DEFAULT 1024
+
+struct SessionServerConfig {
+  // IPv4 address to listen on, localhost if NULL.
+  const char *host;
+  // TCP port, 0 picks any free one.
+  uint16_t port;
+  // 0 starts one reactor per CPU server may run on.
+  size_t reactors;
+  // Connections limit of every reactor, 0 for the default one.
+  size_t connections_max;
+  size_t users_amount;
+};
+
+struct SessionServerStats {
+  size_t accepted;
+  // Connections closed right away because reactor had no free slot.
+  size_t rejected;
+  size_t frames;
+  // Events records, including ones sent by user not on turn.
+  size_t moves;
+  size_t off_turn_moves;
+  size_t games;
+  size_t protocol_errors;
+  // Players handed to matchmaking and players seated by reactor.
+  size_t joins;
+  size_t seated;
+  // Players disconnected because they did not read other players' moves.
+  size_t overruns;
+};
+
+struct SessionServerOps {
+  int (*start)(const struct SessionServerConfig *config);
+  void (*stop)(void);
+  uint16_t (*get_port)(void);
+  size_t (*get_reactors)(void);
+  // Stats are owned by reactors while they run, so they are valid only
+  //  once server is stopped. They are kept until the next start.
+  void (*get_stats)(struct SessionServerStats *stats);
+  void (*get_reactor_stats)(size_t reactor, struct SessionServerStats *stats);
+  void (*get_match_stats)(struct SessionMatchStats *stats);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct SessionServerOps *get_session_server_ops(void);
+
+#endif // SESSION_SESSION_SERVER_H
@@ -0,0 +1,444 @@
+/*******************************************************************************
+ * @file ttt_http_bench.c
+ * @brief Load generator for the game's HTTP server.
+ *
+ * Keeps given amount of connections to the server busy for given time and
+ * reports how many requests per second it answered. Every connection sends
+ * a batch of pipelined requests at once and sends the next batch once all
+ * responses arrived, so the server is measured rather than the round trips.
+ * Generator runs on a single thread with epoll, so it needs less CPU than
+ * the server it measures.
+ *
+ * E.g. `ttt-http-bench -c 64 -p 16 -d 5 8080` measures `GET /api/state`
+ * of the game listening on port 8080.
+ *
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L // getopt, clock_gettime
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define TTT_BENCH_CONNECTIONS_DEFAULT 64
+#define TTT_BENCH_DEPTH_DEFAULT 16
+#define TTT_BENCH_SECONDS_DEFAULT 5
+#define TTT_BENCH_PATH_DEFAULT "/api/state"
+#define TTT_BENCH_PORT_DEFAULT 8080
+#define TTT_BENCH_CONNECTIONS_MAX 10000
+#define TTT_BENCH_DEPTH_MAX 256
+#define TTT_BENCH_PATH_MAX 256
+#define TTT_BENCH_REQUEST_MAX 512
+#define TTT_BENCH_BUFFER_MAX 65536
+#define TTT_BENCH_EVENTS_MAX 256
+
+struct TttBenchConnection {
+  int fd;
+  // Bytes of the current batch which are already sent.
+  size_t sent;
+  // Responses of the current batch which did not arrive yet.
+  size_t pending;
+  size_t buffer_length;
+  char buffer[TTT_BENCH_BUFFER_MAX];
+};
+
+struct TttBench {
+  struct sockaddr_in address;
+  char path[TTT_BENCH_PATH_MAX];
+  size_t connections_length;
+  size_t depth;
+  int seconds;
+  char *requests;
+  size_t requests_length;
+  struct TttBenchConnection *connections;
+  int epoll_fd;
+  size_t responses;
+  size_t errors;
+  size_t bytes;
+};
+
+static int ttt_bench_parse_args(struct TttBench *bench, int argc,
+                                char *argv[]);
+static int ttt_bench_prepare(struct TttBench *bench);
+static int ttt_bench_connect(struct TttBench *bench,
+                             struct TttBenchConnection *connection);
+static int ttt_bench_send(struct TttBench *bench,
+                          struct TttBenchConnection *connection);
+static int ttt_bench_receive(struct TttBench *bench,
+                             struct TttBenchConnection *connection);
+static int ttt_bench_parse_responses(struct TttBench *bench,
+                                     struct TttBenchConnection *connection);
+static int ttt_bench_run(struct TttBench *bench);
+static double ttt_bench_now(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+int main(int argc, char *argv[]) {
+  struct TttBench bench = {0};
+  int err;
+
+  err = ttt_bench_parse_args(&bench, argc, argv);
+  if (err) {
+    fprintf(stderr,
+            "Usage: %s [-c connections] [-p pipeline_depth] [-d seconds] "
+            "[-u path] [port]\n",
+            argv[0]);
+    return 2;
+  }
+
+  err = ttt_bench_prepare(&bench);
+  if (err) {
+    fprintf(stderr, "Unable to prepare benchmark: %s\n", strerror(err));
+    return 1;
+  }
+
+  err = ttt_bench_run(&bench);
+
+  free(bench.connections);
+  free(bench.requests);
+
+  return err ? 1 : 0;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int ttt_bench_parse_args(struct TttBench *bench, int argc,
+                                char *argv[]) {
+  long port = TTT_BENCH_PORT_DEFAULT;
+  long value;
+  char *end;
+  int option;
+
+  strcpy(bench->path, TTT_BENCH_PATH_DEFAULT);
+  bench->connections_length = TTT_BENCH_CONNECTIONS_DEFAULT;
+  bench->depth = TTT_BENCH_DEPTH_DEFAULT;
+  bench->seconds = TTT_BENCH_SECONDS_DEFAULT;
+
+  while ((option = getopt(argc, argv, "c:p:d:u:")) != -1) {
+    if (option == '?') {
+      return EINVAL;
+    }
+
+    if (option == 'u') {
+      if (optarg[0] != '/' || strlen(optarg) >= sizeof(bench->path)) {
+        return EINVAL;
+      }
+      strcpy(bench->path, optarg);
+      continue;
+    }
+
+    value = strtol(optarg, &end, 10);
+    if (end == optarg || *end || value <= 0) {
+      return EINVAL;
+    }
+
+    if (option == 'c') {
+      if (value > TTT_BENCH_CONNECTIONS_MAX) {
+        return EINVAL;
+      }
+      bench->connections_length = value;
+    } else if (option == 'p') {
+      if (value > TTT_BENCH_DEPTH_MAX) {
+        return EINVAL;
+      }
+      bench->depth = value;
+    } else {
+      bench->seconds = value;
+    }
+  }
+
+  if (optind < argc - 1) {
+    return EINVAL;
+  }
+
+  if (optind == argc - 1) {
+    port = strtol(argv[optind], &end, 10);
+    if (end == argv[optind] || *end || port <= 0 || port > UINT16_MAX) {
+      return EINVAL;
+    }
+  }
+
+  bench->address = (struct sockaddr_in){
+      .sin_family = AF_INET,
+      .sin_port = htons(port),
+      .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+  };
+
+  return 0;
+}
+
+// The same batch is sent over and over, so it is composed only once.
+static int ttt_bench_prepare(struct TttBench *bench) {
+  char request[TTT_BENCH_REQUEST_MAX];
+  int length;
+
+  length = snprintf(request, sizeof(request),
+                    "GET %s HTTP/1.1\r\nHost: localhost\r\n\r\n",
+                    bench->path);
+  if (length < 0 || (size_t)length >= sizeof(request)) {
+    return ENAMETOOLONG;
+  }
+
+  bench->requests_length = length * bench->depth;
+  bench->requests = malloc(bench->requests_length);
+  if (!bench->requests) {
+    return ENOMEM;
+  }
+
+  for (size_t i = 0; i < bench->depth; i++) {
+    memcpy(bench->requests + i * length, request, length);
+  }
+
+  bench->connections =
+      calloc(bench->connections_length, sizeof(struct TttBenchConnection));
+  if (!bench->connections) {
+    return ENOMEM;
+  }
+
+  return 0;
+}
+
+static int ttt_bench_connect(struct TttBench *bench,
+                             struct TttBenchConnection *connection) {
+  struct epoll_event event = {.events = EPOLLIN | EPOLLOUT,
+                              .data.ptr = connection};
+  int err;
+
+  connection->fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (connection->fd == -1) {
+    return errno;
+  }
+
+  // Connection is made blocking, so batch can be sent right away.
+  if (connect(connection->fd, (struct sockaddr *)&bench->address,
+              sizeof(bench->address)) == -1) {
+    err = errno;
+    close(connection->fd);
+    connection->fd = -1;
+    return err;
+  }
+
+  if (epoll_ctl(bench->epoll_fd, EPOLL_CTL_ADD, connection->fd, &event) ==
+      -1) {
+    err = errno;
+    close(connection->fd);
+    connection->fd = -1;
+    return err;
+  }
+
+  connection->sent = 0;
+  connection->pending = bench->depth;
+  connection->buffer_length = 0;
+
+  return 0;
+}
+
+static int ttt_bench_send(struct TttBench *bench,
+                          struct TttBenchConnection *connection) {
+  ssize_t bytes_written;
+
+  while (connection->sent < bench->requests_length) {
+    bytes_written = send(connection->fd, bench->requests + connection->sent,
+                         bench->requests_length - connection->sent,
+                         MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (bytes_written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : errno;
+    }
+
+    connection->sent += bytes_written;
+  }
+
+  return 0;
+}
+
+static int ttt_bench_receive(struct TttBench *bench,
+                             struct TttBenchConnection *connection) {
+  ssize_t bytes_read;
+  int err;
+
+  bytes_read =
+      recv(connection->fd, connection->buffer + connection->buffer_length,
+           sizeof(connection->buffer) - connection->buffer_length - 1,
+           MSG_DONTWAIT);
+  if (bytes_read == -1) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0
+                                                                     : errno;
+  }
+
+  if (bytes_read == 0) {
+    return ECONNRESET;
+  }
+
+  bench->bytes += bytes_read;
+  connection->buffer_length += bytes_read;
+  connection->buffer[connection->buffer_length] = 0;
+
+  err = ttt_bench_parse_responses(bench, connection);
+  if (err) {
+    return err;
+  }
+
+  // Whole batch is answered, next one goes out right away.
+  if (connection->pending == 0) {
+    connection->sent = 0;
+    connection->pending = bench->depth;
+    return ttt_bench_send(bench, connection);
+  }
+
+  return 0;
+}
+
+static int ttt_bench_parse_responses(struct TttBench *bench,
+                                     struct TttBenchConnection *connection) {
+  const char content_length_name[] = "Content-Length: ";
+  size_t offset = 0;
+  size_t response_length;
+  const char *head_end;
+  const char *header;
+  char *head;
+  int status;
+
+  while (offset < connection->buffer_length) {
+    head = connection->buffer + offset;
+    head_end = strstr(head, "\r\n\r\n");
+    if (!head_end) {
+      break;
+    }
+
+    header = strstr(head, content_length_name);
+    if (!header || header > head_end || strncmp(head, "HTTP/1.1 ", 9)) {
+      return EPROTO;
+    }
+
+    response_length = head_end + 4 - head +
+                      strtoul(header + sizeof(content_length_name) - 1,
+                              NULL, 10);
+    if (response_length > sizeof(connection->buffer) - 1) {
+      return EMSGSIZE;
+    }
+
+    if (offset + response_length > connection->buffer_length) {
+      break;
+    }
+
+    status = atoi(head + 9);
+    if (status < 200 || status > 299) {
+      bench->errors++;
+    }
+
+    bench->responses++;
+    connection->pending--;
+    offset += response_length;
+  }
+
+  memmove(connection->buffer, connection->buffer + offset,
+          connection->buffer_length - offset);
+  connection->buffer_length -= offset;
+  connection->buffer[connection->buffer_length] = 0;
+
+  return 0;
+}
+
+static int ttt_bench_run(struct TttBench *bench) {
+  struct epoll_event events[TTT_BENCH_EVENTS_MAX];
+  struct TttBenchConnection *connection;
+  double started_at;
+  double elapsed;
+  double now;
+  int count;
+  int err = 0;
+
+  bench->epoll_fd = epoll_create1(0);
+  if (bench->epoll_fd == -1) {
+    perror("epoll_create1");
+    return errno;
+  }
+
+  for (size_t i = 0; i < bench->connections_length; i++) {
+    err = ttt_bench_connect(bench, &bench->connections[i]);
+    if (err) {
+      fprintf(stderr, "Unable to connect: %s\n", strerror(err));
+      bench->connections_length = i;
+      goto out;
+    }
+  }
+
+  started_at = ttt_bench_now();
+  now = started_at;
+
+  while (now - started_at < bench->seconds) {
+    count = epoll_wait(bench->epoll_fd, events, TTT_BENCH_EVENTS_MAX, 100);
+    if (count == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      err = errno;
+      perror("epoll_wait");
+      goto out;
+    }
+
+    for (int i = 0; i < count; i++) {
+      connection = events[i].data.ptr;
+
+      if (events[i].events & EPOLLOUT) {
+        err = ttt_bench_send(bench, connection);
+      }
+
+      if (!err && events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        err = ttt_bench_receive(bench, connection);
+      }
+
+      if (err) {
+        fprintf(stderr, "Connection failed: %s\n", strerror(err));
+        goto out;
+      }
+    }
+
+    now = ttt_bench_now();
+  }
+
+  elapsed = now - started_at;
+
+  printf("%zu connections, pipeline depth %zu, %s\n",
+         bench->connections_length, bench->depth, bench->path);
+  printf("%zu requests in %.2f s, %zu errors\n", bench->responses, elapsed,
+         bench->errors);
+  printf("%.0f requests/s, %.2f MB/s\n", bench->responses / elapsed,
+         bench->bytes / elapsed / (1024 * 1024));
+
+out:
+  for (size_t i = 0; i < bench->connections_length; i++) {
+    close(bench->connections[i].fd);
+  }
+  close(bench->epoll_fd);
+
+  return err;
+}
+
+static double ttt_bench_now(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
@@ -0,0 +1,811 @@
+/*******************************************************************************
+ * @file ttt_loadgen.c
+ * @brief Load generator for the session server.
+ *
+ * Opens given amount of connections to `ttt-server`, plays whole games over
+ * every one of them for given time and reports how fast connections were
+ * made, how many moves per second server answered and how long it took.
+ * Every connection keeps a single move in flight, like a real player, and
+ * move's latency is measured from the moment it is written until server
+ * acknowledges it, so it covers both directions of the network path and
+ * the server's reactor.
+ *
+ * Without `-m` every connection plays all users of its own session, so `-u`
+ * has to match the server's one. With `-m` every connection joins
+ * matchmaking and plays only its own seat, waiting for moves of the other
+ * players in between. Moves are picked either at random or by a simple
+ * player which wins if it can, blocks the others if it has to and takes
+ * the centre otherwise.
+ *
+ * Generator runs on a single thread with epoll and keeps only a limited
+ * amount of connects in progress, so thousands of connections are opened
+ * without flooding server's listen queue.
+ *
+ * E.g. `ttt-loadgen -c 5000 -d 10 -p ai tcp:7878` plays 5000 sessions for
+ * 10 seconds against server listening on port 7878.
+ *
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L // getopt, clock_gettime
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+// App's internal libs
+#include "client/wire_client.h"
+#include "game/user_move.h"
+#include "input/input_common.h"
+#include "session/session.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define TTT_LOADGEN_CONNECTIONS_DEFAULT 1000
+#define TTT_LOADGEN_CONNECTIONS_MAX 65536
+#define TTT_LOADGEN_SECONDS_DEFAULT 10
+#define TTT_LOADGEN_USERS_DEFAULT 2
+#define TTT_LOADGEN_ADDRESS_DEFAULT "tcp:7878"
+// Connects in progress at once.
+#define TTT_LOADGEN_CONNECTING_MAX 256
+#define TTT_LOADGEN_EVENTS_MAX 256
+// Cursor steps random player takes before it selects.
+#define TTT_LOADGEN_STEPS_MAX 3
+#define TTT_LOADGEN_MOVE_EVENTS_MAX (2 * SESSION_BOARD_MAX + 1)
+#define TTT_LOADGEN_HISTOGRAM_LENGTH 24
+
+enum TttLoadgenPolicies {
+  TTT_LOADGEN_POLICY_RANDOM,
+  TTT_LOADGEN_POLICY_AI,
+};
+
+struct TttLoadgenPlayer {
+  struct WireClient client;
+  bool is_connected;
+  // Output did not fit into socket, player waits for EPOLLOUT.
+  bool is_writing;
+  // Player knows its game and may move once it is on turn.
+  bool is_seated;
+  // Move was written and server did not acknowledge it yet.
+  bool is_waiting;
+  // When the connect or the move in flight started.
+  uint64_t started_ns;
+  // Seat player got from matchmaking, 0 if it plays for all users.
+  game_user_id_t seat;
+  game_user_id_t on_turn;
+  size_t users_amount;
+  size_t board_size;
+  // Server's cursor, it is reported with every select.
+  struct UserMoveCoordinates cursor;
+  // User owning every cell, 0 if cell is free.
+  uint8_t board[SESSION_BOARD_MAX][SESSION_BOARD_MAX];
+  size_t games;
+};
+
+struct TttLoadgen {
+  const char *address;
+  size_t players_length;
+  int seconds;
+  size_t users_amount;
+  size_t board_size;
+  enum TttLoadgenPolicies policy;
+  bool is_matching;
+  uint64_t random_state;
+  struct TttLoadgenPlayer *players;
+  int epoll_fd;
+  // Players a connect was started for, they go in order.
+  size_t started;
+  size_t connecting;
+  size_t connected;
+  size_t failed;
+  uint64_t started_ns;
+  uint64_t connected_ns;
+  size_t moves;
+  size_t errors;
+  uint64_t latency_ns_total;
+  uint64_t latency_ns_max;
+  // I-th counts moves answered in less than 2^i microseconds but not less
+  //  than (i-1)-th bound, the last one counts everything else.
+  size_t latency_histogram[TTT_LOADGEN_HISTOGRAM_LENGTH];
+};
+
+static int ttt_loadgen_parse_args(struct TttLoadgen *loadgen, int argc,
+                                  char *argv[]);
+static int ttt_loadgen_prepare(struct TttLoadgen *loadgen);
+static int ttt_loadgen_start_connects(struct TttLoadgen *loadgen);
+static int ttt_loadgen_finish_connect(struct TttLoadgen *loadgen,
+                                      struct TttLoadgenPlayer *player);
+static int ttt_loadgen_serve(struct TttLoadgen *loadgen,
+                             struct TttLoadgenPlayer *player,
+                             uint32_t events);
+static int ttt_loadgen_flush(struct TttLoadgen *loadgen,
+                             struct TttLoadgenPlayer *player);
+static int ttt_loadgen_play(struct TttLoadgen *loadgen,
+                            struct TttLoadgenPlayer *player);
+static size_t ttt_loadgen_pick_random(struct TttLoadgen *loadgen,
+                                      struct TttLoadgenPlayer *player,
+                                      enum InputEvents *events);
+static size_t ttt_loadgen_pick_ai(struct TttLoadgen *loadgen,
+                                  struct TttLoadgenPlayer *player,
+                                  enum InputEvents *events);
+static size_t ttt_loadgen_steer(enum InputEvents *events, size_t from,
+                                size_t to, size_t size,
+                                enum InputEvents forward,
+                                enum InputEvents backward);
+static bool ttt_loadgen_find_win(struct TttLoadgenPlayer *player,
+                                 game_user_id_t user,
+                                 struct UserMoveCoordinates *cell);
+static bool ttt_loadgen_is_win(struct TttLoadgenPlayer *player,
+                               game_user_id_t user, size_t x, size_t y);
+static void ttt_loadgen_record_latency(struct TttLoadgen *loadgen,
+                                       uint64_t latency_ns);
+static void ttt_loadgen_reset_game(struct TttLoadgenPlayer *player);
+static void ttt_loadgen_on_move(struct WireClient *client,
+                                const struct UserMove *move);
+static void ttt_loadgen_on_result(struct WireClient *client,
+                                  game_user_id_t winner, size_t valid_moves);
+static void ttt_loadgen_on_start(struct WireClient *client,
+                                 game_user_id_t seat, size_t users_amount,
+                                 size_t board_size);
+static void ttt_loadgen_print_stats(struct TttLoadgen *loadgen,
+                                    uint64_t elapsed_ns);
+static uint64_t ttt_loadgen_random(struct TttLoadgen *loadgen);
+static uint64_t ttt_loadgen_now(void);
+
+static struct WireClientOps *client_ops;
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+int main(int argc, char *argv[]) {
+  struct epoll_event events[TTT_LOADGEN_EVENTS_MAX];
+  struct TttLoadgen loadgen = {0};
+  struct TttLoadgenPlayer *player;
+  uint64_t deadline_ns;
+  uint64_t now_ns;
+  int events_length;
+  int err;
+
+  err = ttt_loadgen_parse_args(&loadgen, argc, argv);
+  if (err) {
+    fprintf(stderr,
+            "Usage: %s [-c connections] [-d seconds] [-u users] "
+            "[-b board_size] [-p random|ai] [-s seed] [-m] [address]\n",
+            argv[0]);
+    return 2;
+  }
+
+  err = ttt_loadgen_prepare(&loadgen);
+  if (err) {
+    fprintf(stderr, "Unable to prepare load generator: %s\n", strerror(err));
+    return 1;
+  }
+
+  loadgen.started_ns = ttt_loadgen_now();
+  deadline_ns = loadgen.started_ns + loadgen.seconds * 1000000000ull;
+  now_ns = loadgen.started_ns;
+
+  while (now_ns < deadline_ns) {
+    err = ttt_loadgen_start_connects(&loadgen);
+    if (err) {
+      fprintf(stderr, "Unable to connect to %s: %s\n", loadgen.address,
+              strerror(err));
+      break;
+    }
+
+    events_length = epoll_wait(loadgen.epoll_fd, events,
+                               TTT_LOADGEN_EVENTS_MAX, 100);
+    if (events_length == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      perror("epoll_wait");
+      break;
+    }
+
+    for (int i = 0; i < events_length; i++) {
+      player = &loadgen.players[events[i].data.u64];
+
+      // Player which failed is only closed, the others go on.
+      if (player->is_connected
+              ? ttt_loadgen_serve(&loadgen, player, events[i].events)
+              : ttt_loadgen_finish_connect(&loadgen, player)) {
+        loadgen.errors += player->is_connected;
+        client_ops->close(&player->client);
+        player->is_connected = false;
+      }
+    }
+
+    now_ns = ttt_loadgen_now();
+  }
+
+  if (!err) {
+    ttt_loadgen_print_stats(&loadgen, now_ns - loadgen.started_ns);
+  }
+
+  for (size_t i = 0; i < loadgen.started; i++) {
+    client_ops->close(&loadgen.players[i].client);
+  }
+  close(loadgen.epoll_fd);
+  free(loadgen.players);
+
+  return err ? 1 : 0;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int ttt_loadgen_parse_args(struct TttLoadgen *loadgen, int argc,
+                                  char *argv[]) {
+  long value;
+  char *end;
+  int option;
+
+  loadgen->address = TTT_LOADGEN_ADDRESS_DEFAULT;
+  loadgen->players_length = TTT_LOADGEN_CONNECTIONS_DEFAULT;
+  loadgen->seconds = TTT_LOADGEN_SECONDS_DEFAULT;
+  loadgen->users_amount = TTT_LOADGEN_USERS_DEFAULT;
+  loadgen->policy = TTT_LOADGEN_POLICY_RANDOM;
+  loadgen->random_state = 1;
+
+  while ((option = getopt(argc, argv, "c:d:u:b:p:s:m")) != -1) {
+    if (option == '?') {
+      return EINVAL;
+    }
+
+    if (option == 'm') {
+      loadgen->is_matching = true;
+      continue;
+    }
+
+    if (option == 'p') {
+      if (strcmp(optarg, "random") == 0) {
+        loadgen->policy = TTT_LOADGEN_POLICY_RANDOM;
+      } else if (strcmp(optarg, "ai") == 0) {
+        loadgen->policy = TTT_LOADGEN_POLICY_AI;
+      } else {
+        return EINVAL;
+      }
+      continue;
+    }
+
+    value = strtol(optarg, &end, 10);
+    if (end == optarg || *end || value <= 0) {
+      return EINVAL;
+    }
+
+    if (option == 'c') {
+      if (value > TTT_LOADGEN_CONNECTIONS_MAX) {
+        return EINVAL;
+      }
+      loadgen->players_length = value;
+    } else if (option == 'd') {
+      loadgen->seconds = value;
+    } else if (option == 'u') {
+      if (value < 2 || value > SESSION_USERS_MAX) {
+        return EINVAL;
+      }
+      loadgen->users_amount = value;
+    } else if (option == 'b') {
+      if (value > SESSION_BOARD_MAX) {
+        return EINVAL;
+      }
+      loadgen->board_size = value;
+    } else {
+      loadgen->random_state = value;
+    }
+  }
+
+  if (loadgen->board_size == 0) {
+    loadgen->board_size = loadgen->users_amount + 1;
+  }
+
+  // Server hosting its own sessions picks board size by users amount.
+  if (loadgen->board_size <= loadgen->users_amount ||
+      (!loadgen->is_matching &&
+       loadgen->board_size != loadgen->users_amount + 1)) {
+    return EINVAL;
+  }
+
+  if (optind < argc - 1) {
+    return EINVAL;
+  }
+
+  if (optind == argc - 1) {
+    loadgen->address = argv[optind];
+  }
+
+  return 0;
+}
+
+static int ttt_loadgen_prepare(struct TttLoadgen *loadgen) {
+  struct rlimit limit;
+  // Room for stdio and epoll on top of the connections.
+  rlim_t needed = loadgen->players_length + 16;
+
+  client_ops = get_wire_client_ops();
+
+  // Thousands of connections don't fit into the usual soft limit.
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < needed) {
+    limit.rlim_cur = limit.rlim_max < needed ? limit.rlim_max : needed;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+
+  loadgen->players =
+      calloc(loadgen->players_length, sizeof(struct TttLoadgenPlayer));
+  if (!loadgen->players) {
+    return ENOMEM;
+  }
+
+  loadgen->epoll_fd = epoll_create1(0);
+  if (loadgen->epoll_fd == -1) {
+    free(loadgen->players);
+    return errno;
+  }
+
+  return 0;
+}
+
+// Returns error only if address itself is wrong, failed connects are just
+//  counted.
+static int ttt_loadgen_start_connects(struct TttLoadgen *loadgen) {
+  struct epoll_event event = {.events = EPOLLOUT};
+  struct TttLoadgenPlayer *player;
+  int err;
+
+  while (loadgen->connecting < TTT_LOADGEN_CONNECTING_MAX &&
+         loadgen->started < loadgen->players_length) {
+    event.data.u64 = loadgen->started;
+    player = &loadgen->players[loadgen->started++];
+
+    player->client.fd = -1;
+    player->client.handlers = (struct WireClientHandlers){
+        .move = ttt_loadgen_on_move,
+        .result = ttt_loadgen_on_result,
+        .start = ttt_loadgen_on_start,
+    };
+    player->client.data = player;
+    player->started_ns = ttt_loadgen_now();
+
+    err = client_ops->connect(&player->client, loadgen->address, true);
+    if (!err &&
+        epoll_ctl(loadgen->epoll_fd, EPOLL_CTL_ADD, player->client.fd,
+                  &event) == -1) {
+      err = errno;
+      client_ops->close(&player->client);
+    }
+
+    if (err == EINVAL) {
+      return err;
+    }
+    if (err) {
+      loadgen->failed++;
+      continue;
+    }
+
+    loadgen->connecting++;
+  }
+
+  return 0;
+}
+
+// Completes non blocking connect, hello goes out with the first move.
+static int ttt_loadgen_finish_connect(struct TttLoadgen *loadgen,
+                                      struct TttLoadgenPlayer *player) {
+  struct epoll_event event = {.events = EPOLLIN,
+                              .data.u64 = player - loadgen->players};
+  socklen_t err_length = sizeof(int);
+  int err = 0;
+
+  loadgen->connecting--;
+
+  if (getsockopt(player->client.fd, SOL_SOCKET, SO_ERROR, &err,
+                 &err_length) == -1) {
+    err = errno;
+  }
+  if (err) {
+    loadgen->failed++;
+    return err;
+  }
+
+  if (epoll_ctl(loadgen->epoll_fd, EPOLL_CTL_MOD, player->client.fd,
+                &event) == -1) {
+    loadgen->failed++;
+    return errno;
+  }
+
+  player->is_connected = true;
+  loadgen->connected++;
+  loadgen->connected_ns = ttt_loadgen_now();
+
+  if (loadgen->is_matching) {
+    err = client_ops->join(&player->client, loadgen->users_amount,
+                           loadgen->board_size);
+    if (err) {
+      return err;
+    }
+
+    return ttt_loadgen_flush(loadgen, player);
+  }
+
+  player->users_amount = loadgen->users_amount;
+  player->board_size = loadgen->board_size;
+  player->is_seated = true;
+  ttt_loadgen_reset_game(player);
+
+  return ttt_loadgen_play(loadgen, player);
+}
+
+static int ttt_loadgen_serve(struct TttLoadgen *loadgen,
+                             struct TttLoadgenPlayer *player,
+                             uint32_t events) {
+  int err;
+
+  if (player->is_writing && events & EPOLLOUT) {
+    err = ttt_loadgen_flush(loadgen, player);
+    if (err) {
+      return err;
+    }
+  }
+
+  if (!(events & (EPOLLIN | EPOLLERR | EPOLLHUP))) {
+    return 0;
+  }
+
+  err = client_ops->receive(&player->client);
+  if (err == EAGAIN) {
+    return 0;
+  }
+  if (err) {
+    return err;
+  }
+
+  if (player->is_waiting &&
+      player->client.moves_acked == player->client.moves_sent) {
+    ttt_loadgen_record_latency(loadgen,
+                               ttt_loadgen_now() - player->started_ns);
+    player->is_waiting = false;
+  }
+
+  return ttt_loadgen_play(loadgen, player);
+}
+
+// Watches EPOLLOUT only while output does not fit into socket.
+static int ttt_loadgen_flush(struct TttLoadgen *loadgen,
+                             struct TttLoadgenPlayer *player) {
+  struct epoll_event event = {.data.u64 = player - loadgen->players};
+  bool is_writing;
+  int err;
+
+  err = client_ops->flush(&player->client);
+  if (err && err != EAGAIN) {
+    return err;
+  }
+
+  is_writing = err == EAGAIN;
+  if (player->is_writing == is_writing) {
+    return 0;
+  }
+
+  event.events = is_writing ? EPOLLIN | EPOLLOUT : EPOLLIN;
+  if (epoll_ctl(loadgen->epoll_fd, EPOLL_CTL_MOD, player->client.fd,
+                &event) == -1) {
+    return errno;
+  }
+  player->is_writing = is_writing;
+
+  return 0;
+}
+
+static int ttt_loadgen_play(struct TttLoadgen *loadgen,
+                            struct TttLoadgenPlayer *player) {
+  enum InputEvents events[TTT_LOADGEN_MOVE_EVENTS_MAX];
+  size_t events_length;
+  int err;
+
+  // Matched player moves only for its own seat.
+  if (!player->is_seated || player->is_waiting ||
+      (player->seat && player->on_turn != player->seat)) {
+    return 0;
+  }
+
+  events_length = loadgen->policy == TTT_LOADGEN_POLICY_AI
+                      ? ttt_loadgen_pick_ai(loadgen, player, events)
+                      : ttt_loadgen_pick_random(loadgen, player, events);
+
+  err = client_ops->queue_move(&player->client, player->on_turn, events,
+                               events_length);
+  if (err) {
+    return err;
+  }
+
+  player->is_waiting = true;
+  player->started_ns = ttt_loadgen_now();
+
+  return ttt_loadgen_flush(loadgen, player);
+}
+
+// Takes a few random steps and selects whatever cell cursor ends on.
+static size_t ttt_loadgen_pick_random(struct TttLoadgen *loadgen,
+                                      struct TttLoadgenPlayer *player,
+                                      enum InputEvents *events) {
+  size_t steps = ttt_loadgen_random(loadgen) % (TTT_LOADGEN_STEPS_MAX + 1);
+  (void)player;
+
+  for (size_t i = 0; i < steps; i++) {
+    events[i] = INPUT_EVENT_UP + ttt_loadgen_random(loadgen) % 4;
+  }
+  events[steps] = INPUT_EVENT_SELECT;
+
+  return steps + 1;
+}
+
+// Wins if it can, blocks the others if it has to, prefers the centre and
+//  otherwise takes the first free cell after a random one. Cursor is taken
+//  the shorter way round, it wraps at board's edges.
+static size_t ttt_loadgen_pick_ai(struct TttLoadgen *loadgen,
+                                  struct TttLoadgenPlayer *player,
+                                  enum InputEvents *events) {
+  size_t size = player->board_size;
+  size_t center = size / 2;
+  struct UserMoveCoordinates cell;
+  size_t events_length;
+  size_t cells = size * size;
+  size_t first;
+  bool is_found;
+
+  is_found = ttt_loadgen_find_win(player, player->on_turn, &cell);
+  for (game_user_id_t user = 1;
+       !is_found && user <= (game_user_id_t)player->users_amount; user++) {
+    if (user != player->on_turn) {
+      is_found = ttt_loadgen_find_win(player, user, &cell);
+    }
+  }
+
+  if (!is_found && player->board[center][center] == 0) {
+    cell = (struct UserMoveCoordinates){.x = center, .y = center};
+    is_found = true;
+  }
+
+  first = ttt_loadgen_random(loadgen) % cells;
+  for (size_t i = 0; !is_found && i < cells; i++) {
+    cell.x = (first + i) % cells % size;
+    cell.y = (first + i) % cells / size;
+    is_found = player->board[cell.y][cell.x] == 0;
+  }
+
+  events_length =
+      ttt_loadgen_steer(events, player->cursor.x, cell.x, size,
+                        INPUT_EVENT_RIGHT, INPUT_EVENT_LEFT);
+  events_length += ttt_loadgen_steer(events + events_length,
+                                     player->cursor.y, cell.y, size,
+                                     INPUT_EVENT_DOWN, INPUT_EVENT_UP);
+  events[events_length++] = INPUT_EVENT_SELECT;
+
+  return events_length;
+}
+
+// Moves cursor along one axis, which wraps at board's edges, the shorter
+//  way round.
+static size_t ttt_loadgen_steer(enum InputEvents *events, size_t from,
+                                size_t to, size_t size,
+                                enum InputEvents forward,
+                                enum InputEvents backward) {
+  size_t steps = (to + size - from) % size;
+  enum InputEvents event = forward;
+
+  if (steps > size / 2) {
+    steps = size - steps;
+    event = backward;
+  }
+
+  for (size_t i = 0; i < steps; i++) {
+    events[i] = event;
+  }
+
+  return steps;
+}
+
+static bool ttt_loadgen_find_win(struct TttLoadgenPlayer *player,
+                                 game_user_id_t user,
+                                 struct UserMoveCoordinates *cell) {
+  for (size_t y = 0; y < player->board_size; y++) {
+    for (size_t x = 0; x < player->board_size; x++) {
+      if (player->board[y][x] == 0 && ttt_loadgen_is_win(player, user, x, y)) {
+        *cell = (struct UserMoveCoordinates){.x = x, .y = y};
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+// Tells whether user taking given free cell would own a whole line.
+static bool ttt_loadgen_is_win(struct TttLoadgenPlayer *player,
+                               game_user_id_t user, size_t x, size_t y) {
+  size_t last = player->board_size - 1;
+  bool is_row = true;
+  bool is_column = true;
+  bool is_diagonal = x == y;
+  bool is_antidiagonal = x + y == last;
+
+  for (size_t i = 0; i <= last; i++) {
+    is_row = is_row && (i == x || player->board[y][i] == user);
+    is_column = is_column && (i == y || player->board[i][x] == user);
+    is_diagonal = is_diagonal && (i == x || player->board[i][i] == user);
+    is_antidiagonal =
+        is_antidiagonal && (i == x || player->board[last - i][i] == user);
+  }
+
+  return is_row || is_column || is_diagonal || is_antidiagonal;
+}
+
+static void ttt_loadgen_record_latency(struct TttLoadgen *loadgen,
+                                       uint64_t latency_ns) {
+  uint64_t latency_us = latency_ns / 1000;
+  size_t i;
+
+  loadgen->moves++;
+  loadgen->latency_ns_total += latency_ns;
+  if (latency_ns > loadgen->latency_ns_max) {
+    loadgen->latency_ns_max = latency_ns;
+  }
+
+  for (i = 0; latency_us && i < TTT_LOADGEN_HISTOGRAM_LENGTH - 1; i++) {
+    latency_us >>= 1;
+  }
+  loadgen->latency_histogram[i]++;
+}
+
+// Every game starts with the first user and cursor where server puts it.
+static void ttt_loadgen_reset_game(struct TttLoadgenPlayer *player) {
+  memset(player->board, 0, sizeof(player->board));
+  player->on_turn = 1;
+  player->cursor = (struct UserMoveCoordinates){.x = 1, .y = 1};
+}
+
+static void ttt_loadgen_on_move(struct WireClient *client,
+                                const struct UserMove *move) {
+  struct TttLoadgenPlayer *player = client->data;
+
+  if (move->coordinates.x < 0 || move->coordinates.y < 0 ||
+      (size_t)move->coordinates.x >= player->board_size ||
+      (size_t)move->coordinates.y >= player->board_size) {
+    return;
+  }
+
+  player->cursor = move->coordinates;
+
+  // Game which ended is followed by result, which resets the board.
+  if (move->type == USER_MOVE_TYPE_SELECT_VALID) {
+    player->board[move->coordinates.y][move->coordinates.x] = move->user_id;
+    player->on_turn = move->user_id % player->users_amount + 1;
+  }
+}
+
+static void ttt_loadgen_on_result(struct WireClient *client,
+                                  game_user_id_t winner, size_t valid_moves) {
+  struct TttLoadgenPlayer *player = client->data;
+  (void)winner;
+  (void)valid_moves;
+
+  // Every player of shared session gets the result, the first one counts
+  //  it.
+  if (player->seat <= 1) {
+    player->games++;
+  }
+
+  ttt_loadgen_reset_game(player);
+}
+
+static void ttt_loadgen_on_start(struct WireClient *client,
+                                 game_user_id_t seat, size_t users_amount,
+                                 size_t board_size) {
+  struct TttLoadgenPlayer *player = client->data;
+
+  player->seat = seat;
+  player->users_amount = users_amount;
+  player->board_size = board_size;
+  player->is_seated = true;
+  ttt_loadgen_reset_game(player);
+}
+
+static void ttt_loadgen_print_stats(struct TttLoadgen *loadgen,
+                                    uint64_t elapsed_ns) {
+  const double percentiles[] = {0.5, 0.9, 0.99, 0.999};
+  double seconds = elapsed_ns / 1e9;
+  double connect_seconds;
+  size_t games = 0;
+  size_t counted = 0;
+  size_t first = TTT_LOADGEN_HISTOGRAM_LENGTH;
+  size_t last = 0;
+  size_t i;
+
+  for (size_t j = 0; j < loadgen->started; j++) {
+    games += loadgen->players[j].games;
+  }
+
+  connect_seconds =
+      loadgen->connected
+          ? (loadgen->connected_ns - loadgen->started_ns) / 1e9
+          : 0;
+  printf("%zu of %zu connections made in %.2f s, %.0f connections/s, "
+         "%zu failed\n",
+         loadgen->connected, loadgen->players_length, connect_seconds,
+         connect_seconds > 0 ? loadgen->connected / connect_seconds : 0,
+         loadgen->failed);
+  printf("%zu moves in %.2f s, %.0f moves/s, %zu games, %zu errors\n",
+         loadgen->moves, seconds, seconds > 0 ? loadgen->moves / seconds : 0,
+         games, loadgen->errors);
+
+  if (loadgen->moves == 0) {
+    return;
+  }
+
+  printf("move latency: %.1f us on average, %.1f us at most",
+         loadgen->latency_ns_total / 1e3 / loadgen->moves,
+         loadgen->latency_ns_max / 1e3);
+
+  // Percentiles are known only up to their histogram bucket.
+  i = 0;
+  for (size_t j = 0; j < sizeof(percentiles) / sizeof(percentiles[0]); j++) {
+    while (i < TTT_LOADGEN_HISTOGRAM_LENGTH - 1 &&
+           counted + loadgen->latency_histogram[i] <
+               percentiles[j] * loadgen->moves) {
+      counted += loadgen->latency_histogram[i++];
+    }
+    printf(", p%g < %zu us", percentiles[j] * 100, (size_t)1 << i);
+  }
+  printf("\n");
+
+  for (i = 0; i < TTT_LOADGEN_HISTOGRAM_LENGTH; i++) {
+    if (loadgen->latency_histogram[i]) {
+      first = first < i ? first : i;
+      last = i + 1;
+    }
+  }
+
+  // Empty buckets below the fastest and above the slowest move are left
+  //  out.
+  for (i = first; i < last; i++) {
+    if (i < TTT_LOADGEN_HISTOGRAM_LENGTH - 1) {
+      printf("  latency < %8zu us: %zu\n", (size_t)1 << i,
+             loadgen->latency_histogram[i]);
+    } else {
+      printf("  latency >= %7zu us: %zu\n", (size_t)1 << (i - 1),
+             loadgen->latency_histogram[i]);
+    }
+  }
+}
+
+// Xorshift, the same seed plays the same moves against the same replies.
+static uint64_t ttt_loadgen_random(struct TttLoadgen *loadgen) {
+  uint64_t x = loadgen->random_state;
+
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  loadgen->random_state = x;
+
+  return x;
+}
+
+static uint64_t ttt_loadgen_now(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
@@ -0,0 +1,223 @@
+/*******************************************************************************
+ * @file ttt_server.c
+ * @brief Hosted mode, serves game sessions to remote clients.
+ *
+ * Runs session server until it gets SIGINT or SIGTERM and reports what its
+ * reactors served then, so their balance can be checked as well as moves
+ * per second of the whole server. Matchmaking's report tells how many
+ * sessions it started per second and how long players waited for them.
+ *
+ * E.g. `ttt-server -r 4 -u 2 7878` serves two players sessions on port 7878
+ * with four reactors.
+ *
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L // getopt, sigwait, clock_gettime
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// App's internal libs
+#include "session/session.h"
+#include "session/session_match.h"
+#include "session/session_server.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define TTT_SERVER_PORT_DEFAULT 7878
+#define TTT_SERVER_USERS_DEFAULT 2
+#define TTT_SERVER_CONNECTIONS_MAX 1000000
+
+static int ttt_server_parse_args(struct SessionServerConfig *config, int argc,
+                                 char *argv[]);
+static void ttt_server_print_stats(const char *name,
+                                   struct SessionServerStats *stats,
+                                   double seconds);
+static void ttt_server_print_match_stats(struct SessionMatchStats *stats,
+                                         double seconds);
+static double ttt_server_now(void);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+int main(int argc, char *argv[]) {
+  struct SessionServerOps *server_ops = get_session_server_ops();
+  struct SessionServerConfig config = {0};
+  struct SessionMatchStats match_stats;
+  struct SessionServerStats stats;
+  char name[32];
+  double started;
+  sigset_t signals;
+  int signal;
+  int err;
+
+  err = ttt_server_parse_args(&config, argc, argv);
+  if (err) {
+    fprintf(stderr,
+            "Usage: %s [-r reactors] [-c connections_per_reactor] "
+            "[-u users] [-b host] [port]\n",
+            argv[0]);
+    return 2;
+  }
+
+  // Reactors inherit the mask, so signals are left to the main thread.
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+  err = server_ops->start(&config);
+  if (err) {
+    fprintf(stderr, "Unable to start server: %s\n", strerror(err));
+    return 1;
+  }
+
+  printf("Serving %zu players sessions on port %u with %zu reactors\n",
+         config.users_amount, server_ops->get_port(),
+         server_ops->get_reactors());
+  fflush(stdout);
+
+  started = ttt_server_now();
+  sigwait(&signals, &signal);
+
+  server_ops->stop();
+
+  started = ttt_server_now() - started;
+  for (size_t i = 0; i < server_ops->get_reactors(); i++) {
+    server_ops->get_reactor_stats(i, &stats);
+    snprintf(name, sizeof(name), "reactor %zu", i);
+    ttt_server_print_stats(name, &stats, started);
+  }
+
+  server_ops->get_stats(&stats);
+  ttt_server_print_stats("total", &stats, started);
+
+  server_ops->get_match_stats(&match_stats);
+  ttt_server_print_match_stats(&match_stats, started);
+
+  return 0;
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static int ttt_server_parse_args(struct SessionServerConfig *config, int argc,
+                                 char *argv[]) {
+  long port = TTT_SERVER_PORT_DEFAULT;
+  long value;
+  char *end;
+  int option;
+
+  config->users_amount = TTT_SERVER_USERS_DEFAULT;
+
+  while ((option = getopt(argc, argv, "r:c:u:b:")) != -1) {
+    if (option == '?') {
+      return EINVAL;
+    }
+
+    if (option == 'b') {
+      config->host = optarg;
+      continue;
+    }
+
+    value = strtol(optarg, &end, 10);
+    if (end == optarg || *end || value <= 0) {
+      return EINVAL;
+    }
+
+    if (option == 'r') {
+      if (value > SESSION_SERVER_REACTORS_MAX) {
+        return EINVAL;
+      }
+      config->reactors = value;
+    } else if (option == 'c') {
+      if (value > TTT_SERVER_CONNECTIONS_MAX) {
+        return EINVAL;
+      }
+      config->connections_max = value;
+    } else {
+      if (value < 2 || value > SESSION_USERS_MAX) {
+        return EINVAL;
+      }
+      config->users_amount = value;
+    }
+  }
+
+  if (optind < argc - 1) {
+    return EINVAL;
+  }
+
+  if (optind == argc - 1) {
+    port = strtol(argv[optind], &end, 10);
+    if (end == argv[optind] || *end || port < 0 || port > UINT16_MAX) {
+      return EINVAL;
+    }
+  }
+
+  config->port = port;
+
+  return 0;
+}
+
+static void ttt_server_print_stats(const char *name,
+                                   struct SessionServerStats *stats,
+                                   double seconds) {
+  printf("%s: %zu accepted, %zu rejected, %zu frames, %zu moves "
+         "(%zu off turn), %zu games, %zu protocol errors, %zu joins, "
+         "%zu seated, %zu overruns, %.0f moves/s\n",
+         name, stats->accepted, stats->rejected, stats->frames, stats->moves,
+         stats->off_turn_moves, stats->games, stats->protocol_errors,
+         stats->joins, stats->seated, stats->overruns,
+         seconds > 0 ? stats->moves / seconds : 0);
+}
+
+static void ttt_server_print_match_stats(struct SessionMatchStats *stats,
+                                         double seconds) {
+  size_t first = SESSION_MATCH_HISTOGRAM_LENGTH;
+  size_t last = 0;
+
+  printf("matchmaking: %zu queued, %zu dropped, %zu sessions (%.0f/s), "
+         "%zu players, wait %.1f us on average, %.1f us at most\n",
+         stats->queued, stats->dropped, stats->sessions,
+         seconds > 0 ? stats->sessions / seconds : 0, stats->players,
+         stats->players ? stats->wait_ns_total / 1e3 / stats->players : 0,
+         stats->wait_ns_max / 1e3);
+
+  for (size_t i = 0; i < SESSION_MATCH_HISTOGRAM_LENGTH; i++) {
+    if (stats->wait_histogram[i]) {
+      first = first < i ? first : i;
+      last = i + 1;
+    }
+  }
+
+  // Empty buckets below the fastest and above the slowest wait are left
+  //  out.
+  for (size_t i = first; i < last; i++) {
+    if (i < SESSION_MATCH_HISTOGRAM_LENGTH - 1) {
+      printf("  wait < %8zu us: %zu\n", (size_t)1 << i,
+             stats->wait_histogram[i]);
+    } else {
+      printf("  wait >= %7zu us: %zu\n", (size_t)1 << (i - 1),
+             stats->wait_histogram[i]);
+    }
+  }
+}
+
+static double ttt_server_now(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
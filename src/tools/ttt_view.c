@@ -0,0 +1,347 @@
+/*******************************************************************************
+ * @file ttt_view.c
+ * @brief Viewer of boards published by `shm` display.
+ *
+ * Without arguments lists all games publishing into shared memory, with
+ * segment name (e.g. `/ttt.1234`) follows that game and redraws the board
+ * every time new one is published. Reading the board never involves the
+ * game process, viewer only maps the segment read-only and retries copy
+ * if seqlock tells that it overlapped with a write. Game which dies while
+ * writing leaves the sequence odd forever, so retries are limited and the
+ * board is reported as stale instead. Segments of games which are not
+ * running anymore are removed.
+ *
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L // shm_open, nanosleep, kill
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// App's internal libs
+#include "display/shm.h"
+#include "game/game_state_machine/game_state_machine.h"
+#include "game/game_state_machine/game_states.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define TTT_VIEW_SHM_DIR "/dev/shm"
+#define TTT_VIEW_POLL_NS (50 * 1000 * 1000)
+// How many polls pass between checks whether the game is still running.
+#define TTT_VIEW_ALIVE_CHECK_POLLS 20
+// Writer holds the sequence odd only for a copy of the board, reader which
+//  keeps missing it this many times assumes the writer is gone.
+#define TTT_VIEW_READ_RETRIES_MAX 1000
+// Leading slash, file name from the directory and terminating null.
+#define TTT_VIEW_NAME_MAX (NAME_MAX + 2)
+
+static const struct DisplayShmBoard *ttt_view_map(const char *name);
+static void ttt_view_unmap(const struct DisplayShmBoard *board);
+static int ttt_view_read(const struct DisplayShmBoard *shared,
+                         struct DisplayShmBoard *copy,
+                         uint_least64_t *sequence);
+static bool ttt_view_is_alive(const char *name,
+                              const struct DisplayShmBoard *shared);
+static void ttt_view_print_board(const char *name,
+                                 const struct DisplayShmBoard *board);
+static const char *ttt_view_state_name(uint32_t game_state);
+static int ttt_view_list(void);
+static int ttt_view_follow(const char *name);
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+int main(int argc, char *argv[]) {
+  if (argc > 2 || (argc == 2 && argv[1][0] != '/')) {
+    fprintf(stderr, "Usage: %s [/segment_name]\n", argv[0]);
+    return 2;
+  }
+
+  if (argc == 1) {
+    return ttt_view_list();
+  }
+
+  return ttt_view_follow(argv[1]);
+}
+
+/*******************************************************************************
+ *    PRIVATE API
+ ******************************************************************************/
+static const struct DisplayShmBoard *ttt_view_map(const char *name) {
+  struct DisplayShmBoard *board;
+  struct stat shm_stat;
+  int fd;
+
+  fd = shm_open(name, O_RDONLY, 0);
+  if (fd == -1) {
+    return NULL;
+  }
+
+  if (fstat(fd, &shm_stat) == -1 ||
+      (size_t)shm_stat.st_size < sizeof(struct DisplayShmBoard)) {
+    close(fd);
+    errno = EPROTO;
+    return NULL;
+  }
+
+  board = mmap(NULL, sizeof(struct DisplayShmBoard), PROT_READ, MAP_SHARED,
+               fd, 0);
+  close(fd);
+  if (board == MAP_FAILED) {
+    return NULL;
+  }
+
+  if (board->magic != DISPLAY_SHM_MAGIC ||
+      board->version != DISPLAY_SHM_VERSION) {
+    ttt_view_unmap(board);
+    errno = EPROTO;
+    return NULL;
+  }
+
+  return board;
+}
+
+static void ttt_view_unmap(const struct DisplayShmBoard *board) {
+  munmap((void *)board, sizeof(struct DisplayShmBoard));
+}
+
+// Seqlock read, sets sequence of the copied board. Returns EBUSY if no
+//  consistent copy was made within the retries.
+static int ttt_view_read(const struct DisplayShmBoard *shared,
+                         struct DisplayShmBoard *copy,
+                         uint_least64_t *sequence) {
+  atomic_uint_least64_t *shared_sequence =
+      (atomic_uint_least64_t *)&shared->sequence;
+  uint_least64_t before;
+  uint_least64_t after;
+
+  for (size_t retries = 0; retries < TTT_VIEW_READ_RETRIES_MAX; retries++) {
+    if (retries > 0) {
+      sched_yield();
+    }
+
+    before = atomic_load_explicit(shared_sequence, memory_order_acquire);
+    if (before & 1) {
+      continue;
+    }
+
+    copy->pid = shared->pid;
+    copy->game_state = shared->game_state;
+    copy->user_id = shared->user_id;
+    copy->board_xy = shared->board_xy;
+    copy->moves_count = shared->moves_count;
+    copy->cursor_x = shared->cursor_x;
+    copy->cursor_y = shared->cursor_y;
+    memcpy(copy->cells, shared->cells, sizeof(copy->cells));
+
+    atomic_thread_fence(memory_order_acquire);
+    after = atomic_load_explicit(shared_sequence, memory_order_relaxed);
+    if (before != after) {
+      continue;
+    }
+
+    if (copy->board_xy > DISPLAY_SHM_BOARD_XY_MAX) {
+      copy->board_xy = DISPLAY_SHM_BOARD_XY_MAX;
+    }
+
+    *sequence = before;
+
+    return 0;
+  }
+
+  return EBUSY;
+}
+
+// Game removes its segment on exit, but crashed one leaves it behind. Pid is
+//  written once before the segment is published, so it is read directly.
+static bool ttt_view_is_alive(const char *name,
+                              const struct DisplayShmBoard *shared) {
+  pid_t pid = shared->pid;
+  int fd;
+
+  fd = shm_open(name, O_RDONLY, 0);
+  if (fd == -1) {
+    return false;
+  }
+  close(fd);
+
+  if (pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH)) {
+    return true;
+  }
+
+  if (shm_unlink(name) == 0) {
+    fprintf(stderr, "Removed %s, its game (pid %d) is not running\n", name,
+            (int)pid);
+  }
+
+  return false;
+}
+
+static void ttt_view_print_board(const char *name,
+                                 const struct DisplayShmBoard *board) {
+  static const char users_chars[] = "xo+#@$%&*?";
+  const struct DisplayShmCell *cell;
+  char c;
+
+  printf("%s (pid %d): %s, user %d, %u moves\n", name, (int)board->pid,
+         ttt_view_state_name(board->game_state), board->user_id + 1,
+         board->moves_count);
+
+  for (uint32_t y = 0; y < board->board_xy; y++) {
+    for (uint32_t x = 0; x < board->board_xy; x++) {
+      cell = &board->cells[y][x];
+      c = ' ';
+      if (cell->flags & GAME_BOARD_CELL_TAKEN && cell->owner >= 0 &&
+          (size_t)cell->owner < sizeof(users_chars) - 1) {
+        c = users_chars[cell->owner];
+      } else if ((int32_t)x == board->cursor_x &&
+                 (int32_t)y == board->cursor_y) {
+        c = '.';
+      }
+
+      printf("%c%s", c, x + 1 < board->board_xy ? "|" : "\n");
+    }
+  }
+}
+
+static const char *ttt_view_state_name(uint32_t game_state) {
+  switch (game_state) {
+  case GameStatePlay:
+    return "playing";
+  case GameStateQuitting:
+    return "quitting";
+  case GameStateQuit:
+    return "quit";
+  case GameStateWinning:
+    return "winning";
+  case GameStateWin:
+    return "won";
+  default:
+    return "unknown";
+  }
+}
+
+static int ttt_view_list(void) {
+  const struct DisplayShmBoard *shared;
+  struct DisplayShmBoard board;
+  char name[TTT_VIEW_NAME_MAX];
+  uint_least64_t sequence;
+  struct dirent *entry;
+  size_t prefix_length;
+  size_t games = 0;
+  DIR *dir;
+
+  dir = opendir(TTT_VIEW_SHM_DIR);
+  if (!dir) {
+    perror(TTT_VIEW_SHM_DIR);
+    return 1;
+  }
+
+  // Default name is "/ttt", segments are named "ttt.<pid>" in the directory.
+  prefix_length = strlen(DISPLAY_SHM_NAME_DEFAULT) - 1;
+
+  while ((entry = readdir(dir))) {
+    if (strncmp(entry->d_name, DISPLAY_SHM_NAME_DEFAULT + 1, prefix_length) ||
+        entry->d_name[prefix_length] != '.') {
+      continue;
+    }
+
+    snprintf(name, sizeof(name), "/%s", entry->d_name);
+
+    shared = ttt_view_map(name);
+    if (!shared) {
+      continue;
+    }
+
+    if (!ttt_view_is_alive(name, shared)) {
+      ttt_view_unmap(shared);
+      continue;
+    }
+
+    if (ttt_view_read(shared, &board, &sequence)) {
+      printf("%s (pid %d): stale, board is not published\n", name,
+             (int)shared->pid);
+    } else {
+      ttt_view_print_board(name, &board);
+    }
+    ttt_view_unmap(shared);
+
+    games++;
+  }
+
+  closedir(dir);
+
+  if (games == 0) {
+    printf("No games found in %s\n", TTT_VIEW_SHM_DIR);
+  }
+
+  return 0;
+}
+
+static int ttt_view_follow(const char *name) {
+  struct timespec poll = {.tv_nsec = TTT_VIEW_POLL_NS};
+  const struct DisplayShmBoard *shared;
+  struct DisplayShmBoard board = {0};
+  struct DisplayShmBoard next;
+  uint_least64_t last_sequence = 1;
+  uint_least64_t sequence;
+  bool is_stale = false;
+  size_t polls = 0;
+
+  shared = ttt_view_map(name);
+  if (!shared) {
+    fprintf(stderr, "Unable to open %s: %s\n", name, strerror(errno));
+    return 1;
+  }
+
+  for (;;) {
+    // Board which can't be read stays on the screen until the next poll.
+    if (ttt_view_read(shared, &next, &sequence)) {
+      if (!is_stale) {
+        printf("Board is stale, game is not publishing\n");
+        fflush(stdout);
+        is_stale = true;
+      }
+    } else if (sequence != last_sequence || is_stale) {
+      board = next;
+      printf("\033[H\033[2J");
+      ttt_view_print_board(name, &board);
+      fflush(stdout);
+      last_sequence = sequence;
+      is_stale = false;
+    }
+
+    if (board.game_state == GameStateQuit) {
+      break;
+    }
+
+    // Mapping stays valid after the game is gone, but nothing will be
+    //  published anymore.
+    if (++polls % TTT_VIEW_ALIVE_CHECK_POLLS == 0 &&
+        !ttt_view_is_alive(name, shared)) {
+      break;
+    }
+
+    nanosleep(&poll, NULL);
+  }
+
+  ttt_view_unmap(shared);
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * @file ring_utils.c
+ * @brief Bounded queue passing items between threads.
+ *
+ * Slot is free for producer when its sequence equals producer's position
+ * and ready for consumer when it equals position + 1. Consumer hands the
+ * slot back by moving its sequence one lap forward.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#include <errno.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// App's internal libs
+#include "utils/ring_utils.h"
+
+/*******************************************************************************
+ *    API
+ ******************************************************************************/
+static int ring_utils_init(struct Ring *ring, size_t length,
+                             size_t item_size) {
+  if (!ring || length == 0 || (length & (length - 1)) || item_size == 0) {
+    return EINVAL;
+  }
+
+  ring->sequences = malloc(length * sizeof(atomic_size_t));
+  ring->items = malloc(length * item_size);
+  if (!ring->sequences || !ring->items) {
+    free(ring->sequences);
+    free(ring->items);
+    ring->sequences = NULL;
+    ring->items = NULL;
+    return ENOMEM;
+  }
+
+  atomic_store(&ring->push_position, 0);
+  ring->pop_position = 0;
+  ring->mask = length - 1;
+  ring->item_size = item_size;
+
+  for (size_t i = 0; i < length; i++) {
+    atomic_store(&ring->sequences[i], i);
+  }
+
+  return 0;
+}
+
+static void ring_utils_destroy(struct Ring *ring) {
+  if (!ring) {
+    return;
+  }
+
+  free(ring->sequences);
+  free(ring->items);
+  ring->sequences = NULL;
+  ring->items = NULL;
+}
+
+static int ring_utils_push(struct Ring *ring, const void *item) {
+  atomic_size_t *sequence;
+  size_t position;
+  size_t value;
+
+  position = atomic_load_explicit(&ring->push_position, memory_order_relaxed);
+
+  for (;;) {
+    sequence = &ring->sequences[position & ring->mask];
+    value = atomic_load_explicit(sequence, memory_order_acquire);
+
+    if (value == position) {
+      // On failure position is reloaded, so just try again.
+      if (atomic_compare_exchange_weak_explicit(
+              &ring->push_position, &position, position + 1,
+              memory_order_relaxed, memory_order_relaxed)) {
+        break;
+      }
+    } else if ((intptr_t)(value - position) < 0) {
+      // Slot still holds item from previous lap, consumer is behind.
+      return ENOBUFS;
+    } else {
+      position =
+          atomic_load_explicit(&ring->push_position, memory_order_relaxed);
+    }
+  }
+
+  memcpy(ring->items + (position & ring->mask) * ring->item_size, item,
+         ring->item_size);
+  atomic_store_explicit(sequence, position + 1, memory_order_release);
+
+  return 0;
+}
+
+static int ring_utils_pop(struct Ring *ring, void *item) {
+  size_t position = ring->pop_position;
+  atomic_size_t *sequence = &ring->sequences[position & ring->mask];
+
+  if (atomic_load_explicit(sequence, memory_order_acquire) != position + 1) {
+    return EAGAIN;
+  }
+
+  memcpy(item, ring->items + (position & ring->mask) * ring->item_size,
+         ring->item_size);
+  atomic_store_explicit(sequence, position + ring->mask + 1,
+                        memory_order_release);
+  ring->pop_position = position + 1;
+
+  return 0;
+}
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+static struct RingUtilsOps ring_utils_ops = {
+    .init = ring_utils_init,
+    .destroy = ring_utils_destroy,
+    .push = ring_utils_push,
+    .pop = ring_utils_pop,
+};
+
+struct RingUtilsOps *get_ring_utils_ops(void) { return &ring_utils_ops; }
@@ -0,0 +1,51 @@
+#ifndef RING_UTILS_H
+#define RING_UTILS_H
+/*******************************************************************************
+ * @file ring_utils.h
+ * @brief Bounded queue passing items between threads.
+ *
+ * Multiple producers claim slots with single compare and swap and the only
+ * consumer never touches producers' position, so pushing never waits for
+ * popping. Ring carries items of any size and every ring is its own struct,
+ * game's event queue is built on one, session server keeps one per
+ * matchmaking bucket and one per reactor for handoffs.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ *    PUBLIC API
+ ******************************************************************************/
+struct Ring {
+  // Producers and consumer touch different positions, keep them on
+  //  separate cache lines.
+  _Alignas(64) atomic_size_t push_position;
+  _Alignas(64) size_t pop_position;
+  size_t mask;
+  size_t item_size;
+  atomic_size_t *sequences;
+  uint8_t *items;
+};
+
+struct RingUtilsOps {
+  // Length has to be power of two.
+  int (*init)(struct Ring *ring, size_t length, size_t item_size);
+  void (*destroy)(struct Ring *ring);
+  // Returns ENOBUFS if ring is full, any thread may push.
+  int (*push)(struct Ring *ring, const void *item);
+  // Returns EAGAIN if ring is empty, only one thread may pop.
+  int (*pop)(struct Ring *ring, void *item);
+};
+
+/*******************************************************************************
+ *    MODULARITY BOILERCODE
+ ******************************************************************************/
+struct RingUtilsOps *get_ring_utils_ops(void);
+
+#endif // RING_UTILS_H
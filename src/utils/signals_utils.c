@@ -3,6 +3,8 @@
  * @brief Signal handling utilities to manage multiple callbacks for signals.
  ******************************************************************************/
 #define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE // SIGWINCH, SA_RESTART
+#include <errno.h>
 #include <signal.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -15,16 +17,20 @@
 #include "utils/signals_utils.h"
 
 #define MAX_SIGNAL_HANDLERS 10
+#define MAX_WINCH_HANDLERS 10
 
 typedef void (*signal_callback_t)(void);
 
 struct SignalsSubsystem {
   SARRS_FIELD(callbacks, signal_callback_t, MAX_SIGNAL_HANDLERS);
+  SARRS_FIELD(winch_callbacks, signal_callback_t, MAX_WINCH_HANDLERS);
 };
 
 typedef struct SignalsSubsystem SignalsSubsystem;
 
 SARRS_DECL(SignalsSubsystem, callbacks, signal_callback_t, MAX_SIGNAL_HANDLERS);
+SARRS_DECL(SignalsSubsystem, winch_callbacks, signal_callback_t,
+           MAX_WINCH_HANDLERS);
 
 SignalsSubsystem signals_subsystem;
 
@@ -53,6 +59,22 @@ static void signals_utils_signal_handler(int sig) {
   _exit(1); // Fallback: Ensure process terminates (shouldn't reach here)
 }
 
+static void signals_utils_winch_handler(int sig) {
+  signal_callback_t *callback;
+  int saved_errno = errno;
+
+  (void)sig;
+
+  for (size_t i = 0;
+       i < SignalsSubsystem_winch_callbacks_length(&signals_subsystem); ++i) {
+    SignalsSubsystem_winch_callbacks_get(&signals_subsystem, i, &callback);
+
+    (*callback)();
+  }
+
+  errno = saved_errno;
+}
+
 int signal_utils_add_handler(signal_callback_t callback) {
   int err;
 
@@ -64,7 +86,22 @@ int signal_utils_add_handler(signal_callback_t callback) {
   return 0;
 }
 
+int signal_utils_add_winch_handler(signal_callback_t callback) {
+  signal_callback_t *registered;
+
+  for (size_t i = 0;
+       i < SignalsSubsystem_winch_callbacks_length(&signals_subsystem); ++i) {
+    SignalsSubsystem_winch_callbacks_get(&signals_subsystem, i, &registered);
+    if (*registered == callback) {
+      return 0;
+    }
+  }
+
+  return SignalsSubsystem_winch_callbacks_append(&signals_subsystem, callback);
+}
+
 static int signal_utils_register_signals(void) {
+  struct sigaction winch_sa;
   struct sigaction sa;
 
   sa.sa_handler = signals_utils_signal_handler;
@@ -72,6 +109,9 @@ static int signal_utils_register_signals(void) {
       SA_RESETHAND | SA_NODEFER; // Reset the handler and allow nested signals
   sigemptyset(&sa.sa_mask);
 
+  SignalsSubsystem_callbacks_init(&signals_subsystem);
+  SignalsSubsystem_winch_callbacks_init(&signals_subsystem);
+
   atexit(signals_utils_execute_callbacks);
 
   // Hardcoded signals to register
@@ -84,12 +124,25 @@ static int signal_utils_register_signals(void) {
     }
   }
 
+  // Terminal resize is not fatal, handler only notifies interested modules.
+  //  Interrupted syscalls are restarted so resize does not break blocking
+  //  reads of other modules.
+  winch_sa.sa_handler = signals_utils_winch_handler;
+  winch_sa.sa_flags = SA_RESTART;
+  sigemptyset(&winch_sa.sa_mask);
+
+  if (sigaction(SIGWINCH, &winch_sa, NULL) == -1) {
+    perror("sigaction");
+    return -1;
+  }
+
   return 0;
 }
 
 static struct SignalUtilsOps signal_utils_ops = {
     .init = signal_utils_register_signals,
     .add_handler = signal_utils_add_handler,
+    .add_winch_handler = signal_utils_add_winch_handler,
 };
 
 struct SignalUtilsOps *get_signal_utils_ops(void) {
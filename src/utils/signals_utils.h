@@ -19,6 +19,10 @@ typedef void (*signal_callback_t)(void);
 struct SignalUtilsOps {
   int (*init)(void);
   int (*add_handler)(signal_callback_t callback);
+  // Callbacks for SIGWINCH run directly in the signal handler, so they have
+  //  to be async-signal-safe. Callback which is already registered is not
+  //  added again, so modules may register on every start.
+  int (*add_winch_handler)(signal_callback_t callback);
 };
 
 struct SignalUtilsOps *get_signal_utils_ops(void);
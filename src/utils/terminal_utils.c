@@ -3,6 +3,7 @@
  * @brief Terminal settings utility functions using the Ops pattern
  ******************************************************************************/
 #include <errno.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -15,6 +16,18 @@
 // Static storage for original terminal settings
 static struct termios original_termios;
 
+// Cached terminal dimensions, generation is bumped from signal handler so
+//  it has to be sig_atomic_t.
+struct TerminalDimensionsCache {
+  int rows;
+  int cols;
+  unsigned int generation;
+  volatile sig_atomic_t current_generation;
+};
+
+static struct TerminalDimensionsCache dimensions_cache = {
+    .generation = 0, .current_generation = 1};
+
 // Function to disable canonical mode
 static int disable_canonical_mode(int fd) {
   struct termios new_termios;
@@ -134,6 +147,40 @@ static int get_terminal_dimensions(int fd, int *rows, int *cols) {
   return 0; // Success
 }
 
+// Function to get terminal dimensions without syscall if nothing changed
+static int get_cached_terminal_dimensions(int fd, int *rows, int *cols) {
+  unsigned int generation = dimensions_cache.current_generation;
+  int err;
+
+  if (dimensions_cache.generation != generation) {
+    err = get_terminal_dimensions(fd, &dimensions_cache.rows,
+                                  &dimensions_cache.cols);
+    if (err) {
+      return err;
+    }
+
+    dimensions_cache.generation = generation;
+  }
+
+  if (rows) {
+    *rows = dimensions_cache.rows;
+  }
+  if (cols) {
+    *cols = dimensions_cache.cols;
+  }
+
+  return 0; // Success
+}
+
+// Function to mark cached terminal dimensions as outdated
+static void invalidate_terminal_dimensions(void) {
+  dimensions_cache.current_generation++;
+}
+
+static unsigned int get_terminal_generation(void) {
+  return dimensions_cache.current_generation;
+}
+
 // Terminal operations instance
 static struct TerminalUtilsOps terminal_ops = {
     .disable_canonical_mode = disable_canonical_mode,
@@ -141,7 +188,10 @@ static struct TerminalUtilsOps terminal_ops = {
     .disable_echo = disable_echo,
     .enable_echo = enable_echo,
     .restore_settings = restore_settings,
-    .get_terminal_dimensions = get_terminal_dimensions};
+    .get_terminal_dimensions = get_terminal_dimensions,
+    .get_cached_terminal_dimensions = get_cached_terminal_dimensions,
+    .invalidate_terminal_dimensions = invalidate_terminal_dimensions,
+    .get_terminal_generation = get_terminal_generation};
 
 // Returns the terminal operations instance
 struct TerminalUtilsOps *get_terminal_ops(void) {
@@ -16,6 +16,13 @@ struct TerminalUtilsOps {
   int (*enable_canonical_mode)(int fd);
   int (*disable_canonical_mode)(int fd);
   int (*get_terminal_dimensions)(int fd, int *rows, int *cols);
+  // Same as get_terminal_dimensions but queries the terminal only after
+  //  invalidate_terminal_dimensions, otherwise last result is returned.
+  int (*get_cached_terminal_dimensions)(int fd, int *rows, int *cols);
+  // Async-signal-safe, meant to be called on SIGWINCH.
+  void (*invalidate_terminal_dimensions)(void);
+  // Changes each time cached dimensions are invalidated.
+  unsigned int (*get_terminal_generation)(void);
 };
 
 // Returns the terminal operations instance
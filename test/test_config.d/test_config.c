@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200809L // setenv
 #include <errno.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -141,3 +142,54 @@ void test_config_get_var_failure_invalid_id() {
   // Assert failure due to invalid ID
   TEST_ASSERT_EQUAL_INT(ENOENT, err);
 }
+
+// Test Reading Variable Default Value
+void test_config_read_var_default_value() {
+  char value[CONFIG_VARIABLE_MAX];
+  int err;
+
+  unsetenv(TEST_VAR_NAME);
+
+  err = config_ops->read_var(TEST_VAR_NAME, TEST_DEFAULT_VALUE, value,
+                             sizeof(value));
+
+  TEST_ASSERT_EQUAL_INT(0, err);
+  TEST_ASSERT_EQUAL_STRING(TEST_DEFAULT_VALUE, value);
+}
+
+// Test Reading Variable Set In Environment
+void test_config_read_var_env_value() {
+  struct ConfigGetVarOutput get_output;
+  char value[CONFIG_VARIABLE_MAX];
+  int err;
+
+  setenv(TEST_VAR_NAME, "env_value", 1);
+
+  err = config_ops->read_var(TEST_VAR_NAME, TEST_DEFAULT_VALUE, value,
+                             sizeof(value));
+  unsetenv(TEST_VAR_NAME);
+
+  TEST_ASSERT_EQUAL_INT(0, err);
+  TEST_ASSERT_EQUAL_STRING("env_value", value);
+
+  // Variable stays registered, so it can be looked up by name.
+  err = config_ops->get_var(
+      (struct ConfigGetVarInput){.mode = CONFIG_GET_VAR_BY_NAME,
+                                 .var_name = TEST_VAR_NAME},
+      &get_output);
+  TEST_ASSERT_EQUAL_INT(0, err);
+}
+
+// Test Reading Variable Into Too Small Buffer
+void test_config_read_var_failure_too_long() {
+  char value[4] = "abc";
+  int err;
+
+  unsetenv(TEST_VAR_NAME);
+
+  err = config_ops->read_var(TEST_VAR_NAME, TEST_DEFAULT_VALUE, value,
+                             sizeof(value));
+
+  TEST_ASSERT_EQUAL_INT(ENAMETOOLONG, err);
+  TEST_ASSERT_EQUAL_STRING("abc", value);
+}
@@ -2,7 +2,11 @@
  *    IMPORTS
  ******************************************************************************/
 // C standard library
+#define _POSIX_C_SOURCE 200809L // setenv
+#include <signal.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 
 // Tests framework
@@ -10,83 +14,101 @@
 
 // App's internal libs
 #include "display/cli.h"
-#include "game/game.h"
-#include "game/game_state_machine/sub_state_machines/user_move_sm_module.h"
+#include "display/display.h"
 #include "init/init.h"
-#include "utils/logging_utils.h"
-
-// Mocks requirement
-#include "cli_display_wrapper.h"
 
 /*******************************************************************************
  *    PRIVATE DECLARATIONS & DEFINITIONS
  ******************************************************************************/
-struct CliDisplayPrivateOps *cli_display_ops;
+#define BOARD_XY 3
+#define FRAME_MAX 4096
+
+struct TappedFrame {
+  size_t frames;
+  size_t length;
+  bool is_full;
+  char buffer[FRAME_MAX];
+};
+
+static struct DisplayOps *display_ops;
+static struct GameBoardCell cells[GAME_BOARD_XY_MAX][GAME_BOARD_XY_MAX];
+static struct TappedFrame tapped_frame;
+
+static int tap_frame(const char *buffer, size_t length, size_t rows,
+                     size_t cols, bool is_full) {
+  (void)rows;
+  (void)cols;
+
+  tapped_frame.frames++;
+  tapped_frame.is_full = is_full;
+  tapped_frame.length = length < FRAME_MAX - 1 ? length : FRAME_MAX - 1;
+  memcpy(tapped_frame.buffer, buffer, tapped_frame.length);
+  tapped_frame.buffer[tapped_frame.length] = 0;
+
+  return 0;
+}
+
+static void display_board(void) {
+  TEST_ASSERT_EQUAL_INT(
+      0, display_ops->display(&(struct DisplayData){
+             .game_state = GameStatePlay,
+             .user_id = 0,
+             .cells = (const struct GameBoardCell(*)[GAME_BOARD_XY_MAX])cells,
+             .board_xy = BOARD_XY}));
+}
 
 /*******************************************************************************
  *    TESTS FRAMEWORK BOILERCODE
  ******************************************************************************/
-void setUp() {
-  struct InitOps *init_ops = get_init_ops();
-  init_game_reg.init = NULL;
-  init_game_reg.destroy = NULL;
-  init_ops->initialize_system();
+void setUp(void) {
+  setenv("display", DISPLAY_CLI_NAME, 1);
+  setenv(DISPLAY_CLI_RENDERER_VAR_NAME, DISPLAY_CLI_RENDERER_FRAME, 1);
 
-  cli_display_ops = get_display_cli_ops()->private_ops;
-}
+  TEST_ASSERT_EQUAL_INT(0, get_init_ops()->initialize());
+
+  display_ops = get_display_ops();
+  memset(cells, 0, sizeof(cells));
+  memset(&tapped_frame, 0, sizeof(tapped_frame));
 
-void tearDown() {
-  struct InitOps *init_ops = get_init_ops();
-  init_ops->destroy_system();
+  TEST_ASSERT_EQUAL_INT(0, get_display_cli_ops()->add_frame_tap(tap_frame));
 }
 
+void tearDown(void) { get_init_ops()->destroy(); }
+
 /*******************************************************************************
  *    TESTS
  ******************************************************************************/
+void test_cli_first_frame_is_full(void) {
+  display_board();
 
-void test_cli_sort_user_moves_empty_array(void) {
-  struct UserMove user_moves[1] = {}; // Empty array
-  cli_display_ops->sort_user_moves(0, user_moves);
-  TEST_PASS_MESSAGE("Empty array handled correctly.");
+  TEST_ASSERT_EQUAL_size_t(1, tapped_frame.frames);
+  TEST_ASSERT_TRUE(tapped_frame.is_full);
+  TEST_ASSERT_NOT_NULL(strstr(tapped_frame.buffer, "Current user"));
 }
 
-void test_cli_sort_user_moves_single_element(void) {
-  struct UserMove user_moves[1] = {{.coordinates = {2, 1}}};
-  cli_display_ops->sort_user_moves(1, user_moves);
-  TEST_ASSERT_EQUAL_INT(2, user_moves[0].coordinates[0]);
-  TEST_ASSERT_EQUAL_INT(1, user_moves[0].coordinates[1]);
-}
+void test_cli_unchanged_board_sends_only_diff(void) {
+  size_t full_length;
 
-void test_cli_sort_user_moves_sorted_array(void) {
-  struct UserMove user_moves[3] = {{.coordinates = {1, 0}},
-                                   {.coordinates = {2, 0}},
-                                   {.coordinates = {3, 0}}};
-  cli_display_ops->sort_user_moves(3, user_moves);
-  TEST_ASSERT_EQUAL_INT(1, user_moves[0].coordinates[0]);
-  TEST_ASSERT_EQUAL_INT(2, user_moves[1].coordinates[0]);
-  TEST_ASSERT_EQUAL_INT(3, user_moves[2].coordinates[0]);
-}
+  display_board();
+  full_length = tapped_frame.length;
+
+  cells[1][1] = (struct GameBoardCell){.owner = 0,
+                                       .flags = GAME_BOARD_CELL_TAKEN};
+  display_board();
 
-void test_cli_sort_user_moves_unsorted_array(void) {
-  struct UserMove user_moves[3] = {{.coordinates = {3, 0}},
-                                   {.coordinates = {1, 0}},
-                                   {.coordinates = {2, 0}}};
-  cli_display_ops->sort_user_moves(3, user_moves);
-  TEST_ASSERT_EQUAL_INT(1, user_moves[0].coordinates[0]);
-  TEST_ASSERT_EQUAL_INT(2, user_moves[1].coordinates[0]);
-  TEST_ASSERT_EQUAL_INT(3, user_moves[2].coordinates[0]);
+  TEST_ASSERT_EQUAL_size_t(2, tapped_frame.frames);
+  TEST_ASSERT_FALSE(tapped_frame.is_full);
+  TEST_ASSERT_TRUE(tapped_frame.length < full_length);
 }
 
-void test_cli_sort_user_moves_with_duplicates(void) {
-  struct UserMove user_moves[5] = {{.coordinates = {3, 0}},
-                                   {.coordinates = {1, 0}},
-                                   {.coordinates = {2, 0}},
-                                   {.coordinates = {2, 1}},
-                                   {.coordinates = {3, 1}}};
-  cli_display_ops->sort_user_moves(5, user_moves);
-  TEST_ASSERT_EQUAL_INT(1, user_moves[0].coordinates[0]);
-  TEST_ASSERT_EQUAL_INT(2, user_moves[1].coordinates[0]);
-  TEST_ASSERT_EQUAL_INT(2, user_moves[2].coordinates[0]);
-  TEST_ASSERT_EQUAL_INT(3, user_moves[3].coordinates[0]);
-  TEST_ASSERT_EQUAL_INT(3, user_moves[4].coordinates[0]);
+void test_cli_resize_forces_full_redraw(void) {
+  display_board();
+  display_board();
+  TEST_ASSERT_FALSE(tapped_frame.is_full);
+
+  raise(SIGWINCH);
+  display_board();
+
+  TEST_ASSERT_EQUAL_size_t(3, tapped_frame.frames);
+  TEST_ASSERT_TRUE(tapped_frame.is_full);
 }
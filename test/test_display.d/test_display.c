@@ -0,0 +1,143 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#define _POSIX_C_SOURCE 200809L // setenv, nanosleep
+#include <errno.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Tests framework
+#include <unity.h>
+
+// App's internal libs
+#include "display/display.h"
+#include "display/null.h"
+#include "init/init.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define BOARD_XY 3
+// Render threads get up to a second to catch up.
+#define WAIT_RETRIES_MAX 1000
+
+static struct DisplayNullOps *null_ops;
+static struct DisplayOps *display_ops;
+static struct GameBoardCell cells[GAME_BOARD_XY_MAX][GAME_BOARD_XY_MAX];
+
+static int display_board(void) {
+  return display_ops->display(&(struct DisplayData){
+      .game_state = GameStatePlay,
+      .user_id = 0,
+      .cells = (const struct GameBoardCell(*)[GAME_BOARD_XY_MAX])cells,
+      .board_xy = BOARD_XY});
+}
+
+static size_t get_counted_frames(void) {
+  struct DisplayCountingStats stats;
+
+  null_ops->get_counting_stats(&stats);
+
+  return stats.frames;
+}
+
+static size_t wait_for_frames(size_t frames) {
+  struct timespec delay = {.tv_nsec = 1000000};
+
+  for (size_t i = 0; i < WAIT_RETRIES_MAX; i++) {
+    if (get_counted_frames() >= frames) {
+      break;
+    }
+    nanosleep(&delay, NULL);
+  }
+
+  return get_counted_frames();
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp(void) {
+  setenv("display", DISPLAY_COUNTING_NAME, 1);
+
+  TEST_ASSERT_EQUAL_INT(0, get_init_ops()->initialize());
+
+  null_ops = get_display_null_ops();
+  display_ops = get_display_ops();
+  memset(cells, 0, sizeof(cells));
+}
+
+void tearDown(void) { get_init_ops()->destroy(); }
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_display_renders_synchronously_before_start(void) {
+  TEST_ASSERT_EQUAL_INT(0, display_board());
+  TEST_ASSERT_EQUAL_size_t(1, get_counted_frames());
+}
+
+void test_display_rejects_invalid_data(void) {
+  TEST_ASSERT_EQUAL_INT(EINVAL, display_ops->display(NULL));
+  TEST_ASSERT_EQUAL_INT(
+      EINVAL, display_ops->display(&(struct DisplayData){
+                  .user_id = 0, .cells = NULL, .board_xy = BOARD_XY}));
+  TEST_ASSERT_EQUAL_size_t(0, get_counted_frames());
+}
+
+void test_display_every_active_display_gets_frame(void) {
+  int display_id;
+
+  TEST_ASSERT_EQUAL_INT(
+      0, display_ops->get_display_id(DISPLAY_NULL_NAME, &display_id));
+  TEST_ASSERT_EQUAL_INT(0, display_ops->activate_display(display_id));
+
+  TEST_ASSERT_EQUAL_INT(0, display_ops->start());
+  TEST_ASSERT_EQUAL_INT(0, display_board());
+  display_ops->stop();
+
+  TEST_ASSERT_EQUAL_size_t(1, get_counted_frames());
+}
+
+void test_display_redraws_on_resize(void) {
+  TEST_ASSERT_EQUAL_INT(0, display_ops->start());
+  TEST_ASSERT_EQUAL_INT(0, display_board());
+  TEST_ASSERT_EQUAL_size_t(1, wait_for_frames(1));
+
+  raise(SIGWINCH);
+  TEST_ASSERT_EQUAL_size_t(2, wait_for_frames(2));
+
+  raise(SIGWINCH);
+  TEST_ASSERT_EQUAL_size_t(3, wait_for_frames(3));
+
+  display_ops->stop();
+}
+
+void test_display_resize_after_stop_is_ignored(void) {
+  TEST_ASSERT_EQUAL_INT(0, display_ops->start());
+  TEST_ASSERT_EQUAL_INT(0, display_board());
+  display_ops->stop();
+
+  TEST_ASSERT_EQUAL_size_t(1, get_counted_frames());
+
+  raise(SIGWINCH);
+
+  TEST_ASSERT_EQUAL_size_t(1, get_counted_frames());
+
+  // Handler is registered once, restarted renderer redraws once per resize.
+  //  Counting display starts every game from zero.
+  TEST_ASSERT_EQUAL_INT(0, display_ops->start());
+  TEST_ASSERT_EQUAL_INT(0, display_board());
+  TEST_ASSERT_EQUAL_size_t(1, wait_for_frames(1));
+
+  raise(SIGWINCH);
+  TEST_ASSERT_EQUAL_size_t(2, wait_for_frames(2));
+
+  display_ops->stop();
+
+  TEST_ASSERT_EQUAL_size_t(2, get_counted_frames());
+}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#define _POSIX_C_SOURCE 200809L // setenv
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tests framework
+#include <unity.h>
+
+// App's internal libs
+#include "display/display.h"
+#include "display/null.h"
+#include "init/init.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define BOARD_XY 3
+#define FRAMES_AMOUNT 50
+
+static struct DisplayNullOps *null_ops;
+static struct DisplayOps *display_ops;
+static struct GameBoardCell cells[GAME_BOARD_XY_MAX][GAME_BOARD_XY_MAX];
+
+static void display_board(enum GameStates game_state, int user_id) {
+  TEST_ASSERT_EQUAL_INT(
+      0, display_ops->display(&(struct DisplayData){
+             .game_state = game_state,
+             .user_id = user_id,
+             .cells = (const struct GameBoardCell(*)[GAME_BOARD_XY_MAX])cells,
+             .board_xy = BOARD_XY}));
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp(void) {
+  setenv("display", DISPLAY_COUNTING_NAME, 1);
+
+  TEST_ASSERT_EQUAL_INT(0, get_init_ops()->initialize());
+
+  null_ops = get_display_null_ops();
+  display_ops = get_display_ops();
+  memset(cells, 0, sizeof(cells));
+}
+
+void tearDown(void) { get_init_ops()->destroy(); }
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_counting_counts_frames_and_bytes(void) {
+  // Player info line and board, every cell followed by a separator.
+  const size_t frame_bytes =
+      strlen("Current user: 1=x\n\n") + BOARD_XY * BOARD_XY * 2;
+  struct DisplayCountingStats stats;
+
+  for (size_t i = 0; i < FRAMES_AMOUNT; i++) {
+    display_board(GameStatePlay, 0);
+  }
+
+  null_ops->get_counting_stats(&stats);
+
+  TEST_ASSERT_EQUAL_size_t(FRAMES_AMOUNT, stats.frames);
+  TEST_ASSERT_EQUAL_size_t(FRAMES_AMOUNT * frame_bytes, stats.bytes);
+}
+
+void test_counting_counts_quitting_frame_as_one_line(void) {
+  struct DisplayCountingStats stats;
+
+  display_board(GameStateQuitting, 1);
+
+  null_ops->get_counting_stats(&stats);
+
+  TEST_ASSERT_EQUAL_size_t(1, stats.frames);
+  TEST_ASSERT_EQUAL_size_t(strlen("User 2 quitting. To quit press q.\n"),
+                           stats.bytes);
+}
+
+void test_counting_counts_frames_rendered_on_thread(void) {
+  struct DisplayCountingStats stats;
+
+  TEST_ASSERT_EQUAL_INT(0, display_ops->start());
+  for (size_t i = 0; i < FRAMES_AMOUNT; i++) {
+    display_board(GameStatePlay, 0);
+  }
+  display_ops->stop();
+
+  // Render thread keeps only the newest frame, but the last one is always
+  //  drawn.
+  null_ops->get_counting_stats(&stats);
+
+  TEST_ASSERT_TRUE(stats.frames > 0);
+  TEST_ASSERT_TRUE(stats.frames <= FRAMES_AMOUNT);
+  TEST_ASSERT_EQUAL_size_t(stats.frames * (stats.bytes / stats.frames),
+                           stats.bytes);
+}
+
+void test_counting_starts_from_zero_every_game(void) {
+  struct DisplayCountingStats stats;
+
+  display_board(GameStatePlay, 0);
+  display_board(GameStatePlay, 0);
+
+  get_init_ops()->destroy();
+  TEST_ASSERT_EQUAL_INT(0, get_init_ops()->initialize());
+
+  null_ops->get_counting_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(0, stats.frames);
+  TEST_ASSERT_EQUAL_size_t(0, stats.bytes);
+
+  display_board(GameStatePlay, 0);
+
+  null_ops->get_counting_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(1, stats.frames);
+}
+
+void test_counting_starts_from_zero_after_restart(void) {
+  struct DisplayCountingStats stats;
+
+  // Display stays opened between games, only renderer is restarted.
+  TEST_ASSERT_EQUAL_INT(0, display_ops->start());
+  display_board(GameStatePlay, 0);
+  display_board(GameStatePlay, 0);
+  display_ops->stop();
+
+  null_ops->get_counting_stats(&stats);
+  TEST_ASSERT_TRUE(stats.frames > 0);
+
+  TEST_ASSERT_EQUAL_INT(0, display_ops->start());
+
+  null_ops->get_counting_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(0, stats.frames);
+  TEST_ASSERT_EQUAL_size_t(0, stats.bytes);
+
+  display_board(GameStatePlay, 0);
+  display_ops->stop();
+
+  null_ops->get_counting_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(1, stats.frames);
+}
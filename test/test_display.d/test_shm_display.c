@@ -0,0 +1,243 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// C standard library
+#define _POSIX_C_SOURCE 200809L // setenv, shm_open
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Tests framework
+#include <unity.h>
+
+// App's internal libs
+#include "display/display.h"
+#include "display/shm.h"
+#include "init/init.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define SHM_NAME "/ttt_test_shm_display"
+#define BOARD_XY 5
+#define FRAMES_AMOUNT 2000
+#define READ_RETRIES_MAX 100000
+
+struct SegmentReader {
+  const struct DisplayShmBoard *shared;
+  atomic_bool is_stopping;
+  size_t reads;
+  size_t torn_reads;
+};
+
+static struct DisplayOps *display_ops;
+static struct GameBoardCell cells[GAME_BOARD_XY_MAX][GAME_BOARD_XY_MAX];
+
+static void display_board(int user_id, struct UserMoveCoordinates cursor) {
+  TEST_ASSERT_EQUAL_INT(
+      0, display_ops->display(&(struct DisplayData){
+             .game_state = GameStatePlay,
+             .user_id = user_id,
+             .cells = (const struct GameBoardCell(*)[GAME_BOARD_XY_MAX])cells,
+             .board_xy = BOARD_XY,
+             .cursor = cursor}));
+}
+
+static const struct DisplayShmBoard *map_segment(void) {
+  char name[64];
+  void *shared;
+  int fd;
+
+  snprintf(name, sizeof(name), "%s.%d", SHM_NAME, (int)getpid());
+
+  fd = shm_open(name, O_RDONLY, 0);
+  TEST_ASSERT_NOT_EQUAL(-1, fd);
+
+  shared = mmap(NULL, sizeof(struct DisplayShmBoard), PROT_READ, MAP_SHARED,
+                fd, 0);
+  close(fd);
+  TEST_ASSERT_NOT_EQUAL(MAP_FAILED, shared);
+
+  return shared;
+}
+
+static void unmap_segment(const struct DisplayShmBoard *shared) {
+  munmap((void *)shared, sizeof(struct DisplayShmBoard));
+}
+
+// Same protocol as external viewers use, see shm.h.
+static bool read_segment(const struct DisplayShmBoard *shared,
+                         struct DisplayShmBoard *copy) {
+  uint_least64_t before, after;
+
+  for (size_t i = 0; i < READ_RETRIES_MAX; i++) {
+    before = atomic_load_explicit(
+        (atomic_uint_least64_t *)&shared->sequence, memory_order_acquire);
+    if (before & 1) {
+      sched_yield();
+      continue;
+    }
+
+    memcpy(copy, shared, sizeof(struct DisplayShmBoard));
+    atomic_thread_fence(memory_order_acquire);
+
+    after = atomic_load_explicit((atomic_uint_least64_t *)&shared->sequence,
+                                 memory_order_relaxed);
+    if (before == after) {
+      copy->sequence = before;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Every published board is owned in whole by the current user, so copy
+//  mixing two frames shows up as cell with other owner.
+static void *read_segment_thread(void *arg) {
+  struct SegmentReader *reader = arg;
+  struct DisplayShmBoard copy;
+
+  while (!atomic_load(&reader->is_stopping)) {
+    if (read_segment(reader->shared, &copy) && copy.board_xy == BOARD_XY) {
+      reader->reads++;
+      for (size_t y = 0; y < BOARD_XY; y++) {
+        for (size_t x = 0; x < BOARD_XY; x++) {
+          if (copy.cells[y][x].owner != copy.user_id) {
+            reader->torn_reads++;
+          }
+        }
+      }
+    }
+
+    sched_yield();
+  }
+
+  return NULL;
+}
+
+static void fill_board(int owner) {
+  for (size_t y = 0; y < BOARD_XY; y++) {
+    for (size_t x = 0; x < BOARD_XY; x++) {
+      cells[y][x] = (struct GameBoardCell){.owner = owner,
+                                           .flags = GAME_BOARD_CELL_TAKEN};
+    }
+  }
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp(void) {
+  setenv("display", DISPLAY_SHM_NAME, 1);
+  setenv(DISPLAY_SHM_NAME_VAR_NAME, SHM_NAME, 1);
+
+  TEST_ASSERT_EQUAL_INT(0, get_init_ops()->initialize());
+
+  display_ops = get_display_ops();
+  memset(cells, 0, sizeof(cells));
+}
+
+void tearDown(void) { get_init_ops()->destroy(); }
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_shm_published_board_reads_back(void) {
+  const struct DisplayShmBoard *shared;
+  struct DisplayShmBoard copy;
+
+  cells[0][0] = (struct GameBoardCell){.owner = 0,
+                                       .flags = GAME_BOARD_CELL_TAKEN};
+  cells[2][3] = (struct GameBoardCell){.owner = 1,
+                                       .flags = GAME_BOARD_CELL_TAKEN};
+  cells[4][4] = (struct GameBoardCell){.owner = 0,
+                                       .flags = GAME_BOARD_CELL_HIGHLIGHT};
+  display_board(1, (struct UserMoveCoordinates){.x = 3, .y = 2});
+
+  shared = map_segment();
+  TEST_ASSERT_TRUE(read_segment(shared, &copy));
+
+  TEST_ASSERT_EQUAL_UINT32(DISPLAY_SHM_MAGIC, copy.magic);
+  TEST_ASSERT_EQUAL_UINT32(DISPLAY_SHM_VERSION, copy.version);
+  TEST_ASSERT_EQUAL_INT(getpid(), copy.pid);
+  TEST_ASSERT_EQUAL_UINT64(2, copy.sequence);
+  TEST_ASSERT_EQUAL_UINT32(GameStatePlay, copy.game_state);
+  TEST_ASSERT_EQUAL_INT(1, copy.user_id);
+  TEST_ASSERT_EQUAL_UINT32(BOARD_XY, copy.board_xy);
+  TEST_ASSERT_EQUAL_UINT32(2, copy.moves_count);
+  TEST_ASSERT_EQUAL_INT(3, copy.cursor_x);
+  TEST_ASSERT_EQUAL_INT(2, copy.cursor_y);
+
+  for (size_t y = 0; y < BOARD_XY; y++) {
+    for (size_t x = 0; x < BOARD_XY; x++) {
+      TEST_ASSERT_EQUAL_INT(cells[y][x].owner, copy.cells[y][x].owner);
+      TEST_ASSERT_EQUAL_UINT32(cells[y][x].flags, copy.cells[y][x].flags);
+    }
+  }
+
+  unmap_segment(shared);
+}
+
+void test_shm_every_frame_advances_sequence(void) {
+  const struct DisplayShmBoard *shared;
+  struct DisplayShmBoard copy;
+
+  display_board(0, (struct UserMoveCoordinates){0});
+  shared = map_segment();
+
+  for (int i = 1; i <= 10; i++) {
+    fill_board(i);
+    display_board(i, (struct UserMoveCoordinates){0});
+
+    TEST_ASSERT_TRUE(read_segment(shared, &copy));
+    TEST_ASSERT_EQUAL_UINT64(2 * (i + 1), copy.sequence);
+    TEST_ASSERT_EQUAL_INT(i, copy.user_id);
+    TEST_ASSERT_EQUAL_UINT32(BOARD_XY * BOARD_XY, copy.moves_count);
+  }
+
+  unmap_segment(shared);
+}
+
+void test_shm_reader_never_sees_torn_board(void) {
+  struct SegmentReader reader = {0};
+  struct DisplayShmBoard copy;
+  pthread_t thread;
+
+  // Segment is created by the first frame.
+  display_board(0, (struct UserMoveCoordinates){0});
+  reader.shared = map_segment();
+
+  TEST_ASSERT_EQUAL_INT(
+      0, pthread_create(&thread, NULL, read_segment_thread, &reader));
+  TEST_ASSERT_EQUAL_INT(0, display_ops->start());
+
+  for (int i = 0; i < FRAMES_AMOUNT; i++) {
+    fill_board(i);
+    display_board(i, (struct UserMoveCoordinates){0});
+    if (i % 16 == 0) {
+      sched_yield();
+    }
+  }
+
+  // Stop draws the newest frame before render thread exits.
+  display_ops->stop();
+  atomic_store(&reader.is_stopping, true);
+  pthread_join(thread, NULL);
+
+  TEST_ASSERT_TRUE(reader.reads > 0);
+  TEST_ASSERT_EQUAL_size_t(0, reader.torn_reads);
+
+  TEST_ASSERT_TRUE(read_segment(reader.shared, &copy));
+  TEST_ASSERT_EQUAL_INT(FRAMES_AMOUNT - 1, copy.user_id);
+
+  unmap_segment(reader.shared);
+}
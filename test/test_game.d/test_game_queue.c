@@ -0,0 +1,197 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <unity.h>
+
+// App's internal libs
+#include "game/game_queue.h"
+#include "input/input_common.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define PRODUCERS_AMOUNT 4
+#define PRODUCER_EVENTS_AMOUNT 10000
+#define BURST_EVENTS_AMOUNT (GAME_QUEUE_LENGTH_MAX * 3 + 7)
+
+static struct LoggingUtilsOps *logging_ops;
+static struct GameQueueOps *game_queue_ops;
+static enum InputEvents burst_events[BURST_EVENTS_AMOUNT];
+
+static void *producer_thread(void *data) {
+  input_device_id_t device_id = (input_device_id_t)(size_t)data;
+  enum InputEvents input_event;
+
+  for (size_t i = 0; i < PRODUCER_EVENTS_AMOUNT; i++) {
+    input_event = INPUT_EVENT_UP + i % (INPUT_EVENT_EXIT - INPUT_EVENT_UP + 1);
+
+    // Consumer runs concurrently, so full queue only means retry.
+    while (game_queue_ops->push(input_event, device_id) == ENOBUFS)
+      ;
+  }
+
+  return NULL;
+}
+
+static void *burst_producer_thread(void *data) {
+  (void)data;
+
+  for (size_t i = 0; i < BURST_EVENTS_AMOUNT; i++) {
+    burst_events[i] =
+        INPUT_EVENT_UP + i % (INPUT_EVENT_EXIT - INPUT_EVENT_UP + 1);
+  }
+
+  return (void *)(size_t)game_queue_ops->push_batch(burst_events,
+                                                    BURST_EVENTS_AMOUNT, 1);
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() {
+  logging_ops = get_logging_utils_ops();
+  game_queue_ops = get_game_queue_ops();
+
+  logging_ops->init();
+
+  TEST_ASSERT_EQUAL_INT(0, game_queue_ops->init());
+}
+
+void tearDown() {
+  game_queue_ops->destroy();
+  logging_ops->destroy();
+}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_game_queue_keeps_order(void) {
+  enum InputEvents input_events[] = {INPUT_EVENT_LEFT, INPUT_EVENT_SELECT,
+                                     INPUT_EVENT_EXIT};
+  struct GameQueueEvent events[8];
+  size_t length;
+
+  TEST_ASSERT_EQUAL_INT(0, game_queue_ops->push(INPUT_EVENT_UP, 1));
+  TEST_ASSERT_EQUAL_INT(0, game_queue_ops->push_batch(input_events, 3, 2));
+
+  length = game_queue_ops->pop(events, 8);
+  TEST_ASSERT_EQUAL_size_t(4, length);
+
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, events[0].input_event);
+  TEST_ASSERT_EQUAL_INT(1, events[0].device_id);
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL_INT(input_events[i], events[i + 1].input_event);
+    TEST_ASSERT_EQUAL_INT(2, events[i + 1].device_id);
+  }
+  TEST_ASSERT_TRUE(events[0].timestamp_ns <= events[1].timestamp_ns);
+
+  TEST_ASSERT_EQUAL_size_t(0, game_queue_ops->pop(events, 8));
+}
+
+void test_game_queue_drops_when_full(void) {
+  struct GameQueueEvent event;
+
+  for (size_t i = 0; i < GAME_QUEUE_LENGTH_MAX; i++) {
+    TEST_ASSERT_EQUAL_INT(0, game_queue_ops->push(INPUT_EVENT_DOWN, 0));
+  }
+
+  TEST_ASSERT_EQUAL_INT(ENOBUFS, game_queue_ops->push(INPUT_EVENT_UP, 0));
+  TEST_ASSERT_EQUAL_size_t(1, game_queue_ops->get_dropped_events());
+
+  // Popping one event frees exactly one slot.
+  TEST_ASSERT_EQUAL_size_t(1, game_queue_ops->pop(&event, 1));
+  TEST_ASSERT_EQUAL_INT(0, game_queue_ops->push(INPUT_EVENT_UP, 0));
+  TEST_ASSERT_EQUAL_INT(ENOBUFS, game_queue_ops->push(INPUT_EVENT_UP, 0));
+}
+
+void test_game_queue_many_producers(void) {
+  size_t received[PRODUCERS_AMOUNT] = {0};
+  pthread_t threads[PRODUCERS_AMOUNT];
+  struct GameQueueEvent events[64];
+  enum InputEvents expected;
+  size_t total = 0;
+  size_t length;
+
+  for (size_t i = 0; i < PRODUCERS_AMOUNT; i++) {
+    TEST_ASSERT_EQUAL_INT(
+        0, pthread_create(&threads[i], NULL, producer_thread, (void *)i));
+  }
+
+  while (total < PRODUCERS_AMOUNT * PRODUCER_EVENTS_AMOUNT) {
+    length = game_queue_ops->pop(events, 64);
+    if (length == 0) {
+      game_queue_ops->wait();
+      continue;
+    }
+
+    // Every producer's events have to arrive in order it pushed them.
+    for (size_t i = 0; i < length; i++) {
+      TEST_ASSERT_TRUE(events[i].device_id < PRODUCERS_AMOUNT);
+      expected = INPUT_EVENT_UP + received[events[i].device_id] %
+                                      (INPUT_EVENT_EXIT - INPUT_EVENT_UP + 1);
+      TEST_ASSERT_EQUAL_INT(expected, events[i].input_event);
+      received[events[i].device_id]++;
+    }
+
+    total += length;
+  }
+
+  for (size_t i = 0; i < PRODUCERS_AMOUNT; i++) {
+    pthread_join(threads[i], NULL);
+    TEST_ASSERT_EQUAL_size_t(PRODUCER_EVENTS_AMOUNT, received[i]);
+  }
+}
+
+void test_game_queue_batch_bigger_than_queue(void) {
+  struct GameQueueEvent events[64];
+  enum InputEvents expected;
+  pthread_t thread;
+  size_t total = 0;
+  size_t length;
+  void *err;
+
+  TEST_ASSERT_EQUAL_INT(
+      0, pthread_create(&thread, NULL, burst_producer_thread, NULL));
+
+  // Producer waits for consumer instead of dropping the rest of the batch.
+  while (total < BURST_EVENTS_AMOUNT) {
+    length = game_queue_ops->pop(events, 64);
+    if (length == 0) {
+      game_queue_ops->wait();
+      continue;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+      expected = INPUT_EVENT_UP +
+                 (total + i) % (INPUT_EVENT_EXIT - INPUT_EVENT_UP + 1);
+      TEST_ASSERT_EQUAL_INT(expected, events[i].input_event);
+    }
+
+    total += length;
+  }
+
+  pthread_join(thread, &err);
+  TEST_ASSERT_EQUAL_INT(0, (int)(size_t)err);
+  TEST_ASSERT_EQUAL_size_t(0, game_queue_ops->get_dropped_events());
+}
+
+void test_game_queue_counts_every_dropped_event(void) {
+  struct GameQueueEvent event;
+  size_t length = 0;
+
+  // Nobody pops, so everything over queue's length is lost.
+  TEST_ASSERT_EQUAL_INT(ENOBUFS, game_queue_ops->push_batch(
+                                     burst_events, BURST_EVENTS_AMOUNT, 1));
+  TEST_ASSERT_EQUAL_size_t(BURST_EVENTS_AMOUNT - GAME_QUEUE_LENGTH_MAX,
+                           game_queue_ops->get_dropped_events());
+
+  while (game_queue_ops->pop(&event, 1) == 1) {
+    length++;
+  }
+  TEST_ASSERT_EQUAL_size_t(GAME_QUEUE_LENGTH_MAX, length);
+}
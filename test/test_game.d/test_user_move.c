@@ -297,3 +297,42 @@ void test_user_move_create_select() {
   TEST_ASSERT_EQUAL_INT(1, new_user_move->coordinates.x);
   TEST_ASSERT_EQUAL_INT(0, new_user_move->coordinates.y);
 }
+
+void test_user_move_board_follows_moves() {
+  struct GameStateMachineInput input = {.input_event = INPUT_EVENT_SELECT,
+                                        .device_id = 0};
+  struct GameStateMachineState state = {.current_state = GameStatePlay,
+                                        .current_user = USER_2_ID,
+                                        .users_moves_offset = 0,
+                                        .users_moves = {}};
+  int err;
+
+  err = user_move_priv_ops->next_state(input, &state);
+
+  TEST_ASSERT_EQUAL_INT(0, err);
+  TEST_ASSERT_EQUAL_INT(GAME_BOARD_CELL_TAKEN, state.board[1][1].flags);
+  TEST_ASSERT_EQUAL_INT(USER_2_ID, state.board[1][1].owner);
+
+  input.input_event = INPUT_EVENT_SELECT; // Select taken cell
+  err = user_move_priv_ops->next_state(input, &state);
+
+  TEST_ASSERT_EQUAL_INT(0, err);
+  TEST_ASSERT_EQUAL_INT(GAME_BOARD_CELL_TAKEN | GAME_BOARD_CELL_INVALID,
+                        state.board[1][1].flags);
+
+  err = gsm_common_ops->delete_last_move(&state);
+
+  TEST_ASSERT_EQUAL_INT(0, err);
+  TEST_ASSERT_EQUAL_INT(GAME_BOARD_CELL_TAKEN, state.board[1][1].flags);
+
+  input.input_event = INPUT_EVENT_LEFT; // Move to 0, 1
+  err = user_move_priv_ops->next_state(input, &state);
+
+  TEST_ASSERT_EQUAL_INT(0, err);
+  TEST_ASSERT_EQUAL_INT(GAME_BOARD_CELL_HIGHLIGHT, state.board[1][0].flags);
+
+  err = gsm_common_ops->delete_last_move(&state);
+
+  TEST_ASSERT_EQUAL_INT(0, err);
+  TEST_ASSERT_EQUAL_INT(0, state.board[1][0].flags);
+}
@@ -1,3 +1,4 @@
+#include <string.h>
 #include <unity.h>
 
 #include "game/game_state_machine/game_states.h"
@@ -6,17 +7,20 @@
 
 #include "game_sm_win_wrapper.h"
 
-// Mock data for testing
-#define MAX_TEST_MOVES 10
-
-static struct UserMove user_moves[MAX_TEST_MOVES];
+static struct GameStateMachineState state;
 static struct UserMove current_user_move;
 struct GameSmWinModuleOps *win_ops;
 struct GameSmWinModulePrivateOps *win_priv_ops;
 
+static void take_cell(game_user_id_t user_id, int x, int y) {
+  state.board[y][x].owner = user_id;
+  state.board[y][x].flags |= GAME_BOARD_CELL_TAKEN;
+}
+
 void setUp(void) {
   win_ops = get_game_sm_win_module_ops();
   win_priv_ops = get_game_sm_win_module_priv_ops();
+  memset(&state, 0, sizeof(state));
 }
 
 void tearDown(void) {
@@ -30,13 +34,10 @@ void test_process_vertical_win(void) {
 
   // Add moves vertically aligned with the current move
   for (int i = 0; i < 3; i++) {
-    user_moves[i].coordinates.x = 0;
-    user_moves[i].coordinates.y = i;
-    user_moves[i].user_id = 1;
+    take_cell(1, 0, i);
   }
 
-  bool is_win =
-      win_priv_ops->process_vertical_win(&current_user_move, 3, user_moves, 2);
+  bool is_win = win_priv_ops->is_win(&state, &current_user_move, 2);
 
   TEST_ASSERT_TRUE(is_win);
 }
@@ -48,13 +49,10 @@ void test_process_horizontal_win(void) {
 
   // Add moves horizontally aligned with the current move
   for (int i = 0; i < 3; i++) {
-    user_moves[i].coordinates.x = i;
-    user_moves[i].coordinates.y = 0;
-    user_moves[i].user_id = 1;
+    take_cell(1, i, 0);
   }
 
-  bool is_win = win_priv_ops->process_horizontal_win(&current_user_move, 3,
-                                                     user_moves, 2);
+  bool is_win = win_priv_ops->is_win(&state, &current_user_move, 2);
 
   TEST_ASSERT_TRUE(is_win);
 }
@@ -64,16 +62,11 @@ void test_process_diagonal_a_win(void) {
   current_user_move.coordinates.y = 2;
   current_user_move.user_id = 1;
 
-  user_moves[0].coordinates.x = 1;
-  user_moves[0].coordinates.y = 1;
-  user_moves[0].user_id = 1;
+  take_cell(1, 0, 2);
+  take_cell(1, 1, 1);
+  take_cell(1, 2, 0);
 
-  user_moves[1].coordinates.x = 2;
-  user_moves[1].coordinates.y = 0;
-  user_moves[1].user_id = 1;
-
-  bool is_win = win_priv_ops->process_diagonal_win_a(&current_user_move, 2,
-                                                     user_moves, 2);
+  bool is_win = win_priv_ops->is_win(&state, &current_user_move, 2);
 
   TEST_ASSERT_TRUE(is_win);
 }
@@ -83,16 +76,30 @@ void test_process_diagonal_b_win(void) {
   current_user_move.coordinates.y = 2;
   current_user_move.user_id = 1;
 
-  user_moves[0].coordinates.x = 1;
-  user_moves[0].coordinates.y = 1;
-  user_moves[0].user_id = 1;
-
-  user_moves[1].coordinates.x = 0;
-  user_moves[1].coordinates.y = 0;
-  user_moves[1].user_id = 1;
+  take_cell(1, 2, 2);
+  take_cell(1, 1, 1);
+  take_cell(1, 0, 0);
 
-  bool is_win = win_priv_ops->process_diagonal_win_b(&current_user_move, 2,
-                                                     user_moves, 2);
+  bool is_win = win_priv_ops->is_win(&state, &current_user_move, 2);
 
   TEST_ASSERT_TRUE(is_win);
 }
+
+void test_process_no_win(void) {
+  current_user_move.coordinates.x = 1;
+  current_user_move.coordinates.y = 1;
+  current_user_move.user_id = 1;
+
+  // Three players on 4x4 board need four in a row, other user's cell or
+  //  board's edge breaks the line.
+  take_cell(1, 0, 1);
+  take_cell(1, 1, 1);
+  take_cell(1, 2, 1);
+  take_cell(2, 3, 1);
+  take_cell(1, 2, 0);
+  take_cell(1, 0, 2);
+
+  bool is_win = win_priv_ops->is_win(&state, &current_user_move, 3);
+
+  TEST_ASSERT_FALSE(is_win);
+}
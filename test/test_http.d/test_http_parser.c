@@ -0,0 +1,170 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#include <errno.h>
+#include <string.h>
+#include <unity.h>
+
+// App's internal libs
+#include "http/http_parser.h"
+#include "input/input_common.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+static struct HttpParserOps *http_parser_ops;
+
+static int parse_str(const char *buffer, struct HttpRequest *request) {
+  return http_parser_ops->parse_request(buffer, strlen(buffer), request);
+}
+
+static int parse_move_str(const char *body, struct HttpMove *move) {
+  return http_parser_ops->parse_move(body, strlen(body), move);
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() { http_parser_ops = get_http_parser_ops(); }
+
+void tearDown() {}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_http_parser_request(void) {
+  const char buffer[] = "POST /api/move?x=1 HTTP/1.1\r\n"
+                        "Host: localhost\r\n"
+                        "content-length:  12 \r\n"
+                        "\r\n"
+                        "{\"user\": 1}";
+  struct HttpRequest request;
+
+  TEST_ASSERT_EQUAL_INT(0, parse_str(buffer, &request));
+  TEST_ASSERT_EQUAL_INT(HTTP_METHOD_POST, request.method);
+  TEST_ASSERT_EQUAL_size_t(9, request.path_length);
+  TEST_ASSERT_EQUAL_INT(0, strncmp("/api/move", request.path, 9));
+  TEST_ASSERT_EQUAL_size_t(12, request.content_length);
+  TEST_ASSERT_EQUAL_size_t(strstr(buffer, "{") - buffer, request.head_length);
+  TEST_ASSERT_TRUE(request.is_keep_alive);
+}
+
+void test_http_parser_partial_and_pipelined(void) {
+  const char buffer[] = "GET / HTTP/1.1\r\n\r\n"
+                        "GET /api/state HTTP/1.0\n"
+                        "Connection: keep-alive\n"
+                        "\n"
+                        "GET /api/state HTTP/1.1\r\n"
+                        "Connection: close\r\n"
+                        "\r\n";
+  struct HttpRequest request;
+  size_t offset = 0;
+
+  // Head is complete only once the empty line arrives.
+  for (size_t i = 0; i < 18; i++) {
+    TEST_ASSERT_EQUAL_INT(
+        EAGAIN, http_parser_ops->parse_request(buffer, i, &request));
+  }
+
+  TEST_ASSERT_EQUAL_INT(0, parse_str(buffer, &request));
+  TEST_ASSERT_EQUAL_size_t(18, request.head_length);
+  TEST_ASSERT_EQUAL_INT(HTTP_METHOD_GET, request.method);
+  TEST_ASSERT_EQUAL_size_t(1, request.path_length);
+  offset += request.head_length;
+
+  // HTTP/1.0 closes connection unless asked not to.
+  TEST_ASSERT_EQUAL_INT(0, parse_str(buffer + offset, &request));
+  TEST_ASSERT_TRUE(request.is_keep_alive);
+  offset += request.head_length;
+
+  TEST_ASSERT_EQUAL_INT(0, parse_str(buffer + offset, &request));
+  TEST_ASSERT_FALSE(request.is_keep_alive);
+  offset += request.head_length;
+
+  TEST_ASSERT_EQUAL_size_t(sizeof(buffer) - 1, offset);
+}
+
+void test_http_parser_websocket_request(void) {
+  const char buffer[] = "GET /api/updates HTTP/1.1\r\n"
+                        "Connection: Upgrade\r\n"
+                        "Upgrade: WebSocket\r\n"
+                        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                        "\r\n";
+  struct HttpRequest request;
+
+  TEST_ASSERT_EQUAL_INT(0, parse_str(buffer, &request));
+  TEST_ASSERT_TRUE(request.is_websocket);
+  TEST_ASSERT_EQUAL_size_t(24, request.websocket_key_length);
+  TEST_ASSERT_EQUAL_INT(
+      0, strncmp("dGhlIHNhbXBsZSBub25jZQ==", request.websocket_key, 24));
+
+  TEST_ASSERT_EQUAL_INT(
+      0, parse_str("GET / HTTP/1.1\r\nUpgrade: h2c\r\n\r\n", &request));
+  TEST_ASSERT_FALSE(request.is_websocket);
+  TEST_ASSERT_NULL(request.websocket_key);
+}
+
+void test_http_parser_invalid_request(void) {
+  struct HttpRequest request;
+
+  TEST_ASSERT_EQUAL_INT(EPROTO, parse_str("GET\r\n\r\n", &request));
+  TEST_ASSERT_EQUAL_INT(EPROTO, parse_str("GET / HTTP/2.0\r\n\r\n", &request));
+  TEST_ASSERT_EQUAL_INT(EPROTO, parse_str("GET  HTTP/1.1\r\n\r\n", &request));
+  TEST_ASSERT_EQUAL_INT(EPROTO,
+                        parse_str("GET / HTTP/1.1\r\nHost\r\n\r\n", &request));
+  TEST_ASSERT_EQUAL_INT(
+      EPROTO,
+      parse_str("POST / HTTP/1.1\r\nContent-Length: -1\r\n\r\n", &request));
+  TEST_ASSERT_EQUAL_INT(
+      EPROTO,
+      parse_str("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n",
+                &request));
+
+  // Unknown method is valid request, server decides what to do with it.
+  TEST_ASSERT_EQUAL_INT(0, parse_str("PUT / HTTP/1.1\r\n\r\n", &request));
+  TEST_ASSERT_EQUAL_INT(HTTP_METHOD_UNKNOWN, request.method);
+}
+
+void test_http_parser_move(void) {
+  struct HttpMove move;
+
+  TEST_ASSERT_EQUAL_INT(0,
+                        parse_move_str("{\"user\":2,\"event\":\"up\"}", &move));
+  TEST_ASSERT_EQUAL_INT(2, move.user);
+  TEST_ASSERT_EQUAL_size_t(1, move.events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, move.events[0]);
+
+  TEST_ASSERT_EQUAL_INT(
+      0, parse_move_str(" { \"events\" : [ \"left\", \"5\" ,\"exit\" ] ,"
+                        " \"user\" : 10 } ",
+                        &move));
+  TEST_ASSERT_EQUAL_INT(10, move.user);
+  TEST_ASSERT_EQUAL_size_t(3, move.events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_LEFT, move.events[0]);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_SELECT, move.events[1]);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_EXIT, move.events[2]);
+}
+
+void test_http_parser_invalid_move(void) {
+  const char *invalid_moves[] = {
+      "",
+      "{}",
+      "{\"user\":1}",
+      "{\"event\":\"up\"}",
+      "{\"user\":1,\"event\":\"jump\"}",
+      "{\"user\":1,\"event\":\"up\",\"speed\":2}",
+      "{\"user\":-1,\"event\":\"up\"}",
+      "{\"user\":1,\"event\":\"u\\p\"}",
+      "{\"user\":1,\"events\":[\"up\",]}",
+      "{\"user\":1,\"event\":\"up\"} {",
+      "{\"user\":1,\"event\":\"up\"",
+  };
+  struct HttpMove move;
+
+  for (size_t i = 0; i < sizeof(invalid_moves) / sizeof(char *); i++) {
+    TEST_ASSERT_EQUAL_INT_MESSAGE(EINVAL,
+                                  parse_move_str(invalid_moves[i], &move),
+                                  invalid_moves[i]);
+  }
+}
@@ -0,0 +1,429 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#define _POSIX_C_SOURCE 200809L // setenv
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unity.h>
+
+// App's internal libs
+#include "config/config.h"
+#include "display/display.h"
+#include "game/game_state_machine/game_state_machine.h"
+#include "http/http_server.h"
+#include "http/http_websocket.h"
+#include "input/input.h"
+#include "input/input_common.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define MOCK_EVENTS_MAX 16
+#define RESPONSES_MAX 8192
+
+struct MockDevice {
+  input_device_id_t device_id;
+  enum InputEvents events[MOCK_EVENTS_MAX];
+  size_t events_length;
+};
+
+static struct LoggingUtilsOps *logging_ops;
+static struct HttpServerOps *http_ops;
+static struct DisplayOps *display_ops;
+static struct ConfigOps *config_ops;
+static struct InputOps *input_ops;
+static struct MockDevice mock_devices[2];
+static int port;
+
+static int mock_callback(enum InputEvents input_event,
+                         input_device_id_t device_id) {
+  for (size_t i = 0; i < 2; i++) {
+    if (mock_devices[i].device_id == device_id &&
+        mock_devices[i].events_length < MOCK_EVENTS_MAX) {
+      mock_devices[i].events[mock_devices[i].events_length++] = input_event;
+    }
+  }
+
+  return 0;
+}
+
+static int mock_batch_callback(const enum InputEvents *input_events,
+                               size_t input_events_length,
+                               input_device_id_t device_id) {
+  for (size_t i = 0; i < input_events_length; i++) {
+    mock_callback(input_events[i], device_id);
+  }
+
+  return 0;
+}
+
+static void set_device_callback(size_t i, const char *device_name,
+                                input_batch_callback_func_t batch_callback) {
+  struct InputGetDeviceExtendedOutput get_device;
+
+  TEST_ASSERT_EQUAL_INT(
+      0, input_ops->get_device_extended(
+             &(struct InputGetDeviceExtendedInput){
+                 .device_name = (char *)device_name,
+                 .mode = INPUT_GET_DEVICE_BY_NAME},
+             &get_device));
+
+  mock_devices[i].device_id = get_device.device_id;
+
+  TEST_ASSERT_EQUAL_INT(
+      0, input_ops->set_callback(
+             (struct InputSetCallbackInput){.callback = mock_callback,
+                                            .batch_callback = batch_callback,
+                                            .device_id = get_device.device_id},
+             &(struct InputSetCallbackOutput){}));
+}
+
+static int connect_client(void) {
+  struct sockaddr_in address = {
+      .sin_family = AF_INET,
+      .sin_port = htons(port),
+      .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+  };
+  int fd;
+
+  fd = socket(AF_INET, SOCK_STREAM, 0);
+  TEST_ASSERT_NOT_EQUAL(-1, fd);
+  TEST_ASSERT_EQUAL_INT(
+      0, connect(fd, (struct sockaddr *)&address, sizeof(address)));
+
+  return fd;
+}
+
+static void send_str(int fd, const char *str) {
+  TEST_ASSERT_EQUAL_INT(strlen(str), write(fd, str, strlen(str)));
+}
+
+// Reads until given amount of responses arrives, statuses are stored in
+//  order and responses stay in the buffer.
+static void read_responses(int fd, char *buffer, size_t count,
+                           int *statuses) {
+  size_t length = 0;
+  size_t offset = 0;
+  size_t parsed = 0;
+  ssize_t bytes_read;
+  const char *head_end;
+  const char *content_length;
+
+  buffer[0] = 0;
+
+  while (parsed < count) {
+    head_end = strstr(buffer + offset, "\r\n\r\n");
+    if (length > offset && head_end) {
+      content_length = strstr(buffer + offset, "Content-Length: ");
+      TEST_ASSERT_NOT_NULL(content_length);
+      if ((size_t)(head_end + 4 - buffer) + atoi(content_length + 16) <=
+          length) {
+        statuses[parsed++] = atoi(buffer + offset + 9);
+        offset = head_end + 4 - buffer + atoi(content_length + 16);
+        continue;
+      }
+    }
+
+    bytes_read = read(fd, buffer + length, RESPONSES_MAX - 1 - length);
+    TEST_ASSERT_TRUE(bytes_read > 0);
+    length += bytes_read;
+    buffer[length] = 0;
+  }
+}
+
+// Reads until given amount of bytes arrives.
+static void read_exact(int fd, char *buffer, size_t length) {
+  ssize_t bytes_read;
+
+  while (length > 0) {
+    bytes_read = read(fd, buffer, length);
+    TEST_ASSERT_TRUE(bytes_read > 0);
+    buffer += bytes_read;
+    length -= bytes_read;
+  }
+}
+
+// Upgrades connection to WebSocket and checks the handshake.
+static void upgrade_client(int fd) {
+  char buffer[RESPONSES_MAX];
+  size_t length = 0;
+
+  send_str(fd, "GET /api/updates HTTP/1.1\r\n"
+               "Upgrade: websocket\r\n"
+               "Connection: Upgrade\r\n"
+               "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+               "\r\n");
+
+  // Server sends nothing else until something is displayed.
+  do {
+    read_exact(fd, buffer + length, 1);
+    length++;
+  } while (length < 4 || memcmp(buffer + length - 4, "\r\n\r\n", 4));
+  buffer[length] = 0;
+
+  TEST_ASSERT_EQUAL_INT(0, strncmp("HTTP/1.1 101 ", buffer, 13));
+  TEST_ASSERT_NOT_NULL(
+      strstr(buffer, "Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n"));
+}
+
+// Sends message masked with zero key, which leaves payload as it is.
+static void send_message(int fd, enum HttpWebsocketOpcode opcode,
+                         const char *payload, size_t length) {
+  char frame[256] = {(char)(0x80 | opcode), (char)(0x80 | length)};
+
+  TEST_ASSERT_TRUE(length < 126);
+  memcpy(frame + 6, payload, length);
+  TEST_ASSERT_EQUAL_INT(length + 6, write(fd, frame, length + 6));
+}
+
+// Reads whole message into null terminated buffer.
+static enum HttpWebsocketOpcode read_message(int fd, char *buffer) {
+  unsigned char head[4];
+  size_t length;
+
+  read_exact(fd, (char *)head, 2);
+  TEST_ASSERT_EQUAL_HEX8(0x80, head[0] & 0x80);
+
+  length = head[1];
+  TEST_ASSERT_TRUE(length <= 126);
+  if (length == 126) {
+    read_exact(fd, (char *)head + 2, 2);
+    length = head[2] << 8 | head[3];
+  }
+
+  TEST_ASSERT_TRUE(length < RESPONSES_MAX);
+  read_exact(fd, buffer, length);
+  buffer[length] = 0;
+
+  return head[0] & 0x0F;
+}
+
+static void display_board(bool is_center_taken) {
+  struct GameBoardCell cells[GAME_BOARD_XY_MAX][GAME_BOARD_XY_MAX] = {0};
+  int display_id;
+
+  cells[1][2] = (struct GameBoardCell){.owner = 1,
+                                       .flags = GAME_BOARD_CELL_TAKEN};
+  if (is_center_taken) {
+    cells[1][1] = (struct GameBoardCell){.owner = 0,
+                                         .flags = GAME_BOARD_CELL_TAKEN};
+  }
+
+  TEST_ASSERT_EQUAL_INT(
+      0, display_ops->get_display_id(HTTP_SERVER_DISP_NAME, &display_id));
+  TEST_ASSERT_EQUAL_INT(
+      0, display_ops->display(&(struct DisplayData){
+             .game_state = GameStatePlay,
+             .display_id = display_id,
+             .user_id = 1,
+             .cells = (const struct GameBoardCell(*)[GAME_BOARD_XY_MAX])cells,
+             .board_xy = 3,
+             .cursor = {.x = 2, .y = 1}}));
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() {
+  char port_str[8];
+
+  logging_ops = get_logging_utils_ops();
+  http_ops = get_http_server_ops();
+  display_ops = get_display_ops();
+  config_ops = get_config_ops();
+  input_ops = get_input_ops();
+
+  logging_ops->init();
+  TEST_ASSERT_EQUAL_INT(0, config_ops->init());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->init());
+  TEST_ASSERT_EQUAL_INT(0, display_ops->init());
+
+  port = 20000 + getpid() % 20000;
+  snprintf(port_str, sizeof(port_str), "%d", port);
+  setenv(HTTP_SERVER_PORT_VAR_NAME, port_str, 1);
+
+  memset(mock_devices, 0, sizeof(mock_devices));
+
+  TEST_ASSERT_EQUAL_INT(0, http_ops->init());
+  set_device_callback(0, "http1", NULL);
+  set_device_callback(1, "http2", mock_batch_callback);
+
+  TEST_ASSERT_EQUAL_INT(0, input_ops->start());
+}
+
+void tearDown() {
+  TEST_ASSERT_EQUAL_INT(0, input_ops->request_stop());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->wait());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->stop());
+
+  http_ops->destroy();
+  display_ops->destroy();
+  input_ops->destroy();
+  logging_ops->destroy();
+}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_http_server_page_and_state(void) {
+  char buffer[RESPONSES_MAX];
+  int statuses[2];
+  int client = connect_client();
+
+  send_str(client, "GET / HTTP/1.1\r\n\r\nGET /api/state HTTP/1.1\r\n\r\n");
+  read_responses(client, buffer, 2, statuses);
+  TEST_ASSERT_EQUAL_INT(200, statuses[0]);
+  TEST_ASSERT_NOT_NULL(strstr(buffer, "<html>"));
+  // Nothing was displayed yet.
+  TEST_ASSERT_EQUAL_INT(503, statuses[1]);
+
+  display_board(false);
+
+  send_str(client, "GET /api/state HTTP/1.1\r\n\r\n");
+  read_responses(client, buffer, 1, statuses);
+  TEST_ASSERT_EQUAL_INT(200, statuses[0]);
+  TEST_ASSERT_NOT_NULL(
+      strstr(buffer, "{\"state\":\"play\",\"user\":2,\"board_xy\":3,"
+                     "\"cursor\":[2,1],\"cells\":[[0,0,0],[0,0,2],[0,0,0]],"
+                     "\"flags\":[[0,0,0],[0,0,1],[0,0,0]]}"));
+
+  close(client);
+}
+
+void test_http_server_pipelined_moves(void) {
+  const char first_move[] = "{\"user\":1,\"event\":\"up\"}";
+  const char second_move[] = "{\"user\":2,\"events\":[\"left\",\"select\"]}";
+  char buffer[RESPONSES_MAX];
+  char requests[512];
+  int statuses[4];
+  int client = connect_client();
+
+  snprintf(requests, sizeof(requests),
+           "POST /api/move HTTP/1.1\r\nContent-Length: %zu\r\n\r\n%s"
+           "POST /api/move HTTP/1.1\r\nContent-Length: %zu\r\n\r\n%s"
+           "GET /nothing HTTP/1.1\r\n\r\n"
+           "GET /api/move HTTP/1.1\r\n\r\n",
+           sizeof(first_move) - 1, first_move, sizeof(second_move) - 1,
+           second_move);
+  send_str(client, requests);
+
+  read_responses(client, buffer, 4, statuses);
+  TEST_ASSERT_EQUAL_INT(202, statuses[0]);
+  TEST_ASSERT_EQUAL_INT(202, statuses[1]);
+  TEST_ASSERT_EQUAL_INT(404, statuses[2]);
+  TEST_ASSERT_EQUAL_INT(405, statuses[3]);
+
+  TEST_ASSERT_EQUAL_size_t(1, mock_devices[0].events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, mock_devices[0].events[0]);
+  TEST_ASSERT_EQUAL_size_t(2, mock_devices[1].events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_LEFT, mock_devices[1].events[0]);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_SELECT, mock_devices[1].events[1]);
+
+  // Connection is kept alive until client asks to close it.
+  send_str(client, "GET / HTTP/1.1\r\nConnection: close\r\n\r\n");
+  read_responses(client, buffer, 1, statuses);
+  TEST_ASSERT_EQUAL_INT(200, statuses[0]);
+  TEST_ASSERT_EQUAL_INT(0, read(client, buffer, sizeof(buffer)));
+
+  close(client);
+}
+
+void test_http_server_invalid_requests(void) {
+  const char third_user_move[] = "{\"user\":3,\"event\":\"up\"}";
+  struct HttpServerStats stats;
+  char buffer[RESPONSES_MAX];
+  char requests[512];
+  int statuses[3];
+  int client = connect_client();
+
+  snprintf(requests, sizeof(requests),
+           "POST /api/move HTTP/1.1\r\nContent-Length: %zu\r\n\r\n%s"
+           "POST /api/move HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}"
+           "NONSENSE\r\n\r\n",
+           sizeof(third_user_move) - 1, third_user_move);
+  send_str(client, requests);
+
+  read_responses(client, buffer, 3, statuses);
+  // Third user does not play over HTTP.
+  TEST_ASSERT_EQUAL_INT(409, statuses[0]);
+  TEST_ASSERT_EQUAL_INT(400, statuses[1]);
+  // Server can't tell where invalid request ends, so it closes connection.
+  TEST_ASSERT_EQUAL_INT(400, statuses[2]);
+  TEST_ASSERT_EQUAL_INT(0, read(client, buffer, sizeof(buffer)));
+
+  http_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(1, stats.accepted);
+  TEST_ASSERT_EQUAL_size_t(3, stats.errors);
+  TEST_ASSERT_EQUAL_size_t(0, stats.events);
+
+  close(client);
+}
+
+void test_http_server_websocket_updates(void) {
+  const char move[] = "{\"user\":1,\"event\":\"up\"}";
+  struct HttpServerStats stats;
+  char buffer[RESPONSES_MAX];
+  int subscriber = connect_client();
+  int late_subscriber;
+
+  upgrade_client(subscriber);
+
+  // The first frame holds whole state, the following only what changed.
+  display_board(false);
+  TEST_ASSERT_EQUAL_INT(HTTP_WEBSOCKET_TEXT, read_message(subscriber, buffer));
+  TEST_ASSERT_EQUAL_STRING(
+      "{\"state\":\"play\",\"user\":2,\"board_xy\":3,"
+      "\"cursor\":[2,1],\"cells\":[[0,0,0],[0,0,2],[0,0,0]],"
+      "\"flags\":[[0,0,0],[0,0,1],[0,0,0]]}",
+      buffer);
+
+  // Frame which changes nothing is not sent at all.
+  display_board(false);
+  display_board(true);
+  TEST_ASSERT_EQUAL_INT(HTTP_WEBSOCKET_TEXT, read_message(subscriber, buffer));
+  TEST_ASSERT_EQUAL_STRING("{\"state\":\"play\",\"user\":2,\"cursor\":[2,1],"
+                           "\"changes\":[[1,1,1,1]]}",
+                           buffer);
+
+  // Subscriber which comes late starts with whole state.
+  late_subscriber = connect_client();
+  upgrade_client(late_subscriber);
+  TEST_ASSERT_EQUAL_INT(HTTP_WEBSOCKET_TEXT,
+                        read_message(late_subscriber, buffer));
+  TEST_ASSERT_NOT_NULL(strstr(buffer, "\"cells\":[[0,0,0],[0,1,2],[0,0,0]]"));
+  close(late_subscriber);
+
+  // Moves are taken over WebSocket too, only errors are replied.
+  send_message(subscriber, HTTP_WEBSOCKET_TEXT, move, sizeof(move) - 1);
+  send_message(subscriber, HTTP_WEBSOCKET_TEXT, "{}", 2);
+  TEST_ASSERT_EQUAL_INT(HTTP_WEBSOCKET_TEXT, read_message(subscriber, buffer));
+  TEST_ASSERT_EQUAL_STRING("{\"error\":\"invalid move\"}", buffer);
+  TEST_ASSERT_EQUAL_size_t(1, mock_devices[0].events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, mock_devices[0].events[0]);
+
+  send_message(subscriber, HTTP_WEBSOCKET_PING, "abc", 3);
+  TEST_ASSERT_EQUAL_INT(HTTP_WEBSOCKET_PONG, read_message(subscriber, buffer));
+  TEST_ASSERT_EQUAL_STRING("abc", buffer);
+
+  // Close is echoed back before server closes connection.
+  send_message(subscriber, HTTP_WEBSOCKET_CLOSE, "\x03\xe8", 2);
+  TEST_ASSERT_EQUAL_INT(HTTP_WEBSOCKET_CLOSE,
+                        read_message(subscriber, buffer));
+  TEST_ASSERT_EQUAL_MEMORY("\x03\xe8", buffer, 2);
+  TEST_ASSERT_EQUAL_INT(0, read(subscriber, buffer, sizeof(buffer)));
+
+  http_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(2, stats.upgrades);
+  TEST_ASSERT_EQUAL_size_t(3, stats.frames);
+
+  close(subscriber);
+}
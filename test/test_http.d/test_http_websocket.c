@@ -0,0 +1,108 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#include <errno.h>
+#include <string.h>
+#include <unity.h>
+
+// App's internal libs
+#include "http/http_websocket.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+static struct HttpWebsocketOps *http_websocket_ops;
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() { http_websocket_ops = get_http_websocket_ops(); }
+
+void tearDown() {}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_http_websocket_accept_key(void) {
+  // Example from RFC 6455.
+  const char key[] = "dGhlIHNhbXBsZSBub25jZQ==";
+  char accept[HTTP_WEBSOCKET_ACCEPT_MAX];
+
+  TEST_ASSERT_EQUAL_INT(0, http_websocket_ops->get_accept_key(
+                               key, sizeof(key) - 1, accept));
+  TEST_ASSERT_EQUAL_STRING("s3pPLMBiTxaQ9kYGzzhZRbK+xOo=", accept);
+
+  TEST_ASSERT_EQUAL_INT(EINVAL,
+                        http_websocket_ops->get_accept_key(key, 0, accept));
+}
+
+void test_http_websocket_parse_frame(void) {
+  // Masked "Hello" from RFC 6455 followed by masked empty ping.
+  char buffer[] = {(char)0x81, (char)0x85, 0x37, (char)0xfa, 0x21,
+                   0x3d,       0x7f,       (char)0x9f, 0x4d, 0x51,
+                   0x58,       (char)0x89, (char)0x80, 0x01, 0x02,
+                   0x03,       0x04};
+  struct HttpWebsocketFrame frame;
+
+  // Frame is complete only once its whole payload arrives.
+  for (size_t i = 0; i < 11; i++) {
+    TEST_ASSERT_EQUAL_INT(
+        EAGAIN, http_websocket_ops->parse_frame(buffer, i, 125, &frame));
+  }
+
+  TEST_ASSERT_EQUAL_INT(EMSGSIZE, http_websocket_ops->parse_frame(
+                                      buffer, sizeof(buffer), 4, &frame));
+
+  TEST_ASSERT_EQUAL_INT(0, http_websocket_ops->parse_frame(
+                               buffer, sizeof(buffer), 125, &frame));
+  TEST_ASSERT_EQUAL_INT(HTTP_WEBSOCKET_TEXT, frame.opcode);
+  TEST_ASSERT_TRUE(frame.is_final);
+  TEST_ASSERT_EQUAL_size_t(5, frame.payload_length);
+  TEST_ASSERT_EQUAL_INT(0, memcmp("Hello", frame.payload, 5));
+  TEST_ASSERT_EQUAL_size_t(11, frame.frame_length);
+
+  TEST_ASSERT_EQUAL_INT(0, http_websocket_ops->parse_frame(
+                               buffer + 11, sizeof(buffer) - 11, 125, &frame));
+  TEST_ASSERT_EQUAL_INT(HTTP_WEBSOCKET_PING, frame.opcode);
+  TEST_ASSERT_EQUAL_size_t(0, frame.payload_length);
+  TEST_ASSERT_EQUAL_size_t(6, frame.frame_length);
+}
+
+void test_http_websocket_invalid_frame(void) {
+  // Unmasked frame, reserved bit, unknown opcode and fragmented ping.
+  char unmasked[] = {(char)0x81, 0x00};
+  char reserved[] = {(char)0xC1, (char)0x80, 0, 0, 0, 0};
+  char unknown[] = {(char)0x83, (char)0x80, 0, 0, 0, 0};
+  char fragmented[] = {0x09, (char)0x80, 0, 0, 0, 0};
+  struct HttpWebsocketFrame frame;
+
+  TEST_ASSERT_EQUAL_INT(EPROTO, http_websocket_ops->parse_frame(
+                                    unmasked, sizeof(unmasked), 125, &frame));
+  TEST_ASSERT_EQUAL_INT(EPROTO, http_websocket_ops->parse_frame(
+                                    reserved, sizeof(reserved), 125, &frame));
+  TEST_ASSERT_EQUAL_INT(EPROTO, http_websocket_ops->parse_frame(
+                                    unknown, sizeof(unknown), 125, &frame));
+  TEST_ASSERT_EQUAL_INT(EPROTO,
+                        http_websocket_ops->parse_frame(
+                            fragmented, sizeof(fragmented), 125, &frame));
+}
+
+void test_http_websocket_compose_head(void) {
+  char head[HTTP_WEBSOCKET_HEAD_MAX];
+
+  TEST_ASSERT_EQUAL_size_t(
+      2, http_websocket_ops->compose_head(HTTP_WEBSOCKET_TEXT, 125, head));
+  TEST_ASSERT_EQUAL_HEX8(0x81, (unsigned char)head[0]);
+  TEST_ASSERT_EQUAL_HEX8(125, (unsigned char)head[1]);
+
+  TEST_ASSERT_EQUAL_size_t(
+      4, http_websocket_ops->compose_head(HTTP_WEBSOCKET_CLOSE, 300, head));
+  TEST_ASSERT_EQUAL_HEX8(0x88, (unsigned char)head[0]);
+  TEST_ASSERT_EQUAL_HEX8(126, (unsigned char)head[1]);
+  TEST_ASSERT_EQUAL_HEX8(0x01, (unsigned char)head[2]);
+  TEST_ASSERT_EQUAL_HEX8(0x2C, (unsigned char)head[3]);
+
+  TEST_ASSERT_EQUAL_size_t(
+      0, http_websocket_ops->compose_head(HTTP_WEBSOCKET_TEXT, 70000, head));
+}
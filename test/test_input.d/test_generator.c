@@ -0,0 +1,225 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#define _POSIX_C_SOURCE 200809L // setenv
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+// App's internal libs
+#include "config/config.h"
+#include "input/generator.h"
+#include "input/input.h"
+#include "input/input_common.h"
+#include "utils/logging_utils.h"
+
+#include "input_generator_wrapper.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define MOCK_EVENTS_MAX 1000
+
+static struct LoggingUtilsOps *logging_ops;
+static struct InputGeneratorOps *generator_ops;
+static struct InputGeneratorPrivateOps *generator_priv_ops;
+static struct ConfigOps *config_ops;
+static struct InputOps *input_ops;
+static enum InputEvents mock_events[MOCK_EVENTS_MAX];
+static size_t mock_events_length;
+static size_t mock_events_limit;
+
+// Stops the loop once enough events arrived, generator alone never stops
+//  without duration.
+static int mock_callback(enum InputEvents input_event,
+                         input_device_id_t device_id) {
+  (void)device_id;
+
+  if (mock_events_length >= mock_events_limit) {
+    return 0;
+  }
+
+  mock_events[mock_events_length++] = input_event;
+
+  if (mock_events_length == mock_events_limit) {
+    input_ops->request_stop();
+  }
+
+  return 0;
+}
+
+static void run_generator(void) {
+  struct InputGetDeviceExtendedOutput get_device;
+
+  TEST_ASSERT_EQUAL_INT(0, generator_ops->init());
+
+  TEST_ASSERT_EQUAL_INT(
+      0, input_ops->get_device_extended(
+             &(struct InputGetDeviceExtendedInput){
+                 .device_name = INPUT_GENERATOR_DISP_NAME,
+                 .mode = INPUT_GET_DEVICE_BY_NAME},
+             &get_device));
+
+  TEST_ASSERT_EQUAL_INT(
+      0, input_ops->set_callback(
+             (struct InputSetCallbackInput){.callback = mock_callback,
+                                            .device_id = get_device.device_id},
+             &(struct InputSetCallbackOutput){}));
+
+  TEST_ASSERT_EQUAL_INT(0, input_ops->start());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->wait());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->stop());
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() {
+  logging_ops = get_logging_utils_ops();
+  generator_ops = get_input_generator_ops();
+  generator_priv_ops = get_input_generator_priv_ops();
+  config_ops = get_config_ops();
+  input_ops = get_input_ops();
+
+  logging_ops->init();
+  TEST_ASSERT_EQUAL_INT(0, config_ops->init());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->init());
+
+  unsetenv(INPUT_GENERATOR_RATE_VAR_NAME);
+  unsetenv(INPUT_GENERATOR_SEED_VAR_NAME);
+  unsetenv(INPUT_GENERATOR_DURATION_VAR_NAME);
+  unsetenv(INPUT_GENERATOR_WEIGHTS_VAR_NAME);
+
+  mock_events_length = 0;
+  mock_events_limit = MOCK_EVENTS_MAX;
+}
+
+void tearDown() {
+  generator_ops->destroy();
+  input_ops->destroy();
+  logging_ops->destroy();
+}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_generator_weights(void) {
+  setenv(INPUT_GENERATOR_RATE_VAR_NAME, "0", 1);
+  setenv(INPUT_GENERATOR_WEIGHTS_VAR_NAME, "0,3,0,0,1,0", 1);
+
+  run_generator();
+
+  TEST_ASSERT_EQUAL_size_t(MOCK_EVENTS_MAX, mock_events_length);
+  for (size_t i = 0; i < MOCK_EVENTS_MAX; i++) {
+    TEST_ASSERT_TRUE(mock_events[i] == INPUT_EVENT_DOWN ||
+                     mock_events[i] == INPUT_EVENT_SELECT);
+  }
+}
+
+void test_generator_same_seed_same_stream(void) {
+  enum InputEvents first_run[MOCK_EVENTS_MAX];
+  size_t differences = 0;
+
+  setenv(INPUT_GENERATOR_RATE_VAR_NAME, "0", 1);
+  setenv(INPUT_GENERATOR_SEED_VAR_NAME, "7", 1);
+
+  run_generator();
+  memcpy(first_run, mock_events, sizeof(first_run));
+
+  // Every event has a chance, default weights make exit rare.
+  for (enum InputEvents event = INPUT_EVENT_UP; event <= INPUT_EVENT_SELECT;
+       event++) {
+    size_t count = 0;
+    for (size_t i = 0; i < MOCK_EVENTS_MAX; i++) {
+      count += first_run[i] == event;
+    }
+    TEST_ASSERT_TRUE(count > MOCK_EVENTS_MAX / 10);
+  }
+
+  tearDown();
+  setUp();
+  setenv(INPUT_GENERATOR_RATE_VAR_NAME, "0", 1);
+  setenv(INPUT_GENERATOR_SEED_VAR_NAME, "7", 1);
+
+  run_generator();
+
+  for (size_t i = 0; i < MOCK_EVENTS_MAX; i++) {
+    TEST_ASSERT_EQUAL_INT(first_run[i], mock_events[i]);
+  }
+
+  tearDown();
+  setUp();
+  setenv(INPUT_GENERATOR_RATE_VAR_NAME, "0", 1);
+  setenv(INPUT_GENERATOR_SEED_VAR_NAME, "8", 1);
+
+  run_generator();
+
+  for (size_t i = 0; i < MOCK_EVENTS_MAX; i++) {
+    differences += first_run[i] != mock_events[i];
+  }
+  TEST_ASSERT_TRUE(differences > 0);
+}
+
+void test_generator_rate_and_duration(void) {
+  struct InputGeneratorStats stats;
+
+  // Loop exits on its own once duration passes and nothing is watched.
+  setenv(INPUT_GENERATOR_RATE_VAR_NAME, "200", 1);
+  setenv(INPUT_GENERATOR_DURATION_VAR_NAME, "1", 1);
+
+  run_generator();
+
+  generator_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(mock_events_length, stats.events);
+  TEST_ASSERT_TRUE(stats.events >= 150);
+  TEST_ASSERT_TRUE(stats.events <= 201);
+}
+
+void test_generator_invalid_config(void) {
+  setenv(INPUT_GENERATOR_WEIGHTS_VAR_NAME, "1,1,1,1,1", 1);
+  TEST_ASSERT_EQUAL_INT(EINVAL, generator_ops->init());
+
+  TEST_ASSERT_EQUAL_INT(0, config_ops->init());
+  setenv(INPUT_GENERATOR_WEIGHTS_VAR_NAME, "0,0,0,0,0,0", 1);
+  TEST_ASSERT_EQUAL_INT(EINVAL, generator_ops->init());
+
+  TEST_ASSERT_EQUAL_INT(0, config_ops->init());
+  unsetenv(INPUT_GENERATOR_WEIGHTS_VAR_NAME);
+  setenv(INPUT_GENERATOR_RATE_VAR_NAME, "fast", 1);
+  TEST_ASSERT_EQUAL_INT(EINVAL, generator_ops->init());
+}
+
+void test_generator_long_runs_do_not_overflow(void) {
+  // Twenty billion events at a thousand per second are due in twenty
+  //  million seconds, multiplying events by a second first would wrap.
+  TEST_ASSERT_EQUAL_UINT64(
+      7 + 20000000ULL * 1000000000ULL,
+      generator_priv_ops->get_deadline(7, 20000000000ULL, 1000));
+  TEST_ASSERT_EQUAL_UINT64(7 + 1500000000ULL,
+                           generator_priv_ops->get_deadline(7, 3, 2));
+  TEST_ASSERT_EQUAL_UINT64(
+      20000000000ULL,
+      generator_priv_ops->get_due_events(20000000ULL * 1000000000ULL, 1000));
+  TEST_ASSERT_EQUAL_UINT64(
+      3, generator_priv_ops->get_due_events(1999999999ULL, 2));
+  TEST_ASSERT_EQUAL_UINT64(UINT64_MAX, generator_priv_ops->get_due_events(
+                                           UINT64_MAX, 1000000000ULL));
+}
+
+void test_generator_rejects_overflowing_config(void) {
+  setenv(INPUT_GENERATOR_RATE_VAR_NAME, "1000000001", 1);
+  TEST_ASSERT_EQUAL_INT(EINVAL, generator_ops->init());
+
+  TEST_ASSERT_EQUAL_INT(0, config_ops->init());
+  unsetenv(INPUT_GENERATOR_RATE_VAR_NAME);
+  setenv(INPUT_GENERATOR_DURATION_VAR_NAME, "18446744074", 1);
+  TEST_ASSERT_EQUAL_INT(EINVAL, generator_ops->init());
+
+  TEST_ASSERT_EQUAL_INT(0, config_ops->init());
+  unsetenv(INPUT_GENERATOR_DURATION_VAR_NAME);
+  setenv(INPUT_GENERATOR_WEIGHTS_VAR_NAME, "18446744073709551615,1,0,0,0,0",
+         1);
+  TEST_ASSERT_EQUAL_INT(EINVAL, generator_ops->init());
+}
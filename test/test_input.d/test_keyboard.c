@@ -38,9 +38,6 @@ struct timespec ts = {.tv_sec = 0, .tv_nsec = 50000000};
 // Helper Function Prototypes
 static void setup_pty(void);
 static void restore_original_stdin(void);
-static int
-mock_keyboard_callback(const struct KeyboardKeysMappingCallbackInput *input,
-                       struct KeyboardKeysMappingCallbackOutput *output);
 static int mock_input_callback(enum InputEvents, input_device_id_t);
 
 // Test Setup
@@ -55,8 +52,6 @@ void setUp(void) {
   mapping_1_ops = get_keyboard_keys_mapping_1_ops();
   mappings_ops = get_keyboard_keys_mapping_ops();
 
-  mapping_1_priv_ops->keyboard_callback = mock_keyboard_callback;
-
   err = logging_ops->init();
   TEST_ASSERT_EQUAL_INT(0, err);
 
@@ -91,14 +86,14 @@ void tearDown(void) {
 void test_keyboard_single_input(void) {
   int err;
 
-  err = keyboard_ops->start();
+  err = input_ops->start();
   TEST_ASSERT_EQUAL_INT(0, err);
 
   write(master_fd, "w", 1);
 
   thrd_sleep(&ts, NULL); // Allow processing
 
-  err = keyboard_ops->stop();
+  err = input_ops->stop();
   TEST_ASSERT_EQUAL_INT(0, err);
 
   TEST_ASSERT_EQUAL_INT(1, callback_counter);
@@ -108,39 +103,77 @@ void test_keyboard_single_input(void) {
 void test_keyboard_multiple_inputs(void) {
   int err;
 
-  err = keyboard_ops->start();
+  err = input_ops->start();
   TEST_ASSERT_EQUAL_INT(0, err);
 
+  // Every recognised key is delivered, unknown ones are skipped.
   const char *inputs[] = {"wsad", "qe", "ijkl"};
+  int expected_counters[] = {4, 5, 5};
   for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
     write(master_fd, inputs[i], strlen(inputs[i]));
     thrd_sleep(&ts, NULL); // Allow processing
-    TEST_ASSERT_EQUAL_INT((int)(i + 1), callback_counter);
+    TEST_ASSERT_EQUAL_INT(expected_counters[i], callback_counter);
   }
 
-  err = keyboard_ops->stop();
+  err = input_ops->stop();
   TEST_ASSERT_EQUAL_INT(0, err);
 }
 
-// Test Thread Restart
+// Test Escape Sequences Split Across Reads
+void test_keyboard_escape_sequences(void) {
+  int err;
+
+  err = input_ops->start();
+  TEST_ASSERT_EQUAL_INT(0, err);
+
+  // Shorter pause than escape timeout.
+  write(master_fd, "\033[", 2);
+  thrd_sleep(&(struct timespec){.tv_nsec = 10000000}, NULL);
+  TEST_ASSERT_EQUAL_INT(0, callback_counter);
+
+  write(master_fd, "Aw", 2);
+  thrd_sleep(&ts, NULL);
+  TEST_ASSERT_EQUAL_INT(2, callback_counter);
+
+  // Lone escape is flushed by timeout, but it is not mapped to any event.
+  write(master_fd, "\033", 1);
+  for (int i = 0; i < 4; i++) {
+    thrd_sleep(&ts, NULL);
+  }
+  write(master_fd, "[B", 2);
+  thrd_sleep(&ts, NULL);
+  TEST_ASSERT_EQUAL_INT(2, callback_counter);
+
+  err = input_ops->stop();
+  TEST_ASSERT_EQUAL_INT(0, err);
+}
+
+// Test Input Loop Restart
 void test_keyboard_thread_restart(void) {
   int err;
 
-  err = keyboard_ops->start();
+  err = input_ops->start();
   TEST_ASSERT_EQUAL_INT(0, err);
 
   write(master_fd, "q", 1);
   thrd_sleep(&ts, NULL);
-  keyboard_ops->stop();
+  input_ops->stop();
   TEST_ASSERT_EQUAL_INT(1, callback_counter);
 
-  err = keyboard_ops->start();
+  // Stopping input deregisters device's callback.
+  err = input_ops->set_callback(
+      (struct InputSetCallbackInput){.callback = mock_input_callback,
+                                     .device_id = 0},
+      &(struct InputSetCallbackOutput){});
   TEST_ASSERT_EQUAL_INT(0, err);
 
-  write(master_fd, "e", 1);
+  err = input_ops->start();
+  TEST_ASSERT_EQUAL_INT(0, err);
+
+  write(master_fd, "d", 1);
   thrd_sleep(&ts, NULL);
 
-  err = keyboard_ops->stop();
+  err = input_ops->stop();
   TEST_ASSERT_EQUAL_INT(0, err);
   TEST_ASSERT_EQUAL_INT(2, callback_counter);
 }
@@ -170,16 +203,10 @@ void restore_original_stdin(void) {
 }
 
 // Mock Callback
-int mock_keyboard_callback(const struct KeyboardKeysMappingCallbackInput *input,
-                           struct KeyboardKeysMappingCallbackOutput *output) {
-  logging_ops->log_info("mock_keyboard_callback", "Buffer: %.*s, Length: %zu",
-                        (int)input->n, input->buffer, input->n);
-  callback_counter++;
-  output->input_event = INPUT_EVENT_UP; // Mocked event
-  return 0;
-}
-
 int mock_input_callback(enum InputEvents input_event,
                         input_device_id_t device_id) {
+  logging_ops->log_info("mock_input_callback", "Event %d from device %d",
+                        input_event, device_id);
+  callback_counter++;
   return 0;
 };
@@ -1,3 +1,4 @@
+#include <errno.h>
 #include <string.h>
 #include <unity.h>
 
@@ -9,6 +10,8 @@
 
 #include "input_keyboard1_wrapper.h"
 
+#define TEST_KEYBOARD1_EVENTS_MAX 16
+
 static enum InputEvents mock_input_event;
 static int mock_callback_counter;
 static struct LoggingUtilsOps *log_ops;
@@ -53,9 +56,23 @@ void tearDown(void) {
   log_ops->destroy();
 }
 
+static size_t count_char(const char *str, char c) {
+  size_t count = 0;
+
+  for (; *str; str++) {
+    if (*str == c) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
 void test_keyboard1_event_up(void) {
   char *test_strings[] = {"w", "klkw123w", "klwklwklwkl", "12w12w12w12w12"};
-  struct KeyboardKeysMappingCallbackOutput output;
+  enum InputEvents events[TEST_KEYBOARD1_EVENTS_MAX];
+  struct KeyboardKeysMappingCallbackOutput output = {
+      .input_events = events, .input_events_max = TEST_KEYBOARD1_EVENTS_MAX};
 
   for (int i = 0; i < sizeof(test_strings) / sizeof(test_strings[0]); i++) {
     struct KeyboardKeysMappingCallbackInput input = {
@@ -63,13 +80,19 @@ void test_keyboard1_event_up(void) {
 
     int err = keyboard1_priv_ops->keyboard_callback(&input, &output);
     TEST_ASSERT_EQUAL_INT(0, err);
-    TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, output.input_event);
+    TEST_ASSERT_EQUAL_size_t(count_char(test_strings[i], 'w'),
+                             output.input_events_length);
+    for (size_t j = 0; j < output.input_events_length; j++) {
+      TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, events[j]);
+    }
   }
 }
 
 void test_keyboard1_event_down(void) {
   char *test_strings[] = {"s", "12s12s", "21s12s12s", "s12s12s12s12"};
-  struct KeyboardKeysMappingCallbackOutput output;
+  enum InputEvents events[TEST_KEYBOARD1_EVENTS_MAX];
+  struct KeyboardKeysMappingCallbackOutput output = {
+      .input_events = events, .input_events_max = TEST_KEYBOARD1_EVENTS_MAX};
 
   for (int i = 0; i < sizeof(test_strings) / sizeof(test_strings[0]); i++) {
     struct KeyboardKeysMappingCallbackInput input = {
@@ -77,13 +100,19 @@ void test_keyboard1_event_down(void) {
 
     int err = keyboard1_priv_ops->keyboard_callback(&input, &output);
     TEST_ASSERT_EQUAL_INT(0, err);
-    TEST_ASSERT_EQUAL_INT(INPUT_EVENT_DOWN, output.input_event);
+    TEST_ASSERT_EQUAL_size_t(count_char(test_strings[i], 's'),
+                             output.input_events_length);
+    for (size_t j = 0; j < output.input_events_length; j++) {
+      TEST_ASSERT_EQUAL_INT(INPUT_EVENT_DOWN, events[j]);
+    }
   }
 }
 
 void test_keyboard1_event_left(void) {
   char *test_strings[] = {"a", "1a12a", "12a12a12a", "12a12a12a12a12"};
-  struct KeyboardKeysMappingCallbackOutput output;
+  enum InputEvents events[TEST_KEYBOARD1_EVENTS_MAX];
+  struct KeyboardKeysMappingCallbackOutput output = {
+      .input_events = events, .input_events_max = TEST_KEYBOARD1_EVENTS_MAX};
 
   for (int i = 0; i < sizeof(test_strings) / sizeof(test_strings[0]); i++) {
     struct KeyboardKeysMappingCallbackInput input = {
@@ -91,13 +120,19 @@ void test_keyboard1_event_left(void) {
 
     int err = keyboard1_priv_ops->keyboard_callback(&input, &output);
     TEST_ASSERT_EQUAL_INT(0, err);
-    TEST_ASSERT_EQUAL_INT(INPUT_EVENT_LEFT, output.input_event);
+    TEST_ASSERT_EQUAL_size_t(count_char(test_strings[i], 'a'),
+                             output.input_events_length);
+    for (size_t j = 0; j < output.input_events_length; j++) {
+      TEST_ASSERT_EQUAL_INT(INPUT_EVENT_LEFT, events[j]);
+    }
   }
 }
 
 void test_keyboard1_event_right(void) {
   char *test_strings[] = {"d", "12d12d", "12d12d12d", "12d12d12d12d12"};
-  struct KeyboardKeysMappingCallbackOutput output;
+  enum InputEvents events[TEST_KEYBOARD1_EVENTS_MAX];
+  struct KeyboardKeysMappingCallbackOutput output = {
+      .input_events = events, .input_events_max = TEST_KEYBOARD1_EVENTS_MAX};
 
   for (int i = 0; i < sizeof(test_strings) / sizeof(test_strings[0]); i++) {
     struct KeyboardKeysMappingCallbackInput input = {
@@ -105,6 +140,42 @@ void test_keyboard1_event_right(void) {
 
     int err = keyboard1_priv_ops->keyboard_callback(&input, &output);
     TEST_ASSERT_EQUAL_INT(0, err);
-    TEST_ASSERT_EQUAL_INT(INPUT_EVENT_RIGHT, output.input_event);
+    TEST_ASSERT_EQUAL_size_t(count_char(test_strings[i], 'd'),
+                             output.input_events_length);
+    for (size_t j = 0; j < output.input_events_length; j++) {
+      TEST_ASSERT_EQUAL_INT(INPUT_EVENT_RIGHT, events[j]);
+    }
   }
 }
+
+void test_keyboard1_events_burst(void) {
+  char test_string[] = "w1ad\nsq";
+  enum InputEvents expected[] = {INPUT_EVENT_UP, INPUT_EVENT_LEFT,
+                                 INPUT_EVENT_RIGHT, INPUT_EVENT_SELECT,
+                                 INPUT_EVENT_DOWN, INPUT_EVENT_EXIT};
+  enum InputEvents events[TEST_KEYBOARD1_EVENTS_MAX];
+  struct KeyboardKeysMappingCallbackOutput output = {
+      .input_events = events, .input_events_max = TEST_KEYBOARD1_EVENTS_MAX};
+  struct KeyboardKeysMappingCallbackInput input = {.buffer = test_string,
+                                                   .n = strlen(test_string)};
+
+  int err = keyboard1_priv_ops->keyboard_callback(&input, &output);
+  TEST_ASSERT_EQUAL_INT(0, err);
+  TEST_ASSERT_EQUAL_size_t(sizeof(expected) / sizeof(expected[0]),
+                           output.input_events_length);
+  for (size_t i = 0; i < output.input_events_length; i++) {
+    TEST_ASSERT_EQUAL_INT(expected[i], events[i]);
+  }
+}
+
+void test_keyboard1_events_overflow(void) {
+  char test_string[] = "wwww";
+  enum InputEvents events[TEST_KEYBOARD1_EVENTS_MAX];
+  struct KeyboardKeysMappingCallbackOutput output = {.input_events = events,
+                                                     .input_events_max = 3};
+  struct KeyboardKeysMappingCallbackInput input = {.buffer = test_string,
+                                                   .n = strlen(test_string)};
+
+  int err = keyboard1_priv_ops->keyboard_callback(&input, &output);
+  TEST_ASSERT_EQUAL_INT(ENOBUFS, err);
+}
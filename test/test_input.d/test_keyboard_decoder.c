@@ -0,0 +1,115 @@
+#include <errno.h>
+#include <string.h>
+#include <unity.h>
+
+#include "input/keyboard/keyboard_decoder.h"
+#include "input/keyboard/keyboard_keys_mapping.h"
+
+#define TEST_DECODER_KEYS_MAX 16
+
+static struct KeyboardDecoderOps *decoder_ops;
+static struct KeyboardDecoder decoder;
+static keyboard_key_t keys[TEST_DECODER_KEYS_MAX];
+static size_t keys_length;
+
+static int feed(const char *str) {
+  return decoder_ops->feed(&decoder, str, strlen(str), keys,
+                           TEST_DECODER_KEYS_MAX, &keys_length);
+}
+
+void setUp(void) {
+  decoder_ops = get_keyboard_decoder_ops();
+  decoder_ops->init(&decoder);
+  keys_length = 0;
+}
+
+void tearDown(void) {}
+
+void test_keyboard_decoder_plain_bytes(void) {
+  TEST_ASSERT_EQUAL_INT(0, feed("wa\n"));
+
+  TEST_ASSERT_EQUAL_size_t(3, keys_length);
+  TEST_ASSERT_EQUAL_INT('w', keys[0]);
+  TEST_ASSERT_EQUAL_INT('a', keys[1]);
+  TEST_ASSERT_EQUAL_INT('\n', keys[2]);
+  TEST_ASSERT_FALSE(decoder_ops->is_pending(&decoder));
+}
+
+void test_keyboard_decoder_arrows(void) {
+  TEST_ASSERT_EQUAL_INT(0, feed("\033[A\033[B\033OC\033OD\033[1;5A"));
+
+  TEST_ASSERT_EQUAL_size_t(5, keys_length);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_UP, keys[0]);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_DOWN, keys[1]);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_RIGHT, keys[2]);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_LEFT, keys[3]);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_UP, keys[4]);
+}
+
+void test_keyboard_decoder_tilde_keys(void) {
+  TEST_ASSERT_EQUAL_INT(0, feed("\033[3~\033[5~\033[11~\033[99~"));
+
+  TEST_ASSERT_EQUAL_size_t(3, keys_length);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_DELETE, keys[0]);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_PAGE_UP, keys[1]);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_F1, keys[2]);
+}
+
+void test_keyboard_decoder_split_sequence(void) {
+  TEST_ASSERT_EQUAL_INT(0, feed("w\033"));
+  TEST_ASSERT_EQUAL_size_t(1, keys_length);
+  TEST_ASSERT_TRUE(decoder_ops->is_pending(&decoder));
+
+  TEST_ASSERT_EQUAL_INT(0, feed("["));
+  TEST_ASSERT_EQUAL_size_t(1, keys_length);
+  TEST_ASSERT_TRUE(decoder_ops->is_pending(&decoder));
+
+  TEST_ASSERT_EQUAL_INT(0, feed("Cs"));
+  TEST_ASSERT_EQUAL_size_t(3, keys_length);
+  TEST_ASSERT_EQUAL_INT('w', keys[0]);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_RIGHT, keys[1]);
+  TEST_ASSERT_EQUAL_INT('s', keys[2]);
+  TEST_ASSERT_FALSE(decoder_ops->is_pending(&decoder));
+}
+
+void test_keyboard_decoder_escape_followed_by_key(void) {
+  TEST_ASSERT_EQUAL_INT(0, feed("\033w"));
+
+  TEST_ASSERT_EQUAL_size_t(2, keys_length);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_ESCAPE, keys[0]);
+  TEST_ASSERT_EQUAL_INT('w', keys[1]);
+}
+
+void test_keyboard_decoder_flush(void) {
+  TEST_ASSERT_EQUAL_INT(0, feed("\033"));
+  TEST_ASSERT_EQUAL_size_t(0, keys_length);
+
+  TEST_ASSERT_EQUAL_INT(0, decoder_ops->flush(&decoder, keys,
+                                              TEST_DECODER_KEYS_MAX,
+                                              &keys_length));
+  TEST_ASSERT_EQUAL_size_t(1, keys_length);
+  TEST_ASSERT_EQUAL_INT(KEYBOARD_KEY_ESCAPE, keys[0]);
+
+  // Unfinished sequence is dropped.
+  TEST_ASSERT_EQUAL_INT(0, feed("\033[1"));
+  TEST_ASSERT_EQUAL_INT(0, decoder_ops->flush(&decoder, keys,
+                                              TEST_DECODER_KEYS_MAX,
+                                              &keys_length));
+  TEST_ASSERT_EQUAL_size_t(1, keys_length);
+  TEST_ASSERT_FALSE(decoder_ops->is_pending(&decoder));
+}
+
+void test_keyboard_decoder_unknown_sequence(void) {
+  TEST_ASSERT_EQUAL_INT(0, feed("\033[99Zd\033[\n"));
+
+  TEST_ASSERT_EQUAL_size_t(2, keys_length);
+  TEST_ASSERT_EQUAL_INT('d', keys[0]);
+  TEST_ASSERT_EQUAL_INT('\n', keys[1]);
+}
+
+void test_keyboard_decoder_full_keys(void) {
+  keys_length = TEST_DECODER_KEYS_MAX - 1;
+
+  TEST_ASSERT_EQUAL_INT(ENOBUFS, feed("ws"));
+  TEST_ASSERT_EQUAL_size_t(TEST_DECODER_KEYS_MAX, keys_length);
+}
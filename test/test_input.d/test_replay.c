@@ -0,0 +1,230 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#define _POSIX_C_SOURCE 200809L // setenv, mkstemp, clock_gettime
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <unity.h>
+
+// App's internal libs
+#include "config/config.h"
+#include "input/input.h"
+#include "input/input_common.h"
+#include "input/replay.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define MOCK_EVENTS_MAX 1024
+
+static struct LoggingUtilsOps *logging_ops;
+static struct InputReplayOps *replay_ops;
+static struct ConfigOps *config_ops;
+static struct InputOps *input_ops;
+static char replay_path[] = "/tmp/test_replay_XXXXXX";
+static enum InputEvents mock_events[MOCK_EVENTS_MAX];
+static size_t mock_events_length;
+static int mock_callback_err;
+
+static int mock_callback(enum InputEvents input_event,
+                         input_device_id_t device_id) {
+  int err;
+  (void)device_id;
+
+  // Queue is full once, replay has to deliver the event again.
+  if (mock_callback_err) {
+    err = mock_callback_err;
+    mock_callback_err = 0;
+    return err;
+  }
+
+  if (mock_events_length < MOCK_EVENTS_MAX) {
+    mock_events[mock_events_length++] = input_event;
+  }
+
+  return 0;
+}
+
+static void write_recording(const char *recording) {
+  FILE *file;
+
+  file = fopen(replay_path, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  fputs(recording, file);
+  fclose(file);
+}
+
+static void run_replay(const char *pacing) {
+  struct InputGetDeviceExtendedOutput get_device;
+
+  setenv(INPUT_REPLAY_PATH_VAR_NAME, replay_path, 1);
+  setenv(INPUT_REPLAY_PACING_VAR_NAME, pacing, 1);
+
+  TEST_ASSERT_EQUAL_INT(0, replay_ops->init());
+
+  TEST_ASSERT_EQUAL_INT(
+      0, input_ops->get_device_extended(
+             &(struct InputGetDeviceExtendedInput){
+                 .device_name = INPUT_REPLAY_DISP_NAME,
+                 .mode = INPUT_GET_DEVICE_BY_NAME},
+             &get_device));
+
+  TEST_ASSERT_EQUAL_INT(
+      0, input_ops->set_callback(
+             (struct InputSetCallbackInput){.callback = mock_callback,
+                                            .device_id = get_device.device_id},
+             &(struct InputSetCallbackOutput){}));
+
+  // Loop exits on its own once recording is over and nothing is watched.
+  TEST_ASSERT_EQUAL_INT(0, input_ops->start());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->wait());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->stop());
+}
+
+static uint64_t get_time_ms(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() {
+  int fd;
+
+  logging_ops = get_logging_utils_ops();
+  replay_ops = get_input_replay_ops();
+  config_ops = get_config_ops();
+  input_ops = get_input_ops();
+
+  logging_ops->init();
+  TEST_ASSERT_EQUAL_INT(0, config_ops->init());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->init());
+
+  strcpy(replay_path, "/tmp/test_replay_XXXXXX");
+  fd = mkstemp(replay_path);
+  TEST_ASSERT_NOT_EQUAL(-1, fd);
+  close(fd);
+
+  mock_events_length = 0;
+  mock_callback_err = 0;
+}
+
+void tearDown() {
+  replay_ops->destroy();
+  input_ops->destroy();
+  logging_ops->destroy();
+  unlink(replay_path);
+}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_replay_fast(void) {
+  enum InputEvents expected[] = {INPUT_EVENT_UP,    INPUT_EVENT_LEFT,
+                                 INPUT_EVENT_RIGHT, INPUT_EVENT_DOWN,
+                                 INPUT_EVENT_SELECT, INPUT_EVENT_EXIT};
+
+  write_recording("# recorded session\n"
+                  "0 0 up\n"
+                  "\n"
+                  "1000000 1 left\n"
+                  "2000000 0 right\n"
+                  "  3000000 1 2\n"
+                  "4000000 0 select\n"
+                  "5000000 1 exit");
+
+  mock_callback_err = ENOBUFS;
+
+  run_replay(INPUT_REPLAY_PACING_FAST);
+
+  TEST_ASSERT_EQUAL_size_t(6, mock_events_length);
+  for (size_t i = 0; i < 6; i++) {
+    TEST_ASSERT_EQUAL_INT(expected[i], mock_events[i]);
+  }
+}
+
+void test_replay_fast_many_chunks(void) {
+  FILE *file;
+
+  file = fopen(replay_path, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  for (size_t i = 0; i < MOCK_EVENTS_MAX; i++) {
+    fprintf(file, "%zu 0 %d\n", i * 1000000, INPUT_EVENT_UP + (int)(i % 4));
+  }
+  fclose(file);
+
+  run_replay(INPUT_REPLAY_PACING_FAST);
+
+  TEST_ASSERT_EQUAL_size_t(MOCK_EVENTS_MAX, mock_events_length);
+  for (size_t i = 0; i < MOCK_EVENTS_MAX; i++) {
+    TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP + i % 4, mock_events[i]);
+  }
+}
+
+void test_replay_original_pacing(void) {
+  uint64_t start;
+
+  // Timestamps are relative to the first event, not to the epoch.
+  write_recording("1000000 0 up\n"
+                  "1030000 0 down\n"
+                  "1060000 0 select\n");
+
+  start = get_time_ms();
+  run_replay(INPUT_REPLAY_PACING_ORIGINAL);
+
+  TEST_ASSERT_EQUAL_size_t(3, mock_events_length);
+  TEST_ASSERT_TRUE(get_time_ms() - start >= 60);
+}
+
+void test_replay_stops_at_invalid_line(void) {
+  write_recording("0 0 up\n"
+                  "1 0 jump\n"
+                  "2 0 down\n");
+
+  run_replay(INPUT_REPLAY_PACING_FAST);
+
+  TEST_ASSERT_EQUAL_size_t(1, mock_events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, mock_events[0]);
+}
+
+void test_replay_stops_at_line_starting_with_nul(void) {
+  const char recording[] = "0 0 up\n"
+                           "\0 0 down\n"
+                           "2 0 left\n";
+  FILE *file;
+
+  file = fopen(replay_path, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  fwrite(recording, 1, sizeof(recording) - 1, file);
+  fclose(file);
+
+  run_replay(INPUT_REPLAY_PACING_FAST);
+
+  TEST_ASSERT_EQUAL_size_t(1, mock_events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, mock_events[0]);
+}
+
+void test_replay_empty_recording(void) {
+  write_recording("# nothing recorded\n");
+
+  run_replay(INPUT_REPLAY_PACING_FAST);
+
+  TEST_ASSERT_EQUAL_size_t(0, mock_events_length);
+}
+
+void test_replay_unknown_pacing(void) {
+  setenv(INPUT_REPLAY_PATH_VAR_NAME, replay_path, 1);
+  setenv(INPUT_REPLAY_PACING_VAR_NAME, "slow", 1);
+
+  TEST_ASSERT_EQUAL_INT(EINVAL, replay_ops->init());
+}
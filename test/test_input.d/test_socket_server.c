@@ -0,0 +1,343 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#define _POSIX_C_SOURCE 200809L // setenv
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <unity.h>
+
+// App's internal libs
+#include "client/wire_client.h"
+#include "config/config.h"
+#include "input/input.h"
+#include "input/input_common.h"
+#include "input/input_uring.h"
+#include "input/socket_server.h"
+#include "input/wire_protocol.h"
+#include "utils/logging_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define MOCK_EVENTS_MAX 64
+#define IDLE_CLIENTS_AMOUNT 200
+#define BUSY_CLIENTS_AMOUNT 50
+
+struct MockDevice {
+  input_device_id_t device_id;
+  enum InputEvents events[MOCK_EVENTS_MAX];
+  size_t events_length;
+  size_t batches;
+};
+
+static struct LoggingUtilsOps *logging_ops;
+static struct InputSocketOps *socket_ops;
+static struct ConfigOps *config_ops;
+static struct InputOps *input_ops;
+static char socket_path[64];
+static struct MockDevice mock_devices[2];
+// Loop is stopped once that many events arrived, zero means on exit.
+static size_t mock_events_expected;
+
+static void mock_record(input_device_id_t device_id,
+                        enum InputEvents input_event) {
+  for (size_t i = 0; i < 2; i++) {
+    if (mock_devices[i].device_id == device_id &&
+        mock_devices[i].events_length < MOCK_EVENTS_MAX) {
+      mock_devices[i].events[mock_devices[i].events_length++] = input_event;
+    }
+  }
+
+  // Loop is stopped from its own thread, once the session is over.
+  if ((mock_events_expected == 0 && input_event == INPUT_EVENT_EXIT) ||
+      (mock_events_expected > 0 &&
+       mock_devices[0].events_length + mock_devices[1].events_length ==
+           mock_events_expected)) {
+    input_ops->request_stop();
+  }
+}
+
+static int mock_callback(enum InputEvents input_event,
+                         input_device_id_t device_id) {
+  mock_record(device_id, input_event);
+  return 0;
+}
+
+static int mock_batch_callback(const enum InputEvents *input_events,
+                               size_t input_events_length,
+                               input_device_id_t device_id) {
+  mock_devices[1].batches++;
+  for (size_t i = 0; i < input_events_length; i++) {
+    mock_record(device_id, input_events[i]);
+  }
+  return 0;
+}
+
+static void set_device_callback(size_t i, const char *device_name,
+                                input_batch_callback_func_t batch_callback) {
+  struct InputGetDeviceExtendedOutput get_device;
+
+  TEST_ASSERT_EQUAL_INT(
+      0, input_ops->get_device_extended(
+             &(struct InputGetDeviceExtendedInput){
+                 .device_name = (char *)device_name,
+                 .mode = INPUT_GET_DEVICE_BY_NAME},
+             &get_device));
+
+  mock_devices[i].device_id = get_device.device_id;
+
+  TEST_ASSERT_EQUAL_INT(
+      0, input_ops->set_callback(
+             (struct InputSetCallbackInput){.callback = mock_callback,
+                                            .batch_callback = batch_callback,
+                                            .device_id = get_device.device_id},
+             &(struct InputSetCallbackOutput){}));
+}
+
+static int connect_client(void) {
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  int fd;
+
+  fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  TEST_ASSERT_NOT_EQUAL(-1, fd);
+
+  strcpy(address.sun_path, socket_path);
+  TEST_ASSERT_EQUAL_INT(
+      0, connect(fd, (struct sockaddr *)&address, sizeof(address)));
+
+  return fd;
+}
+
+static void send_str(int fd, const char *str) {
+  TEST_ASSERT_EQUAL_INT(strlen(str), write(fd, str, strlen(str)));
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() {
+  char address[80];
+
+  logging_ops = get_logging_utils_ops();
+  socket_ops = get_input_socket_ops();
+  config_ops = get_config_ops();
+  input_ops = get_input_ops();
+
+  logging_ops->init();
+  TEST_ASSERT_EQUAL_INT(0, config_ops->init());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->init());
+
+  snprintf(socket_path, sizeof(socket_path), "/tmp/test_socket.%d", getpid());
+  snprintf(address, sizeof(address), "unix:%s", socket_path);
+  setenv(INPUT_SOCKET_ADDRESS_VAR_NAME, address, 1);
+
+  memset(mock_devices, 0, sizeof(mock_devices));
+  mock_events_expected = 0;
+
+  TEST_ASSERT_EQUAL_INT(0, socket_ops->init());
+  set_device_callback(0, "socket1", NULL);
+  set_device_callback(1, "socket2", mock_batch_callback);
+
+  TEST_ASSERT_EQUAL_INT(0, input_ops->start());
+}
+
+void tearDown() {
+  TEST_ASSERT_EQUAL_INT(0, input_ops->wait());
+  TEST_ASSERT_EQUAL_INT(0, input_ops->stop());
+
+  socket_ops->destroy();
+  input_ops->destroy();
+  logging_ops->destroy();
+
+  // Server cleans its socket up.
+  TEST_ASSERT_EQUAL_INT(-1, access(socket_path, F_OK));
+}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_socket_server_routes_users(void) {
+  int first_client = connect_client();
+  int second_client = connect_client();
+  size_t down_index = 0;
+
+  mock_events_expected = 6;
+
+  // Both users can be fed by one client too.
+  send_str(second_client, "user 2\r\nup\nleft\n3\nuser 1\nright\n");
+  send_str(first_client, "user 1\ndown\nsel");
+  send_str(first_client, "ect\n");
+
+  TEST_ASSERT_EQUAL_INT(0, input_ops->wait());
+
+  TEST_ASSERT_EQUAL_size_t(3, mock_devices[1].events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, mock_devices[1].events[0]);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_LEFT, mock_devices[1].events[1]);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_LEFT, mock_devices[1].events[2]);
+  TEST_ASSERT_TRUE(mock_devices[1].batches >= 1);
+
+  // Clients are independent, only each client's own order is kept.
+  TEST_ASSERT_EQUAL_size_t(3, mock_devices[0].events_length);
+  if (mock_devices[0].events[0] == INPUT_EVENT_RIGHT) {
+    down_index = 1;
+  } else if (mock_devices[0].events[2] == INPUT_EVENT_RIGHT) {
+    down_index = 0;
+  } else {
+    TEST_FAIL_MESSAGE("Client's events are interleaved");
+  }
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_DOWN, mock_devices[0].events[down_index]);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_SELECT,
+                        mock_devices[0].events[down_index + 1]);
+
+  close(first_client);
+  close(second_client);
+}
+
+void test_socket_server_closes_invalid_client(void) {
+  struct InputSocketStats stats;
+  char buffer[8];
+  int invalid_client = connect_client();
+  int unused_user_client = connect_client();
+  int client;
+
+  // Events before user is known go nowhere.
+  send_str(invalid_client, "up\n");
+  TEST_ASSERT_EQUAL_INT(0, read(invalid_client, buffer, sizeof(buffer)));
+
+  // Third user does not play over the socket.
+  send_str(unused_user_client, "user 3\n");
+  TEST_ASSERT_EQUAL_INT(0, read(unused_user_client, buffer, sizeof(buffer)));
+
+  client = connect_client();
+  send_str(client, "user 1\nexit\n");
+
+  TEST_ASSERT_EQUAL_INT(0, input_ops->wait());
+
+  socket_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(3, stats.accepted);
+  TEST_ASSERT_EQUAL_size_t(2, stats.protocol_errors);
+  TEST_ASSERT_EQUAL_size_t(1, stats.events);
+
+  close(invalid_client);
+  close(unused_user_client);
+  close(client);
+}
+
+void test_socket_server_many_idle_clients(void) {
+  int clients[IDLE_CLIENTS_AMOUNT];
+  struct InputSocketStats stats;
+
+  for (size_t i = 0; i < IDLE_CLIENTS_AMOUNT; i++) {
+    clients[i] = connect_client();
+  }
+
+  send_str(clients[IDLE_CLIENTS_AMOUNT - 1], "user 2\nexit\n");
+
+  TEST_ASSERT_EQUAL_INT(0, input_ops->wait());
+
+  socket_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(IDLE_CLIENTS_AMOUNT, stats.accepted);
+  TEST_ASSERT_EQUAL_size_t(1, mock_devices[1].events_length);
+
+  for (size_t i = 0; i < IDLE_CLIENTS_AMOUNT; i++) {
+    close(clients[i]);
+  }
+}
+
+void test_socket_server_binary_protocol(void) {
+  const enum InputEvents first_move[] = {INPUT_EVENT_UP, INPUT_EVENT_LEFT};
+  const enum InputEvents second_move[] = {INPUT_EVENT_SELECT};
+  const enum InputEvents third_move[] = {INPUT_EVENT_DOWN};
+  // Hello from newer client, followed by frame cut after record's head.
+  const uint8_t newer_hello[] = {INPUT_WIRE_MAGIC, INPUT_WIRE_VERSION + 1};
+  const uint8_t invalid_frame[] = {1, 1 << 2};
+  struct WireClientOps *client_ops = get_wire_client_ops();
+  struct InputSocketStats stats;
+  struct WireClient client;
+  uint8_t buffer[INPUT_WIRE_HELLO_LENGTH];
+  char address[80];
+  int raw_client;
+
+  mock_events_expected = 4;
+
+  raw_client = connect_client();
+  TEST_ASSERT_EQUAL_INT(sizeof(newer_hello),
+                        write(raw_client, newer_hello, sizeof(newer_hello)));
+  TEST_ASSERT_EQUAL_INT(sizeof(buffer),
+                        read(raw_client, buffer, sizeof(buffer)));
+  TEST_ASSERT_EQUAL_HEX8(INPUT_WIRE_MAGIC, buffer[0]);
+  TEST_ASSERT_EQUAL_HEX8(INPUT_WIRE_VERSION, buffer[1]);
+
+  TEST_ASSERT_EQUAL_INT(sizeof(invalid_frame), write(raw_client, invalid_frame,
+                                                     sizeof(invalid_frame)));
+  TEST_ASSERT_EQUAL_INT(0, read(raw_client, buffer, sizeof(buffer)));
+
+  // Hello and all three moves go out in one write.
+  snprintf(address, sizeof(address), "unix:%s", socket_path);
+  TEST_ASSERT_EQUAL_INT(0, client_ops->connect(&client, address, false));
+  TEST_ASSERT_EQUAL_INT(0, client_ops->queue_move(&client, 2, first_move, 2));
+  TEST_ASSERT_EQUAL_INT(0,
+                        client_ops->queue_move(&client, 1, second_move, 1));
+  TEST_ASSERT_EQUAL_INT(0, client_ops->queue_move(&client, 2, third_move, 1));
+  TEST_ASSERT_EQUAL_INT(0, client_ops->flush(&client));
+  TEST_ASSERT_EQUAL_size_t(3, client.moves_sent);
+
+  while (client.moves_acked < client.moves_sent) {
+    TEST_ASSERT_EQUAL_INT(0, client_ops->receive(&client));
+  }
+  TEST_ASSERT_EQUAL_UINT8(INPUT_WIRE_VERSION, client.version);
+
+  TEST_ASSERT_EQUAL_INT(0, input_ops->wait());
+
+  TEST_ASSERT_EQUAL_size_t(3, mock_devices[1].events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, mock_devices[1].events[0]);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_LEFT, mock_devices[1].events[1]);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_DOWN, mock_devices[1].events[2]);
+  TEST_ASSERT_EQUAL_size_t(1, mock_devices[0].events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_SELECT, mock_devices[0].events[0]);
+
+  socket_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(2, stats.frames);
+  TEST_ASSERT_EQUAL_size_t(1, stats.protocol_errors);
+
+  client_ops->close(&client);
+  close(raw_client);
+}
+
+void test_socket_server_batches_uring_syscalls(void) {
+  int clients[BUSY_CLIENTS_AMOUNT];
+  struct InputUringStats stats;
+
+  if (!get_input_uring_ops()->is_supported()) {
+    // Loop still has to be stopped for tear down.
+    input_ops->request_stop();
+    TEST_IGNORE_MESSAGE("io_uring backend is not compiled in.");
+  }
+
+  mock_events_expected = BUSY_CLIENTS_AMOUNT;
+
+  for (size_t i = 0; i < BUSY_CLIENTS_AMOUNT; i++) {
+    clients[i] = connect_client();
+    send_str(clients[i], "user 1\nup\n");
+  }
+
+  TEST_ASSERT_EQUAL_INT(0, input_ops->wait());
+
+  TEST_ASSERT_EQUAL_size_t(BUSY_CLIENTS_AMOUNT, mock_devices[0].events_length);
+
+  // Each client costs at least accept and receive completion, they are
+  //  processed in batches rather than syscall by syscall.
+  get_input_uring_ops()->get_stats(&stats);
+  TEST_ASSERT_TRUE(stats.completions >= 2 * BUSY_CLIENTS_AMOUNT);
+  TEST_ASSERT_TRUE(stats.enters < stats.completions);
+
+  for (size_t i = 0; i < BUSY_CLIENTS_AMOUNT; i++) {
+    close(clients[i]);
+  }
+}
@@ -0,0 +1,277 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+
+// App's internal libs
+#include "game/user_move.h"
+#include "input/input_common.h"
+#include "input/wire_protocol.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+static struct InputWireOps *wire_ops;
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() { wire_ops = get_input_wire_ops(); }
+
+void tearDown() {}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_wire_protocol_varint(void) {
+  const uint32_t values[] = {0, 1, 127, 128, 300, 16384, UINT32_MAX};
+  const size_t lengths[] = {1, 1, 1, 2, 2, 3, 5};
+  const uint8_t too_long[] = {0xFF, 0xFF, 0xFF, 0xFF, 0x1F};
+  uint8_t buffer[INPUT_WIRE_VARINT_MAX];
+  size_t value_length;
+  size_t length;
+  uint32_t value;
+
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    length = wire_ops->encode_varint(values[i], buffer);
+    TEST_ASSERT_EQUAL_size_t(lengths[i], length);
+
+    // Varint is complete only with its last byte.
+    TEST_ASSERT_EQUAL_INT(EAGAIN, wire_ops->decode_varint(buffer, length - 1,
+                                                          &value,
+                                                          &value_length));
+    TEST_ASSERT_EQUAL_INT(
+        0, wire_ops->decode_varint(buffer, length, &value, &value_length));
+    TEST_ASSERT_EQUAL_UINT32(values[i], value);
+    TEST_ASSERT_EQUAL_size_t(length, value_length);
+  }
+
+  TEST_ASSERT_EQUAL_INT(EPROTO,
+                        wire_ops->decode_varint(too_long, sizeof(too_long),
+                                                &value, &value_length));
+}
+
+void test_wire_protocol_events_frame(void) {
+  const enum InputEvents first[] = {INPUT_EVENT_UP, INPUT_EVENT_LEFT,
+                                    INPUT_EVENT_SELECT};
+  const enum InputEvents second[] = {INPUT_EVENT_EXIT};
+  uint8_t payload[INPUT_WIRE_PAYLOAD_MAX];
+  uint8_t buffer[INPUT_WIRE_FRAME_MAX];
+  struct InputWireRecord record;
+  struct InputWireFrame frame;
+  size_t payload_length = 0;
+  size_t frame_length;
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->compose_events(payload, &payload_length,
+                                                    2, first, 3));
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->compose_events(payload, &payload_length,
+                                                    1, second, 1));
+
+  // Two moves, four events, fit into eight bytes with length prefix.
+  frame_length = wire_ops->compose_frame(payload, payload_length, buffer);
+  TEST_ASSERT_EQUAL_size_t(8, frame_length);
+  TEST_ASSERT_EQUAL_HEX8(7, buffer[0]);
+  TEST_ASSERT_EQUAL_HEX8(2 << 2, buffer[1]);
+  TEST_ASSERT_EQUAL_HEX8(3, buffer[2]);
+  TEST_ASSERT_EQUAL_HEX8(INPUT_EVENT_LEFT << 4 | INPUT_EVENT_UP, buffer[3]);
+  TEST_ASSERT_EQUAL_HEX8(INPUT_EVENT_SELECT, buffer[4]);
+
+  for (size_t i = 0; i < frame_length; i++) {
+    TEST_ASSERT_EQUAL_INT(EAGAIN, wire_ops->parse_frame(buffer, i, &frame));
+  }
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_frame(buffer, frame_length,
+                                                 &frame));
+  TEST_ASSERT_EQUAL_size_t(frame_length, frame.frame_length);
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_record(&frame, &record));
+  TEST_ASSERT_EQUAL_INT(INPUT_WIRE_EVENTS, record.kind);
+  TEST_ASSERT_EQUAL_UINT32(2, record.user);
+  TEST_ASSERT_EQUAL_size_t(3, record.events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_UP, record.events[0]);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_LEFT, record.events[1]);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_SELECT, record.events[2]);
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_record(&frame, &record));
+  TEST_ASSERT_EQUAL_UINT32(1, record.user);
+  TEST_ASSERT_EQUAL_size_t(1, record.events_length);
+  TEST_ASSERT_EQUAL_INT(INPUT_EVENT_EXIT, record.events[0]);
+
+  TEST_ASSERT_EQUAL_INT(ENOENT, wire_ops->parse_record(&frame, &record));
+}
+
+void test_wire_protocol_ack_frame(void) {
+  uint8_t payload[INPUT_WIRE_PAYLOAD_MAX];
+  uint8_t buffer[INPUT_WIRE_FRAME_MAX];
+  struct InputWireRecord record;
+  struct InputWireFrame frame;
+  size_t payload_length = 0;
+  size_t frame_length;
+
+  TEST_ASSERT_EQUAL_INT(0,
+                        wire_ops->compose_ack(payload, &payload_length, 300));
+  frame_length = wire_ops->compose_frame(payload, payload_length, buffer);
+  TEST_ASSERT_EQUAL_size_t(4, frame_length);
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_frame(buffer, frame_length,
+                                                 &frame));
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_record(&frame, &record));
+  TEST_ASSERT_EQUAL_INT(INPUT_WIRE_ACK, record.kind);
+  TEST_ASSERT_EQUAL_UINT32(300, record.moves);
+}
+
+void test_wire_protocol_move_and_result(void) {
+  uint8_t payload[INPUT_WIRE_PAYLOAD_MAX];
+  uint8_t buffer[INPUT_WIRE_FRAME_MAX];
+  struct InputWireRecord record;
+  struct InputWireFrame frame;
+  size_t payload_length = 0;
+  size_t frame_length;
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->compose_move(
+                               payload, &payload_length, 3,
+                               USER_MOVE_TYPE_SELECT_INVALID, 2, 10));
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->compose_result(payload, &payload_length,
+                                                    0, 121));
+  TEST_ASSERT_EQUAL_INT(EINVAL, wire_ops->compose_move(
+                                    payload, &payload_length, 1,
+                                    USER_MOVE_TYPE_HIGHLIGHT, 0, 0));
+
+  frame_length = wire_ops->compose_frame(payload, payload_length, buffer);
+  TEST_ASSERT_EQUAL_size_t(8, frame_length);
+  TEST_ASSERT_EQUAL_HEX8(3 << 2 | INPUT_WIRE_MOVE, buffer[1]);
+  TEST_ASSERT_EQUAL_HEX8(INPUT_WIRE_GAME, buffer[5]);
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_frame(buffer, frame_length,
+                                                 &frame));
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_record(&frame, &record));
+  TEST_ASSERT_EQUAL_INT(INPUT_WIRE_MOVE, record.kind);
+  TEST_ASSERT_EQUAL_UINT32(3, record.user);
+  TEST_ASSERT_EQUAL_UINT32(USER_MOVE_TYPE_SELECT_INVALID, record.move_type);
+  TEST_ASSERT_EQUAL_UINT32(2, record.x);
+  TEST_ASSERT_EQUAL_UINT32(10, record.y);
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_record(&frame, &record));
+  TEST_ASSERT_EQUAL_INT(INPUT_WIRE_GAME, record.kind);
+  TEST_ASSERT_EQUAL_INT(INPUT_WIRE_GAME_RESULT, record.game);
+  TEST_ASSERT_EQUAL_UINT32(0, record.user);
+  TEST_ASSERT_EQUAL_UINT32(121, record.moves);
+
+  TEST_ASSERT_EQUAL_INT(ENOENT, wire_ops->parse_record(&frame, &record));
+}
+
+void test_wire_protocol_join_and_start(void) {
+  // Join telling a seat and start without one.
+  const uint8_t seated_join[] = {4, 1 << 2 | 3, 1, 2, 3};
+  const uint8_t no_seat[] = {4, 3, 2, 2, 3};
+  uint8_t payload[INPUT_WIRE_PAYLOAD_MAX];
+  uint8_t buffer[INPUT_WIRE_FRAME_MAX];
+  struct InputWireRecord record;
+  struct InputWireFrame frame;
+  size_t payload_length = 0;
+  size_t frame_length;
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->compose_join(payload, &payload_length,
+                                                  4, 7));
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->compose_start(payload, &payload_length,
+                                                   2, 4, 7));
+  TEST_ASSERT_EQUAL_INT(EINVAL, wire_ops->compose_start(
+                                    payload, &payload_length, 0, 4, 7));
+
+  frame_length = wire_ops->compose_frame(payload, payload_length, buffer);
+  TEST_ASSERT_EQUAL_size_t(9, frame_length);
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_frame(buffer, frame_length,
+                                                 &frame));
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_record(&frame, &record));
+  TEST_ASSERT_EQUAL_INT(INPUT_WIRE_GAME, record.kind);
+  TEST_ASSERT_EQUAL_INT(INPUT_WIRE_GAME_JOIN, record.game);
+  TEST_ASSERT_EQUAL_UINT32(0, record.user);
+  TEST_ASSERT_EQUAL_UINT32(4, record.users);
+  TEST_ASSERT_EQUAL_UINT32(7, record.board_size);
+
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_record(&frame, &record));
+  TEST_ASSERT_EQUAL_INT(INPUT_WIRE_GAME_START, record.game);
+  TEST_ASSERT_EQUAL_UINT32(2, record.user);
+  TEST_ASSERT_EQUAL_UINT32(4, record.users);
+  TEST_ASSERT_EQUAL_UINT32(7, record.board_size);
+
+  TEST_ASSERT_EQUAL_INT(ENOENT, wire_ops->parse_record(&frame, &record));
+
+  frame_length = sizeof(seated_join);
+  memcpy(buffer, seated_join, frame_length);
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_frame(buffer, frame_length,
+                                                 &frame));
+  TEST_ASSERT_EQUAL_INT(EPROTO, wire_ops->parse_record(&frame, &record));
+
+  frame_length = sizeof(no_seat);
+  memcpy(buffer, no_seat, frame_length);
+  TEST_ASSERT_EQUAL_INT(0, wire_ops->parse_frame(buffer, frame_length,
+                                                 &frame));
+  TEST_ASSERT_EQUAL_INT(EPROTO, wire_ops->parse_record(&frame, &record));
+}
+
+void test_wire_protocol_invalid_frames(void) {
+  // Empty payload, too long payload, unknown event, odd count with
+  //  non zero padding, events of user 0, record past payload's end,
+  //  unknown game record and move without coordinates.
+  const uint8_t empty[] = {0};
+  const uint8_t too_long[] = {0x80, 0x01};
+  const uint8_t unknown_event[] = {3, 1 << 2, 1, 0x07};
+  const uint8_t padding[] = {3, 1 << 2, 1, 0x11};
+  const uint8_t no_user[] = {3, 0, 1, 0x01};
+  const uint8_t truncated[] = {3, 1 << 2, 4, 0x11};
+  const uint8_t unknown_kind[] = {2, 1 << 2 | 3, 7};
+  const uint8_t no_coordinates[] = {3, 1 << 2 | 2, 1, 0};
+  const uint8_t *invalid[] = {unknown_event, padding,      no_user,
+                              truncated,     unknown_kind, no_coordinates};
+  const size_t invalid_lengths[] = {
+      sizeof(unknown_event), sizeof(padding),      sizeof(no_user),
+      sizeof(truncated),     sizeof(unknown_kind), sizeof(no_coordinates)};
+  const enum InputEvents events[] = {INPUT_EVENT_INVALID};
+  uint8_t payload[INPUT_WIRE_PAYLOAD_MAX];
+  struct InputWireRecord record;
+  struct InputWireFrame frame;
+  size_t payload_length = 0;
+
+  TEST_ASSERT_EQUAL_INT(EMSGSIZE,
+                        wire_ops->parse_frame(empty, sizeof(empty), &frame));
+  TEST_ASSERT_EQUAL_INT(EMSGSIZE, wire_ops->parse_frame(
+                                      too_long, sizeof(too_long), &frame));
+
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    TEST_ASSERT_EQUAL_INT(
+        0, wire_ops->parse_frame(invalid[i], invalid_lengths[i], &frame));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(
+        EPROTO, wire_ops->parse_record(&frame, &record), "Invalid record");
+  }
+
+  TEST_ASSERT_EQUAL_INT(EINVAL, wire_ops->compose_events(
+                                    payload, &payload_length, 1, events, 1));
+}
+
+void test_wire_protocol_full_payload(void) {
+  enum InputEvents events[INPUT_WIRE_EVENTS_MAX];
+  uint8_t payload[INPUT_WIRE_PAYLOAD_MAX];
+  size_t payload_length = 0;
+  size_t moves = 0;
+
+  for (size_t i = 0; i < INPUT_WIRE_EVENTS_MAX; i++) {
+    events[i] = INPUT_EVENT_DOWN;
+  }
+
+  // Each move takes head, count and one byte of two events.
+  while (wire_ops->compose_events(payload, &payload_length, 1, events, 2) ==
+         0) {
+    moves++;
+  }
+
+  TEST_ASSERT_EQUAL_size_t(INPUT_WIRE_PAYLOAD_MAX / 3, moves);
+  TEST_ASSERT_EQUAL_size_t(3 * moves, payload_length);
+  TEST_ASSERT_EQUAL_INT(ENOBUFS, wire_ops->compose_events(
+                                     payload, &payload_length, 1, events, 2));
+}
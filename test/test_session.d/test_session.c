@@ -0,0 +1,155 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#include <errno.h>
+#include <stddef.h>
+#include <unity.h>
+
+// App's internal libs
+#include "game/user_move.h"
+#include "input/input_common.h"
+#include "session/session.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define EVENTS_MAX (2 * SESSION_BOARD_MAX + 1)
+
+static struct SessionOps *session_ops;
+static struct Session session;
+
+// Moves cursor to the cell with rights and downs only, then selects it.
+static int play(game_user_id_t user, int x, int y) {
+  enum InputEvents events[EVENTS_MAX];
+  struct UserMove moves[EVENTS_MAX];
+  size_t events_length = 0;
+  int size = session.board_size;
+  size_t moves_length;
+
+  for (int i = 0; i < (x - session.cursor.x + size) % size; i++) {
+    events[events_length++] = INPUT_EVENT_RIGHT;
+  }
+  for (int i = 0; i < (y - session.cursor.y + size) % size; i++) {
+    events[events_length++] = INPUT_EVENT_DOWN;
+  }
+  events[events_length++] = INPUT_EVENT_SELECT;
+
+  return session_ops->process_events(&session, user, events, events_length,
+                                     moves, &moves_length);
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() {
+  session_ops = get_session_ops();
+  TEST_ASSERT_EQUAL_INT(0, session_ops->init(&session, 2, 3));
+}
+
+void tearDown() {}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_session_init(void) {
+  TEST_ASSERT_EQUAL_INT(EINVAL, session_ops->init(&session, 1, 2));
+  TEST_ASSERT_EQUAL_INT(EINVAL, session_ops->init(&session, 3, 3));
+  TEST_ASSERT_EQUAL_INT(EINVAL, session_ops->init(&session, 2,
+                                                  SESSION_BOARD_MAX + 1));
+
+  TEST_ASSERT_EQUAL_INT(0, session_ops->init(&session, 3, 5));
+  TEST_ASSERT_EQUAL_INT(SESSION_STATE_PLAY, session.state);
+  TEST_ASSERT_EQUAL_INT(0, session.current_user);
+  TEST_ASSERT_EQUAL_INT(1, session.cursor.x);
+  TEST_ASSERT_EQUAL_INT(1, session.cursor.y);
+}
+
+void test_session_turns(void) {
+  const enum InputEvents events[] = {INPUT_EVENT_SELECT, INPUT_EVENT_UP,
+                                     INPUT_EVENT_UP, INPUT_EVENT_SELECT,
+                                     INPUT_EVENT_LEFT};
+  struct UserMove moves[sizeof(events) / sizeof(events[0])];
+  size_t moves_length;
+
+  TEST_ASSERT_EQUAL_INT(EPERM, session_ops->process_events(
+                                   &session, 1, events, 1, moves,
+                                   &moves_length));
+
+  TEST_ASSERT_EQUAL_INT(0, session_ops->process_events(&session, 0, events,
+                                                       1, moves,
+                                                       &moves_length));
+  TEST_ASSERT_EQUAL_size_t(1, moves_length);
+  TEST_ASSERT_EQUAL_INT(USER_MOVE_TYPE_SELECT_VALID, moves[0].type);
+  TEST_ASSERT_EQUAL_INT(1, session.current_user);
+
+  // Taken cell keeps user on turn, cursor wraps around the board and
+  //  events past valid select are dropped.
+  TEST_ASSERT_EQUAL_INT(
+      0, session_ops->process_events(&session, 1, events,
+                                     sizeof(events) / sizeof(events[0]),
+                                     moves, &moves_length));
+  TEST_ASSERT_EQUAL_size_t(2, moves_length);
+  TEST_ASSERT_EQUAL_INT(USER_MOVE_TYPE_SELECT_INVALID, moves[0].type);
+  TEST_ASSERT_EQUAL_INT(USER_MOVE_TYPE_SELECT_VALID, moves[1].type);
+  TEST_ASSERT_EQUAL_INT(1, moves[1].user_id);
+  TEST_ASSERT_EQUAL_INT(1, moves[1].coordinates.x);
+  TEST_ASSERT_EQUAL_INT(2, moves[1].coordinates.y);
+  TEST_ASSERT_EQUAL_INT(1, session.cursor.x);
+  TEST_ASSERT_EQUAL_INT(0, session.current_user);
+}
+
+void test_session_win(void) {
+  const int cells[][2] = {{0, 1}, {1, 1}, {0, 0}, {1, 0}, {0, 2}};
+  for (size_t i = 0; i < sizeof(cells) / sizeof(cells[0]); i++) {
+    TEST_ASSERT_EQUAL_INT(SESSION_STATE_PLAY, session.state);
+    TEST_ASSERT_EQUAL_INT(0, play(i % 2, cells[i][0], cells[i][1]));
+  }
+
+  TEST_ASSERT_EQUAL_INT(SESSION_STATE_WIN, session.state);
+  TEST_ASSERT_EQUAL_INT(0, session.winner);
+  TEST_ASSERT_EQUAL_size_t(5, session.valid_moves);
+
+  // Game is over for everyone.
+  TEST_ASSERT_EQUAL_INT(EPERM, play(1, 2, 2));
+  TEST_ASSERT_EQUAL_INT(EPERM, play(0, 2, 2));
+}
+
+void test_session_diagonal_win(void) {
+  const int cells[][2] = {{2, 0}, {0, 0}, {1, 1}, {1, 0}, {0, 2}};
+
+  for (size_t i = 0; i < sizeof(cells) / sizeof(cells[0]); i++) {
+    TEST_ASSERT_EQUAL_INT(0, play(i % 2, cells[i][0], cells[i][1]));
+  }
+
+  TEST_ASSERT_EQUAL_INT(SESSION_STATE_WIN, session.state);
+  TEST_ASSERT_EQUAL_INT(0, session.winner);
+}
+
+void test_session_draw(void) {
+  const int cells[][2] = {{0, 0}, {1, 0}, {2, 0}, {1, 1}, {0, 1},
+                          {2, 1}, {1, 2}, {0, 2}, {2, 2}};
+
+  for (size_t i = 0; i < sizeof(cells) / sizeof(cells[0]); i++) {
+    TEST_ASSERT_EQUAL_INT(SESSION_STATE_PLAY, session.state);
+    TEST_ASSERT_EQUAL_INT(0, play(i % 2, cells[i][0], cells[i][1]));
+  }
+
+  TEST_ASSERT_EQUAL_INT(SESSION_STATE_DRAW, session.state);
+  TEST_ASSERT_EQUAL_size_t(9, session.valid_moves);
+}
+
+void test_session_quit(void) {
+  const enum InputEvents events[] = {INPUT_EVENT_RIGHT, INPUT_EVENT_EXIT,
+                                     INPUT_EVENT_SELECT};
+  struct UserMove moves[3];
+  size_t moves_length;
+
+  TEST_ASSERT_EQUAL_INT(0, session_ops->process_events(&session, 0, events, 3,
+                                                       moves, &moves_length));
+  TEST_ASSERT_EQUAL_size_t(1, moves_length);
+  TEST_ASSERT_EQUAL_INT(USER_MOVE_TYPE_QUIT, moves[0].type);
+  TEST_ASSERT_EQUAL_INT(2, moves[0].coordinates.x);
+  TEST_ASSERT_EQUAL_INT(SESSION_STATE_QUIT, session.state);
+  TEST_ASSERT_EQUAL_size_t(0, session.valid_moves);
+}
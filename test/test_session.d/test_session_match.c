@@ -0,0 +1,189 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#define _POSIX_C_SOURCE 200809L // nanosleep
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <unity.h>
+
+// App's internal libs
+#include "session/session_match.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define MOCK_GROUPS_MAX 8
+#define MOCK_TICKETS_AMOUNT 8
+#define WAITS_MAX 5000
+
+static struct SessionMatchOps *match_ops;
+static struct SessionMatchGroup mock_groups[MOCK_GROUPS_MAX];
+static atomic_size_t mock_groups_length;
+static int mock_callback_error;
+static int fds[MOCK_TICKETS_AMOUNT];
+
+// Runs on matcher's thread, test reads groups only once it saw their count.
+static int mock_callback(const struct SessionMatchGroup *group) {
+  size_t length = atomic_load(&mock_groups_length);
+
+  if (mock_callback_error) {
+    return mock_callback_error;
+  }
+
+  if (length < MOCK_GROUPS_MAX) {
+    mock_groups[length] = *group;
+    atomic_store(&mock_groups_length, length + 1);
+  }
+
+  return 0;
+}
+
+static void enqueue(size_t i, size_t users_amount, size_t board_size) {
+  struct SessionMatchTicket ticket = {
+      .fd = fds[i],
+      .version = 1,
+      .queued_ns = match_ops->get_timestamp(),
+  };
+
+  TEST_ASSERT_EQUAL_INT(
+      0, match_ops->enqueue(&ticket, users_amount, board_size));
+}
+
+static void wait_for_groups(size_t groups_length) {
+  struct timespec delay = {.tv_nsec = 1000000};
+
+  for (size_t i = 0; i < WAITS_MAX; i++) {
+    if (atomic_load(&mock_groups_length) >= groups_length) {
+      return;
+    }
+    nanosleep(&delay, NULL);
+  }
+
+  TEST_FAIL_MESSAGE("Matcher did not seat the groups");
+}
+
+static bool is_open(int fd) { return fcntl(fd, F_GETFD) != -1; }
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() {
+  match_ops = get_session_match_ops();
+  memset(mock_groups, 0, sizeof(mock_groups));
+  atomic_store(&mock_groups_length, 0);
+  mock_callback_error = 0;
+
+  // Matcher owns tickets' sockets, any descriptors do for it.
+  for (size_t i = 0; i < MOCK_TICKETS_AMOUNT; i++) {
+    fds[i] = dup(STDERR_FILENO);
+    TEST_ASSERT_NOT_EQUAL(-1, fds[i]);
+  }
+
+  TEST_ASSERT_EQUAL_INT(0, match_ops->start(mock_callback));
+}
+
+void tearDown() {
+  match_ops->stop();
+
+  // Descriptors the matcher handed to callback are left to the test.
+  for (size_t i = 0; i < MOCK_TICKETS_AMOUNT; i++) {
+    if (is_open(fds[i])) {
+      close(fds[i]);
+    }
+  }
+}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_session_match_seats_groups(void) {
+  struct SessionMatchStats stats;
+  size_t seated = 0;
+
+  TEST_ASSERT_EQUAL_INT(EALREADY, match_ops->start(mock_callback));
+
+  // Two buckets fill up in between each other.
+  enqueue(0, 2, 3);
+  enqueue(1, 3, 4);
+  enqueue(2, 2, 3);
+  enqueue(3, 3, 4);
+  enqueue(4, 2, 3);
+  enqueue(5, 3, 4);
+  wait_for_groups(2);
+
+  for (size_t i = 0; i < 2; i++) {
+    if (mock_groups[i].users_amount == 2) {
+      TEST_ASSERT_EQUAL_size_t(3, mock_groups[i].board_size);
+      TEST_ASSERT_EQUAL_INT(fds[0], mock_groups[i].tickets[0].fd);
+      TEST_ASSERT_EQUAL_INT(fds[2], mock_groups[i].tickets[1].fd);
+    } else {
+      TEST_ASSERT_EQUAL_size_t(3, mock_groups[i].users_amount);
+      TEST_ASSERT_EQUAL_size_t(4, mock_groups[i].board_size);
+      TEST_ASSERT_EQUAL_INT(fds[1], mock_groups[i].tickets[0].fd);
+      TEST_ASSERT_EQUAL_INT(fds[3], mock_groups[i].tickets[1].fd);
+      TEST_ASSERT_EQUAL_INT(fds[5], mock_groups[i].tickets[2].fd);
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, mock_groups[i].tickets[0].version);
+  }
+
+  // The fifth player still waits for its partner, stop disconnects it.
+  match_ops->stop();
+  TEST_ASSERT_FALSE(is_open(fds[4]));
+  TEST_ASSERT_TRUE(is_open(fds[0]));
+
+  match_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(2, stats.sessions);
+  TEST_ASSERT_EQUAL_size_t(5, stats.players);
+  TEST_ASSERT_EQUAL_size_t(0, stats.dropped);
+  TEST_ASSERT_TRUE(stats.wait_ns_max <= stats.wait_ns_total);
+  for (size_t i = 0; i < SESSION_MATCH_HISTOGRAM_LENGTH; i++) {
+    seated += stats.wait_histogram[i];
+  }
+  TEST_ASSERT_EQUAL_size_t(5, seated);
+}
+
+void test_session_match_invalid_game(void) {
+  struct SessionMatchTicket ticket = {.fd = fds[0]};
+
+  TEST_ASSERT_EQUAL_INT(EINVAL, match_ops->enqueue(NULL, 2, 3));
+  TEST_ASSERT_EQUAL_INT(EINVAL, match_ops->enqueue(&ticket, 1, 3));
+  TEST_ASSERT_EQUAL_INT(EINVAL, match_ops->enqueue(&ticket, 2, 2));
+  TEST_ASSERT_EQUAL_INT(EINVAL, match_ops->enqueue(
+                                    &ticket, 2, SESSION_BOARD_MAX + 1));
+  TEST_ASSERT_EQUAL_INT(EINVAL, match_ops->enqueue(
+                                    &ticket, SESSION_USERS_MAX + 1,
+                                    SESSION_BOARD_MAX));
+
+  // Rejected ticket stays caller's.
+  TEST_ASSERT_TRUE(is_open(fds[0]));
+}
+
+void test_session_match_callback_failure(void) {
+  struct SessionMatchStats stats;
+  struct timespec delay = {.tv_nsec = 1000000};
+
+  mock_callback_error = ENOBUFS;
+
+  enqueue(0, 2, 3);
+  enqueue(1, 2, 3);
+
+  // Group nobody hosts is disconnected.
+  for (size_t i = 0; i < WAITS_MAX && is_open(fds[1]); i++) {
+    nanosleep(&delay, NULL);
+  }
+  TEST_ASSERT_FALSE(is_open(fds[1]));
+
+  match_ops->stop();
+  TEST_ASSERT_FALSE(is_open(fds[0]));
+
+  match_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(0, stats.sessions);
+  TEST_ASSERT_EQUAL_size_t(2, stats.dropped);
+  TEST_ASSERT_EQUAL_size_t(2, stats.queued);
+}
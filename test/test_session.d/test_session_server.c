@@ -0,0 +1,343 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#define _POSIX_C_SOURCE 200809L // snprintf
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <unity.h>
+
+// App's internal libs
+#include "client/wire_client.h"
+#include "game/user_move.h"
+#include "input/input_common.h"
+#include "session/session_server.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define MOCK_MOVES_MAX 16
+#define CLIENTS_AMOUNT 64
+#define RECEIVES_MAX 100
+
+struct MockPlayer {
+  struct UserMove moves[MOCK_MOVES_MAX];
+  size_t moves_length;
+  game_user_id_t winners[MOCK_MOVES_MAX];
+  size_t valid_moves[MOCK_MOVES_MAX];
+  size_t results;
+  size_t users_amount;
+  size_t board_size;
+};
+
+static struct SessionServerOps *server_ops;
+static struct WireClientOps *client_ops;
+static struct MockPlayer mock_players[CLIENTS_AMOUNT];
+static struct WireClient clients[CLIENTS_AMOUNT];
+
+static void mock_move(struct WireClient *client, const struct UserMove *move) {
+  struct MockPlayer *player = client->data;
+
+  if (player->moves_length < MOCK_MOVES_MAX) {
+    player->moves[player->moves_length++] = *move;
+  }
+}
+
+static void mock_result(struct WireClient *client, game_user_id_t winner,
+                        size_t valid_moves) {
+  struct MockPlayer *player = client->data;
+
+  if (player->results < MOCK_MOVES_MAX) {
+    player->winners[player->results] = winner;
+    player->valid_moves[player->results] = valid_moves;
+  }
+  player->results++;
+}
+
+static void mock_start(struct WireClient *client, game_user_id_t seat,
+                       size_t users_amount, size_t board_size) {
+  struct MockPlayer *player = client->data;
+
+  (void)seat;
+  player->users_amount = users_amount;
+  player->board_size = board_size;
+}
+
+static void connect_client(size_t i) {
+  struct timeval timeout = {.tv_sec = 5};
+  char address[32];
+
+  // Both address forms reach server listening on localhost.
+  snprintf(address, sizeof(address), i % 2 ? "tcp:127.0.0.1:%u" : "tcp:%u",
+           server_ops->get_port());
+
+  clients[i].handlers = (struct WireClientHandlers){
+      .move = mock_move,
+      .result = mock_result,
+      .start = mock_start,
+  };
+  clients[i].data = &mock_players[i];
+  TEST_ASSERT_EQUAL_INT(0, client_ops->connect(&clients[i], address, false));
+
+  // Broken server fails the test instead of hanging it.
+  setsockopt(clients[i].fd, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+             sizeof(timeout));
+}
+
+static void queue(size_t i, game_user_id_t user, const char *events) {
+  enum InputEvents parsed[32];
+  size_t length = strlen(events);
+
+  for (size_t j = 0; j < length; j++) {
+    parsed[j] = events[j] == 'u'   ? INPUT_EVENT_UP
+                : events[j] == 'd' ? INPUT_EVENT_DOWN
+                : events[j] == 'l' ? INPUT_EVENT_LEFT
+                : events[j] == 'r' ? INPUT_EVENT_RIGHT
+                : events[j] == 's' ? INPUT_EVENT_SELECT
+                                   : INPUT_EVENT_EXIT;
+  }
+
+  TEST_ASSERT_EQUAL_INT(0, client_ops->queue_move(&clients[i], user, parsed,
+                                                  length));
+}
+
+// Flushes client and receives until server acknowledged all of its moves.
+static int exchange(size_t i) {
+  int err;
+
+  err = client_ops->flush(&clients[i]);
+  if (err) {
+    return err;
+  }
+
+  for (size_t j = 0; j < RECEIVES_MAX; j++) {
+    if (clients[i].moves_acked == clients[i].moves_sent) {
+      return 0;
+    }
+
+    err = client_ops->receive(&clients[i]);
+    if (err) {
+      return err;
+    }
+  }
+
+  return ETIMEDOUT;
+}
+
+// Receives until client got at least given amount of moves and results.
+static void receive_until(size_t i, size_t moves_length, size_t results) {
+  for (size_t j = 0; j < RECEIVES_MAX; j++) {
+    if (mock_players[i].moves_length >= moves_length &&
+        mock_players[i].results >= results) {
+      return;
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, client_ops->receive(&clients[i]));
+  }
+
+  TEST_FAIL_MESSAGE("Server did not send expected records");
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() {
+  server_ops = get_session_server_ops();
+  client_ops = get_wire_client_ops();
+  memset(mock_players, 0, sizeof(mock_players));
+  memset(clients, 0, sizeof(clients));
+}
+
+void tearDown() {
+  for (size_t i = 0; i < CLIENTS_AMOUNT; i++) {
+    if (clients[i].fd > 0) {
+      client_ops->close(&clients[i]);
+    }
+  }
+
+  server_ops->stop();
+}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_session_server_plays_games(void) {
+  struct SessionServerConfig config = {.reactors = 2, .users_amount = 2};
+  struct MockPlayer *player = &mock_players[0];
+  struct SessionServerStats stats;
+
+  TEST_ASSERT_EQUAL_INT(0, server_ops->start(&config));
+  TEST_ASSERT_NOT_EQUAL(0, server_ops->get_port());
+  TEST_ASSERT_EQUAL_size_t(2, server_ops->get_reactors());
+
+  connect_client(0);
+
+  // Second user is not on turn yet, first one wins the column on the left.
+  queue(0, 2, "s");
+  queue(0, 1, "ls");
+  queue(0, 2, "rs");
+  queue(0, 1, "lus");
+  queue(0, 2, "rs");
+  queue(0, 1, "ldds");
+  // Next game starts right away.
+  queue(0, 1, "e");
+  TEST_ASSERT_EQUAL_INT(0, exchange(0));
+
+  TEST_ASSERT_EQUAL_size_t(7, clients[0].moves_acked);
+  TEST_ASSERT_EQUAL_size_t(6, player->moves_length);
+  for (size_t i = 0; i < 5; i++) {
+    TEST_ASSERT_EQUAL_INT(USER_MOVE_TYPE_SELECT_VALID, player->moves[i].type);
+    TEST_ASSERT_EQUAL_INT(i % 2 + 1, player->moves[i].user_id);
+  }
+  TEST_ASSERT_EQUAL_INT(0, player->moves[4].coordinates.x);
+  TEST_ASSERT_EQUAL_INT(2, player->moves[4].coordinates.y);
+  TEST_ASSERT_EQUAL_INT(USER_MOVE_TYPE_QUIT, player->moves[5].type);
+
+  TEST_ASSERT_EQUAL_size_t(2, player->results);
+  TEST_ASSERT_EQUAL_INT(1, player->winners[0]);
+  TEST_ASSERT_EQUAL_size_t(5, player->valid_moves[0]);
+  TEST_ASSERT_EQUAL_INT(0, player->winners[1]);
+  TEST_ASSERT_EQUAL_size_t(0, player->valid_moves[1]);
+
+  server_ops->stop();
+  server_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(1, stats.accepted);
+  TEST_ASSERT_EQUAL_size_t(7, stats.moves);
+  TEST_ASSERT_EQUAL_size_t(1, stats.off_turn_moves);
+  TEST_ASSERT_EQUAL_size_t(2, stats.games);
+  TEST_ASSERT_EQUAL_size_t(0, stats.protocol_errors);
+}
+
+void test_session_server_spreads_connections(void) {
+  struct SessionServerConfig config = {.reactors = 4, .users_amount = 3};
+  struct SessionServerStats stats;
+  size_t busy_reactors = 0;
+
+  TEST_ASSERT_EQUAL_INT(0, server_ops->start(&config));
+
+  for (size_t i = 0; i < CLIENTS_AMOUNT; i++) {
+    connect_client(i);
+    queue(i, 1, "s");
+    queue(i, 2, "e");
+    TEST_ASSERT_EQUAL_INT(0, client_ops->flush(&clients[i]));
+  }
+
+  for (size_t i = 0; i < CLIENTS_AMOUNT; i++) {
+    TEST_ASSERT_EQUAL_INT(0, exchange(i));
+    TEST_ASSERT_EQUAL_size_t(1, mock_players[i].results);
+    TEST_ASSERT_EQUAL_size_t(1, mock_players[i].valid_moves[0]);
+  }
+
+  server_ops->stop();
+
+  server_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(CLIENTS_AMOUNT, stats.accepted);
+  TEST_ASSERT_EQUAL_size_t(CLIENTS_AMOUNT, stats.games);
+
+  // Kernel hashes connections over reactors' sockets, all of them landing
+  //  on one reactor out of four is practically impossible.
+  for (size_t i = 0; i < server_ops->get_reactors(); i++) {
+    server_ops->get_reactor_stats(i, &stats);
+    TEST_ASSERT_EQUAL_size_t(stats.accepted, stats.games);
+    busy_reactors += stats.accepted > 0;
+  }
+  TEST_ASSERT_GREATER_THAN(1, busy_reactors);
+}
+
+void test_session_server_protocol_error(void) {
+  struct SessionServerConfig config = {.reactors = 1, .users_amount = 2};
+  struct SessionServerStats stats;
+  int err;
+
+  TEST_ASSERT_EQUAL_INT(0, server_ops->start(&config));
+  TEST_ASSERT_EQUAL_INT(EALREADY, server_ops->start(&config));
+
+  // Session has no third user.
+  connect_client(0);
+  queue(0, 3, "s");
+
+  err = exchange(0);
+  TEST_ASSERT_TRUE(err == ECONNRESET || err == EPIPE);
+
+  server_ops->stop();
+  server_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(1, stats.protocol_errors);
+  TEST_ASSERT_EQUAL_size_t(0, stats.moves);
+}
+
+void test_session_server_matches_players(void) {
+  struct SessionServerConfig config = {.reactors = 2, .users_amount = 3};
+  struct SessionServerStats stats;
+  struct SessionMatchStats match_stats;
+  size_t first;
+  size_t second;
+  int err;
+
+  TEST_ASSERT_EQUAL_INT(0, server_ops->start(&config));
+
+  for (size_t i = 0; i < 2; i++) {
+    connect_client(i);
+    TEST_ASSERT_EQUAL_INT(0, client_ops->join(&clients[i], 2, 3));
+    TEST_ASSERT_EQUAL_INT(0, client_ops->flush(&clients[i]));
+  }
+
+  for (size_t i = 0; i < 2; i++) {
+    for (size_t j = 0; j < RECEIVES_MAX && clients[i].seat == 0; j++) {
+      TEST_ASSERT_EQUAL_INT(0, client_ops->receive(&clients[i]));
+    }
+    TEST_ASSERT_EQUAL_size_t(2, mock_players[i].users_amount);
+    TEST_ASSERT_EQUAL_size_t(3, mock_players[i].board_size);
+  }
+
+  // Players are seated in order matcher got them, which is up to reactors.
+  first = clients[0].seat == 1 ? 0 : 1;
+  second = 1 - first;
+  TEST_ASSERT_EQUAL_INT(1, clients[first].seat);
+  TEST_ASSERT_EQUAL_INT(2, clients[second].seat);
+
+  // Both players see every move of the shared session.
+  queue(first, 1, "s");
+  TEST_ASSERT_EQUAL_INT(0, exchange(first));
+  receive_until(second, 1, 0);
+
+  queue(second, 2, "ls");
+  TEST_ASSERT_EQUAL_INT(0, exchange(second));
+  receive_until(first, 2, 0);
+
+  for (size_t i = 0; i < 2; i++) {
+    TEST_ASSERT_EQUAL_INT(1, mock_players[i].moves[0].user_id);
+    TEST_ASSERT_EQUAL_INT(1, mock_players[i].moves[0].coordinates.x);
+    TEST_ASSERT_EQUAL_INT(2, mock_players[i].moves[1].user_id);
+    TEST_ASSERT_EQUAL_INT(0, mock_players[i].moves[1].coordinates.x);
+  }
+
+  // Player may play only for its own seat, breaking that ends the game for
+  //  the other one too.
+  queue(first, 2, "s");
+  err = exchange(first);
+  TEST_ASSERT_TRUE(err == ECONNRESET || err == EPIPE);
+
+  receive_until(second, 2, 1);
+  TEST_ASSERT_EQUAL_INT(0, mock_players[second].winners[0]);
+  TEST_ASSERT_EQUAL_size_t(2, mock_players[second].valid_moves[0]);
+
+  // The other one is back on its own and may play or join again.
+  queue(second, 3, "s");
+  TEST_ASSERT_EQUAL_INT(0, exchange(second));
+
+  server_ops->stop();
+  server_ops->get_stats(&stats);
+  TEST_ASSERT_EQUAL_size_t(2, stats.accepted);
+  TEST_ASSERT_EQUAL_size_t(2, stats.joins);
+  TEST_ASSERT_EQUAL_size_t(2, stats.seated);
+  TEST_ASSERT_EQUAL_size_t(1, stats.protocol_errors);
+  TEST_ASSERT_EQUAL_size_t(0, stats.overruns);
+
+  server_ops->get_match_stats(&match_stats);
+  TEST_ASSERT_EQUAL_size_t(1, match_stats.sessions);
+  TEST_ASSERT_EQUAL_size_t(2, match_stats.players);
+}
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+
+// App's internal libs
+#include "game/game_state_machine/game_state_machine.h"
+#include "game/game_state_machine/mini_state_machines/common.h"
+#include "game/user_move.h"
+#include "input/input_common.h"
+#include "session/session.h"
+
+// Mocks requirement
+#include "game_sm_win_wrapper.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define GAMES_AMOUNT 200
+#define EVENTS_MAX (2 * SESSION_BOARD_MAX + 1)
+
+static struct GameSmWinModulePrivateOps *win_priv_ops;
+static struct GameStateMachineCommonOps *gsm_common_ops;
+static struct SessionOps *session_ops;
+static struct GameStateMachineState state;
+static struct Session session;
+
+// Moves cursor to the cell with rights and downs only, then selects it.
+static int play(int x, int y) {
+  enum InputEvents events[EVENTS_MAX];
+  struct UserMove moves[EVENTS_MAX];
+  int size = session.board_size;
+  size_t events_length = 0;
+  size_t moves_length;
+
+  for (int i = 0; i < (x - session.cursor.x + size) % size; i++) {
+    events[events_length++] = INPUT_EVENT_RIGHT;
+  }
+  for (int i = 0; i < (y - session.cursor.y + size) % size; i++) {
+    events[events_length++] = INPUT_EVENT_DOWN;
+  }
+  events[events_length++] = INPUT_EVENT_SELECT;
+
+  return session_ops->process_events(&session, session.current_user, events,
+                                     events_length, moves, &moves_length);
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() {
+  win_priv_ops = get_game_sm_win_module_priv_ops();
+  gsm_common_ops = get_sm_mini_machines_common_ops();
+  session_ops = get_session_ops();
+}
+
+void tearDown() {}
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+// Hosted sessions have to end exactly when the same game played locally
+//  would.
+void test_session_win_agrees_with_local_game(void) {
+  struct UserMove move = {.type = USER_MOVE_TYPE_SELECT_VALID};
+  struct UserMoveCoordinates cells[SESSION_BOARD_MAX * SESSION_BOARD_MAX];
+  struct UserMoveCoordinates swap;
+  uint32_t seed = 7;
+  size_t wins = 0;
+  size_t users_amount;
+  size_t board_size;
+  size_t cells_length;
+  size_t j;
+  bool is_win;
+
+  for (size_t game = 0; game < GAMES_AMOUNT; game++) {
+    users_amount = 2 + game % 4;
+    board_size = users_amount + 1;
+    cells_length = board_size * board_size;
+    memset(&state, 0, sizeof(state));
+    TEST_ASSERT_EQUAL_INT(
+        0, session_ops->init(&session, users_amount, board_size));
+
+    // Both games take the same cells in the same, random order.
+    for (size_t i = 0; i < cells_length; i++) {
+      cells[i] = (struct UserMoveCoordinates){.x = i % board_size,
+                                              .y = i / board_size};
+    }
+    for (size_t i = cells_length - 1; i > 0; i--) {
+      seed = seed * 1103515245 + 12345;
+      j = (seed >> 16) % (i + 1);
+      swap = cells[i];
+      cells[i] = cells[j];
+      cells[j] = swap;
+    }
+
+    for (size_t i = 0; i < cells_length; i++) {
+      move.user_id = session.current_user;
+      move.coordinates = cells[i];
+      TEST_ASSERT_EQUAL_INT(0, gsm_common_ops->add_move(&state, move));
+      is_win = win_priv_ops->is_win(&state, &move, users_amount);
+
+      TEST_ASSERT_EQUAL_INT(0, play(move.coordinates.x, move.coordinates.y));
+      TEST_ASSERT_EQUAL(is_win, session.state == SESSION_STATE_WIN);
+
+      if (is_win) {
+        TEST_ASSERT_EQUAL_INT(move.user_id, session.winner);
+        wins++;
+        break;
+      }
+    }
+  }
+
+  // Random games have to end both ways, otherwise nothing was compared.
+  TEST_ASSERT_TRUE(wins > 0 && wins < GAMES_AMOUNT);
+}
@@ -0,0 +1,120 @@
+/*******************************************************************************
+ *    IMPORTS
+ ******************************************************************************/
+// Tests framework
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <unity.h>
+
+// App's internal libs
+#include "utils/ring_utils.h"
+
+/*******************************************************************************
+ *    PRIVATE DECLARATIONS & DEFINITIONS
+ ******************************************************************************/
+#define RING_LENGTH 8
+#define PRODUCERS_AMOUNT 4
+#define PRODUCER_ITEMS_AMOUNT 10000
+
+struct MockItem {
+  size_t producer;
+  size_t value;
+  // Items are bigger than a word, so torn copies would show.
+  size_t check;
+};
+
+static struct RingUtilsOps *ring_ops;
+static struct Ring ring;
+
+static void *producer_thread(void *data) {
+  struct MockItem item = {.producer = (size_t)data};
+
+  for (size_t i = 0; i < PRODUCER_ITEMS_AMOUNT; i++) {
+    item.value = i;
+    item.check = ~i;
+
+    // Consumer runs concurrently, so full ring only means retry.
+    while (ring_ops->push(&ring, &item) == ENOBUFS) {
+      sched_yield();
+    }
+  }
+
+  return NULL;
+}
+
+/*******************************************************************************
+ *    TESTS FRAMEWORK BOILERCODE
+ ******************************************************************************/
+void setUp() {
+  ring_ops = get_ring_utils_ops();
+
+  TEST_ASSERT_EQUAL_INT(
+      0, ring_ops->init(&ring, RING_LENGTH, sizeof(struct MockItem)));
+}
+
+void tearDown() { ring_ops->destroy(&ring); }
+
+/*******************************************************************************
+ *    TESTS
+ ******************************************************************************/
+void test_ring_utils_init_invalid(void) {
+  struct Ring invalid;
+
+  TEST_ASSERT_EQUAL_INT(EINVAL, ring_ops->init(&invalid, 6, 1));
+  TEST_ASSERT_EQUAL_INT(EINVAL, ring_ops->init(&invalid, 0, 1));
+  TEST_ASSERT_EQUAL_INT(EINVAL, ring_ops->init(&invalid, 8, 0));
+}
+
+void test_ring_utils_keeps_order(void) {
+  struct MockItem item;
+
+  TEST_ASSERT_EQUAL_INT(EAGAIN, ring_ops->pop(&ring, &item));
+
+  // Two laps, so slots are reused.
+  for (size_t lap = 0; lap < 2; lap++) {
+    for (size_t i = 0; i < RING_LENGTH; i++) {
+      item = (struct MockItem){.value = i, .check = ~i};
+      TEST_ASSERT_EQUAL_INT(0, ring_ops->push(&ring, &item));
+    }
+    TEST_ASSERT_EQUAL_INT(ENOBUFS, ring_ops->push(&ring, &item));
+
+    for (size_t i = 0; i < RING_LENGTH; i++) {
+      TEST_ASSERT_EQUAL_INT(0, ring_ops->pop(&ring, &item));
+      TEST_ASSERT_EQUAL_size_t(i, item.value);
+      TEST_ASSERT_EQUAL_size_t(~i, item.check);
+    }
+    TEST_ASSERT_EQUAL_INT(EAGAIN, ring_ops->pop(&ring, &item));
+  }
+}
+
+void test_ring_utils_many_producers(void) {
+  size_t received[PRODUCERS_AMOUNT] = {0};
+  pthread_t threads[PRODUCERS_AMOUNT];
+  struct MockItem item;
+  size_t total = 0;
+
+  for (size_t i = 0; i < PRODUCERS_AMOUNT; i++) {
+    TEST_ASSERT_EQUAL_INT(
+        0, pthread_create(&threads[i], NULL, producer_thread, (void *)i));
+  }
+
+  while (total < PRODUCERS_AMOUNT * PRODUCER_ITEMS_AMOUNT) {
+    if (ring_ops->pop(&ring, &item)) {
+      sched_yield();
+      continue;
+    }
+
+    // Every producer's items have to arrive in order it pushed them.
+    TEST_ASSERT_TRUE(item.producer < PRODUCERS_AMOUNT);
+    TEST_ASSERT_EQUAL_size_t(received[item.producer], item.value);
+    TEST_ASSERT_EQUAL_size_t(~item.value, item.check);
+    received[item.producer]++;
+    total++;
+  }
+
+  for (size_t i = 0; i < PRODUCERS_AMOUNT; i++) {
+    pthread_join(threads[i], NULL);
+  }
+}
@@ -0,0 +1,23 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "input/input.h"
+#include "input/input_common.h"
+
+#define GENERATOR_EVENTS_LENGTH (INPUT_EVENT_EXIT - INPUT_EVENT_UP + 1)
+
+struct InputGenerator;
+
+struct InputGeneratorPrivateOps {
+  int (*get_number)(char *var_name, char *default_value, uint64_t *number);
+  int (*parse_weights)(char *weights_str,
+                       uint64_t weights[GENERATOR_EVENTS_LENGTH]);
+  int (*start)(struct InputGenerator *generator);
+  void (*stop)(struct InputGenerator *generator);
+  enum InputEvents (*draw_event)(struct InputGenerator *generator);
+  void (*process_timer)(struct InputWatch *watch, uint32_t events);
+  uint64_t (*get_deadline)(uint64_t start_ns, uint64_t events, uint64_t rate);
+  uint64_t (*get_due_events)(uint64_t elapsed_ns, uint64_t rate);
+};
+
+struct InputGeneratorPrivateOps *get_input_generator_priv_ops(void);
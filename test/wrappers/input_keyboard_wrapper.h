@@ -1,7 +1,7 @@
 // C standard library
-#include <pthread.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "static_array_lib.h"
 
@@ -9,34 +9,71 @@
 #include "input/input.h"
 #include "input/input_common.h"
 #include "input/keyboard/keyboard.h"
+#include "input/keyboard/keyboard_decoder.h"
 #include "input/keyboard/keyboard_keys_mapping.h"
 
 /*******************************************************************************
  *    PRIVATE DECLARATIONS & DEFINITIONS
  ******************************************************************************/
 #define KEYBOARD_KEYS_MAPPINGS_MAX 10
-#define KEYBOARD_STDIN_BUFFER_MAX 10
+// Big enough for pasted text or piped script, every byte may be a key.
+#define KEYBOARD_STDIN_BUFFER_MAX 4096
+// Escape pending from previous read may become one more key.
+#define KEYBOARD_KEYS_MAX (KEYBOARD_STDIN_BUFFER_MAX + 1)
+// Terminals send whole escape sequence at once, anything slower is a user
+//  pressing escape key.
+#define KEYBOARD_ESCAPE_TIMEOUT_MS 100
+
+// Mapping resolved to everything needed for decoding and delivering the
+//  events. Dispatch table is built when keyboard starts and only read
+//  afterwards, so reading stdin needs no device lookups.
+struct KeyboardDispatch {
+  enum InputEvents keys[KEYBOARD_KEYS_TABLE_LENGTH];
+  // Used only by mappings which do not have keys table.
+  keyboard_key_mapping_callback_t decode;
+  input_callback_func_t callback;
+  input_batch_callback_func_t batch_callback;
+  input_device_id_t device_id;
+};
 
 typedef struct KeyboardSubsystem {
-  pthread_t thread;
+  struct InputWatch watch;
+  // Timer flushing unfinished escape sequence, runs on input's loop too.
+  struct InputWatch escape_watch;
   bool is_initialized;
   size_t stdin_buffer_count;
   char stdin_buffer[KEYBOARD_STDIN_BUFFER_MAX];
+  // Decoder is kept across reads, sequences may be split between them.
+  struct KeyboardDecoder decoder;
+  size_t keys_count;
+  keyboard_key_t keys[KEYBOARD_KEYS_MAX];
+  enum InputEvents input_events[KEYBOARD_KEYS_MAX];
   SARRS_FIELD(keys_mappings, struct KeyboardKeysMapping,
               KEYBOARD_KEYS_MAPPINGS_MAX);
+  SARRS_FIELD(dispatches, struct KeyboardDispatch, KEYBOARD_KEYS_MAPPINGS_MAX);
 } KeyboardSubsystem;
 
 SARRS_DECL(KeyboardSubsystem, keys_mappings, struct KeyboardKeysMapping,
            KEYBOARD_KEYS_MAPPINGS_MAX);
+SARRS_DECL(KeyboardSubsystem, dispatches, struct KeyboardDispatch,
+           KEYBOARD_KEYS_MAPPINGS_MAX);
 
 struct KeyboardPrivateOps {
   int (*init)(struct KeyboardSubsystem *);
   void (*destroy)(struct KeyboardSubsystem *);
-  void (*read_stdin)(struct KeyboardSubsystem *);
-  int (*start_thread)(struct KeyboardSubsystem *);
-  void (*stop_thread)(struct KeyboardSubsystem *);
-  void *(*process_stdin)(struct KeyboardSubsystem *);
+  int (*read_stdin)(struct KeyboardSubsystem *);
+  int (*start_watch)(struct KeyboardSubsystem *);
+  void (*stop_watch)(struct KeyboardSubsystem *);
+  void (*process_stdin)(struct InputWatch *, uint32_t);
+  void (*process_escape_timeout)(struct InputWatch *, uint32_t);
+  int (*set_escape_timeout)(struct KeyboardSubsystem *, bool is_armed);
   void (*execute_callbacks)(struct KeyboardSubsystem *);
+  int (*build_dispatches)(struct KeyboardSubsystem *);
+  int (*decode)(struct KeyboardSubsystem *, struct KeyboardDispatch *,
+                size_t *);
+  int (*deliver_events)(struct KeyboardDispatch *dispatch,
+                        const enum InputEvents *input_events,
+                        size_t input_events_length);
   int (*add_keys_mapping)(struct KeyboardAddKeysMappingInput *,
                           struct KeyboardAddKeysMappingOutput *);
 };